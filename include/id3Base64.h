@@ -0,0 +1,37 @@
+/**
+ * @file id3Base64.h
+ * @author Ewan Jones
+ * @brief Function definitions for the base64 encoding used to represent binary frame content as text
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_BASE64
+#define ID3_BASE64
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+size_t id3Base64EncodedSize(size_t length);
+
+size_t id3Base64Encode(const uint8_t *data, size_t length, char *out);
+
+bool id3Base64Accelerated(void);
+
+size_t id3Base64DecodedSize(size_t length);
+
+bool id3Base64Decode(const char *text, size_t length, uint8_t *out, size_t *outl);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file id3Cbor.h
+ * @author Ewan Jones
+ * @brief Function definitions for the CBOR writer and reader used for the compact binary export of tags
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_CBOR
+#define ID3_CBOR
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "id3Sink.h"
+
+//! Longest map key the reader keeps, including the null terminator. Longer keys are truncated
+#define ID3_CBOR_KEY_SIZE 32
+
+//! Deepest nesting of maps and arrays the reader enters or skips
+#define ID3_CBOR_MAX_DEPTH 64
+
+/**
+ * @brief Pull reader walking a CBOR document in place.
+ * @details Items are read in document order without building a tree. Text and byte strings are returned as
+ * pointers into the document, so reading never copies or allocates. Only definite length strings are accepted,
+ * maps and arrays may have definite or indefinite length. Once malformed or unexpected input is met the reader is
+ * marked as failed and every further read fails.
+ */
+typedef struct _Id3CborReader {
+    //! CBOR document being read
+    const uint8_t *data;
+
+    //! Number of bytes in data
+    size_t length;
+
+    //! Offset of the next byte to read
+    size_t cursor;
+
+    //! Set once malformed or unexpected CBOR was met
+    bool failed;
+
+    //! Key of the member id3CborNextMember last moved to, null-terminated
+    char key[ID3_CBOR_KEY_SIZE];
+
+    //! Number of maps and arrays entered and not yet left
+    size_t depth;
+
+    //! Items left in each entered container, SIZE_MAX for indefinite length
+    size_t remaining[ID3_CBOR_MAX_DEPTH];
+} Id3CborReader;
+
+// writing
+
+bool id3CborWriteUnsigned(Id3Sink *sink, uint64_t value);
+
+bool id3CborWriteBool(Id3Sink *sink, bool value);
+
+bool id3CborWriteFloat(Id3Sink *sink, float value);
+
+bool id3CborWriteText(Id3Sink *sink, const char *text, size_t length);
+
+bool id3CborWriteString(Id3Sink *sink, const char *string);
+
+bool id3CborWriteBytes(Id3Sink *sink, const uint8_t *data, size_t length);
+
+bool id3CborWriteMap(Id3Sink *sink, size_t count);
+
+bool id3CborWriteArray(Id3Sink *sink, size_t count);
+
+bool id3CborWriteArrayStart(Id3Sink *sink);
+
+bool id3CborWriteBreak(Id3Sink *sink);
+
+// reading
+
+Id3CborReader *id3CborReaderCreate(const uint8_t *data, size_t length);
+
+void id3CborReaderDestroy(Id3CborReader **toDelete);
+
+bool id3CborBeginMap(Id3CborReader *reader);
+
+bool id3CborNextMember(Id3CborReader *reader);
+
+bool id3CborBeginArray(Id3CborReader *reader);
+
+bool id3CborNextElement(Id3CborReader *reader);
+
+const char *id3CborReadText(Id3CborReader *reader, size_t *length);
+
+const uint8_t *id3CborReadBytes(Id3CborReader *reader, size_t *length);
+
+bool id3CborReadUnsigned(Id3CborReader *reader, uint64_t *value);
+
+bool id3CborReadBool(Id3CborReader *reader, bool *value);
+
+bool id3CborReadFloat(Id3CborReader *reader, float *value);
+
+bool id3CborSkipValue(Id3CborReader *reader);
+
+bool id3CborReaderFinished(Id3CborReader *reader);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,33 @@
+/**
+ * @file id3Crc32.h
+ * @author Ewan Jones
+ * @brief Function definitions for the CRC-32 checksum stored in ID3v2 extended headers
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_CRC32
+#define ID3_CRC32
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+uint32_t id3Crc32(uint32_t crc, const uint8_t *data, size_t length);
+
+uint32_t id3Crc32Zeros(uint32_t crc, size_t length);
+
+bool id3Crc32Accelerated(void);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file id3File.h
+ * @author Ewan Jones
+ * @brief Declarations of low level file helpers used to read, patch, and rewrite tagged files
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_FILE
+#define ID3_FILE
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+//! Size in bytes of the buffer used when the kernel cannot copy a range on its own (64 KiB)
+#define ID3_FILE_COPY_BUFFER_SIZE 65536
+
+/**
+ * @brief Location of the tags and audio data within a file.
+ * @details The audio data, along with anything else that is not a leading ID3v2 tag or a trailing ID3v1 tag,
+ * is the range [id3v2Size, id3v1Offset).
+ */
+typedef struct _Id3FileLayout {
+    //! Size of the file in bytes
+    uint64_t fileSize;
+
+    //! Bytes taken by the ID3v2 tag at the start of the file including header, padding, and footer. 0 when there is no tag.
+    uint64_t id3v2Size;
+
+    //! Offset of the ID3v1 tag at the end of the file. Equal to fileSize when there is no tag.
+    uint64_t id3v1Offset;
+} Id3FileLayout;
+
+/**
+ * @brief Identity and version of a file, filled in by id3FileIdentify.
+ * @details Two descriptors refer to the same file when device and inode match, whatever path, symbolic link, or hard
+ * link they were opened through. Size and modification time change when the file is written. Windows reports no
+ * inode numbers, there every file on a drive has the same identity.
+ */
+typedef struct _Id3FileIdentity {
+    //! Device the file is stored on
+    uint64_t device;
+
+    //! Inode number of the file on its device
+    uint64_t inode;
+
+    //! Size of the file in bytes
+    uint64_t size;
+
+    //! Last modification time in nanoseconds since the epoch
+    int64_t modified;
+} Id3FileIdentity;
+
+/**
+ * @brief Read only view of a whole file mapped into memory.
+ * @details Created by id3FileMap and released with id3FileUnmap.
+ */
+typedef struct _Id3FileMapping {
+    //! Mapped bytes of the file
+    const uint8_t *data;
+
+    //! Number of bytes mapped, the size of the file when it was mapped
+    size_t length;
+} Id3FileMapping;
+
+int id3FileOpen(const char *filePath, bool write);
+
+void id3FileClose(int fd);
+
+bool id3FileSize(int fd, uint64_t *size);
+
+bool id3FileIdentify(int fd, Id3FileIdentity *identity);
+
+bool id3FileReadAt(int fd, uint8_t *buffer, size_t length, uint64_t offset);
+
+bool id3FileWriteAt(int fd, const uint8_t *buffer, size_t length, uint64_t offset);
+
+bool id3FileWrite(int fd, const uint8_t *buffer, size_t length);
+
+bool id3FileCopyRange(int inFd, uint64_t offset, uint64_t length, int outFd);
+
+uint64_t id3FileTagSize(const uint8_t *bytes, bool footer);
+
+bool id3FileReadLayout(int fd, Id3FileLayout *layout);
+
+bool id3FileRewrite(const char *filePath, int fd, const uint8_t *head, size_t headl, uint64_t start, uint64_t end,
+                    const uint8_t *tail, size_t taill);
+
+bool id3FileMap(const char *filePath, Id3FileMapping *mapping);
+
+void id3FileUnmap(Id3FileMapping *mapping);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
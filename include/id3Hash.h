@@ -0,0 +1,62 @@
+/**
+ * @file id3Hash.h
+ * @author Ewan Jones
+ * @brief Function definitions for the streaming 64 bit hash used to fingerprint audio content
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_HASH
+#define ID3_HASH
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! Number of bytes the hash consumes per step
+#define ID3_HASH_STRIPE_SIZE 32
+
+//! Size of a hash once written out as bytes
+#define ID3_HASH_DIGEST_SIZE 8
+
+/**
+ * @brief State of a hash being computed over data given in pieces.
+ * @details Set up with id3HashInit, fed with id3HashUpdate and read with id3HashFinal. The result does not depend on
+ * how the data was split between calls.
+ */
+typedef struct _Id3Hash {
+    //! Four accumulators each stripe is mixed into
+    uint64_t lanes[4];
+
+    //! Number of bytes given so far
+    uint64_t total;
+
+    //! Seed the accumulators started from
+    uint64_t seed;
+
+    //! Bytes held back until a full stripe is available
+    uint8_t buffer[ID3_HASH_STRIPE_SIZE];
+
+    //! Number of bytes held in buffer
+    size_t buffered;
+} Id3Hash;
+
+void id3HashInit(Id3Hash *state, uint64_t seed);
+
+void id3HashUpdate(Id3Hash *state, const uint8_t *data, size_t length);
+
+uint64_t id3HashFinal(const Id3Hash *state);
+
+uint64_t id3Hash64(const uint8_t *data, size_t length, uint64_t seed);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file id3Json.h
+ * @author Ewan Jones
+ * @brief Function definitions for the streaming JSON reader used to import tags from their JSON representation
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_JSON
+#define ID3_JSON
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+//! Longest object key the reader keeps, including the null terminator. Longer keys are truncated
+#define ID3_JSON_KEY_SIZE 32
+
+//! Deepest nesting of objects and arrays id3JsonSkipValue descends into
+#define ID3_JSON_MAX_DEPTH 64
+
+/**
+ * @brief Pull reader walking a JSON document in place.
+ * @details Values are read in document order without building a tree. String values are unescaped into a single
+ * buffer owned by the reader that is reused for every string, so reading a document allocates only when a string
+ * longer than any before it is met. Once malformed or unexpected input is met the reader is marked as failed and
+ * every further read fails.
+ */
+typedef struct _Id3JsonReader {
+    //! JSON text being read
+    const char *json;
+
+    //! Number of bytes in json
+    size_t length;
+
+    //! Offset of the next byte to read
+    size_t cursor;
+
+    //! Set once malformed or unexpected JSON was met
+    bool failed;
+
+    //! Key of the member id3JsonNextMember last moved to, null-terminated
+    char key[ID3_JSON_KEY_SIZE];
+
+    //! Unescaped text of the string id3JsonReadString last read, null-terminated
+    char *value;
+
+    //! Number of bytes allocated for value
+    size_t capacity;
+} Id3JsonReader;
+
+Id3JsonReader *id3JsonReaderCreate(const char *json, size_t length);
+
+void id3JsonReaderDestroy(Id3JsonReader **toDelete);
+
+bool id3JsonBeginObject(Id3JsonReader *reader);
+
+bool id3JsonNextMember(Id3JsonReader *reader);
+
+bool id3JsonBeginArray(Id3JsonReader *reader);
+
+bool id3JsonNextElement(Id3JsonReader *reader);
+
+const char *id3JsonReadString(Id3JsonReader *reader, size_t *length);
+
+bool id3JsonReadInteger(Id3JsonReader *reader, int64_t *value);
+
+bool id3JsonReadBool(Id3JsonReader *reader, bool *value);
+
+bool id3JsonSkipValue(Id3JsonReader *reader);
+
+bool id3JsonReaderFinished(Id3JsonReader *reader);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file id3Mpeg.h
+ * @author Ewan Jones
+ * @brief Function definitions for walking the MPEG audio frames that follow a tag and indexing them for seeking
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_MPEG
+#define ID3_MPEG
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+//! Size of an MPEG audio frame header in bytes
+#define ID3_MPEG_FRAME_HEADER_SIZE 4
+
+//! Milliseconds between seek points when no interval is given
+#define ID3_MPEG_DEFAULT_INTERVAL 1000
+
+//! Version value of MPEG 2.5 streams
+#define ID3_MPEG_VERSION_2_5 25
+
+/**
+ * @brief Fields of an MPEG audio frame header.
+ */
+typedef struct _Id3MpegFrameHeader {
+    //! MPEG version, 1, 2 or ID3_MPEG_VERSION_2_5
+    uint8_t version;
+
+    //! Layer, 1 to 3
+    uint8_t layer;
+
+    //! Number of channels, 1 or 2
+    uint8_t channels;
+
+    //! Bits per second
+    uint32_t bitrate;
+
+    //! Samples per second
+    uint32_t sampleRate;
+
+    //! Samples the frame decodes to per channel
+    uint32_t samples;
+
+    //! Size of the frame in bytes including its header
+    uint32_t size;
+} Id3MpegFrameHeader;
+
+/**
+ * @brief Positions of evenly spaced audio frames in an MPEG stream.
+ * @details Created by id3MpegIndexFromFile or id3MpegIndexFromBuffer and turned into a seek frame with
+ * id3v2WriteSeekIndex. Every frame of a stream is expected to decode to the same number of samples at the same
+ * sample rate, so frame stride * i starts at stride * i * samplesPerFrame / sampleRate seconds.
+ */
+typedef struct _Id3MpegIndex {
+    //! Offset of the first audio frame from the start of the file
+    uint64_t start;
+
+    //! Number of bytes from the first audio frame to the end of the last
+    uint64_t length;
+
+    //! Number of audio frames
+    uint64_t frames;
+
+    //! Samples each frame decodes to per channel
+    uint32_t samplesPerFrame;
+
+    //! Samples per second
+    uint32_t sampleRate;
+
+    //! Number of frames between consecutive entries of offsets
+    uint32_t stride;
+
+    //! Number of entries in offsets
+    size_t count;
+
+    //! Offset of frame stride * i from the first audio frame for each entry i, the first entry is always 0
+    uint64_t *offsets;
+
+    //! Set when the offsets were estimated from a Xing or VBRI table of contents instead of walking every frame
+    bool estimated;
+} Id3MpegIndex;
+
+bool id3MpegReadFrameHeader(const uint8_t *bytes, size_t length, Id3MpegFrameHeader *header);
+
+Id3MpegIndex *id3MpegIndexFromBuffer(const uint8_t *buffer, size_t size, uint32_t interval, bool exact);
+
+Id3MpegIndex *id3MpegIndexFromFile(const char *filePath, uint32_t interval, bool exact);
+
+void id3MpegDestroyIndex(Id3MpegIndex **toDelete);
+
+uint64_t id3MpegIndexDuration(const Id3MpegIndex *index);
+
+uint64_t id3MpegIndexOffsetAt(const Id3MpegIndex *index, uint64_t frame);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,212 @@
+/**
+ * @file id3Scan.h
+ * @author Ewan Jones
+ * @brief Function definitions for reading and editing the tags of many files at once across worker threads
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_SCAN
+#define ID3_SCAN
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "id3dev.h"
+
+//! Read the ID3v1 tag of each file
+#define ID3_SCAN_ID3V1 0x01
+
+//! Read the ID3v2 tag of each file
+#define ID3_SCAN_ID3V2 0x02
+
+//! Most worker threads a scan starts
+#define ID3_SCAN_MAX_THREADS 256
+
+//! Most files the io_uring reader keeps in flight, fewer when the open file limit (RLIMIT_NOFILE) is lower
+#define ID3_SCAN_MAX_QUEUE_DEPTH 4096
+
+//! Reorder window of an ordered scan when the options give none, see Id3ScanOptions
+#define ID3_SCAN_REORDER_WINDOW 64
+
+/**
+ * @brief Receives the tags read from one file during a scan.
+ * @details Calls are never made at the same time, so a callback needs no locking of its own, but they may come from
+ * any worker thread. A file that could not be read is delivered with both tags set to NULL, and metadata is only NULL
+ * when memory ran out.
+ * @param filePath - Path of the file the tags were read from.
+ * @param metadata - Tags read from the file. Ownership passes to the callback, which must free it with id3Destroy.
+ * @param userData - Pointer given to the scan.
+ */
+typedef void (*Id3ScanCallback)(const char *filePath, ID3 *metadata, void *userData);
+
+/**
+ * @brief Options controlling how files are scanned.
+ * @details A NULL options pointer is accepted wherever these options are taken and reads both tags of every file
+ * with one worker per processor, delivering results as soon as they are ready.
+ */
+typedef struct _Id3ScanOptions {
+    //! Number of worker threads, 0 for one per online processor
+    size_t threads;
+
+    //! Tags read from each file, a combination of ID3_SCAN_ID3V1 and ID3_SCAN_ID3V2
+    uint8_t tags;
+
+    //! Deliver results in path order instead of as soon as each file is read
+    bool ordered;
+
+    //! Files an ordered scan reads at most from the next one to deliver onwards, bounding the results it holds. 0 for ID3_SCAN_REORDER_WINDOW
+    size_t reorderWindow;
+
+    //! Files the io_uring reader keeps in flight from the calling thread, 0 to read with worker threads. Worker threads are used when io_uring is unavailable, see id3ScanUringSupported
+    size_t queueDepth;
+
+    //! Only files ending in this extension are read by id3ScanDirectory, compared without case, or NULL for every file. Borrowed
+    const char *extension;
+
+    //! Options every delivered structure uses, or NULL. Borrowed, the user pairings are used when parsing
+    const Id3Options *options;
+} Id3ScanOptions;
+
+/**
+ * @brief Fields an edit set can change.
+ * @details Each field is written with the id3Write function of the same name, so the preferred standard of the
+ * structure decides which tag is changed.
+ */
+typedef enum _Id3EditField {
+    //! Changed with id3WriteTitle
+    title_edit,
+
+    //! Changed with id3WriteArtist
+    artist_edit,
+
+    //! Changed with id3WriteAlbumArtist
+    albumArtist_edit,
+
+    //! Changed with id3WriteAlbum
+    album_edit,
+
+    //! Changed with id3WriteYear
+    year_edit,
+
+    //! Changed with id3WriteGenre
+    genre_edit,
+
+    //! Changed with id3WriteTrack
+    track_edit,
+
+    //! Changed with id3WriteDisc
+    disc_edit,
+
+    //! Changed with id3WriteComposer
+    composer_edit,
+
+    //! Changed with id3WriteLyrics
+    lyrics_edit,
+
+    //! Changed with id3WriteComment
+    comment_edit
+} Id3EditField;
+
+//! Number of fields an edit set can change
+#define ID3_EDIT_FIELD_COUNT 11
+
+/**
+ * @brief Changes made to the tags of a file by id3EditFiles.
+ * @details A zero initialised set changes nothing. One set may be shared by any number of files.
+ */
+typedef struct _Id3EditSet {
+    //! New UTF-8 value of each field indexed by Id3EditField, NULL leaves the field as it is. Borrowed
+    const char *values[ID3_EDIT_FIELD_COUNT];
+} Id3EditSet;
+
+/**
+ * @brief A file and the changes to make to it.
+ */
+typedef struct _Id3Edit {
+    //! Path of the file to edit. Borrowed
+    const char *filePath;
+
+    //! Changes to make to the file. Borrowed
+    const Id3EditSet *edits;
+} Id3Edit;
+
+/**
+ * @brief Outcome of editing one file.
+ */
+typedef enum _Id3EditStatus {
+    //! The changed tags were written to the file
+    written_edit,
+
+    //! The file could not be opened or its tags could not be read
+    readFailed_edit,
+
+    //! The file has no tag to change
+    noTag_edit,
+
+    //! A field could not be written to the tags, the file was left as it was
+    applyFailed_edit,
+
+    //! The changed tags could not be written to the file
+    writeFailed_edit
+} Id3EditStatus;
+
+/**
+ * @brief Receives the outcome of each file edited by id3EditFiles.
+ * @details Calls are never made at the same time but may come from any worker thread, done counts the files
+ * finished so far including this one.
+ * @param filePath - Path of the file that was edited.
+ * @param status - Outcome of the edit.
+ * @param done - Number of files finished so far.
+ * @param count - Number of files being edited.
+ * @param userData - Pointer given to id3EditFiles.
+ */
+typedef void (*Id3EditCallback)(const char *filePath, Id3EditStatus status, size_t done, size_t count,
+                                void *userData);
+
+/**
+ * @brief Options controlling how files are edited.
+ * @details A NULL options pointer is accepted wherever these options are taken and edits with one worker per
+ * processor and no memory limit.
+ */
+typedef struct _Id3EditOptions {
+    //! Number of worker threads, 0 for one per online processor
+    size_t threads;
+
+    //! Bytes of tags the workers may hold at once, 0 for no limit. A file larger than the limit is edited alone
+    size_t memoryLimit;
+
+    //! Options every edited structure uses, or NULL. Borrowed, the preferred standard decides which tag is changed and the write options how the file is written
+    const Id3Options *options;
+} Id3EditOptions;
+
+Id3ScanOptions *id3CreateScanOptions(size_t threads, uint8_t tags, bool ordered);
+
+void id3DestroyScanOptions(Id3ScanOptions **toDelete);
+
+bool id3ScanUringSupported(void);
+
+bool id3ScanFiles(const char *const *filePaths, size_t count, const Id3ScanOptions *options, Id3ScanCallback callback,
+                  void *userData);
+
+bool id3ScanDirectory(const char *root, const Id3ScanOptions *options, Id3ScanCallback callback, void *userData);
+
+Id3EditOptions *id3CreateEditOptions(size_t threads, size_t memoryLimit);
+
+void id3DestroyEditOptions(Id3EditOptions **toDelete);
+
+bool id3EditFiles(const Id3Edit *edits, size_t count, const Id3EditOptions *options, Id3EditCallback callback,
+                  void *userData);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
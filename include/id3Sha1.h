@@ -0,0 +1,31 @@
+/**
+ * @file id3Sha1.h
+ * @author Ewan Jones
+ * @brief Function definitions for the SHA-1 digest used to identify binary frame content
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_SHA1
+#define ID3_SHA1
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! Size of a SHA-1 digest in bytes
+#define ID3_SHA1_DIGEST_SIZE 20
+
+void id3Sha1(const uint8_t *data, size_t length, uint8_t digest[ID3_SHA1_DIGEST_SIZE]);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
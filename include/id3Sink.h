@@ -0,0 +1,91 @@
+/**
+ * @file id3Sink.h
+ * @author Ewan Jones
+ * @brief Declarations of output sinks used to stream serialized tags and JSON without intermediate buffers
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3_SINK
+#define ID3_SINK
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Callback receiving serialized output.
+ * @details Must consume all length bytes and return true, or return false to stop the serialization.
+ * @param user - User pointer given when the sink was created.
+ * @param data - Bytes to consume.
+ * @param length - Number of bytes in data.
+ * @return bool - true if all bytes were consumed, false otherwise.
+ */
+typedef bool (*Id3SinkWriteFunction)(void *user, const uint8_t *data, size_t length);
+
+/**
+ * @brief Destination for serialized binary or JSON output.
+ * @details A sink forwards everything written to it to a callback. Ready-made sinks write to a FILE*, a file
+ * descriptor, or a growable memory buffer owned by the sink. Once a write fails the sink is marked as failed
+ * and ignores all further writes so producers only need to check the result once at the end.
+ */
+typedef struct _Id3Sink {
+    //! Callback receiving the output
+    Id3SinkWriteFunction write;
+
+    //! User pointer handed to the callback
+    void *user;
+
+    //! Total number of bytes accepted by the sink
+    size_t written;
+
+    //! Set once a write has failed
+    bool failed;
+
+    //! Memory owned by a buffer sink, NULL for every other sink
+    uint8_t *buffer;
+
+    //! Number of bytes allocated for buffer
+    size_t capacity;
+
+    //! File descriptor of an fd sink, -1 for every other sink
+    int fd;
+} Id3Sink;
+
+Id3Sink *id3SinkCreate(Id3SinkWriteFunction write, void *user);
+
+Id3Sink *id3SinkCreateFromFile(FILE *fp);
+
+Id3Sink *id3SinkCreateFromFd(int fd);
+
+Id3Sink *id3SinkCreateBuffer(size_t capacity);
+
+void id3SinkDestroy(Id3Sink **toDelete);
+
+bool id3SinkWrite(Id3Sink *sink, const uint8_t *data, size_t length);
+
+bool id3SinkWriteString(Id3Sink *sink, const char *string);
+
+bool id3SinkWriteZeros(Id3Sink *sink, size_t length);
+
+bool id3SinkPrintf(Id3Sink *sink, const char *format, ...);
+
+bool id3SinkReserve(Id3Sink *sink, size_t length);
+
+const uint8_t *id3SinkBuffer(const Id3Sink *sink, size_t *length);
+
+uint8_t *id3SinkTakeBuffer(Id3Sink *sink, size_t *length);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -18,6 +18,23 @@ extern "C"{
 
 #include "id3v1/id3v1Types.h"
 #include "id3v2/id3v2Types.h"
+#include "id3Sink.h"
+
+/**
+ * @brief Settings used by the functions working on an ID3 structure.
+ * @details Replaces the library wide preference set with id3SetPreferredStandard. Options are not changed after they
+ * are created, so one set can be shared by any number of ID3 structures and threads. Create with id3CreateOptions.
+ */
+typedef struct _Id3Options {
+    //! Standard read from and written to first, see id3SetPreferredStandard
+    uint8_t preferredStandard;
+
+    //! User identifier and context pairings used when parsing, or NULL. Borrowed, not freed with the options
+    HashTable *userPairs;
+
+    //! Padding and compression used when writing to a file, or NULL for the defaults
+    Id3v2WriteOptions *writeOptions;
+} Id3Options;
 
 /**
  * @brief A structure of both ID3v1 and ID3v2 tags.
@@ -28,14 +45,22 @@ typedef struct _ID3 {
     Id3v2Tag *id3v2;
     //! An ID3v1 or ID3v1.1 Tag
     Id3v1Tag *id3v1;
+    //! Options used instead of the library wide preference, or NULL. Borrowed, not freed with the structure
+    const Id3Options *options;
 } ID3;
 
 // mem
 
 ID3 *id3Create(Id3v2Tag *id3v2, Id3v1Tag *id3v1);
 
+ID3 *id3CreateWithOptions(Id3v2Tag *id3v2, Id3v1Tag *id3v1, const Id3Options *options);
+
 void id3Destroy(ID3 **toDelete);
 
+Id3Options *id3CreateOptions(uint8_t preferredStandard, HashTable *userPairs, const Id3v2WriteOptions *writeOptions);
+
+void id3DestroyOptions(Id3Options **toDelete);
+
 // util functions
 
 bool id3SetPreferredStandard(uint8_t standard);
@@ -44,6 +69,18 @@ uint8_t id3GetPreferredStandard(void);
 
 ID3 *id3FromFile(const char *filePath);
 
+ID3 *id3FromFileWithOptions(const char *filePath, const Id3Options *options);
+
+bool id3AudioRange(const char *filePath, uint64_t *start, uint64_t *end);
+
+bool id3AudioRangeFromBuffer(const uint8_t *buffer, size_t size, uint64_t *start, uint64_t *end);
+
+bool id3AudioHash(const char *filePath, uint64_t *hash);
+
+bool id3AudioHashFromBuffer(const uint8_t *buffer, size_t size, uint64_t *hash);
+
+bool id3SetOptions(ID3 *metadata, const Id3Options *options);
+
 ID3 *id3Copy(const ID3 *toCopy);
 
 bool id3Compare(const ID3 *metadata1, const ID3 *metadata2);
@@ -111,6 +148,20 @@ int id3WritePictureFromFile(const char *filename, const char *kind, uint8_t type
 
 char *id3ToJSON(const ID3 *metadata);
 
+int id3ToJSONSink(const ID3 *metadata, Id3Sink *sink);
+
+char *id3ToJSONWithOptions(const ID3 *metadata, const Id3v2JSONOptions *options);
+
+int id3ToJSONSinkWithOptions(const ID3 *metadata, const Id3v2JSONOptions *options, Id3Sink *sink);
+
+ID3 *id3FromJSON(const char *json);
+
+uint8_t *id3ToCBOR(const ID3 *metadata, size_t *outl);
+
+int id3ToCBORSink(const ID3 *metadata, Id3Sink *sink);
+
+ID3 *id3FromCBOR(const uint8_t *cbor, size_t length);
+
 int id3WriteToFile(const char *filePath, const ID3 *metadata);
 
 #ifdef __cplusplus
@@ -16,6 +16,9 @@ extern "C"{
 #endif
 
 #include "id3v1Types.h"
+#include "id3Sink.h"
+#include "id3Json.h"
+#include "id3Cbor.h"
 
 Id3v1Tag *id3v1TagFromFile(const char *filePath);
 
@@ -44,6 +47,10 @@ bool id3v1CompareTag(const Id3v1Tag *tag1, const Id3v1Tag *tag2);
 
 char *id3v1GenreFromTable(Genre val);
 
+const char *id3v1GenreName(Genre val);
+
+Genre id3v1GenreFromString(const char *genre);
+
 //compatability functions a.k.a getters
 
 char *id3v1ReadTitle(const Id3v1Tag *tag);
@@ -64,6 +71,24 @@ int id3v1ReadTrack(const Id3v1Tag *tag);
 
 char *id3v1ToJSON(const Id3v1Tag *tag);
 
+int id3v1ToJSONSink(const Id3v1Tag *tag, Id3Sink *sink);
+
+Id3v1Tag *id3v1TagFromJSONReader(Id3JsonReader *reader);
+
+Id3v1Tag *id3v1TagFromJSON(const char *json);
+
+uint8_t *id3v1ToCBOR(const Id3v1Tag *tag, size_t *outl);
+
+int id3v1ToCBORSink(const Id3v1Tag *tag, Id3Sink *sink);
+
+Id3v1Tag *id3v1TagFromCBORReader(Id3CborReader *reader);
+
+Id3v1Tag *id3v1TagFromCBOR(const uint8_t *cbor, size_t length);
+
+uint8_t *id3v1TagSerialize(const Id3v1Tag *tag, size_t *outl);
+
+int id3v1TagSerializeToSink(const Id3v1Tag *tag, Id3Sink *sink);
+
 int id3v1WriteTagToFile(const char *filePath, const Id3v1Tag *tag);
 
 #ifdef __cplusplus
@@ -33,6 +33,9 @@ extern "C" {
 //! Major version number for ID3v1 and ID3v1.1 specification (always 1)
 #define ID3V1_TAG_VERSION 1
 
+//! Number of genres in the genre table, PSYBIENT_GENRE + 1
+#define ID3V1_GENRE_COUNT 193
+
 /**
  * @brief ID3v1 genre enumeration with Winamp extensions (genres 0-191).
  * @details Complete list of standard ID3v1 genres (0-79) and Winamp extension genres (80-191). 
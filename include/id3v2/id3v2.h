@@ -18,10 +18,19 @@ extern "C"{
 
 #include "id3v2Types.h"
 #include "id3v2TagIdentity.h" // included due to dependency on freeing memory
+#include "id3Sink.h"
+#include "id3File.h"
+#include "id3Mpeg.h"
 
 
 Id3v2Tag *id3v2TagFromFile(const char *filename);
 
+Id3v2Tag *id3v2TagFromFileLazy(const char *filename);
+
+Id3v2Tag *id3v2TagFromMapping(const Id3FileMapping *mapping);
+
+bool id3v2VerifyTagCrcFromFile(const char *filename);
+
 Id3v2Tag *id3v2CopyTag(const Id3v2Tag *toCopy);
 
 // util functions
@@ -65,6 +74,13 @@ char *id3v2ReadComment(Id3v2Tag *tag);
 
 uint8_t *id3v2ReadPicture(uint8_t type, const Id3v2Tag *tag, size_t *dataSize);
 
+const uint8_t *id3v2ReadPictureView(uint8_t type, const Id3v2Tag *tag, const Id3FileMapping *mapping,
+                                    size_t *dataSize);
+
+bool id3v2ExtractPictureToFd(const char *filePath, uint8_t type, int fd);
+
+bool id3v2ReadAudioHash(const Id3v2Tag *tag, uint64_t *hash);
+
 // change values within an id3v2 structure
 
 int id3v2WriteTextFrameContent(const char id[ID3V2_FRAME_ID_MAX_SIZE], const char *string, Id3v2Tag *tag);
@@ -95,14 +111,55 @@ int id3v2WritePicture(uint8_t *image, size_t imageSize, const char *kind, uint8_
 
 int id3v2WritePictureFromFile(const char *filename, const char *kind, uint8_t type, Id3v2Tag *tag);
 
+int id3v2WriteAudioHash(uint64_t hash, Id3v2Tag *tag);
+
+int id3v2WriteSeekIndex(const Id3MpegIndex *index, Id3v2Tag *tag);
+
+// write options
+
+Id3v2WriteOptions *id3v2CreateWriteOptions(Id3v2PaddingPolicy paddingPolicy, size_t paddingAmount);
+
+void id3v2DestroyWriteOptions(Id3v2WriteOptions **toDelete);
+
+Id3v2JSONOptions *id3v2CreateJSONOptions(Id3v2JSONBinaryPolicy binaryPolicy, size_t binaryLimit);
+
+void id3v2DestroyJSONOptions(Id3v2JSONOptions **toDelete);
+
 // writes
 
 uint8_t *id3v2TagSerialize(Id3v2Tag *tag, size_t *outl);
 
+uint8_t *id3v2TagSerializeWithOptions(Id3v2Tag *tag, const Id3v2WriteOptions *options, size_t *outl);
+
+int id3v2TagSerializeToSink(Id3v2Tag *tag, const Id3v2WriteOptions *options, Id3Sink *sink);
+
 char *id3v2TagToJSON(Id3v2Tag *tag);
 
+int id3v2TagToJSONSink(Id3v2Tag *tag, Id3Sink *sink);
+
+char *id3v2TagToJSONWithOptions(Id3v2Tag *tag, const Id3v2JSONOptions *options);
+
+int id3v2TagToJSONSinkWithOptions(Id3v2Tag *tag, const Id3v2JSONOptions *options, Id3Sink *sink);
+
+Id3v2Tag *id3v2TagFromJSONReader(Id3JsonReader *reader, HashTable *userPairs);
+
+Id3v2Tag *id3v2TagFromJSON(const char *json);
+
+uint8_t *id3v2TagToCBOR(Id3v2Tag *tag, size_t *outl);
+
+int id3v2TagToCBORSink(Id3v2Tag *tag, Id3Sink *sink);
+
+Id3v2Tag *id3v2TagFromCBORReader(Id3CborReader *reader, HashTable *userPairs);
+
+Id3v2Tag *id3v2TagFromCBOR(const uint8_t *cbor, size_t length);
+
 int id3v2WriteTagToFile(const char *filename, Id3v2Tag *tag);
 
+int id3v2WriteTagToFileWithOptions(const char *filename, Id3v2Tag *tag, const Id3v2WriteOptions *options);
+
+int id3v2WriteTagToFileWithTrailer(const char *filename, Id3v2Tag *tag, const Id3v2WriteOptions *options,
+                                   const uint8_t trailer[ID3V1_MAX_SIZE]);
+
 #ifdef __cplusplus
 } //extern c end
 #endif
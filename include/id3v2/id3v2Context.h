@@ -120,6 +120,8 @@ HashTable *id3v2CreateDefaultIdentifierContextPairings(unsigned int version);
 bool id3v2InsertIdentifierContextPair(HashTable *identifierContextPairs, char key[ID3V2_FRAME_ID_MAX_SIZE],
                                       List *context);
 
+List *id3v2FindIdentifierContext(HashTable *identifierContextPairs, HashTable *userPairs, const char *id);
+
 
 // convi
 
@@ -18,6 +18,10 @@ extern "C"{
 #endif
 
 #include "id3v2Types.h"
+#include "id3Sink.h"
+#include "id3Json.h"
+#include "id3Cbor.h"
+#include "id3File.h"
 
 /*
     Frame header
@@ -31,6 +35,16 @@ void id3v2DestroyFrameHeader(Id3v2FrameHeader **toDelete);
 
 Id3v2ContentEntry *id3v2CreateContentEntry(void *entry, size_t size);
 
+Id3v2Source *id3v2CreateSource(const char *path);
+
+void id3v2ReleaseSource(Id3v2Source **toRelease);
+
+Id3v2ContentEntry *id3v2CreateFileContentEntry(Id3v2Source *source, uint64_t offset, size_t size);
+
+int id3v2OpenContentSource(const Id3v2ContentEntry *entry);
+
+bool id3v2LoadContentEntry(Id3v2ContentEntry *entry);
+
 // List/Hash API required functions
 
 void id3v2DeleteContentEntry(void *toBeDeleted);
@@ -88,6 +102,28 @@ bool id3v2AttachFrameToTag(Id3v2Tag *tag, Id3v2Frame *frame);
 
 Id3v2Frame *id3v2DetachFrameFromTag(Id3v2Tag *tag, Id3v2Frame *frame);
 
+/*
+    Frame cache
+*/
+
+bool id3v2CacheFrameBytes(Id3v2Frame *frame, uint8_t version, const uint8_t *bytes, size_t size);
+
+void id3v2MarkFrameDirty(Id3v2Frame *frame);
+
+bool id3v2FrameIsDirty(const Id3v2Frame *frame, uint8_t version);
+
+const uint8_t *id3v2FrameCachedBytes(const Id3v2Frame *frame, size_t *size, const uint8_t **shared, size_t *sharedSize);
+
+const uint8_t *id3v2FrameEntryView(const Id3v2Frame *frame, const Id3FileMapping *mapping, size_t *dataSize);
+
+/*
+    Frame compression
+*/
+
+bool id3v2CompressionSupported(void);
+
+bool id3v2DecompressFrame(Id3v2Frame *frame);
+
 
 /*
     output
@@ -99,8 +135,36 @@ char *id3v2FrameHeaderToJSON(const Id3v2FrameHeader *header, uint8_t version);
 
 uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl);
 
+uint8_t *id3v2FrameSerializeWithOptions(Id3v2Frame *frame, uint8_t version, bool unsync, size_t compressionThreshold,
+                                        size_t *outl);
+
+int id3v2FrameSerializeToSink(Id3v2Frame *frame, uint8_t version, Id3Sink *sink);
+
 char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version);
 
+int id3v2FrameToJSONSink(Id3v2Frame *frame, uint8_t version, Id3Sink *sink);
+
+int id3v2FrameToJSONSinkWithOptions(Id3v2Frame *frame, uint8_t version, const Id3v2JSONOptions *options,
+                                    Id3Sink *sink);
+
+uint8_t *id3v2FrameToCBOR(Id3v2Frame *frame, uint8_t version, size_t *outl);
+
+int id3v2FrameToCBORSink(Id3v2Frame *frame, uint8_t version, Id3Sink *sink);
+
+/*
+    input
+*/
+
+Id3v2Frame *id3v2FrameFromJSON(const char *json, uint8_t version);
+
+Id3v2Frame *id3v2FrameFromJSONReader(Id3JsonReader *reader, uint8_t version, HashTable *identifierContextPairs,
+                                     HashTable *userPairs);
+
+Id3v2Frame *id3v2FrameFromCBOR(const uint8_t *cbor, size_t length, uint8_t version);
+
+Id3v2Frame *id3v2FrameFromCBORReader(Id3CborReader *reader, uint8_t version, HashTable *identifierContextPairs,
+                                     HashTable *userPairs);
+
 
 #ifdef __cplusplus
 } //extern c end
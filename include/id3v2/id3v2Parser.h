@@ -32,6 +32,16 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
 
 Id3v2Tag *id3v2ParseTagFromBuffer(uint8_t *in, size_t inl, HashTable *userPairs);
 
+Id3v2Tag *id3v2ParseTagFromFileBuffer(uint8_t *in, size_t inl, HashTable *userPairs, Id3v2Source *source);
+
+Id3v2Parser *id3v2CreateParser(HashTable *userPairs);
+
+void id3v2DestroyParser(Id3v2Parser **toDelete);
+
+Id3v2Tag *id3v2ParserParse(Id3v2Parser *parser, uint8_t *in, size_t inl);
+
+bool id3v2VerifyTagCrc(uint8_t *in, size_t inl);
+
 #ifdef __cplusplus
 } //extern c end
 #endif
@@ -18,6 +18,8 @@ extern "C"{
 
 
 #include "id3v2Types.h"
+#include "id3Json.h"
+#include "id3Cbor.h"
 
 
 /*
@@ -111,6 +113,18 @@ uint8_t *id3v2TagHeaderSerialize(Id3v2TagHeader *header, uint32_t uintSize, size
 
 char *id3v2TagHeaderToJSON(const Id3v2TagHeader *header);
 
+Id3v2ExtendedTagHeader *id3v2ExtendedTagHeaderFromJSONReader(Id3JsonReader *reader);
+
+Id3v2TagHeader *id3v2TagHeaderFromJSONReader(Id3JsonReader *reader);
+
+int id3v2ExtendedTagHeaderToCBORSink(const Id3v2ExtendedTagHeader *ext, uint8_t version, Id3Sink *sink);
+
+int id3v2TagHeaderToCBORSink(const Id3v2TagHeader *header, Id3Sink *sink);
+
+Id3v2ExtendedTagHeader *id3v2ExtendedTagHeaderFromCBORReader(Id3CborReader *reader);
+
+Id3v2TagHeader *id3v2TagHeaderFromCBORReader(Id3CborReader *reader);
+
 
 #ifdef __cplusplus
 } //extern c end
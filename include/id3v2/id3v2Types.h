@@ -26,10 +26,14 @@ extern "C" {
 #include "id3dependencies/LinkedListLib/include/LinkedList.h"
 #include "id3dependencies/HashTableLib/include/hashTable.h"
 #include "id3dependencies/ByteStream/include/byteDefines.h"
+#include "id3File.h"
 
 //! Size in bytes of the ID3v2 tag identifier "ID3" or "3DI" (3 bytes)
 #define ID3V2_TAG_ID_SIZE 3
 
+//! Size in bytes of an ID3v2 tag header or footer (10 bytes)
+#define ID3V2_TAG_HEADER_SIZE 10
+
 //! Hexadecimal magic number for ID3v2 header tag identifier "ID3" (0x494433)
 #define ID3V2_TAG_ID_MAGIC_NUMBER_H 0x494433
 
@@ -75,6 +79,13 @@ extern "C" {
  */
 #define ID3V2_FRAME_FLAG_SIZE 2
 
+/**
+ * @brief Largest number of bytes a frame header can occupy (16 bytes).
+ * @details An ID3v2.3 or ID3v2.4 frame header is 10 bytes followed by at most a 4 byte size and two single byte
+ * symbols added by its flags.
+ */
+#define ID3V2_FRAME_HEADER_MAX_SIZE 16
+
 /**
  * @brief Optional ID3v2 extended header containing supplementary tag metadata.
  * @details Provides additional information about tag structure including CRC validation, 
@@ -254,11 +265,27 @@ typedef struct _Id3v2ContentContext {
     size_t max;
 } Id3v2ContentContext;
 
+/**
+ * @brief File that content entries left in place by id3v2TagFromFileLazy are read from.
+ * @details Shared by every entry referring to the file and freed once the last of them is deleted.
+ */
+typedef struct _Id3v2Source {
+    //! Path of the file
+    char *path;
+
+    //! Identity of the file when the source was created, it is no longer read once this changes
+    Id3FileIdentity identity;
+
+    //! Number of content entries referring to the file
+    size_t references;
+} Id3v2Source;
+
 /**
  * @brief Parsed data field from an ID3v2 frame.
  * @details Generic container for a single extracted field value. Interpretation requires corresponding 
  * Id3v2ContentContext from the frame's context list. Separation of data from context metadata enables 
- * custom frame definitions.
+ * custom frame definitions. An entry may also refer to size bytes of a file instead of holding them, in which case
+ * entry is NULL and the bytes are read from source whenever they are needed.
  */
 typedef struct _Id3v2ContentEntry {
     //! Pointer to extracted field data (string, binary, numeric, etc.). Type determined by corresponding context.
@@ -266,6 +293,12 @@ typedef struct _Id3v2ContentEntry {
 
     //! Size in bytes of the data pointed to by entry
     size_t size;
+
+    //! File the data is read from when it is not held in entry, NULL when it is held
+    Id3v2Source *source;
+
+    //! Offset of the data from the start of the source file
+    uint64_t offset;
 } Id3v2ContentEntry;
 
 /**
@@ -283,6 +316,31 @@ typedef struct _Id3v2Frame {
 
     //! Linked list of Id3v2ContentEntry parsed data fields corresponding to contexts
     List *entries;
+
+    //! Serialized frame as read from a tag or last serialized. NULL when the frame must be encoded from its entries
+    uint8_t *raw;
+
+    //! Number of bytes in raw
+    size_t rawSize;
+
+    //! Number of bytes at the end of the serialized frame left out of raw because they are the data of its last entry
+    size_t rawShared;
+
+    //! Tag version raw was encoded for
+    uint8_t rawVersion;
+
+    //! Copy of the header raw was encoded with, used to notice changes made directly to the header
+    Id3v2FrameHeader rawHeader;
+
+    //! Offset of raw from the start of the tag it was read from. 0 when raw was not read verbatim from a tag
+    size_t rawOffset;
+
+    //! Context used to parse the content once it is decompressed. NULL unless entries still hold compressed content
+    List *compressedContext;
+
+    //! true if the frame was created holding compressed content. Never changes, readers check it before taking the lock
+    //! the content is inflated under
+    bool compressed;
 } Id3v2Frame;
 
 /**
@@ -299,6 +357,126 @@ typedef struct _Id3v2Tag {
     List *frames;
 } Id3v2Tag;
 
+/**
+ * @brief Default block size in bytes used by block_padding when no size is given (4096 bytes).
+ * @details Matches the common filesystem block size so the audio data following the tag starts on a block boundary.
+ */
+#define ID3V2_PADDING_BLOCK_SIZE 4096
+
+/**
+ * @brief Size in bytes from which the data of a frame's last entry is not copied into its cached bytes (1024 bytes).
+ * @details Pictures and objects are already held by their entry, keeping them in the cache as well would double the
+ * memory a tag needs.
+ */
+#define ID3V2_FRAME_CACHE_SHARE_SIZE 1024
+
+/**
+ * @brief Largest tag size, excluding header and footer, that a synchsafe size field can describe (256 MB - 1).
+ */
+#define ID3V2_MAX_TAG_SIZE 0x0FFFFFFF
+
+/**
+ * @brief Largest ratio between the inflated and compressed size of frame content zlib can produce (1032).
+ * @details A frame claiming to inflate to more than this is rejected before anything is allocated for it.
+ */
+#define ID3V2_FRAME_MAX_INFLATE_RATIO 1032
+
+/**
+ * @brief Owner identifier of the unique file identifier frame (UFID, UFI in ID3v2.2) holding an audio hash.
+ * @details The identifier data of the frame is the 8 byte big-endian hash from id3AudioHash.
+ */
+#define ID3V2_AUDIO_HASH_OWNER "id3dev:xxh64"
+
+/**
+ * @brief Padding reservation policies used when serializing or writing an ID3v2 tag.
+ * @details Padding is zeroed space after the last frame. Reserving it allows later edits to grow the tag
+ * in place without moving the audio data that follows. Tags with a footer never carry padding.
+ */
+typedef enum _Id3v2PaddingPolicy {
+    //! Use the padding amount stored in the extended header, or none when there is no extended header.
+    extended_padding,
+
+    //! Reserve a fixed number of bytes.
+    fixed_padding,
+
+    //! Reserve a percentage of the serialized tag size (header, extended header and frames).
+    percentage_padding,
+
+    //! Pad the complete tag up to the next multiple of a block size (ID3V2_PADDING_BLOCK_SIZE when none is given).
+    block_padding,
+
+    //! Keep the padding already present in the file being written to.
+    preserve_padding
+} Id3v2PaddingPolicy;
+
+/**
+ * @brief Options controlling how an ID3v2 tag is serialized and written to a file.
+ * @details A NULL options pointer is accepted wherever these options are taken and behaves like
+ * extended_padding. With any other policy a file write reuses the space of the existing tag whenever
+ * the new tag fits inside it, filling the remainder with padding, so the audio data is never moved.
+ */
+typedef struct _Id3v2WriteOptions {
+    //! Policy used to decide how much padding to reserve
+    Id3v2PaddingPolicy paddingPolicy;
+
+    //! Bytes for fixed_padding, percent for percentage_padding, block size for block_padding. Unused otherwise.
+    size_t paddingAmount;
+
+    //! Modified ID3v2.3/2.4 frames with more content bytes than this are compressed with zlib. 0 disables compression.
+    size_t compressionThreshold;
+} Id3v2WriteOptions;
+
+/**
+ * @brief Ways binary frame content is represented when a tag is converted to JSON.
+ * @details Applies to content that has no text form, such as picture data, object data, private data, and
+ * volume adjustments. Skipping or summarising it keeps catalog exports small when tags carry artwork.
+ */
+typedef enum _Id3v2JSONBinaryPolicy {
+    //! Embed the complete content base64 encoded.
+    embed_binary,
+
+    //! Embed at most binaryLimit bytes base64 encoded and mark content that was cut short with "truncated":true.
+    truncate_binary,
+
+    //! Replace the content with its size and the hex encoded SHA-1 digest of its bytes.
+    digest_binary,
+
+    //! Replace the content with its size and its offset from the start of the tag it was read from, null when unknown.
+    reference_binary
+} Id3v2JSONBinaryPolicy;
+
+/**
+ * @brief Options controlling how an ID3v2 tag is converted to JSON.
+ * @details A NULL options pointer is accepted wherever these options are taken and behaves like embed_binary.
+ */
+typedef struct _Id3v2JSONOptions {
+    //! Policy used for binary content
+    Id3v2JSONBinaryPolicy binaryPolicy;
+
+    //! Largest number of bytes embedded by truncate_binary. Unused otherwise.
+    size_t binaryLimit;
+} Id3v2JSONOptions;
+
+/**
+ * @brief Reusable state for parsing many ID3v2 tags one after another.
+ * @details Keeps the default identifier and context pairings of every version once they are first needed, and a
+ * grow-only buffer tags are resynchronised in, so repeated parses do not rebuild either. A parser is not safe to
+ * share between threads, create one per thread instead.
+ */
+typedef struct _Id3v2Parser {
+    //! User identifier and context pairings checked after the defaults, or NULL. Borrowed, not freed with the parser
+    HashTable *userPairs;
+
+    //! Default identifier and context pairings for ID3v2.2, ID3v2.3, and ID3v2.4, NULL until first needed
+    HashTable *pairs[3];
+
+    //! Buffer unsynchronised tags, or unsynchronised frames of ID3v2.4 tags, are copied to and resynchronised in
+    uint8_t *scratch;
+
+    //! Number of bytes allocated for scratch
+    size_t scratchSize;
+} Id3v2Parser;
+
 #ifdef __cplusplus
 } // extern c end
 #endif
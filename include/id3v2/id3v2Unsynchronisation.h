@@ -0,0 +1,38 @@
+/**
+ * @file id3v2Unsynchronisation.h
+ * @author Ewan Jones
+ * @brief Function definitions for applying and removing the ID3v2 unsynchronisation scheme
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#ifndef ID3V2_UNSYNCHRONISATION
+#define ID3V2_UNSYNCHRONISATION
+
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+//! Byte that starts a false synchronisation
+#define ID3V2_UNSYNC_MARKER 0xFF
+
+//! Smallest byte after ID3V2_UNSYNC_MARKER that forms a false synchronisation
+#define ID3V2_UNSYNC_SYNC_MIN 0xE0
+
+size_t id3v2UnsynchronisedSize(const uint8_t *in, size_t inl, const uint8_t *next);
+
+uint8_t *id3v2Unsynchronise(const uint8_t *in, size_t inl, const uint8_t *next, size_t *outl);
+
+size_t id3v2Resynchronise(uint8_t *buffer, size_t length);
+
+#ifdef __cplusplus
+} //extern c end
+#endif
+
+#endif
@@ -0,0 +1,266 @@
+/**
+ * @file id3Base64.c
+ * @author Ewan Jones
+ * @brief Function implementations for the base64 encoding used to represent binary frame content as text
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include "id3Base64.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define ID3_BASE64_SSSE3
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define ID3_BASE64_NEON
+#include <arm_neon.h>
+#endif
+
+//! Character used to pad the last group of output
+#define ID3_BASE64_PAD '='
+
+static const char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+//! Value of every base64 character, -1 for bytes outside the alphabet
+static const int8_t base64Values[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+};
+
+// internal function ------------------------------------------------------------------------
+static size_t internal_id3Base64EncodeScalar(const uint8_t *data, size_t length, char *out) {
+    size_t o = 0;
+
+    while (length >= 3) {
+        const uint32_t group = ((uint32_t) data[0] << 16) | ((uint32_t) data[1] << 8) | (uint32_t) data[2];
+
+        out[o] = base64Chars[group >> 18];
+        out[o + 1] = base64Chars[(group >> 12) & 0x3F];
+        out[o + 2] = base64Chars[(group >> 6) & 0x3F];
+        out[o + 3] = base64Chars[group & 0x3F];
+
+        data += 3;
+        length -= 3;
+        o += 4;
+    }
+
+    if (length > 0) {
+        const uint32_t group = ((uint32_t) data[0] << 16) | ((length > 1) ? (uint32_t) data[1] << 8 : 0);
+
+        out[o] = base64Chars[group >> 18];
+        out[o + 1] = base64Chars[(group >> 12) & 0x3F];
+        out[o + 2] = (length > 1) ? base64Chars[(group >> 6) & 0x3F] : ID3_BASE64_PAD;
+        out[o + 3] = ID3_BASE64_PAD;
+        o += 4;
+    }
+
+    return o;
+}
+
+#ifdef ID3_BASE64_SSSE3
+/*
+    Turns 12 bytes into 16 characters per step. A byte shuffle spreads every 3 byte group over
+    4 lanes, two multiplies move the 6 bit values into place and a second shuffle maps each
+    value range (A-Z, a-z, 0-9, + and /) to the offset that turns it into its character.
+    Reads 16 bytes per step so the last 4 bytes of data are always left to the scalar loop.
+*/
+__attribute__((target("ssse3")))
+static size_t internal_id3Base64EncodeSsse3(const uint8_t *data, size_t length, char *out) {
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    size_t o = 0;
+
+    while (length >= 16) {
+        __m128i in = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *) data), spread);
+        __m128i hi = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i lo = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i values = _mm_or_si128(hi, lo);
+
+        // 0 for A-Z, 1 for a-z, 2-11 for digits, 12 for + and 13 for /
+        __m128i range = _mm_subs_epu8(values, _mm_set1_epi8(51));
+        range = _mm_sub_epi8(range, _mm_cmpgt_epi8(values, _mm_set1_epi8(25)));
+
+        _mm_storeu_si128((__m128i *) (out + o), _mm_add_epi8(values, _mm_shuffle_epi8(offsets, range)));
+
+        data += 12;
+        length -= 12;
+        o += 16;
+    }
+
+    return o + internal_id3Base64EncodeScalar(data, length, out + o);
+}
+#endif
+
+#ifdef ID3_BASE64_NEON
+/*
+    Turns 48 bytes into 64 characters per step. A structured load splits the input into the
+    first, second and third byte of every group, the 6 bit values are built with shifts and
+    a single 64 entry table lookup maps them to characters.
+*/
+static size_t internal_id3Base64EncodeNeon(const uint8_t *data, size_t length, char *out) {
+    uint8x16x4_t table;
+    size_t o = 0;
+
+    table.val[0] = vld1q_u8((const uint8_t *) base64Chars);
+    table.val[1] = vld1q_u8((const uint8_t *) base64Chars + 16);
+    table.val[2] = vld1q_u8((const uint8_t *) base64Chars + 32);
+    table.val[3] = vld1q_u8((const uint8_t *) base64Chars + 48);
+
+    while (length >= 48) {
+        uint8x16x3_t in = vld3q_u8(data);
+        uint8x16x4_t values;
+
+        values.val[0] = vshrq_n_u8(in.val[0], 2);
+        values.val[1] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[0], vdupq_n_u8(0x03)), 4), vshrq_n_u8(in.val[1], 4));
+        values.val[2] = vorrq_u8(vshlq_n_u8(vandq_u8(in.val[1], vdupq_n_u8(0x0F)), 2), vshrq_n_u8(in.val[2], 6));
+        values.val[3] = vandq_u8(in.val[2], vdupq_n_u8(0x3F));
+
+        values.val[0] = vqtbl4q_u8(table, values.val[0]);
+        values.val[1] = vqtbl4q_u8(table, values.val[1]);
+        values.val[2] = vqtbl4q_u8(table, values.val[2]);
+        values.val[3] = vqtbl4q_u8(table, values.val[3]);
+
+        vst4q_u8((uint8_t *) (out + o), values);
+
+        data += 48;
+        length -= 48;
+        o += 64;
+    }
+
+    return o + internal_id3Base64EncodeScalar(data, length, out + o);
+}
+#endif
+
+/**
+ * @brief Calculates the number of characters base64 encoding produces.
+ * @param length - Number of bytes to encode.
+ * @return size_t - Number of characters, padding included, without a null terminator.
+ */
+size_t id3Base64EncodedSize(size_t length) {
+    return ((length + 2) / 3) * 4;
+}
+
+/**
+ * @brief Base64 encodes bytes with the standard alphabet and padding.
+ * @details Produces the encoding described in RFC 4648 section 4. x86 processors supporting SSSE3 encode 12 bytes per
+ * step and AArch64 builds encode 48 bytes per step with NEON, everything else is encoded 3 bytes at a time. No null
+ * terminator is written.
+ * @param data - Bytes to encode, may be NULL when length is 0.
+ * @param length - Number of bytes in data.
+ * @param out - Receives the characters, must hold at least id3Base64EncodedSize(length) bytes.
+ * @return size_t - Number of characters written to out, 0 if data or out is NULL.
+ */
+size_t id3Base64Encode(const uint8_t *data, size_t length, char *out) {
+    if (data == NULL || out == NULL || length == 0) {
+        return 0;
+    }
+
+#if defined(ID3_BASE64_SSSE3)
+    if (id3Base64Accelerated()) {
+        return internal_id3Base64EncodeSsse3(data, length, out);
+    }
+#elif defined(ID3_BASE64_NEON)
+    return internal_id3Base64EncodeNeon(data, length, out);
+#endif
+
+    return internal_id3Base64EncodeScalar(data, length, out);
+}
+
+/**
+ * @brief Reports whether id3Base64Encode uses vector instructions on this machine.
+ * @details x86 support is detected at runtime, NEON support is decided when the library is compiled.
+ * @return bool - true if SSSE3 or NEON is used, false if every byte goes through the scalar encoder.
+ */
+bool id3Base64Accelerated(void) {
+#if defined(ID3_BASE64_SSSE3)
+    return __builtin_cpu_supports("ssse3");
+#elif defined(ID3_BASE64_NEON)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Calculates the largest number of bytes base64 text can decode to.
+ * @param length - Number of characters of base64 text.
+ * @return size_t - Upper bound on the decoded size, exact when the text has no padding.
+ */
+size_t id3Base64DecodedSize(size_t length) {
+    return (length / 4) * 3;
+}
+
+/**
+ * @brief Decodes base64 text written with the standard alphabet and padding.
+ * @details Accepts the output of id3Base64Encode: groups of 4 characters where only the last group may end in one
+ * or two padding characters. Every group is read before its bytes are written, so out may point at text to decode
+ * in place.
+ * @param text - Characters to decode, may be NULL when length is 0.
+ * @param length - Number of characters in text, a multiple of 4.
+ * @param out - Receives the bytes, must hold at least id3Base64DecodedSize(length) bytes.
+ * @param outl - Receives the number of bytes written to out, 0 on failure.
+ * @return bool - true if the text was decoded, false if it is not valid base64.
+ */
+bool id3Base64Decode(const char *text, size_t length, uint8_t *out, size_t *outl) {
+    size_t o = 0;
+
+    if (outl == NULL) {
+        return false;
+    }
+
+    *outl = 0;
+
+    if (length == 0) {
+        return true;
+    }
+
+    if (text == NULL || out == NULL || length % 4 != 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < length; i += 4) {
+        const bool last = (i + 4 == length);
+        const size_t pad = (last && text[i + 3] == ID3_BASE64_PAD) ? ((text[i + 2] == ID3_BASE64_PAD) ? 2 : 1) : 0;
+        const int8_t a = base64Values[(uint8_t) text[i]];
+        const int8_t b = base64Values[(uint8_t) text[i + 1]];
+        const int8_t c = (pad == 2) ? 0 : base64Values[(uint8_t) text[i + 2]];
+        const int8_t d = (pad > 0) ? 0 : base64Values[(uint8_t) text[i + 3]];
+        uint32_t group = 0;
+
+        if ((a | b | c | d) < 0) {
+            return false;
+        }
+
+        group = ((uint32_t) a << 18) | ((uint32_t) b << 12) | ((uint32_t) c << 6) | (uint32_t) d;
+
+        out[o++] = (uint8_t) (group >> 16);
+
+        if (pad < 2) {
+            out[o++] = (uint8_t) (group >> 8);
+        }
+
+        if (pad < 1) {
+            out[o++] = (uint8_t) group;
+        }
+    }
+
+    *outl = o;
+    return true;
+}
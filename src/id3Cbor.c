@@ -0,0 +1,724 @@
+/**
+ * @file id3Cbor.c
+ * @author Ewan Jones
+ * @brief Function implementations for the CBOR writer and reader used for the compact binary export of tags
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "id3Cbor.h"
+
+//! Major type of unsigned integers
+#define ID3_CBOR_UNSIGNED 0
+
+//! Major type of byte strings
+#define ID3_CBOR_BYTES 2
+
+//! Major type of UTF-8 text strings
+#define ID3_CBOR_TEXT 3
+
+//! Major type of arrays
+#define ID3_CBOR_ARRAY 4
+
+//! Major type of maps
+#define ID3_CBOR_MAP 5
+
+//! Major type of tags
+#define ID3_CBOR_TAG 6
+
+//! Major type of simple values and floats
+#define ID3_CBOR_SIMPLE 7
+
+//! Additional information marking an indefinite length
+#define ID3_CBOR_INDEFINITE 31
+
+//! Byte ending an indefinite length map or array
+#define ID3_CBOR_BREAK 0xFF
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3CborWriteHead(Id3Sink *sink, uint8_t major, uint64_t value) {
+    uint8_t head[9] = {0};
+    size_t n = 0;
+
+    if (value < 24) {
+        head[0] = (uint8_t) ((major << 5) | value);
+        return id3SinkWrite(sink, head, 1);
+    }
+
+    if (value <= UINT8_MAX) {
+        head[0] = (uint8_t) ((major << 5) | 24);
+        n = 1;
+    } else if (value <= UINT16_MAX) {
+        head[0] = (uint8_t) ((major << 5) | 25);
+        n = 2;
+    } else if (value <= UINT32_MAX) {
+        head[0] = (uint8_t) ((major << 5) | 26);
+        n = 4;
+    } else {
+        head[0] = (uint8_t) ((major << 5) | 27);
+        n = 8;
+    }
+
+    // arguments are big endian
+    for (size_t i = 0; i < n; i++) {
+        head[n - i] = (uint8_t) (value >> (i * 8));
+    }
+
+    return id3SinkWrite(sink, head, n + 1);
+}
+
+/**
+ * @brief Writes an unsigned integer.
+ * @details Uses the shortest encoding that holds the value.
+ * @param sink - Sink receiving the item.
+ * @param value - Value to write.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteUnsigned(Id3Sink *sink, uint64_t value) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    return internal_id3CborWriteHead(sink, ID3_CBOR_UNSIGNED, value);
+}
+
+/**
+ * @brief Writes true or false.
+ * @param sink - Sink receiving the item.
+ * @param value - Value to write.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteBool(Id3Sink *sink, bool value) {
+    const uint8_t item = value ? 0xF5 : 0xF4;
+
+    if (sink == NULL) {
+        return false;
+    }
+
+    return id3SinkWrite(sink, &item, 1);
+}
+
+/**
+ * @brief Writes a single precision float.
+ * @details The value is written with all 32 bits so it is read back exactly.
+ * @param sink - Sink receiving the item.
+ * @param value - Value to write.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteFloat(Id3Sink *sink, float value) {
+    uint8_t item[5] = {0xFA, 0, 0, 0, 0};
+    uint32_t bits = 0;
+
+    if (sink == NULL) {
+        return false;
+    }
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    for (int i = 0; i < 4; i++) {
+        item[4 - i] = (uint8_t) (bits >> (i * 8));
+    }
+
+    return id3SinkWrite(sink, item, sizeof(item));
+}
+
+/**
+ * @brief Writes a UTF-8 text string.
+ * @details The text is written as it is, it is not checked to be valid UTF-8.
+ * @param sink - Sink receiving the item.
+ * @param text - Text to write, may be NULL when length is 0.
+ * @param length - Number of bytes in text.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteText(Id3Sink *sink, const char *text, size_t length) {
+    if (sink == NULL || (text == NULL && length > 0)) {
+        return false;
+    }
+
+    if (!internal_id3CborWriteHead(sink, ID3_CBOR_TEXT, length)) {
+        return false;
+    }
+
+    return (length == 0) ? true : id3SinkWrite(sink, (const uint8_t *) text, length);
+}
+
+/**
+ * @brief Writes a null-terminated string as a UTF-8 text string.
+ * @param sink - Sink receiving the item.
+ * @param string - Null-terminated text to write.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteString(Id3Sink *sink, const char *string) {
+    if (string == NULL) {
+        return false;
+    }
+
+    return id3CborWriteText(sink, string, strlen(string));
+}
+
+/**
+ * @brief Writes a byte string.
+ * @details The bytes are copied into the sink as they are, there is no text encoding step like base64.
+ * @param sink - Sink receiving the item.
+ * @param data - Bytes to write, may be NULL when length is 0.
+ * @param length - Number of bytes in data.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteBytes(Id3Sink *sink, const uint8_t *data, size_t length) {
+    if (sink == NULL || (data == NULL && length > 0)) {
+        return false;
+    }
+
+    if (!internal_id3CborWriteHead(sink, ID3_CBOR_BYTES, length)) {
+        return false;
+    }
+
+    return (length == 0) ? true : id3SinkWrite(sink, data, length);
+}
+
+/**
+ * @brief Starts a map holding a known number of members.
+ * @details Must be followed by count key and value pairs, each key a text string.
+ * @param sink - Sink receiving the item.
+ * @param count - Number of members in the map.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteMap(Id3Sink *sink, size_t count) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    return internal_id3CborWriteHead(sink, ID3_CBOR_MAP, count);
+}
+
+/**
+ * @brief Starts an array holding a known number of elements.
+ * @param sink - Sink receiving the item.
+ * @param count - Number of elements in the array.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteArray(Id3Sink *sink, size_t count) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    return internal_id3CborWriteHead(sink, ID3_CBOR_ARRAY, count);
+}
+
+/**
+ * @brief Starts an array whose number of elements is not known yet.
+ * @details The elements are written after it and the array is ended with id3CborWriteBreak, so content can be
+ * streamed without counting it first.
+ * @param sink - Sink receiving the item.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteArrayStart(Id3Sink *sink) {
+    const uint8_t item = (ID3_CBOR_ARRAY << 5) | ID3_CBOR_INDEFINITE;
+
+    if (sink == NULL) {
+        return false;
+    }
+
+    return id3SinkWrite(sink, &item, 1);
+}
+
+/**
+ * @brief Ends an array started with id3CborWriteArrayStart.
+ * @param sink - Sink receiving the item.
+ * @return bool - true if the item was written, false otherwise.
+ */
+bool id3CborWriteBreak(Id3Sink *sink) {
+    const uint8_t item = ID3_CBOR_BREAK;
+
+    if (sink == NULL) {
+        return false;
+    }
+
+    return id3SinkWrite(sink, &item, 1);
+}
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3CborFail(Id3CborReader *reader) {
+    reader->failed = true;
+    return false;
+}
+
+// reads the initial byte and argument of the next item
+static bool internal_id3CborReadHead(Id3CborReader *reader, uint8_t *major, uint64_t *value, bool *indefinite) {
+    uint8_t info = 0;
+    size_t n = 0;
+
+    if (reader->failed || reader->cursor >= reader->length) {
+        return internal_id3CborFail(reader);
+    }
+
+    *major = reader->data[reader->cursor] >> 5;
+    info = reader->data[reader->cursor] & 0x1F;
+    *value = 0;
+    *indefinite = false;
+    reader->cursor++;
+
+    if (info < 24) {
+        *value = info;
+        return true;
+    }
+
+    switch (info) {
+        case 24:
+            n = 1;
+            break;
+        case 25:
+            n = 2;
+            break;
+        case 26:
+            n = 4;
+            break;
+        case 27:
+            n = 8;
+            break;
+        case ID3_CBOR_INDEFINITE:
+            // only containers, strings, and the break have an indefinite form
+            if (*major == ID3_CBOR_UNSIGNED || *major == 1 || *major == ID3_CBOR_TAG) {
+                return internal_id3CborFail(reader);
+            }
+
+            *indefinite = true;
+            return true;
+        default:
+            return internal_id3CborFail(reader);
+    }
+
+    if (reader->length - reader->cursor < n) {
+        return internal_id3CborFail(reader);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        *value = (*value << 8) | reader->data[reader->cursor++];
+    }
+
+    return true;
+}
+
+static bool internal_id3CborEnter(Id3CborReader *reader, uint8_t expected) {
+    uint8_t major = 0;
+    uint64_t value = 0;
+    bool indefinite = false;
+
+    if (reader->depth >= ID3_CBOR_MAX_DEPTH) {
+        return internal_id3CborFail(reader);
+    }
+
+    if (!internal_id3CborReadHead(reader, &major, &value, &indefinite) || major != expected) {
+        return internal_id3CborFail(reader);
+    }
+
+    // every element takes at least a byte, larger counts cannot be real
+    if (!indefinite && value > reader->length - reader->cursor) {
+        return internal_id3CborFail(reader);
+    }
+
+    reader->remaining[reader->depth++] = indefinite ? SIZE_MAX : (size_t) value;
+    return true;
+}
+
+// moves to the next item of the innermost container, false once it ends
+static bool internal_id3CborNext(Id3CborReader *reader) {
+    size_t *remaining = NULL;
+
+    if (reader->failed || reader->depth == 0) {
+        return internal_id3CborFail(reader);
+    }
+
+    remaining = &reader->remaining[reader->depth - 1];
+
+    if (*remaining == SIZE_MAX) {
+        if (reader->cursor >= reader->length) {
+            return internal_id3CborFail(reader);
+        }
+
+        if (reader->data[reader->cursor] == ID3_CBOR_BREAK) {
+            reader->cursor++;
+            reader->depth--;
+            return false;
+        }
+
+        return true;
+    }
+
+    if (*remaining == 0) {
+        reader->depth--;
+        return false;
+    }
+
+    (*remaining)--;
+    return true;
+}
+
+static const uint8_t *internal_id3CborReadString(Id3CborReader *reader, uint8_t expected, size_t *length) {
+    const uint8_t *start = NULL;
+    uint8_t major = 0;
+    uint64_t value = 0;
+    bool indefinite = false;
+
+    if (length != NULL) {
+        *length = 0;
+    }
+
+    if (!internal_id3CborReadHead(reader, &major, &value, &indefinite)) {
+        return NULL;
+    }
+
+    if (major != expected || indefinite || value > reader->length - reader->cursor) {
+        internal_id3CborFail(reader);
+        return NULL;
+    }
+
+    start = reader->data + reader->cursor;
+    reader->cursor += (size_t) value;
+
+    if (length != NULL) {
+        *length = (size_t) value;
+    }
+
+    return start;
+}
+
+static bool internal_id3CborSkip(Id3CborReader *reader, size_t depth) {
+    uint8_t major = 0;
+    uint64_t value = 0;
+    bool indefinite = false;
+
+    // tags annotate the item after them, chains of them are passed over without nesting
+    do {
+        if (!internal_id3CborReadHead(reader, &major, &value, &indefinite)) {
+            return false;
+        }
+    } while (major == ID3_CBOR_TAG);
+
+    switch (major) {
+        case ID3_CBOR_BYTES:
+        case ID3_CBOR_TEXT:
+            if (indefinite || value > reader->length - reader->cursor) {
+                return internal_id3CborFail(reader);
+            }
+
+            reader->cursor += (size_t) value;
+            return true;
+
+        case ID3_CBOR_ARRAY:
+        case ID3_CBOR_MAP:
+            if (depth >= ID3_CBOR_MAX_DEPTH) {
+                return internal_id3CborFail(reader);
+            }
+
+            if (indefinite) {
+                while (reader->cursor < reader->length && reader->data[reader->cursor] != ID3_CBOR_BREAK) {
+                    if (!internal_id3CborSkip(reader, depth + 1)) {
+                        return false;
+                    }
+                }
+
+                if (reader->cursor >= reader->length) {
+                    return internal_id3CborFail(reader);
+                }
+
+                reader->cursor++;
+                return true;
+            }
+
+            if (value > reader->length - reader->cursor) {
+                return internal_id3CborFail(reader);
+            }
+
+            // a map holds a key and a value per member
+            for (uint64_t i = 0; i < value * ((major == ID3_CBOR_MAP) ? 2 : 1); i++) {
+                if (!internal_id3CborSkip(reader, depth + 1)) {
+                    return false;
+                }
+            }
+
+            return true;
+
+        case ID3_CBOR_SIMPLE:
+            // a break where no container can end
+            if (indefinite) {
+                return internal_id3CborFail(reader);
+            }
+
+            return true;
+
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Creates a reader over a CBOR document.
+ * @details The document is read in place and must stay valid while the reader and any string returned by it are
+ * in use. Returns NULL if data is NULL or memory allocation fails.
+ * @param data - CBOR document to read.
+ * @param length - Number of bytes in data.
+ * @return Id3CborReader* - Pointer to the reader, or NULL on failure. Caller must free with id3CborReaderDestroy.
+ */
+Id3CborReader *id3CborReaderCreate(const uint8_t *data, size_t length) {
+    if (data == NULL) {
+        return NULL;
+    }
+
+    Id3CborReader *reader = malloc(sizeof(Id3CborReader));
+
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    reader->data = data;
+    reader->length = length;
+    reader->cursor = 0;
+    reader->failed = false;
+    reader->key[0] = 0;
+    reader->depth = 0;
+
+    return reader;
+}
+
+/**
+ * @brief Frees a reader and sets the pointer to NULL.
+ * @details The document given to the reader is not freed. Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the reader pointer to free.
+ */
+void id3CborReaderDestroy(Id3CborReader **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Enters the map that is the next item in the document.
+ * @param reader - Reader to advance.
+ * @return bool - true if a map was entered, false if the next item is not a map.
+ */
+bool id3CborBeginMap(Id3CborReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3CborEnter(reader, ID3_CBOR_MAP);
+}
+
+/**
+ * @brief Moves to the next member of the current map.
+ * @details On success the member key is stored in the reader's key field, truncated to ID3_CBOR_KEY_SIZE - 1
+ * bytes, and the member value is the next item to read. Keys must be text strings. Every member value must be read
+ * or skipped before moving to the next member. Returns false once the map ends; check the failed field of the
+ * reader to tell the end of the map from malformed input.
+ * @param reader - Reader positioned inside a map.
+ * @return bool - true if the reader moved to a member, false at the end of the map or on failure.
+ */
+bool id3CborNextMember(Id3CborReader *reader) {
+    const uint8_t *key = NULL;
+    size_t length = 0;
+
+    if (reader == NULL || !internal_id3CborNext(reader)) {
+        return false;
+    }
+
+    key = internal_id3CborReadString(reader, ID3_CBOR_TEXT, &length);
+
+    if (key == NULL) {
+        return false;
+    }
+
+    length = (length >= ID3_CBOR_KEY_SIZE) ? ID3_CBOR_KEY_SIZE - 1 : length;
+    memcpy(reader->key, key, length);
+    reader->key[length] = 0;
+
+    return true;
+}
+
+/**
+ * @brief Enters the array that is the next item in the document.
+ * @param reader - Reader to advance.
+ * @return bool - true if an array was entered, false if the next item is not an array.
+ */
+bool id3CborBeginArray(Id3CborReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3CborEnter(reader, ID3_CBOR_ARRAY);
+}
+
+/**
+ * @brief Moves to the next element of the current array.
+ * @details On success the element is the next item to read. Returns false once the array ends; check the failed
+ * field of the reader to tell the end of the array from malformed input.
+ * @param reader - Reader positioned inside an array.
+ * @return bool - true if another element follows, false at the end of the array or on failure.
+ */
+bool id3CborNextElement(Id3CborReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3CborNext(reader);
+}
+
+/**
+ * @brief Reads a UTF-8 text string.
+ * @details The returned text points into the document and is not null-terminated, use length to bound it.
+ * @param reader - Reader positioned at a text string.
+ * @param length - Receives the number of bytes in the text.
+ * @return const char* - Pointer to the text, or NULL if the next item is not a definite length text string.
+ */
+const char *id3CborReadText(Id3CborReader *reader, size_t *length) {
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    return (const char *) internal_id3CborReadString(reader, ID3_CBOR_TEXT, length);
+}
+
+/**
+ * @brief Reads a byte string.
+ * @details The returned bytes point into the document and are not copied.
+ * @param reader - Reader positioned at a byte string.
+ * @param length - Receives the number of bytes.
+ * @return const uint8_t* - Pointer to the bytes, or NULL if the next item is not a definite length byte string.
+ * An empty byte string returns a non NULL pointer with a length of 0.
+ */
+const uint8_t *id3CborReadBytes(Id3CborReader *reader, size_t *length) {
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    return internal_id3CborReadString(reader, ID3_CBOR_BYTES, length);
+}
+
+/**
+ * @brief Reads an unsigned integer.
+ * @param reader - Reader positioned at an unsigned integer.
+ * @param value - Receives the value.
+ * @return bool - true if an unsigned integer was read, false otherwise.
+ */
+bool id3CborReadUnsigned(Id3CborReader *reader, uint64_t *value) {
+    uint8_t major = 0;
+    bool indefinite = false;
+
+    if (reader == NULL || value == NULL) {
+        return false;
+    }
+
+    if (!internal_id3CborReadHead(reader, &major, value, &indefinite)) {
+        return false;
+    }
+
+    if (major != ID3_CBOR_UNSIGNED) {
+        *value = 0;
+        return internal_id3CborFail(reader);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads true or false.
+ * @param reader - Reader positioned at a boolean.
+ * @param value - Receives the boolean.
+ * @return bool - true if a boolean was read, false otherwise.
+ */
+bool id3CborReadBool(Id3CborReader *reader, bool *value) {
+    if (reader == NULL || value == NULL || reader->failed || reader->cursor >= reader->length) {
+        return (reader != NULL) ? internal_id3CborFail(reader) : false;
+    }
+
+    switch (reader->data[reader->cursor]) {
+        case 0xF4:
+            *value = false;
+            break;
+        case 0xF5:
+            *value = true;
+            break;
+        default:
+            return internal_id3CborFail(reader);
+    }
+
+    reader->cursor++;
+    return true;
+}
+
+/**
+ * @brief Reads a float.
+ * @details Single and double precision floats are accepted, doubles are narrowed to float.
+ * @param reader - Reader positioned at a float.
+ * @param value - Receives the value.
+ * @return bool - true if a float was read, false otherwise.
+ */
+bool id3CborReadFloat(Id3CborReader *reader, float *value) {
+    uint8_t major = 0;
+    uint64_t bits = 0;
+    bool indefinite = false;
+    uint8_t info = 0;
+
+    if (reader == NULL || value == NULL || reader->failed || reader->cursor >= reader->length) {
+        return (reader != NULL) ? internal_id3CborFail(reader) : false;
+    }
+
+    info = reader->data[reader->cursor] & 0x1F;
+
+    if (!internal_id3CborReadHead(reader, &major, &bits, &indefinite)) {
+        return false;
+    }
+
+    if (major != ID3_CBOR_SIMPLE || (info != 26 && info != 27)) {
+        return internal_id3CborFail(reader);
+    }
+
+    if (info == 26) {
+        const uint32_t single = (uint32_t) bits;
+
+        memcpy(value, &single, sizeof(*value));
+    } else {
+        double wide = 0;
+
+        memcpy(&wide, &bits, sizeof(wide));
+        *value = (float) wide;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Skips over the next item, including any maps or arrays nested in it.
+ * @details Used for members an importer does not know. Tags are skipped along with the item they annotate.
+ * Nesting deeper than ID3_CBOR_MAX_DEPTH fails.
+ * @param reader - Reader positioned at an item.
+ * @return bool - true if an item was skipped, false if it is malformed.
+ */
+bool id3CborSkipValue(Id3CborReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3CborSkip(reader, reader->depth);
+}
+
+/**
+ * @brief Checks that a document was read completely.
+ * @param reader - Reader to check.
+ * @return bool - true if every container entered was left, nothing follows the items read, and no read failed.
+ */
+bool id3CborReaderFinished(Id3CborReader *reader) {
+    if (reader == NULL || reader->failed) {
+        return false;
+    }
+
+    return (reader->depth == 0 && reader->cursor == reader->length);
+}
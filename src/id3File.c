@@ -0,0 +1,628 @@
+/**
+ * @file id3File.c
+ * @author Ewan Jones
+ * @brief Implementation of low level file helpers used to read, patch, and rewrite tagged files
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+// copy_file_range and large file offsets
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#if defined(ID3_HAVE_SENDFILE)
+#include <sys/sendfile.h>
+#endif
+#endif
+
+#include "id3File.h"
+#include "id3v1/id3v1Types.h"
+#include "id3v2/id3v2Types.h"
+
+// internal function ------------------------------------------------------------------------
+#if defined(_WIN32)
+static int64_t internal_id3FilePread(int fd, uint8_t *buffer, size_t length, uint64_t offset) {
+    if (_lseeki64(fd, (__int64) offset, SEEK_SET) < 0) {
+        return -1;
+    }
+
+    return _read(fd, buffer, (unsigned int) ((length > INT32_MAX) ? INT32_MAX : length));
+}
+
+static int64_t internal_id3FilePwrite(int fd, const uint8_t *buffer, size_t length, uint64_t offset) {
+    if (_lseeki64(fd, (__int64) offset, SEEK_SET) < 0) {
+        return -1;
+    }
+
+    return _write(fd, buffer, (unsigned int) ((length > INT32_MAX) ? INT32_MAX : length));
+}
+
+static int64_t internal_id3FileWrite(int fd, const uint8_t *buffer, size_t length) {
+    return _write(fd, buffer, (unsigned int) ((length > INT32_MAX) ? INT32_MAX : length));
+}
+#else
+static int64_t internal_id3FilePread(int fd, uint8_t *buffer, size_t length, uint64_t offset) {
+    return pread(fd, buffer, length, (off_t) offset);
+}
+
+static int64_t internal_id3FilePwrite(int fd, const uint8_t *buffer, size_t length, uint64_t offset) {
+    return pwrite(fd, buffer, length, (off_t) offset);
+}
+
+static int64_t internal_id3FileWrite(int fd, const uint8_t *buffer, size_t length) {
+    return write(fd, buffer, length);
+}
+#endif
+
+/**
+ * @brief Opens a file for reading, or for reading and writing, returning its descriptor.
+ * @details Files are opened in binary mode and are never created. The descriptor must be released with id3FileClose.
+ * @param filePath - Null-terminated path of the file to open.
+ * @param write - true to open the file for reading and writing, false for reading only.
+ * @return int - File descriptor on success, -1 on failure.
+ */
+int id3FileOpen(const char *filePath, bool write) {
+    if (filePath == NULL) {
+        return -1;
+    }
+
+#if defined(_WIN32)
+    return _open(filePath, ((write) ? _O_RDWR : _O_RDONLY) | _O_BINARY);
+#else
+    return open(filePath, ((write) ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+#endif
+}
+
+/**
+ * @brief Closes a descriptor returned by id3FileOpen.
+ * @details Negative descriptors are ignored.
+ * @param fd - File descriptor to close.
+ */
+void id3FileClose(int fd) {
+    if (fd < 0) {
+        return;
+    }
+
+#if defined(_WIN32)
+    (void) _close(fd);
+#else
+    (void) close(fd);
+#endif
+}
+
+/**
+ * @brief Reads the size of an open file.
+ * @details Uses fstat so the file position is left untouched. Sizes are 64-bit on every platform.
+ * @param fd - File descriptor to query.
+ * @param size - Receives the size of the file in bytes.
+ * @return bool - true on success, false on failure.
+ */
+bool id3FileSize(int fd, uint64_t *size) {
+    if (fd < 0 || size == NULL) {
+        return false;
+    }
+
+#if defined(_WIN32)
+    struct _stat64 st;
+
+    if (_fstat64(fd, &st) != 0) {
+        return false;
+    }
+#else
+    struct stat st;
+
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+#endif
+
+    *size = (uint64_t) st.st_size;
+    return true;
+}
+
+/**
+ * @brief Reads the identity of an open file.
+ * @details Uses fstat so the file position is left untouched. See Id3FileIdentity for what the fields can tell apart.
+ * @param fd - File descriptor to query.
+ * @param identity - Receives the identity of the file.
+ * @return bool - true on success, false on failure.
+ */
+bool id3FileIdentify(int fd, Id3FileIdentity *identity) {
+    if (fd < 0 || identity == NULL) {
+        return false;
+    }
+
+#if defined(_WIN32)
+    struct _stat64 st;
+
+    if (_fstat64(fd, &st) != 0) {
+        return false;
+    }
+
+    identity->modified = (int64_t) st.st_mtime * 1000000000;
+#else
+    struct stat st;
+
+    if (fstat(fd, &st) != 0) {
+        return false;
+    }
+
+#if defined(__APPLE__)
+    identity->modified = (int64_t) st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    identity->modified = (int64_t) st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+
+    identity->device = (uint64_t) st.st_dev;
+    identity->inode = (uint64_t) st.st_ino;
+    identity->size = (uint64_t) st.st_size;
+    return true;
+}
+
+/**
+ * @brief Reads exactly length bytes from a file at an absolute offset.
+ * @details Uses positional reads so the file position is left untouched on POSIX systems. Short reads are retried
+ * until the buffer is full; reaching the end of the file first is a failure.
+ * @param fd - File descriptor to read from.
+ * @param buffer - Destination of at least length bytes.
+ * @param length - Number of bytes to read.
+ * @param offset - Absolute offset to read from.
+ * @return bool - true if all bytes were read, false otherwise.
+ */
+bool id3FileReadAt(int fd, uint8_t *buffer, size_t length, uint64_t offset) {
+    if (fd < 0 || (buffer == NULL && length > 0)) {
+        return false;
+    }
+
+    while (length > 0) {
+        int64_t n = internal_id3FilePread(fd, buffer, length, offset);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        buffer += n;
+        length -= (size_t) n;
+        offset += (uint64_t) n;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes exactly length bytes to a file at an absolute offset.
+ * @details Uses positional writes so the file position is left untouched on POSIX systems.
+ * @param fd - File descriptor opened for writing.
+ * @param buffer - Bytes to write.
+ * @param length - Number of bytes to write.
+ * @param offset - Absolute offset to write to.
+ * @return bool - true if all bytes were written, false otherwise.
+ */
+bool id3FileWriteAt(int fd, const uint8_t *buffer, size_t length, uint64_t offset) {
+    if (fd < 0 || (buffer == NULL && length > 0)) {
+        return false;
+    }
+
+    while (length > 0) {
+        int64_t n = internal_id3FilePwrite(fd, buffer, length, offset);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        buffer += n;
+        length -= (size_t) n;
+        offset += (uint64_t) n;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Writes exactly length bytes at the current position of a file.
+ * @details Short writes and interrupted calls are retried until every byte is written.
+ * @param fd - File descriptor opened for writing.
+ * @param buffer - Bytes to write.
+ * @param length - Number of bytes to write.
+ * @return bool - true if all bytes were written, false otherwise.
+ */
+bool id3FileWrite(int fd, const uint8_t *buffer, size_t length) {
+    if (fd < 0 || (buffer == NULL && length > 0)) {
+        return false;
+    }
+
+    while (length > 0) {
+        int64_t n = internal_id3FileWrite(fd, buffer, length);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        buffer += n;
+        length -= (size_t) n;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Copies a range of one file to the current position of another.
+ * @details The copy is done by the kernel with copy_file_range where available, falling back to sendfile and finally to
+ * a fixed ID3_FILE_COPY_BUFFER_SIZE buffer, so memory use does not depend on the length copied. A fallback picks up
+ * where the previous method stopped. The position of inFd is left untouched; outFd advances by length bytes.
+ * @param inFd - File descriptor to copy from.
+ * @param offset - Absolute offset of the first byte to copy.
+ * @param length - Number of bytes to copy.
+ * @param outFd - File descriptor to copy to.
+ * @return bool - true if the full range was copied, false otherwise.
+ */
+bool id3FileCopyRange(int inFd, uint64_t offset, uint64_t length, int outFd) {
+    if (inFd < 0 || outFd < 0) {
+        return false;
+    }
+
+#if defined(ID3_HAVE_COPY_FILE_RANGE)
+    while (length > 0) {
+        loff_t in = (loff_t) offset;
+        ssize_t n = copy_file_range(inFd, &in, outFd, NULL, (length > SSIZE_MAX) ? SSIZE_MAX : (size_t) length, 0);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        // unsupported by this kernel or file system pair, or an early end of file
+        if (n <= 0) {
+            break;
+        }
+
+        offset += (uint64_t) n;
+        length -= (uint64_t) n;
+    }
+#endif
+
+#if defined(ID3_HAVE_SENDFILE)
+    while (length > 0) {
+        off_t in = (off_t) offset;
+        ssize_t n = sendfile(outFd, inFd, &in, (length > 0x7ffff000) ? 0x7ffff000 : (size_t) length);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            break;
+        }
+
+        offset += (uint64_t) n;
+        length -= (uint64_t) n;
+    }
+#endif
+
+    if (length > 0) {
+        uint8_t *buffer = malloc(ID3_FILE_COPY_BUFFER_SIZE);
+
+        if (buffer == NULL) {
+            return false;
+        }
+
+        while (length > 0) {
+            size_t chunk = (length > ID3_FILE_COPY_BUFFER_SIZE) ? ID3_FILE_COPY_BUFFER_SIZE : (size_t) length;
+
+            if (!id3FileReadAt(inFd, buffer, chunk, offset) || !id3FileWrite(outFd, buffer, chunk)) {
+                break;
+            }
+
+            offset += chunk;
+            length -= chunk;
+        }
+
+        free(buffer);
+    }
+
+    return (length == 0);
+}
+
+/**
+ * @brief Reads the size of an ID3v2 tag from its header or footer.
+ * @details Only the 10 given bytes are looked at, nothing is parsed or allocated. The size covers the header, the
+ * extended header, the frames, the padding, and a v2.4 footer. Footers only exist in v2.4 tags.
+ * @param bytes - ID3V2_TAG_HEADER_SIZE bytes holding a tag header or footer.
+ * @param footer - true if bytes should be a footer ("3DI"), false for a header ("ID3").
+ * @return uint64_t - Size of the whole tag in bytes, 0 if bytes are not a valid header or footer.
+ */
+uint64_t id3FileTagSize(const uint8_t *bytes, bool footer) {
+    uint64_t size = 0;
+
+    if (bytes == NULL || memcmp(bytes, footer ? "3DI" : "ID3", ID3V2_TAG_ID_SIZE) != 0 || bytes[3] == 0xFF ||
+        bytes[4] == 0xFF || ((bytes[6] | bytes[7] | bytes[8] | bytes[9]) & 0x80) != 0) {
+        return 0;
+    }
+
+    if (footer && bytes[3] != ID3V2_TAG_VERSION_4) {
+        return 0;
+    }
+
+    size = ID3V2_TAG_HEADER_SIZE + (((uint64_t) bytes[6] << 21) | ((uint64_t) bytes[7] << 14) |
+                                    ((uint64_t) bytes[8] << 7) | (uint64_t) bytes[9]);
+
+    // v2.4 footer
+    if (bytes[3] == ID3V2_TAG_VERSION_4 && (bytes[5] & 0x10) != 0) {
+        size += ID3V2_TAG_HEADER_SIZE;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Locates the ID3v2 tag at the start and the ID3v1 tag at the end of a file.
+ * @details Reads the 10 byte ID3v2 header and the 3 byte ID3v1 identifier only; no frames are parsed. A v2.4 footer
+ * is counted as part of the ID3v2 tag. A header whose size runs past the end of the file, or an ID3v1 identifier that
+ * falls inside the ID3v2 tag, is not treated as a tag.
+ * @param fd - File descriptor to inspect.
+ * @param layout - Receives the location of both tags.
+ * @return bool - true on success, false if the file could not be inspected.
+ */
+bool id3FileReadLayout(int fd, Id3FileLayout *layout) {
+    if (fd < 0 || layout == NULL) {
+        return false;
+    }
+
+    uint8_t header[ID3V2_TAG_HEADER_SIZE] = {0};
+    uint64_t size = 0;
+
+    if (!id3FileSize(fd, &layout->fileSize)) {
+        return false;
+    }
+
+    layout->id3v2Size = 0;
+    layout->id3v1Offset = layout->fileSize;
+
+    if (layout->fileSize >= ID3V2_TAG_HEADER_SIZE && id3FileReadAt(fd, header, ID3V2_TAG_HEADER_SIZE, 0)) {
+        size = id3FileTagSize(header, false);
+        layout->id3v2Size = (size <= layout->fileSize) ? size : 0;
+    }
+
+    if (layout->fileSize >= layout->id3v2Size + ID3V1_MAX_SIZE &&
+        id3FileReadAt(fd, header, ID3V1_TAG_ID_SIZE, layout->fileSize - ID3V1_MAX_SIZE) &&
+        memcmp(header, "TAG", ID3V1_TAG_ID_SIZE) == 0) {
+        layout->id3v1Offset = layout->fileSize - ID3V1_MAX_SIZE;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Rewrites a file as head + [start, end) of its current content + tail, replacing it atomically.
+ * @details The new content is streamed into a temporary file created in the same directory, so the rename that replaces
+ * the original is atomic and the original is left untouched on any failure. The kept range is copied with
+ * id3FileCopyRange, so memory use is constant regardless of the file size. The permissions of the original are kept
+ * and the temporary file is flushed to disk before the rename. end is clamped to the size of the file.
+ * A symbolic link is followed and the file it names is replaced, the link itself is kept. A file with more than one
+ * hard link is not renamed over, as that would split it from its other names, instead the temporary file is copied
+ * back over it and truncated, so in that case a failure part way through can leave the file incomplete. Both are
+ * POSIX only, on Windows the path given is replaced.
+ * The caller keeps ownership of fd; after a successful rewrite it refers to the replaced content and should be closed.
+ * @param filePath - Null-terminated path of an existing file to rewrite.
+ * @param fd - Open descriptor of filePath used to read the kept range.
+ * @param head - Bytes written before the kept range, may be NULL when headl is 0.
+ * @param headl - Number of bytes in head.
+ * @param start - Absolute offset of the first byte of the original file to keep.
+ * @param end - Absolute offset one past the last byte of the original file to keep.
+ * @param tail - Bytes written after the kept range, may be NULL when taill is 0.
+ * @param taill - Number of bytes in tail.
+ * @return bool - true if the file was replaced, false otherwise.
+ */
+bool id3FileRewrite(const char *filePath, int fd, const uint8_t *head, size_t headl, uint64_t start, uint64_t end,
+                    const uint8_t *tail, size_t taill) {
+    if (filePath == NULL || fd < 0 || (head == NULL && headl > 0) || (tail == NULL && taill > 0)) {
+        return false;
+    }
+
+    int outFd = -1;
+    uint64_t size = 0;
+    size_t pathl = 0;
+    char *tmpPath = NULL;
+    char *target = NULL;
+    bool ok = false;
+
+    if (!id3FileSize(fd, &size)) {
+        return false;
+    }
+
+    end = (end > size) ? size : end;
+    start = (start > end) ? end : start;
+
+#if !defined(_WIN32)
+    // the temporary file goes next to the file a symbolic link names so the rename replaces that file
+    target = realpath(filePath, NULL);
+
+    if (target != NULL) {
+        filePath = target;
+    }
+#endif
+
+    pathl = strlen(filePath);
+    tmpPath = malloc(pathl + sizeof(".XXXXXX"));
+
+    if (tmpPath == NULL) {
+        free(target);
+        return false;
+    }
+
+    memcpy(tmpPath, filePath, pathl);
+    memcpy(tmpPath + pathl, ".XXXXXX", sizeof(".XXXXXX"));
+
+#if defined(_WIN32)
+    struct _stat64 st;
+
+    if (_fstat64(fd, &st) == 0 && _mktemp_s(tmpPath, pathl + sizeof(".XXXXXX")) == 0) {
+        outFd = _open(tmpPath, _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+#else
+    struct stat st;
+
+    if (fstat(fd, &st) == 0) {
+        outFd = mkstemp(tmpPath);
+    }
+#endif
+
+    if (outFd < 0) {
+        free(tmpPath);
+        free(target);
+        return false;
+    }
+
+    ok = id3FileWrite(outFd, head, headl) &&
+         id3FileCopyRange(fd, start, end - start, outFd) &&
+         id3FileWrite(outFd, tail, taill);
+
+#if defined(_WIN32)
+    ok = ok && (_commit(outFd) == 0);
+    id3FileClose(outFd);
+    ok = ok && MoveFileExA(tmpPath, filePath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    if (st.st_nlink > 1) {
+        // every hard link has to see the new content, so the file keeps its inode
+        int linkedFd = open(filePath, O_WRONLY);
+        uint64_t newSize = (uint64_t) headl + (end - start) + taill;
+
+        ok = ok && linkedFd >= 0 &&
+             id3FileCopyRange(outFd, 0, newSize, linkedFd) &&
+             ftruncate(linkedFd, (off_t) newSize) == 0 &&
+             fsync(linkedFd) == 0;
+
+        if (linkedFd >= 0) {
+            ok = (close(linkedFd) == 0) && ok;
+        }
+
+        (void) close(outFd);
+        (void) remove(tmpPath);
+    } else {
+        ok = ok && (fchmod(outFd, st.st_mode & 07777) == 0) && (fsync(outFd) == 0);
+        ok = (close(outFd) == 0) && ok;
+        ok = ok && (rename(tmpPath, filePath) == 0);
+    }
+#endif
+
+    if (!ok) {
+        (void) remove(tmpPath);
+    }
+
+    free(tmpPath);
+    free(target);
+    return ok;
+}
+
+/**
+ * @brief Maps a whole file into memory read only.
+ * @details The mapping is private and backed by the page cache, so several processes mapping the same file share
+ * its pages and nothing is copied onto the heap. The file descriptor used to create it is closed before returning,
+ * the mapping stays valid until id3FileUnmap. Changes made to the file while it is mapped may or may not be seen.
+ * Empty files cannot be mapped.
+ * @param filePath - Null-terminated path of the file to map.
+ * @param mapping - Receives the mapped bytes and their length.
+ * @return bool - true on success, false if the file could not be opened or mapped.
+ */
+bool id3FileMap(const char *filePath, Id3FileMapping *mapping) {
+    if (filePath == NULL || mapping == NULL) {
+        return false;
+    }
+
+    int fd = id3FileOpen(filePath, false);
+    uint64_t size = 0;
+    void *data = NULL;
+
+    mapping->data = NULL;
+    mapping->length = 0;
+
+    if (fd < 0) {
+        return false;
+    }
+
+    if (!id3FileSize(fd, &size) || size == 0 || size > SIZE_MAX) {
+        id3FileClose(fd);
+        return false;
+    }
+
+#if defined(_WIN32)
+    HANDLE map = CreateFileMappingA((HANDLE) _get_osfhandle(fd), NULL, PAGE_READONLY, 0, 0, NULL);
+
+    // the view keeps the mapping object alive on its own
+    if (map != NULL) {
+        data = MapViewOfFile(map, FILE_MAP_READ, 0, 0, (SIZE_T) size);
+        (void) CloseHandle(map);
+    }
+#else
+    data = mmap(NULL, (size_t) size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data == MAP_FAILED) {
+        data = NULL;
+    }
+#endif
+
+    id3FileClose(fd);
+
+    if (data == NULL) {
+        return false;
+    }
+
+    mapping->data = (const uint8_t *) data;
+    mapping->length = (size_t) size;
+    return true;
+}
+
+/**
+ * @brief Releases a mapping created by id3FileMap.
+ * @details Pointers into the mapping must not be used afterwards. Safe to call with NULL or with a mapping that is
+ * already released.
+ * @param mapping - Mapping to release, left empty.
+ */
+void id3FileUnmap(Id3FileMapping *mapping) {
+    if (mapping == NULL || mapping->data == NULL) {
+        return;
+    }
+
+#if defined(_WIN32)
+    (void) UnmapViewOfFile((LPCVOID) mapping->data);
+#else
+    (void) munmap((void *) mapping->data, mapping->length);
+#endif
+
+    mapping->data = NULL;
+    mapping->length = 0;
+}
@@ -0,0 +1,205 @@
+/**
+ * @file id3Hash.c
+ * @author Ewan Jones
+ * @brief Function implementations for the streaming 64 bit hash used to fingerprint audio content
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "id3Hash.h"
+
+//! First XXH64 prime, multiplies each lane after a round
+#define ID3_HASH_PRIME1 0x9E3779B185EBCA87ULL
+
+//! Second XXH64 prime, multiplies each input word
+#define ID3_HASH_PRIME2 0xC2B2AE3D27D4EB4FULL
+
+//! Third XXH64 prime, used by the tail and avalanche
+#define ID3_HASH_PRIME3 0x165667B19E3779F9ULL
+
+//! Fourth XXH64 prime, added when merging lanes
+#define ID3_HASH_PRIME4 0x85EBCA77C2B2AE63ULL
+
+//! Fifth XXH64 prime, used for short inputs and trailing bytes
+#define ID3_HASH_PRIME5 0x27D4EB2F165667C5ULL
+
+//! Rotates a 64 bit value left
+#define ID3_HASH_ROTL(x, n) (((x) << (n)) | ((x) >> (64 - (n))))
+
+// internal function ------------------------------------------------------------------------
+static uint64_t internal_id3HashRead64(const uint8_t *p) {
+    return (uint64_t) p[0] | ((uint64_t) p[1] << 8) | ((uint64_t) p[2] << 16) | ((uint64_t) p[3] << 24) |
+           ((uint64_t) p[4] << 32) | ((uint64_t) p[5] << 40) | ((uint64_t) p[6] << 48) | ((uint64_t) p[7] << 56);
+}
+
+// internal function ------------------------------------------------------------------------
+static uint32_t internal_id3HashRead32(const uint8_t *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+// internal function ------------------------------------------------------------------------
+static uint64_t internal_id3HashRound(uint64_t acc, uint64_t input) {
+    acc += input * ID3_HASH_PRIME2;
+    acc = ID3_HASH_ROTL(acc, 31);
+    return acc * ID3_HASH_PRIME1;
+}
+
+// internal function ------------------------------------------------------------------------
+static uint64_t internal_id3HashMerge(uint64_t acc, uint64_t lane) {
+    acc ^= internal_id3HashRound(0, lane);
+    return acc * ID3_HASH_PRIME1 + ID3_HASH_PRIME4;
+}
+
+// internal function ------------------------------------------------------------------------
+static void internal_id3HashStripe(uint64_t lanes[4], const uint8_t *stripe) {
+    lanes[0] = internal_id3HashRound(lanes[0], internal_id3HashRead64(stripe));
+    lanes[1] = internal_id3HashRound(lanes[1], internal_id3HashRead64(stripe + 8));
+    lanes[2] = internal_id3HashRound(lanes[2], internal_id3HashRead64(stripe + 16));
+    lanes[3] = internal_id3HashRound(lanes[3], internal_id3HashRead64(stripe + 24));
+}
+
+/**
+ * @brief Prepares a hash state for new data.
+ * @details The hash is XXH64, a non-cryptographic hash that keeps up with sequential reads from disk. It is meant to
+ * tell identical audio apart from different audio, not to resist deliberate collisions.
+ * @param state - State to prepare.
+ * @param seed - Seed mixed into the hash, 0 unless a separate family of hashes is wanted.
+ */
+void id3HashInit(Id3Hash *state, uint64_t seed) {
+    if (state == NULL) {
+        return;
+    }
+
+    memset(state, 0, sizeof(Id3Hash));
+    state->seed = seed;
+    state->lanes[0] = seed + ID3_HASH_PRIME1 + ID3_HASH_PRIME2;
+    state->lanes[1] = seed + ID3_HASH_PRIME2;
+    state->lanes[2] = seed;
+    state->lanes[3] = seed - ID3_HASH_PRIME1;
+}
+
+/**
+ * @brief Adds bytes to a hash.
+ * @param state - State set up with id3HashInit.
+ * @param data - Bytes to add, may be NULL when length is 0.
+ * @param length - Number of bytes in data.
+ */
+void id3HashUpdate(Id3Hash *state, const uint8_t *data, size_t length) {
+    if (state == NULL || data == NULL || length == 0) {
+        return;
+    }
+
+    state->total += length;
+
+    // finish a stripe started by an earlier call
+    if (state->buffered > 0) {
+        size_t take = ID3_HASH_STRIPE_SIZE - state->buffered;
+
+        if (take > length) {
+            take = length;
+        }
+
+        memcpy(state->buffer + state->buffered, data, take);
+        state->buffered += take;
+        data += take;
+        length -= take;
+
+        if (state->buffered < ID3_HASH_STRIPE_SIZE) {
+            return;
+        }
+
+        internal_id3HashStripe(state->lanes, state->buffer);
+        state->buffered = 0;
+    }
+
+    while (length >= ID3_HASH_STRIPE_SIZE) {
+        internal_id3HashStripe(state->lanes, data);
+        data += ID3_HASH_STRIPE_SIZE;
+        length -= ID3_HASH_STRIPE_SIZE;
+    }
+
+    if (length > 0) {
+        memcpy(state->buffer, data, length);
+        state->buffered = length;
+    }
+}
+
+/**
+ * @brief Reads the hash of every byte added so far.
+ * @details The state is not changed, so more bytes may still be added afterwards.
+ * @param state - State set up with id3HashInit.
+ * @return uint64_t - The hash, or 0 when state is NULL.
+ */
+uint64_t id3HashFinal(const Id3Hash *state) {
+    if (state == NULL) {
+        return 0;
+    }
+
+    const uint8_t *p = state->buffer;
+    size_t remaining = state->buffered;
+    uint64_t h = 0;
+
+    if (state->total >= ID3_HASH_STRIPE_SIZE) {
+        const uint64_t *v = state->lanes;
+
+        h = ID3_HASH_ROTL(v[0], 1) + ID3_HASH_ROTL(v[1], 7) + ID3_HASH_ROTL(v[2], 12) + ID3_HASH_ROTL(v[3], 18);
+
+        for (int i = 0; i < 4; i++) {
+            h = internal_id3HashMerge(h, v[i]);
+        }
+    } else {
+        h = state->seed + ID3_HASH_PRIME5;
+    }
+
+    h += state->total;
+
+    while (remaining >= 8) {
+        h ^= internal_id3HashRound(0, internal_id3HashRead64(p));
+        h = ID3_HASH_ROTL(h, 27) * ID3_HASH_PRIME1 + ID3_HASH_PRIME4;
+        p += 8;
+        remaining -= 8;
+    }
+
+    if (remaining >= 4) {
+        h ^= (uint64_t) internal_id3HashRead32(p) * ID3_HASH_PRIME1;
+        h = ID3_HASH_ROTL(h, 23) * ID3_HASH_PRIME2 + ID3_HASH_PRIME3;
+        p += 4;
+        remaining -= 4;
+    }
+
+    while (remaining > 0) {
+        h ^= (uint64_t) *p * ID3_HASH_PRIME5;
+        h = ID3_HASH_ROTL(h, 11) * ID3_HASH_PRIME1;
+        p++;
+        remaining--;
+    }
+
+    // avalanche
+    h ^= h >> 33;
+    h *= ID3_HASH_PRIME2;
+    h ^= h >> 29;
+    h *= ID3_HASH_PRIME3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+/**
+ * @brief Hashes a block of memory in one call.
+ * @param data - Bytes to hash, may be NULL when length is 0.
+ * @param length - Number of bytes in data.
+ * @param seed - Seed mixed into the hash.
+ * @return uint64_t - The hash.
+ */
+uint64_t id3Hash64(const uint8_t *data, size_t length, uint64_t seed) {
+    Id3Hash state;
+
+    id3HashInit(&state, seed);
+    id3HashUpdate(&state, data, length);
+
+    return id3HashFinal(&state);
+}
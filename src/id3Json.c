@@ -0,0 +1,562 @@
+/**
+ * @file id3Json.c
+ * @author Ewan Jones
+ * @brief Function implementations for the streaming JSON reader used to import tags from their JSON representation
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "id3Json.h"
+
+//! Initial number of bytes allocated for string values
+#define ID3_JSON_VALUE_CAPACITY 256
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3JsonFail(Id3JsonReader *reader) {
+    reader->failed = true;
+    return false;
+}
+
+// moves past whitespace and returns the next byte, 0 at the end of the document
+static char internal_id3JsonPeek(Id3JsonReader *reader) {
+    while (reader->cursor < reader->length) {
+        const char c = reader->json[reader->cursor];
+
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return c;
+        }
+
+        reader->cursor++;
+    }
+
+    return 0;
+}
+
+static bool internal_id3JsonExpect(Id3JsonReader *reader, char c) {
+    if (reader->failed || internal_id3JsonPeek(reader) != c) {
+        return internal_id3JsonFail(reader);
+    }
+
+    reader->cursor++;
+    return true;
+}
+
+static bool internal_id3JsonLiteral(Id3JsonReader *reader, const char *literal) {
+    const size_t n = strlen(literal);
+
+    if (reader->length - reader->cursor < n || memcmp(reader->json + reader->cursor, literal, n) != 0) {
+        return internal_id3JsonFail(reader);
+    }
+
+    reader->cursor += n;
+    return true;
+}
+
+static int internal_id3JsonHex(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+static bool internal_id3JsonCodeUnit(Id3JsonReader *reader, uint32_t *unit) {
+    *unit = 0;
+
+    if (reader->length - reader->cursor < 4) {
+        return false;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        const int h = internal_id3JsonHex(reader->json[reader->cursor++]);
+
+        if (h < 0) {
+            return false;
+        }
+
+        *unit = (*unit << 4) | (uint32_t) h;
+    }
+
+    return true;
+}
+
+// writes a code point as UTF-8, returns the number of bytes written
+static size_t internal_id3JsonUtf8(uint32_t cp, char *out) {
+    if (cp < 0x80) {
+        out[0] = (char) cp;
+        return 1;
+    }
+
+    if (cp < 0x800) {
+        out[0] = (char) (0xC0 | (cp >> 6));
+        out[1] = (char) (0x80 | (cp & 0x3F));
+        return 2;
+    }
+
+    if (cp < 0x10000) {
+        out[0] = (char) (0xE0 | (cp >> 12));
+        out[1] = (char) (0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (cp & 0x3F));
+        return 3;
+    }
+
+    out[0] = (char) (0xF0 | (cp >> 18));
+    out[1] = (char) (0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char) (0x80 | ((cp >> 6) & 0x3F));
+    out[3] = (char) (0x80 | (cp & 0x3F));
+    return 4;
+}
+
+static bool internal_id3JsonSkipString(Id3JsonReader *reader) {
+    if (!internal_id3JsonExpect(reader, '"')) {
+        return false;
+    }
+
+    while (reader->cursor < reader->length) {
+        const char c = reader->json[reader->cursor++];
+
+        if (c == '"') {
+            return true;
+        }
+
+        if (c == '\\') {
+            reader->cursor++;
+        }
+    }
+
+    return internal_id3JsonFail(reader);
+}
+
+static bool internal_id3JsonSkip(Id3JsonReader *reader, int depth) {
+    const char c = internal_id3JsonPeek(reader);
+
+    if (reader->failed || ((c == '{' || c == '[') && depth >= ID3_JSON_MAX_DEPTH)) {
+        return internal_id3JsonFail(reader);
+    }
+
+    switch (c) {
+        case '"':
+            return internal_id3JsonSkipString(reader);
+        case '{':
+            reader->cursor++;
+
+            while (id3JsonNextMember(reader)) {
+                if (!internal_id3JsonSkip(reader, depth + 1)) {
+                    return false;
+                }
+            }
+
+            return !reader->failed;
+        case '[':
+            reader->cursor++;
+
+            while (id3JsonNextElement(reader)) {
+                if (!internal_id3JsonSkip(reader, depth + 1)) {
+                    return false;
+                }
+            }
+
+            return !reader->failed;
+        case 't':
+            return internal_id3JsonLiteral(reader, "true");
+        case 'f':
+            return internal_id3JsonLiteral(reader, "false");
+        case 'n':
+            return internal_id3JsonLiteral(reader, "null");
+        default:
+            break;
+    }
+
+    // numbers
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        reader->cursor++;
+
+        while (reader->cursor < reader->length &&
+               strchr("0123456789+-.eE", reader->json[reader->cursor]) != NULL &&
+               reader->json[reader->cursor] != 0) {
+            reader->cursor++;
+        }
+
+        return true;
+    }
+
+    return internal_id3JsonFail(reader);
+}
+
+/**
+ * @brief Creates a reader over a JSON document.
+ * @details The text is read in place and must stay valid until the reader is destroyed. It does not need to be
+ * null-terminated. Returns NULL if json is NULL or memory allocation fails.
+ * @param json - JSON text to read.
+ * @param length - Number of bytes in json.
+ * @return Id3JsonReader* - Pointer to the reader, or NULL on failure. Caller must free with id3JsonReaderDestroy.
+ */
+Id3JsonReader *id3JsonReaderCreate(const char *json, size_t length) {
+    if (json == NULL) {
+        return NULL;
+    }
+
+    Id3JsonReader *reader = malloc(sizeof(Id3JsonReader));
+
+    if (reader == NULL) {
+        return NULL;
+    }
+
+    reader->json = json;
+    reader->length = length;
+    reader->cursor = 0;
+    reader->failed = false;
+    reader->key[0] = 0;
+    reader->capacity = ID3_JSON_VALUE_CAPACITY;
+    reader->value = malloc(reader->capacity);
+
+    if (reader->value == NULL) {
+        free(reader);
+        return NULL;
+    }
+
+    reader->value[0] = 0;
+
+    return reader;
+}
+
+/**
+ * @brief Frees a reader and sets the pointer to NULL.
+ * @details The JSON text given to the reader is not freed. Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the reader pointer to free.
+ */
+void id3JsonReaderDestroy(Id3JsonReader **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free((*toDelete)->value);
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Enters the object that is the next value in the document.
+ * @param reader - Reader to advance.
+ * @return bool - true if an object was entered, false if the next value is not an object.
+ */
+bool id3JsonBeginObject(Id3JsonReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3JsonExpect(reader, '{');
+}
+
+/**
+ * @brief Moves to the next member of the current object.
+ * @details On success the member key is stored in the reader's key field, truncated to ID3_JSON_KEY_SIZE - 1
+ * bytes, and the member value is the next value to read. Every member value must be read or skipped before
+ * moving to the next member. Returns false once the closing brace is consumed; check the failed field of the
+ * reader to tell the end of the object from malformed input.
+ * @param reader - Reader positioned inside an object.
+ * @return bool - true if the reader moved to a member, false at the end of the object or on failure.
+ */
+bool id3JsonNextMember(Id3JsonReader *reader) {
+    size_t length = 0;
+    const char *key = NULL;
+
+    if (reader == NULL || reader->failed) {
+        return false;
+    }
+
+    switch (internal_id3JsonPeek(reader)) {
+        case '}':
+            reader->cursor++;
+            return false;
+        case ',':
+            reader->cursor++;
+            break;
+        default:
+            break;
+    }
+
+    key = id3JsonReadString(reader, &length);
+
+    if (key == NULL) {
+        return false;
+    }
+
+    length = (length >= ID3_JSON_KEY_SIZE) ? ID3_JSON_KEY_SIZE - 1 : length;
+    memcpy(reader->key, key, length);
+    reader->key[length] = 0;
+
+    return internal_id3JsonExpect(reader, ':');
+}
+
+/**
+ * @brief Enters the array that is the next value in the document.
+ * @param reader - Reader to advance.
+ * @return bool - true if an array was entered, false if the next value is not an array.
+ */
+bool id3JsonBeginArray(Id3JsonReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3JsonExpect(reader, '[');
+}
+
+/**
+ * @brief Moves to the next element of the current array.
+ * @details On success the element is the next value to read. Returns false once the closing bracket is consumed;
+ * check the failed field of the reader to tell the end of the array from malformed input.
+ * @param reader - Reader positioned inside an array.
+ * @return bool - true if another element follows, false at the end of the array or on failure.
+ */
+bool id3JsonNextElement(Id3JsonReader *reader) {
+    if (reader == NULL || reader->failed) {
+        return false;
+    }
+
+    switch (internal_id3JsonPeek(reader)) {
+        case ']':
+            reader->cursor++;
+            return false;
+        case ',':
+            reader->cursor++;
+            break;
+        case 0:
+            return internal_id3JsonFail(reader);
+        default:
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Reads a string value.
+ * @details Escape sequences, including UTF-16 surrogate pairs written as \\u escapes, are decoded to UTF-8. Bytes
+ * that are not escaped are copied as they are, so text written without escaping control characters is accepted.
+ * The returned text is owned by the reader and overwritten by the next string read.
+ * @param reader - Reader positioned at a string.
+ * @param length - Receives the number of bytes in the returned text, may be NULL.
+ * @return const char* - Null-terminated unescaped text, or NULL if the next value is not a valid string.
+ */
+const char *id3JsonReadString(Id3JsonReader *reader, size_t *length) {
+    size_t o = 0;
+
+    if (length != NULL) {
+        *length = 0;
+    }
+
+    if (reader == NULL || !internal_id3JsonExpect(reader, '"')) {
+        return NULL;
+    }
+
+    while (reader->cursor < reader->length) {
+        char c = reader->json[reader->cursor++];
+
+        // room for the longest escape plus the terminator
+        if (o + 5 > reader->capacity) {
+            char *tmp = realloc(reader->value, reader->capacity * 2);
+
+            if (tmp == NULL) {
+                internal_id3JsonFail(reader);
+                return NULL;
+            }
+
+            reader->value = tmp;
+            reader->capacity *= 2;
+        }
+
+        if (c == '"') {
+            reader->value[o] = 0;
+
+            if (length != NULL) {
+                *length = o;
+            }
+
+            return reader->value;
+        }
+
+        if (c != '\\') {
+            reader->value[o++] = c;
+            continue;
+        }
+
+        if (reader->cursor >= reader->length) {
+            break;
+        }
+
+        c = reader->json[reader->cursor++];
+
+        switch (c) {
+            case '"':
+            case '\\':
+            case '/':
+                reader->value[o++] = c;
+                break;
+            case 'b':
+                reader->value[o++] = '\b';
+                break;
+            case 'f':
+                reader->value[o++] = '\f';
+                break;
+            case 'n':
+                reader->value[o++] = '\n';
+                break;
+            case 'r':
+                reader->value[o++] = '\r';
+                break;
+            case 't':
+                reader->value[o++] = '\t';
+                break;
+            case 'u': {
+                uint32_t cp = 0;
+                uint32_t low = 0;
+
+                if (!internal_id3JsonCodeUnit(reader, &cp)) {
+                    internal_id3JsonFail(reader);
+                    return NULL;
+                }
+
+                // a high surrogate must be followed by an escaped low one
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    if (reader->length - reader->cursor < 6 || reader->json[reader->cursor] != '\\' ||
+                        reader->json[reader->cursor + 1] != 'u') {
+                        internal_id3JsonFail(reader);
+                        return NULL;
+                    }
+
+                    reader->cursor += 2;
+
+                    if (!internal_id3JsonCodeUnit(reader, &low) || low < 0xDC00 || low > 0xDFFF) {
+                        internal_id3JsonFail(reader);
+                        return NULL;
+                    }
+
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+
+                o += internal_id3JsonUtf8(cp, reader->value + o);
+            }
+            break;
+            default:
+                internal_id3JsonFail(reader);
+                return NULL;
+        }
+    }
+
+    internal_id3JsonFail(reader);
+    return NULL;
+}
+
+/**
+ * @brief Reads an integer value.
+ * @details Accepts an optional minus sign followed by decimal digits. Fractions, exponents, and values outside the
+ * range of int64_t are rejected.
+ * @param reader - Reader positioned at a number.
+ * @param value - Receives the number.
+ * @return bool - true if an integer was read, false otherwise.
+ */
+bool id3JsonReadInteger(Id3JsonReader *reader, int64_t *value) {
+    uint64_t magnitude = 0;
+    bool negative = false;
+    size_t digits = 0;
+
+    if (reader == NULL || value == NULL || reader->failed) {
+        return false;
+    }
+
+    *value = 0;
+
+    if (internal_id3JsonPeek(reader) == '-') {
+        negative = true;
+        reader->cursor++;
+    }
+
+    while (reader->cursor < reader->length && reader->json[reader->cursor] >= '0' &&
+           reader->json[reader->cursor] <= '9') {
+        const uint64_t d = (uint64_t) (reader->json[reader->cursor] - '0');
+
+        if (magnitude > (UINT64_MAX - d) / 10) {
+            return internal_id3JsonFail(reader);
+        }
+
+        magnitude = magnitude * 10 + d;
+        reader->cursor++;
+        digits++;
+    }
+
+    if (digits == 0 || magnitude > (uint64_t) INT64_MAX + (negative ? 1 : 0)) {
+        return internal_id3JsonFail(reader);
+    }
+
+    if (reader->cursor < reader->length && strchr(".eE", reader->json[reader->cursor]) != NULL &&
+        reader->json[reader->cursor] != 0) {
+        return internal_id3JsonFail(reader);
+    }
+
+    *value = negative ? (int64_t) (0 - magnitude) : (int64_t) magnitude;
+    return true;
+}
+
+/**
+ * @brief Reads a true or false value.
+ * @param reader - Reader positioned at a boolean.
+ * @param value - Receives the boolean.
+ * @return bool - true if a boolean was read, false otherwise.
+ */
+bool id3JsonReadBool(Id3JsonReader *reader, bool *value) {
+    if (reader == NULL || value == NULL || reader->failed) {
+        return false;
+    }
+
+    switch (internal_id3JsonPeek(reader)) {
+        case 't':
+            *value = true;
+            return internal_id3JsonLiteral(reader, "true");
+        case 'f':
+            *value = false;
+            return internal_id3JsonLiteral(reader, "false");
+        default:
+            return internal_id3JsonFail(reader);
+    }
+}
+
+/**
+ * @brief Skips over the next value, including any objects or arrays nested in it.
+ * @details Used for members an importer does not know. Nesting deeper than ID3_JSON_MAX_DEPTH fails.
+ * @param reader - Reader positioned at a value.
+ * @return bool - true if a value was skipped, false if it is malformed.
+ */
+bool id3JsonSkipValue(Id3JsonReader *reader) {
+    if (reader == NULL) {
+        return false;
+    }
+
+    return internal_id3JsonSkip(reader, 0);
+}
+
+/**
+ * @brief Checks that a document was read completely.
+ * @param reader - Reader to check.
+ * @return bool - true if nothing but whitespace follows the values read and no read failed, false otherwise.
+ */
+bool id3JsonReaderFinished(Id3JsonReader *reader) {
+    if (reader == NULL || reader->failed) {
+        return false;
+    }
+
+    return (internal_id3JsonPeek(reader) == 0 && reader->cursor >= reader->length);
+}
@@ -0,0 +1,529 @@
+/**
+ * @file id3Mpeg.c
+ * @author Ewan Jones
+ * @brief Function implementations for walking the MPEG audio frames that follow a tag and indexing them for seeking
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "id3Mpeg.h"
+#include "id3File.h"
+#include "id3dev.h"
+
+//! Most frames the seek frames can place between two seek points
+#define ID3_MPEG_MAX_STRIDE 0xFFFF
+
+//! Number of percentage entries in a Xing table of contents
+#define ID3_MPEG_XING_TOC_SIZE 100
+
+//! Xing flag set when the frame count is present
+#define ID3_MPEG_XING_FRAMES 0x01
+
+//! Xing flag set when the byte count is present
+#define ID3_MPEG_XING_BYTES 0x02
+
+//! Xing flag set when the table of contents is present
+#define ID3_MPEG_XING_TOC 0x04
+
+//! Offset of a VBRI header from the start of its frame
+#define ID3_MPEG_VBRI_OFFSET 36
+
+//! Size of a VBRI header before its table of contents
+#define ID3_MPEG_VBRI_HEADER_SIZE 26
+
+// bitrates in kbps indexed by [MPEG 1 layer 1, 2, 3, MPEG 2 and 2.5 layer 1, 2 and 3][bitrate index]
+static const uint16_t internal_id3MpegBitrates[5][15] = {
+        {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},
+        {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+        {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},
+        {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160}
+};
+
+// sample rates indexed by [MPEG 1, 2, 2.5][sample rate index]
+static const uint32_t internal_id3MpegSampleRates[3][3] = {
+        {44100, 48000, 32000},
+        {22050, 24000, 16000},
+        {11025, 12000, 8000}
+};
+
+// internal function ---
+static uint32_t internal_id3MpegRead32(const uint8_t *p) {
+    return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) | ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+// internal function ---
+static uint16_t internal_id3MpegRead16(const uint8_t *p) {
+    return (uint16_t) (((uint16_t) p[0] << 8) | p[1]);
+}
+
+// internal function ---
+// true if two frames belong to the same stream
+static bool internal_id3MpegSameStream(const Id3MpegFrameHeader *a, const Id3MpegFrameHeader *b) {
+    return a->version == b->version && a->layer == b->layer && a->sampleRate == b->sampleRate;
+}
+
+// internal function ---
+// finds the next frame at or after pos that matches ref, or any stream when ref is NULL, and is followed by
+// another frame of the same stream or the end of the audio. returns end when there is none
+static size_t internal_id3MpegSync(const uint8_t *data, size_t pos, size_t end, const Id3MpegFrameHeader *ref,
+                                   Id3MpegFrameHeader *header) {
+    Id3MpegFrameHeader next = {0};
+
+    for (; pos + ID3_MPEG_FRAME_HEADER_SIZE <= end; pos++) {
+        if (data[pos] != 0xFF || !id3MpegReadFrameHeader(data + pos, end - pos, header)) {
+            continue;
+        }
+
+        if ((ref != NULL && !internal_id3MpegSameStream(header, ref)) || header->size > end - pos) {
+            continue;
+        }
+
+        if (pos + header->size == end ||
+            (id3MpegReadFrameHeader(data + pos + header->size, end - pos - header->size, &next) &&
+             internal_id3MpegSameStream(header, &next))) {
+            return pos;
+        }
+    }
+
+    return end;
+}
+
+// internal function ---
+static bool internal_id3MpegPush(Id3MpegIndex *index, size_t *capacity, uint64_t offset) {
+    if (index->count == *capacity) {
+        size_t grown = (*capacity == 0) ? 256 : *capacity * 2;
+        uint64_t *offsets = realloc(index->offsets, grown * sizeof(uint64_t));
+
+        if (offsets == NULL) {
+            return false;
+        }
+
+        index->offsets = offsets;
+        *capacity = grown;
+    }
+
+    index->offsets[index->count++] = offset;
+    return true;
+}
+
+// internal function ---
+// frames between seek points interval milliseconds apart
+static uint32_t internal_id3MpegStride(const Id3MpegFrameHeader *header, uint32_t interval) {
+    uint64_t stride = ((uint64_t) ((interval == 0) ? ID3_MPEG_DEFAULT_INTERVAL : interval) * header->sampleRate) /
+                      ((uint64_t) header->samples * 1000);
+
+    if (stride == 0) {
+        return 1;
+    }
+
+    return (stride > ID3_MPEG_MAX_STRIDE) ? ID3_MPEG_MAX_STRIDE : (uint32_t) stride;
+}
+
+// internal function ---
+// allocates the offsets of an index whose frame count is known ahead of walking it
+static bool internal_id3MpegReserve(Id3MpegIndex *index) {
+    index->count = (index->frames == 0) ? 0 : (size_t) ((index->frames - 1) / index->stride + 1);
+
+    if (index->count == 0) {
+        return false;
+    }
+
+    index->offsets = calloc(index->count, sizeof(uint64_t));
+    return index->offsets != NULL;
+}
+
+// internal function ---
+// estimates the offsets from a Xing table of contents giving the position at each percent of the playing time
+// in 256ths of the stream, the stream including the Xing frame of size skip
+static bool internal_id3MpegFromXing(Id3MpegIndex *index, const uint8_t *toc, uint64_t bytes, uint32_t skip) {
+    if (!internal_id3MpegReserve(index)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < index->count; i++) {
+        double percent = (double) i * index->stride * ID3_MPEG_XING_TOC_SIZE / (double) index->frames;
+        size_t at = (size_t) percent;
+        double low = (at < ID3_MPEG_XING_TOC_SIZE) ? toc[at] : 256.0;
+        double high = (at + 1 < ID3_MPEG_XING_TOC_SIZE) ? toc[at + 1] : 256.0;
+        double position = (low + (high - low) * (percent - (double) at)) * (double) bytes / 256.0;
+        uint64_t offset = (position > skip) ? (uint64_t) position - skip : 0;
+
+        if (offset > index->length) {
+            offset = index->length;
+        }
+
+        // a table of contents is never meant to go backwards
+        if (i > 0 && offset < index->offsets[i - 1]) {
+            offset = index->offsets[i - 1];
+        }
+
+        index->offsets[i] = (i == 0) ? 0 : offset;
+    }
+
+    return true;
+}
+
+// internal function ---
+// estimates the offsets from a VBRI table of contents giving the size of each run of perEntry frames
+static bool internal_id3MpegFromVbri(Id3MpegIndex *index, const uint8_t *toc, uint16_t entries, uint16_t scale,
+                                     uint16_t entrySize, uint16_t perEntry) {
+    uint64_t position = 0;
+    uint64_t frame = 0;
+    size_t next = 0;
+
+    if (!internal_id3MpegReserve(index)) {
+        return false;
+    }
+
+    for (uint16_t e = 0; e < entries && next < index->count; e++) {
+        uint64_t size = 0;
+
+        for (uint16_t b = 0; b < entrySize; b++) {
+            size = (size << 8) | toc[(size_t) e * entrySize + b];
+        }
+
+        size *= scale;
+
+        while (next < index->count && (uint64_t) next * index->stride < frame + perEntry) {
+            index->offsets[next] = position + size * ((uint64_t) next * index->stride - frame) / perEntry;
+            next++;
+        }
+
+        position += size;
+        frame += perEntry;
+    }
+
+    for (; next < index->count; next++) {
+        index->offsets[next] = position;
+    }
+
+    for (size_t i = 0; i < index->count; i++) {
+        if (index->offsets[i] > index->length) {
+            index->offsets[i] = index->length;
+        }
+    }
+
+    return true;
+}
+
+// internal function ---
+// reads a Xing, Info or VBRI header from the first frame of a stream. returns 1 if the frame is such a header,
+// 2 if the index was also filled from its table of contents, 0 otherwise
+static int internal_id3MpegInfoFrame(const uint8_t *data, size_t pos, size_t end, const Id3MpegFrameHeader *header,
+                                     Id3MpegIndex *index, bool exact) {
+    size_t side = 0;
+    size_t frameEnd = pos + header->size;
+    const uint8_t *p = NULL;
+
+    if (header->version == 1) {
+        side = (header->channels == 1) ? 17 : 32;
+    } else {
+        side = (header->channels == 1) ? 9 : 17;
+    }
+
+    p = data + pos + ID3_MPEG_FRAME_HEADER_SIZE + side;
+
+    if (pos + ID3_MPEG_FRAME_HEADER_SIZE + side + 8 <= frameEnd &&
+        (memcmp(p, "Xing", 4) == 0 || memcmp(p, "Info", 4) == 0)) {
+        uint32_t flags = internal_id3MpegRead32(p + 4);
+        const uint8_t *toc = NULL;
+        uint64_t frames = 0;
+        uint64_t bytes = 0;
+        size_t need = 8;
+
+        need += (flags & ID3_MPEG_XING_FRAMES) ? 4 : 0;
+        need += (flags & ID3_MPEG_XING_BYTES) ? 4 : 0;
+        need += (flags & ID3_MPEG_XING_TOC) ? ID3_MPEG_XING_TOC_SIZE : 0;
+
+        if ((size_t) (p - data) + need > frameEnd) {
+            return 1;
+        }
+
+        p += 8;
+
+        if (flags & ID3_MPEG_XING_FRAMES) {
+            frames = internal_id3MpegRead32(p);
+            p += 4;
+        }
+
+        if (flags & ID3_MPEG_XING_BYTES) {
+            bytes = internal_id3MpegRead32(p);
+            p += 4;
+        }
+
+        if (flags & ID3_MPEG_XING_TOC) {
+            toc = p;
+        }
+
+        // every frame takes at least a header, so a larger count is damaged
+        if (exact || toc == NULL || frames == 0 || frames > (end - pos) / ID3_MPEG_FRAME_HEADER_SIZE) {
+            return 1;
+        }
+
+        if (bytes == 0 || bytes > end - pos) {
+            bytes = end - pos;
+        }
+
+        index->frames = frames;
+        index->length = (bytes > header->size) ? bytes - header->size : 0;
+        return internal_id3MpegFromXing(index, toc, bytes, header->size) ? 2 : 1;
+    }
+
+    p = data + pos + ID3_MPEG_VBRI_OFFSET;
+
+    if (pos + ID3_MPEG_VBRI_OFFSET + ID3_MPEG_VBRI_HEADER_SIZE <= end && memcmp(p, "VBRI", 4) == 0) {
+        uint64_t bytes = internal_id3MpegRead32(p + 10);
+        uint64_t frames = internal_id3MpegRead32(p + 14);
+        uint16_t entries = internal_id3MpegRead16(p + 18);
+        uint16_t scale = internal_id3MpegRead16(p + 20);
+        uint16_t entrySize = internal_id3MpegRead16(p + 22);
+        uint16_t perEntry = internal_id3MpegRead16(p + 24);
+
+        if (exact || frames == 0 || frames > (end - pos) / ID3_MPEG_FRAME_HEADER_SIZE || entries == 0 ||
+            entrySize == 0 || entrySize > 4 || perEntry == 0 ||
+            pos + ID3_MPEG_VBRI_OFFSET + ID3_MPEG_VBRI_HEADER_SIZE + (size_t) entries * entrySize > end) {
+            return 1;
+        }
+
+        if (bytes == 0 || bytes > end - pos) {
+            bytes = end - pos;
+        }
+
+        index->frames = frames;
+        index->length = (bytes > header->size) ? bytes - header->size : 0;
+        return internal_id3MpegFromVbri(index, p + ID3_MPEG_VBRI_HEADER_SIZE, entries, scale, entrySize, perEntry)
+                   ? 2
+                   : 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Reads the header of an MPEG audio frame.
+ * @details Accepts layer 1, 2 and 3 frames of MPEG 1, 2 and 2.5. Free format frames and frames with reserved
+ * values are rejected, as their size cannot be worked out from the header.
+ * @param bytes - Bytes starting at the frame.
+ * @param length - Number of bytes available, at least ID3_MPEG_FRAME_HEADER_SIZE are needed.
+ * @param header - Receives the fields of the header.
+ * @return bool - true if bytes start with a usable frame header, false otherwise.
+ */
+bool id3MpegReadFrameHeader(const uint8_t *bytes, size_t length, Id3MpegFrameHeader *header) {
+    if (bytes == NULL || header == NULL || length < ID3_MPEG_FRAME_HEADER_SIZE) {
+        return false;
+    }
+
+    uint8_t versionBits = (bytes[1] >> 3) & 0x03;
+    uint8_t layerBits = (bytes[1] >> 1) & 0x03;
+    uint8_t bitrateIndex = (bytes[2] >> 4) & 0x0F;
+    uint8_t rateIndex = (bytes[2] >> 2) & 0x03;
+    uint32_t padding = (bytes[2] >> 1) & 0x01;
+    int table = 0;
+
+    // sync, reserved version and layer, free format and bad bitrate, reserved sample rate
+    if (bytes[0] != 0xFF || (bytes[1] & 0xE0) != 0xE0 || versionBits == 1 || layerBits == 0 || bitrateIndex == 0 ||
+        bitrateIndex == 0x0F || rateIndex == 3) {
+        return false;
+    }
+
+    header->version = (versionBits == 3) ? 1 : ((versionBits == 2) ? 2 : ID3_MPEG_VERSION_2_5);
+    header->layer = (uint8_t) (4 - layerBits);
+    header->channels = (((bytes[3] >> 6) & 0x03) == 3) ? 1 : 2;
+
+    if (header->version == 1) {
+        table = header->layer - 1;
+        header->sampleRate = internal_id3MpegSampleRates[0][rateIndex];
+    } else {
+        table = (header->layer == 1) ? 3 : 4;
+        header->sampleRate = internal_id3MpegSampleRates[(header->version == 2) ? 1 : 2][rateIndex];
+    }
+
+    header->bitrate = (uint32_t) internal_id3MpegBitrates[table][bitrateIndex] * 1000;
+
+    switch (header->layer) {
+        case 1:
+            header->samples = 384;
+            header->size = (12 * header->bitrate / header->sampleRate + padding) * 4;
+            break;
+        case 2:
+            header->samples = 1152;
+            header->size = 144 * header->bitrate / header->sampleRate + padding;
+            break;
+        default:
+            header->samples = (header->version == 1) ? 1152 : 576;
+            header->size = ((header->version == 1) ? 144 : 72) * header->bitrate / header->sampleRate + padding;
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Indexes the MPEG audio frames of a file held in memory.
+ * @details The frames between the tags found by id3AudioRangeFromBuffer are walked from the first frame, which
+ * must be followed by another frame of the same stream so stray sync bytes are not mistaken for audio. Damaged data
+ * is skipped by searching for the next frame. A Xing, Info or VBRI header in the first frame is not counted as
+ * audio. Unless exact is set, a Xing or VBRI table of contents is used instead of walking every frame, which only
+ * reads the first frame but places the seek points less precisely.
+ * @param buffer - Bytes of the file.
+ * @param size - Number of bytes in buffer.
+ * @param interval - Milliseconds between seek points, 0 for ID3_MPEG_DEFAULT_INTERVAL.
+ * @param exact - Walk every frame even when a table of contents is present.
+ * @return Id3MpegIndex* - Index of the stream, or NULL if no MPEG audio was found or memory ran out. Caller must
+ * free with id3MpegDestroyIndex.
+ */
+Id3MpegIndex *id3MpegIndexFromBuffer(const uint8_t *buffer, size_t size, uint32_t interval, bool exact) {
+    uint64_t start = 0;
+    uint64_t end = 0;
+
+    if (buffer == NULL || !id3AudioRangeFromBuffer(buffer, size, &start, &end)) {
+        return NULL;
+    }
+
+    Id3MpegIndex *index = NULL;
+    Id3MpegFrameHeader first = {0};
+    Id3MpegFrameHeader header = {0};
+    size_t pos = internal_id3MpegSync(buffer, (size_t) start, (size_t) end, NULL, &first);
+    size_t last = 0;
+    size_t capacity = 0;
+    int info = 0;
+
+    if (pos >= end) {
+        return NULL;
+    }
+
+    index = calloc(1, sizeof(Id3MpegIndex));
+
+    if (index == NULL) {
+        return NULL;
+    }
+
+    index->samplesPerFrame = first.samples;
+    index->sampleRate = first.sampleRate;
+    index->stride = internal_id3MpegStride(&first, interval);
+
+    info = internal_id3MpegInfoFrame(buffer, pos, (size_t) end, &first, index, exact);
+
+    if (info == 2) {
+        index->start = pos + first.size;
+        index->estimated = true;
+        return index;
+    }
+
+    free(index->offsets);
+    index->offsets = NULL;
+    index->count = 0;
+    index->frames = 0;
+    index->length = 0;
+
+    if (info == 1) {
+        pos += first.size;
+    }
+
+    index->start = pos;
+    last = pos;
+
+    while (pos < end) {
+        if (!id3MpegReadFrameHeader(buffer + pos, (size_t) end - pos, &header) ||
+            !internal_id3MpegSameStream(&header, &first) || header.size > end - pos) {
+            pos = internal_id3MpegSync(buffer, pos + 1, (size_t) end, &first, &header);
+            continue;
+        }
+
+        if (index->frames % index->stride == 0 && !internal_id3MpegPush(index, &capacity, pos - index->start)) {
+            id3MpegDestroyIndex(&index);
+            return NULL;
+        }
+
+        index->frames++;
+        pos += header.size;
+        last = pos;
+    }
+
+    index->length = last - index->start;
+
+    if (index->frames == 0) {
+        id3MpegDestroyIndex(&index);
+    }
+
+    return index;
+}
+
+/**
+ * @brief Indexes the MPEG audio frames of a file.
+ * @details The file is mapped into memory and indexed as id3MpegIndexFromBuffer describes, only the pages holding
+ * frame headers are read from disk.
+ * @param filePath - Null-terminated string containing the path to the file.
+ * @param interval - Milliseconds between seek points, 0 for ID3_MPEG_DEFAULT_INTERVAL.
+ * @param exact - Walk every frame even when a table of contents is present.
+ * @return Id3MpegIndex* - Index of the stream, or NULL if the file could not be read, no MPEG audio was found, or
+ * memory ran out. Caller must free with id3MpegDestroyIndex.
+ */
+Id3MpegIndex *id3MpegIndexFromFile(const char *filePath, uint32_t interval, bool exact) {
+    Id3FileMapping mapping = {0};
+    Id3MpegIndex *index = NULL;
+
+    if (filePath == NULL || !id3FileMap(filePath, &mapping)) {
+        return NULL;
+    }
+
+    index = id3MpegIndexFromBuffer(mapping.data, mapping.length, interval, exact);
+    id3FileUnmap(&mapping);
+
+    return index;
+}
+
+/**
+ * @brief Frees an index and sets its pointer to NULL.
+ * @param toDelete - Pointer to the index to free.
+ */
+void id3MpegDestroyIndex(Id3MpegIndex **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free((*toDelete)->offsets);
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Works out the playing time of an indexed stream.
+ * @param index - Index of the stream.
+ * @return uint64_t - Playing time in milliseconds, 0 if index is NULL.
+ */
+uint64_t id3MpegIndexDuration(const Id3MpegIndex *index) {
+    if (index == NULL || index->sampleRate == 0) {
+        return 0;
+    }
+
+    return index->frames * index->samplesPerFrame * 1000 / index->sampleRate;
+}
+
+/**
+ * @brief Finds where a frame starts in an indexed stream.
+ * @details Frames between two entries of the index are placed in proportion to their position between them.
+ * @param index - Index of the stream.
+ * @param frame - Number of the frame, counting from 0.
+ * @return uint64_t - Offset of the frame from the first audio frame, or the length of the stream for frames past
+ * its end.
+ */
+uint64_t id3MpegIndexOffsetAt(const Id3MpegIndex *index, uint64_t frame) {
+    if (index == NULL || index->count == 0 || frame >= index->frames) {
+        return (index != NULL) ? index->length : 0;
+    }
+
+    uint64_t entry = frame / index->stride;
+    uint64_t from = entry * index->stride;
+    uint64_t to = (entry + 1 < index->count) ? from + index->stride : index->frames;
+    uint64_t low = index->offsets[entry];
+    uint64_t high = (entry + 1 < index->count) ? index->offsets[entry + 1] : index->length;
+
+    return low + (high - low) * (frame - from) / (to - from);
+}
@@ -0,0 +1,1421 @@
+/**
+ * @file id3Scan.c
+ * @author Ewan Jones
+ * @brief Implementation of reading and editing the tags of many files at once across worker threads
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+// directory walking, lstat, and sysconf
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#ifndef _FILE_OFFSET_BITS
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(ID3_HAVE_LIBURING)
+#include <errno.h>
+#include <fcntl.h>
+#include <liburing.h>
+#include <sys/resource.h>
+
+//! Descriptors the io_uring reader leaves free for the rest of the process when sizing its queue
+#define ID3_SCAN_FD_RESERVE 64
+#endif
+
+#include "id3Scan.h"
+#include "id3File.h"
+#include "id3v1/id3v1Parser.h"
+#include "id3v2/id3v2Parser.h"
+#include "id3v2/id3v2TagIdentity.h"
+
+#if defined(_WIN32)
+typedef CRITICAL_SECTION Id3ScanLock;
+typedef CONDITION_VARIABLE Id3ScanCond;
+#define ID3_SCAN_SEPARATOR '\\'
+#else
+typedef pthread_mutex_t Id3ScanLock;
+typedef pthread_cond_t Id3ScanCond;
+#define ID3_SCAN_SEPARATOR '/'
+#endif
+
+// range of paths a worker has left to read, other workers steal from its end
+typedef struct _Id3ScanQueue {
+    Id3ScanLock lock;
+    size_t begin;
+    size_t end;
+} Id3ScanQueue;
+
+// everything the workers of one scan share
+typedef struct _Id3ScanState {
+    const char *const *filePaths;
+    size_t count;
+    uint8_t tags;
+    bool ordered;
+    const Id3Options *options;
+    Id3ScanCallback callback;
+    void *userData;
+
+    Id3ScanQueue *queues;
+    size_t workers;
+
+    // held while a result is delivered so callbacks never overlap
+    Id3ScanLock deliver;
+    ID3 **results;
+    bool *ready;
+    size_t next;
+
+    // an ordered scan hands out files in path order and none at or beyond next + window, results are held in a ring
+    // of window entries. a worker waits on delivered until delivery catches up
+    size_t window;
+    size_t taken;
+    Id3ScanCond delivered;
+
+    // set when editing instead of reading, see id3EditFiles
+    const Id3Edit *edits;
+    Id3EditCallback editCallback;
+    size_t done;
+
+    // bytes of tags held by the workers of an edit, a worker waits on released once the limit would be passed
+    Id3ScanLock budget;
+    Id3ScanCond released;
+    size_t memoryLimit;
+    size_t memoryUsed;
+} Id3ScanState;
+
+// argument given to each worker thread
+typedef struct _Id3ScanWorker {
+    Id3ScanState *state;
+    size_t index;
+} Id3ScanWorker;
+
+// paths found by a directory walk
+typedef struct _Id3ScanPaths {
+    char **paths;
+    size_t count;
+    size_t capacity;
+} Id3ScanPaths;
+
+// internal function ------------------------------------------------------------------------
+#if defined(_WIN32)
+static void internal_scanLockInit(Id3ScanLock *lock) {
+    InitializeCriticalSection(lock);
+}
+
+static void internal_scanLock(Id3ScanLock *lock) {
+    EnterCriticalSection(lock);
+}
+
+static void internal_scanUnlock(Id3ScanLock *lock) {
+    LeaveCriticalSection(lock);
+}
+
+static void internal_scanLockDestroy(Id3ScanLock *lock) {
+    DeleteCriticalSection(lock);
+}
+
+static void internal_scanCondInit(Id3ScanCond *cond) {
+    InitializeConditionVariable(cond);
+}
+
+static void internal_scanWait(Id3ScanCond *cond, Id3ScanLock *lock) {
+    (void) SleepConditionVariableCS(cond, lock, INFINITE);
+}
+
+static void internal_scanWakeAll(Id3ScanCond *cond) {
+    WakeAllConditionVariable(cond);
+}
+
+static void internal_scanCondDestroy(Id3ScanCond *cond) {
+    // nothing to release
+    (void) cond;
+}
+
+static size_t internal_scanProcessors(void) {
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+    return (size_t) info.dwNumberOfProcessors;
+}
+#else
+static void internal_scanLockInit(Id3ScanLock *lock) {
+    (void) pthread_mutex_init(lock, NULL);
+}
+
+static void internal_scanLock(Id3ScanLock *lock) {
+    (void) pthread_mutex_lock(lock);
+}
+
+static void internal_scanUnlock(Id3ScanLock *lock) {
+    (void) pthread_mutex_unlock(lock);
+}
+
+static void internal_scanLockDestroy(Id3ScanLock *lock) {
+    (void) pthread_mutex_destroy(lock);
+}
+
+static void internal_scanCondInit(Id3ScanCond *cond) {
+    (void) pthread_cond_init(cond, NULL);
+}
+
+static void internal_scanWait(Id3ScanCond *cond, Id3ScanLock *lock) {
+    (void) pthread_cond_wait(cond, lock);
+}
+
+static void internal_scanWakeAll(Id3ScanCond *cond) {
+    (void) pthread_cond_broadcast(cond);
+}
+
+static void internal_scanCondDestroy(Id3ScanCond *cond) {
+    (void) pthread_cond_destroy(cond);
+}
+
+static size_t internal_scanProcessors(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (n > 0) ? (size_t) n : 1;
+}
+#endif
+
+// internal function ---
+// true if an ordered scan can start reading item without holding more results than its window allows
+static bool internal_scanAdmits(const Id3ScanState *state, size_t item) {
+    return item < state->count && (!state->ordered || item - state->next < state->window);
+}
+
+// internal function ---
+// takes the next path for a worker, stealing the back half of another worker's range once its own is empty. an
+// ordered scan hands out paths in order instead, waiting while the next one is outside the reorder window
+static bool internal_scanTake(Id3ScanState *state, size_t index, size_t *item) {
+    Id3ScanQueue *own = &state->queues[index];
+    bool taken = false;
+
+    // every path before the one waited for is already being read, so the next to deliver always arrives
+    if (state->ordered) {
+        internal_scanLock(&state->deliver);
+
+        while (state->taken < state->count && !internal_scanAdmits(state, state->taken)) {
+            internal_scanWait(&state->delivered, &state->deliver);
+        }
+
+        taken = (state->taken < state->count);
+        *item = state->taken;
+        state->taken += (taken) ? 1 : 0;
+
+        internal_scanUnlock(&state->deliver);
+        return taken;
+    }
+
+    internal_scanLock(&own->lock);
+
+    if (own->begin < own->end) {
+        *item = own->begin++;
+        internal_scanUnlock(&own->lock);
+        return true;
+    }
+
+    internal_scanUnlock(&own->lock);
+
+    for (size_t i = 1; i < state->workers; i++) {
+        Id3ScanQueue *victim = &state->queues[(index + i) % state->workers];
+        size_t begin = 0;
+        size_t end = 0;
+
+        internal_scanLock(&victim->lock);
+
+        if (victim->begin < victim->end) {
+            end = victim->end;
+            begin = victim->end - (victim->end - victim->begin + 1) / 2;
+            victim->end = begin;
+        }
+
+        internal_scanUnlock(&victim->lock);
+
+        if (begin < end) {
+            // nothing can be stolen from an empty range so no other worker touches it in the meantime
+            internal_scanLock(&own->lock);
+            own->begin = begin + 1;
+            own->end = end;
+            internal_scanUnlock(&own->lock);
+
+            *item = begin;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// internal function ---
+// reads the selected tags of a file, the ID3v2 tag is read into a buffer kept by the worker
+static ID3 *internal_scanRead(const Id3ScanState *state, Id3v2Parser *parser, uint8_t **buffer, size_t *bufferSize,
+                              const char *filePath) {
+    Id3FileLayout layout;
+    Id3v2Tag *id3v2 = NULL;
+    Id3v1Tag *id3v1 = NULL;
+    ID3 *metadata = NULL;
+    uint8_t id3v1Bytes[ID3V1_MAX_SIZE];
+    int fd = id3FileOpen(filePath, false);
+
+    if (fd >= 0 && id3FileReadLayout(fd, &layout)) {
+        if ((state->tags & ID3_SCAN_ID3V2) && layout.id3v2Size > 0 && layout.id3v2Size <= SIZE_MAX) {
+            size_t size = (size_t) layout.id3v2Size;
+
+            if (*bufferSize < size) {
+                uint8_t *tmp = realloc(*buffer, size);
+
+                if (tmp != NULL) {
+                    *buffer = tmp;
+                    *bufferSize = size;
+                }
+            }
+
+            if (*bufferSize >= size && id3FileReadAt(fd, *buffer, size, 0)) {
+                if (parser != NULL) {
+                    id3v2 = id3v2ParserParse(parser, *buffer, size);
+                } else {
+                    id3v2 = id3v2ParseTagFromBuffer(*buffer, size,
+                                                    (state->options != NULL) ? state->options->userPairs : NULL);
+                }
+            }
+        }
+
+        if ((state->tags & ID3_SCAN_ID3V1) && layout.fileSize >= ID3V1_MAX_SIZE &&
+            id3FileReadAt(fd, id3v1Bytes, ID3V1_MAX_SIZE, layout.fileSize - ID3V1_MAX_SIZE)) {
+            id3v1 = id3v1TagFromBuffer(id3v1Bytes);
+        }
+    }
+
+    id3FileClose(fd);
+
+    metadata = id3CreateWithOptions(id3v2, id3v1, state->options);
+
+    if (metadata == NULL) {
+        id3v2DestroyTag(&id3v2);
+        id3v1DestroyTag(&id3v1);
+    }
+
+    return metadata;
+}
+
+// internal function ---
+// hands a result to the callback, in path order when asked for
+static void internal_scanDeliver(Id3ScanState *state, size_t item, ID3 *metadata) {
+    internal_scanLock(&state->deliver);
+
+    if (!state->ordered) {
+        state->callback(state->filePaths[item], metadata, state->userData);
+        internal_scanUnlock(&state->deliver);
+        return;
+    }
+
+    // items in the window never share a slot of the ring
+    state->results[item % state->window] = metadata;
+    state->ready[item % state->window] = true;
+
+    while (state->next < state->count && state->ready[state->next % state->window]) {
+        size_t slot = state->next % state->window;
+
+        state->callback(state->filePaths[state->next], state->results[slot], state->userData);
+        state->results[slot] = NULL;
+        state->ready[slot] = false;
+        state->next++;
+    }
+
+    internal_scanWakeAll(&state->delivered);
+    internal_scanUnlock(&state->deliver);
+}
+
+// functions writing each field of an edit set, indexed by Id3EditField
+static int (*const internal_editWriters[ID3_EDIT_FIELD_COUNT])(const char *, ID3 *) = {
+    id3WriteTitle,
+    id3WriteArtist,
+    id3WriteAlbumArtist,
+    id3WriteAlbum,
+    id3WriteYear,
+    id3WriteGenre,
+    id3WriteTrack,
+    id3WriteDisc,
+    id3WriteComposer,
+    id3WriteLyrics,
+    id3WriteComment
+};
+
+// internal function ---
+// bytes a file is expected to hold while it is edited, its tags as read, parsed, and serialized again
+static size_t internal_editCost(const Id3FileLayout *layout) {
+    uint64_t cost = layout->id3v2Size * 3 + ID3V1_MAX_SIZE * 2;
+
+    return (cost > SIZE_MAX) ? SIZE_MAX : (size_t) cost;
+}
+
+// internal function ---
+// waits until cost more bytes fit the memory limit. a worker is never made to wait while nothing is held, so a file
+// larger than the limit is still edited but alone
+static void internal_editReserve(Id3ScanState *state, size_t cost) {
+    if (state->memoryLimit == 0) {
+        return;
+    }
+
+    internal_scanLock(&state->budget);
+
+    while (state->memoryUsed > 0 &&
+           (cost > state->memoryLimit || state->memoryUsed > state->memoryLimit - cost)) {
+        internal_scanWait(&state->released, &state->budget);
+    }
+
+    state->memoryUsed += cost;
+    internal_scanUnlock(&state->budget);
+}
+
+// internal function ---
+// gives back bytes taken by internal_editReserve
+static void internal_editRelease(Id3ScanState *state, size_t cost) {
+    if (state->memoryLimit == 0) {
+        return;
+    }
+
+    internal_scanLock(&state->budget);
+    state->memoryUsed -= cost;
+    internal_scanWakeAll(&state->released);
+    internal_scanUnlock(&state->budget);
+}
+
+// internal function ---
+// reads, changes, and writes back the tags of one file
+static Id3EditStatus internal_editFile(Id3ScanState *state, Id3v2Parser *parser, const Id3Edit *edit) {
+    Id3FileLayout layout;
+    Id3EditStatus status = written_edit;
+    ID3 *metadata = NULL;
+    uint8_t *buffer = NULL;
+    size_t bufferSize = 0;
+    size_t cost = 0;
+    int fd = id3FileOpen(edit->filePath, false);
+    bool ok = (fd >= 0 && id3FileReadLayout(fd, &layout));
+
+    id3FileClose(fd);
+
+    if (!ok) {
+        return readFailed_edit;
+    }
+
+    cost = internal_editCost(&layout);
+    internal_editReserve(state, cost);
+
+    // the read buffer is not kept between files so a worker holds no more than it reserved
+    metadata = internal_scanRead(state, parser, &buffer, &bufferSize, edit->filePath);
+    free(buffer);
+
+    if (metadata == NULL) {
+        status = readFailed_edit;
+    } else if (metadata->id3v1 == NULL && metadata->id3v2 == NULL) {
+        status = noTag_edit;
+    } else {
+        for (size_t i = 0; i < ID3_EDIT_FIELD_COUNT && edit->edits != NULL && status == written_edit; i++) {
+            if (edit->edits->values[i] != NULL && !internal_editWriters[i](edit->edits->values[i], metadata)) {
+                status = applyFailed_edit;
+            }
+        }
+
+        if (status == written_edit && !id3WriteToFile(edit->filePath, metadata)) {
+            status = writeFailed_edit;
+        }
+    }
+
+    id3Destroy(&metadata);
+    internal_editRelease(state, cost);
+    return status;
+}
+
+// internal function ---
+// reports the outcome of an edit to the callback
+static void internal_editDeliver(Id3ScanState *state, size_t item, Id3EditStatus status) {
+    internal_scanLock(&state->deliver);
+    state->done++;
+
+    if (state->editCallback != NULL) {
+        state->editCallback(state->edits[item].filePath, status, state->done, state->count, state->userData);
+    }
+
+    internal_scanUnlock(&state->deliver);
+}
+
+// internal function ---
+// body of every worker, each keeps its own parser and read buffer
+static void internal_scanWork(Id3ScanWorker *worker) {
+    Id3ScanState *state = worker->state;
+    Id3v2Parser *parser = NULL;
+    uint8_t *buffer = NULL;
+    size_t bufferSize = 0;
+    size_t item = 0;
+
+    if (state->tags & ID3_SCAN_ID3V2) {
+        parser = id3v2CreateParser((state->options != NULL) ? state->options->userPairs : NULL);
+    }
+
+    while (internal_scanTake(state, worker->index, &item)) {
+        if (state->edits != NULL) {
+            internal_editDeliver(state, item, internal_editFile(state, parser, &state->edits[item]));
+        } else {
+            internal_scanDeliver(state, item,
+                                 internal_scanRead(state, parser, &buffer, &bufferSize, state->filePaths[item]));
+        }
+    }
+
+    id3v2DestroyParser(&parser);
+    free(buffer);
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI internal_scanThread(LPVOID arg) {
+    internal_scanWork((Id3ScanWorker *) arg);
+    return 0;
+}
+#else
+static void *internal_scanThread(void *arg) {
+    internal_scanWork((Id3ScanWorker *) arg);
+    return NULL;
+}
+#endif
+
+// internal function ---
+// splits the items of a state evenly between n workers. NULL on memory allocation failure
+static Id3ScanWorker *internal_scanStart(Id3ScanState *state, size_t n) {
+    Id3ScanWorker *workers = calloc(n, sizeof(Id3ScanWorker));
+
+    state->workers = n;
+    state->queues = calloc(n, sizeof(Id3ScanQueue));
+
+    if (state->queues == NULL || workers == NULL) {
+        free(state->queues);
+        free(workers);
+        state->queues = NULL;
+        return NULL;
+    }
+
+    internal_scanLockInit(&state->deliver);
+    internal_scanLockInit(&state->budget);
+    internal_scanCondInit(&state->released);
+    internal_scanCondInit(&state->delivered);
+
+    for (size_t i = 0; i < n; i++) {
+        internal_scanLockInit(&state->queues[i].lock);
+        state->queues[i].begin = (state->count / n) * i + ((i < state->count % n) ? i : state->count % n);
+        state->queues[i].end = state->queues[i].begin + (state->count / n) + ((i < state->count % n) ? 1 : 0);
+
+        workers[i].state = state;
+        workers[i].index = i;
+    }
+
+    return workers;
+}
+
+// internal function ---
+// runs every worker with the calling thread as the first and waits for them to finish. a worker that fails to start
+// leaves its share to be stolen by the rest
+static void internal_scanRun(Id3ScanState *state, Id3ScanWorker *workers) {
+    size_t started = 0;
+#if defined(_WIN32)
+    HANDLE *threads = calloc(state->workers, sizeof(HANDLE));
+#else
+    pthread_t *threads = calloc(state->workers, sizeof(pthread_t));
+#endif
+
+    for (size_t i = 1; i < state->workers && threads != NULL; i++) {
+#if defined(_WIN32)
+        threads[started] = CreateThread(NULL, 0, internal_scanThread, &workers[i], 0, NULL);
+
+        if (threads[started] != NULL) {
+            started++;
+        }
+#else
+        if (pthread_create(&threads[started], NULL, internal_scanThread, &workers[i]) == 0) {
+            started++;
+        }
+#endif
+    }
+
+    internal_scanWork(&workers[0]);
+
+    for (size_t i = 0; i < started; i++) {
+#if defined(_WIN32)
+        (void) WaitForSingleObject(threads[i], INFINITE);
+        (void) CloseHandle(threads[i]);
+#else
+        (void) pthread_join(threads[i], NULL);
+#endif
+    }
+
+    free(threads);
+}
+
+// internal function ---
+// releases what internal_scanStart set up
+static void internal_scanStop(Id3ScanState *state, Id3ScanWorker *workers) {
+    for (size_t i = 0; i < state->workers; i++) {
+        internal_scanLockDestroy(&state->queues[i].lock);
+    }
+
+    internal_scanCondDestroy(&state->delivered);
+    internal_scanCondDestroy(&state->released);
+    internal_scanLockDestroy(&state->budget);
+    internal_scanLockDestroy(&state->deliver);
+
+    free(state->queues);
+    free(workers);
+    state->queues = NULL;
+}
+
+#if defined(ID3_HAVE_LIBURING)
+// step a file read by the io_uring reader is waiting on
+typedef enum _Id3ScanStage {
+    open_stage,
+    header_stage,
+    tag_stage,
+    tail_stage,
+    close_stage
+} Id3ScanStage;
+
+// the ring of the io_uring reader and the number of operations queued on it so far
+typedef struct _Id3ScanRing {
+    struct io_uring ring;
+    uint64_t queued;
+} Id3ScanRing;
+
+// a file in flight with the io_uring reader, a slot is reused for the next file once one is delivered
+typedef struct _Id3ScanSlot {
+    size_t item;
+    bool active;
+
+    // the open failed for want of descriptors and is retried once another file is closed
+    bool waiting;
+    Id3ScanStage stage;
+    int fd;
+
+    // value of queued before the slot's latest operation
+    uint64_t sequence;
+    uint64_t fileSize;
+
+    // read in progress, continued until want bytes are done
+    uint8_t *target;
+    size_t want;
+    size_t done;
+    uint64_t offset;
+
+    uint8_t header[ID3V2_TAG_HEADER_SIZE];
+    uint8_t tail[ID3V1_MAX_SIZE];
+    uint8_t *buffer;
+    size_t bufferSize;
+
+    Id3v2Tag *id3v2;
+    Id3v1Tag *id3v1;
+} Id3ScanSlot;
+
+// internal function ---
+// true if the kernel supports every operation the reader submits
+static bool internal_scanUringProbe(struct io_uring *ring) {
+    struct io_uring_probe *probe = io_uring_get_probe_ring(ring);
+    bool ok = false;
+
+    if (probe == NULL) {
+        return false;
+    }
+
+    ok = io_uring_opcode_supported(probe, IORING_OP_OPENAT) && io_uring_opcode_supported(probe, IORING_OP_READ) &&
+         io_uring_opcode_supported(probe, IORING_OP_CLOSE);
+
+    io_uring_free_probe(probe);
+    return ok;
+}
+
+// internal function ---
+// queues the operation of the slot's stage, an entry is always free because each slot has one operation in flight
+static void internal_scanUringQueue(Id3ScanRing *ring, const Id3ScanState *state, Id3ScanSlot *slot, size_t index) {
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&ring->ring);
+
+    switch (slot->stage) {
+        case open_stage:
+            io_uring_prep_openat(sqe, AT_FDCWD, state->filePaths[slot->item], O_RDONLY | O_CLOEXEC, 0);
+            break;
+        case close_stage:
+            io_uring_prep_close(sqe, slot->fd);
+            break;
+        default:
+            io_uring_prep_read(sqe, slot->fd, slot->target + slot->done, (unsigned) (slot->want - slot->done),
+                               slot->offset + slot->done);
+            break;
+    }
+
+    io_uring_sqe_set_data(sqe, (void *) (uintptr_t) index);
+    slot->sequence = ring->queued++;
+}
+
+// internal function ---
+static void internal_scanUringRead(Id3ScanRing *ring, const Id3ScanState *state, Id3ScanSlot *slot, size_t index,
+                                   Id3ScanStage stage, uint8_t *target, size_t want, uint64_t offset) {
+    slot->stage = stage;
+    slot->target = target;
+    slot->want = want;
+    slot->done = 0;
+    slot->offset = offset;
+    internal_scanUringQueue(ring, state, slot, index);
+}
+
+// internal function ---
+// reads the ID3v1 tail when asked for, otherwise closes the file
+static void internal_scanUringTail(Id3ScanRing *ring, const Id3ScanState *state, Id3ScanSlot *slot, size_t index) {
+    if ((state->tags & ID3_SCAN_ID3V1) && slot->fileSize >= ID3V1_MAX_SIZE) {
+        internal_scanUringRead(ring, state, slot, index, tail_stage, slot->tail, ID3V1_MAX_SIZE,
+                               slot->fileSize - ID3V1_MAX_SIZE);
+        return;
+    }
+
+    slot->stage = close_stage;
+    internal_scanUringQueue(ring, state, slot, index);
+}
+
+// internal function ---
+// size of the complete ID3v2 tag a header describes, 0 when it does not describe one that fits in the file
+static size_t internal_scanUringTagSize(const Id3ScanSlot *slot) {
+    uint64_t size = id3FileTagSize(slot->header, false);
+
+    return (size <= slot->fileSize && size <= SIZE_MAX) ? (size_t) size : 0;
+}
+
+// internal function ---
+// handles the completion of a slot's operation and queues the next one. false once the file has been delivered
+static bool internal_scanUringAdvance(Id3ScanRing *ring, Id3ScanState *state, Id3v2Parser *parser, Id3ScanSlot *slot,
+                                      size_t index, int res) {
+    ID3 *metadata = NULL;
+    size_t size = 0;
+
+    switch (slot->stage) {
+        case open_stage:
+            if (res < 0) {
+                slot->fd = -1;
+                break;
+            }
+
+            slot->fd = res;
+
+            if (!id3FileSize(slot->fd, &slot->fileSize)) {
+                slot->stage = close_stage;
+                internal_scanUringQueue(ring, state, slot, index);
+                return true;
+            }
+
+            if ((state->tags & ID3_SCAN_ID3V2) && slot->fileSize >= ID3V2_TAG_HEADER_SIZE) {
+                internal_scanUringRead(ring, state, slot, index, header_stage, slot->header, ID3V2_TAG_HEADER_SIZE, 0);
+            } else {
+                internal_scanUringTail(ring, state, slot, index);
+            }
+
+            return true;
+
+        case header_stage:
+        case tag_stage:
+        case tail_stage:
+            if (res > 0) {
+                slot->done += (size_t) res;
+
+                // short read, ask for the rest
+                if (slot->done < slot->want) {
+                    internal_scanUringQueue(ring, state, slot, index);
+                    return true;
+                }
+            }
+
+            if (slot->stage == header_stage) {
+                if (slot->done == slot->want && memcmp(slot->header, "ID3", ID3V2_TAG_ID_SIZE) == 0 &&
+                    (size = internal_scanUringTagSize(slot)) > 0) {
+                    if (slot->bufferSize < size) {
+                        uint8_t *tmp = realloc(slot->buffer, size);
+
+                        if (tmp != NULL) {
+                            slot->buffer = tmp;
+                            slot->bufferSize = size;
+                        }
+                    }
+
+                    if (slot->bufferSize >= size) {
+                        internal_scanUringRead(ring, state, slot, index, tag_stage, slot->buffer, size, 0);
+                        return true;
+                    }
+                }
+
+                internal_scanUringTail(ring, state, slot, index);
+                return true;
+            }
+
+            if (slot->stage == tag_stage) {
+                if (slot->done == slot->want) {
+                    if (parser != NULL) {
+                        slot->id3v2 = id3v2ParserParse(parser, slot->buffer, slot->want);
+                    } else {
+                        slot->id3v2 = id3v2ParseTagFromBuffer(slot->buffer, slot->want,
+                                                              (state->options != NULL) ? state->options->userPairs
+                                                                                       : NULL);
+                    }
+                }
+
+                internal_scanUringTail(ring, state, slot, index);
+                return true;
+            }
+
+            if (slot->done == slot->want) {
+                slot->id3v1 = id3v1TagFromBuffer(slot->tail);
+            }
+
+            slot->stage = close_stage;
+            internal_scanUringQueue(ring, state, slot, index);
+            return true;
+
+        case close_stage:
+        default:
+            break;
+    }
+
+    metadata = id3CreateWithOptions(slot->id3v2, slot->id3v1, state->options);
+
+    if (metadata == NULL) {
+        id3v2DestroyTag(&slot->id3v2);
+        id3v1DestroyTag(&slot->id3v1);
+    }
+
+    slot->id3v2 = NULL;
+    slot->id3v1 = NULL;
+    slot->fd = -1;
+
+    internal_scanDeliver(state, slot->item, metadata);
+    return false;
+}
+
+// internal function ---
+// number of files the reader can keep open at once without running the process out of descriptors
+static size_t internal_scanUringDepth(const Id3ScanState *state, size_t depth) {
+    struct rlimit limit;
+
+    depth = (depth > ID3_SCAN_MAX_QUEUE_DEPTH) ? ID3_SCAN_MAX_QUEUE_DEPTH : depth;
+    depth = (depth > state->count) ? state->count : depth;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        limit.rlim_cur < (rlim_t) depth + ID3_SCAN_FD_RESERVE) {
+        depth = (limit.rlim_cur > ID3_SCAN_FD_RESERVE) ? (size_t) (limit.rlim_cur - ID3_SCAN_FD_RESERVE) : 1;
+    }
+
+    return depth;
+}
+
+// internal function ---
+// starts the open of the next file in a slot
+static void internal_scanUringOpen(Id3ScanRing *ring, const Id3ScanState *state, Id3ScanSlot *slot, size_t index,
+                                   size_t item) {
+    slot->item = item;
+    slot->active = true;
+    slot->waiting = false;
+    slot->stage = open_stage;
+    slot->fd = -1;
+    internal_scanUringQueue(ring, state, slot, index);
+}
+
+// internal function ---
+// reads every file from the calling thread with up to depth files in flight. false, with nothing delivered, when
+// io_uring cannot be used
+static bool internal_scanUring(Id3ScanState *state, size_t depth) {
+    Id3ScanRing ring;
+    struct io_uring_cqe *cqe = NULL;
+    Id3ScanSlot *slots = NULL;
+    Id3v2Parser *parser = NULL;
+    size_t next = 0;
+    size_t inFlight = 0;
+    size_t waiting = 0;
+    uint64_t unsubmitted = 0;
+    int ret = 0;
+
+    depth = internal_scanUringDepth(state, depth);
+    ring.queued = 0;
+
+    if (io_uring_queue_init((unsigned) depth, &ring.ring, 0) < 0) {
+        return false;
+    }
+
+    if (!internal_scanUringProbe(&ring.ring) || (slots = calloc(depth, sizeof(Id3ScanSlot))) == NULL) {
+        io_uring_queue_exit(&ring.ring);
+        return false;
+    }
+
+    if (state->tags & ID3_SCAN_ID3V2) {
+        parser = id3v2CreateParser((state->options != NULL) ? state->options->userPairs : NULL);
+    }
+
+    for (size_t i = 0; i < depth && internal_scanAdmits(state, next); i++) {
+        internal_scanUringOpen(&ring, state, &slots[i], i, next++);
+        inFlight++;
+    }
+
+    while (inFlight > 0) {
+        (void) io_uring_submit(&ring.ring);
+
+        while ((ret = io_uring_wait_cqe(&ring.ring, &cqe)) == -EINTR) {
+        }
+
+        if (ret < 0) {
+            break;
+        }
+
+        // every completion already waiting is handled before submitting again
+        do {
+            size_t index = (size_t) (uintptr_t) io_uring_cqe_get_data(cqe);
+            int res = cqe->res;
+
+            io_uring_cqe_seen(&ring.ring, cqe);
+
+            // out of descriptors, wait for another file to close unless none is left open to do so
+            if (slots[index].stage == open_stage && (res == -EMFILE || res == -ENFILE) &&
+                inFlight - waiting > 1) {
+                slots[index].waiting = true;
+                waiting++;
+                continue;
+            }
+
+            if (!internal_scanUringAdvance(&ring, state, parser, &slots[index], index, res)) {
+                slots[index].active = false;
+                inFlight--;
+
+                // the descriptor just closed goes to a file that could not get one
+                for (size_t i = 0; waiting > 0 && i < depth; i++) {
+                    if (slots[i].waiting) {
+                        internal_scanUringOpen(&ring, state, &slots[i], i, slots[i].item);
+                        waiting--;
+                        break;
+                    }
+                }
+
+                // delivery may have made room for files an ordered scan held back, in any idle slot
+                for (size_t i = 0; i < depth && internal_scanAdmits(state, next); i++) {
+                    if (!slots[i].active) {
+                        internal_scanUringOpen(&ring, state, &slots[i], i, next++);
+                        inFlight++;
+                    }
+                }
+            }
+        } while (io_uring_peek_cqe(&ring.ring, &cqe) == 0);
+    }
+
+    // operations still queued when the ring failed never reached the kernel, they are always the latest ones
+    unsubmitted = io_uring_sq_ready(&ring.ring);
+    io_uring_queue_exit(&ring.ring);
+
+    // the ring failed, finish whatever is left without it
+    if (inFlight > 0) {
+        uint8_t *buffer = NULL;
+        size_t bufferSize = 0;
+
+        for (size_t i = 0; i < depth; i++) {
+            if (!slots[i].active) {
+                continue;
+            }
+
+            // a close that was submitted may have happened
+            if (slots[i].stage != close_stage || slots[i].sequence >= ring.queued - unsubmitted) {
+                id3FileClose(slots[i].fd);
+            }
+
+            id3v2DestroyTag(&slots[i].id3v2);
+            id3v1DestroyTag(&slots[i].id3v1);
+            internal_scanDeliver(state, slots[i].item,
+                                 internal_scanRead(state, parser, &buffer, &bufferSize,
+                                                   state->filePaths[slots[i].item]));
+        }
+
+        while (next < state->count) {
+            internal_scanDeliver(state, next,
+                                 internal_scanRead(state, parser, &buffer, &bufferSize, state->filePaths[next]));
+            next++;
+        }
+
+        free(buffer);
+    }
+
+    for (size_t i = 0; i < depth; i++) {
+        free(slots[i].buffer);
+    }
+
+    free(slots);
+    id3v2DestroyParser(&parser);
+    return true;
+}
+#endif
+
+/**
+ * @brief Creates a set of options describing how files are scanned.
+ * @details No extension filter or ID3 options are set and the default reorder window is used, assign extension,
+ * options, and reorderWindow directly to change them.
+ * Returns NULL on memory allocation failure.
+ * @param threads - Number of worker threads, 0 for one per online processor.
+ * @param tags - Tags read from each file, a combination of ID3_SCAN_ID3V1 and ID3_SCAN_ID3V2.
+ * @param ordered - true to deliver results in path order, false to deliver them as soon as each file is read.
+ * @return Id3ScanOptions* - Pointer to the allocated options, or NULL on failure. Caller must free with id3DestroyScanOptions.
+ */
+Id3ScanOptions *id3CreateScanOptions(size_t threads, uint8_t tags, bool ordered) {
+    Id3ScanOptions *options = malloc(sizeof(Id3ScanOptions));
+
+    if (options == NULL) {
+        return NULL;
+    }
+
+    options->threads = threads;
+    options->tags = tags;
+    options->ordered = ordered;
+    options->reorderWindow = 0;
+    options->queueDepth = 0;
+    options->extension = NULL;
+    options->options = NULL;
+
+    return options;
+}
+
+/**
+ * @brief Frees a set of scan options and sets the pointer to NULL.
+ * @details The extension and ID3 options are borrowed and are not freed. Safe to call with NULL or with a pointer
+ * to NULL.
+ * @param toDelete - Pointer to the options pointer to free.
+ */
+void id3DestroyScanOptions(Id3ScanOptions **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Checks whether scans can read files through io_uring.
+ * @details True when the library was built with liburing and the running kernel supports the operations the reader
+ * uses. When false, a queue depth given in the scan options is ignored and worker threads are used instead.
+ * @return bool - true if io_uring is used for scans with a queue depth, false otherwise.
+ */
+bool id3ScanUringSupported(void) {
+#if defined(ID3_HAVE_LIBURING)
+    struct io_uring ring;
+    bool ok = false;
+
+    if (io_uring_queue_init(1, &ring, 0) < 0) {
+        return false;
+    }
+
+    ok = internal_scanUringProbe(&ring);
+    io_uring_queue_exit(&ring);
+    return ok;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Reads the tags of a list of files across a pool of worker threads.
+ * @details The list is split evenly between the workers and a worker that runs out of files takes the back half of
+ * another worker's remaining share, so a few slow files do not leave the others idle. The calling thread is one of
+ * the workers and the function returns once every file has been delivered. Each worker reuses one Id3v2Parser and
+ * one read buffer, and only the bytes of the tags are read from each file. Unlike id3FromFile, an ID3v2 tag is only
+ * found at the start of a file. When ordered is set, files are handed out in path order and results that finish early
+ * are held until every file before them has been delivered. No file at or beyond the reorder window from the next
+ * one to deliver is read until delivery catches up, so at most that many results are held however slow one file is.
+ * When the options give a queue depth and io_uring is supported, see id3ScanUringSupported, the files are instead
+ * read from the calling thread alone with up to that many files in flight. Each file goes through an open, a read of
+ * the ID3v2 header, a read of exactly the tag it describes, a read of the ID3v1 tail, and a close, and is parsed as
+ * soon as its reads complete.
+ * @param filePaths - Paths of the files to read.
+ * @param count - Number of paths.
+ * @param options - Scan options, or NULL for the defaults.
+ * @param callback - Function receiving the tags of each file.
+ * @param userData - Pointer passed to every call of callback.
+ * @return bool - true if every file was delivered, false on invalid arguments or memory allocation failure in
+ * which case nothing is delivered.
+ */
+bool id3ScanFiles(const char *const *filePaths, size_t count, const Id3ScanOptions *options, Id3ScanCallback callback,
+                  void *userData) {
+    if ((filePaths == NULL && count > 0) || callback == NULL) {
+        return false;
+    }
+
+    Id3ScanState state;
+    Id3ScanWorker *workers = NULL;
+    bool uring = false;
+    size_t n = (options != NULL && options->threads > 0) ? options->threads : internal_scanProcessors();
+
+    for (size_t i = 0; i < count; i++) {
+        if (filePaths[i] == NULL) {
+            return false;
+        }
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    n = (n > ID3_SCAN_MAX_THREADS) ? ID3_SCAN_MAX_THREADS : n;
+    n = (n > count) ? count : n;
+
+    memset(&state, 0, sizeof(Id3ScanState));
+    state.filePaths = filePaths;
+    state.count = count;
+    state.tags = (options != NULL) ? options->tags : (ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2);
+    state.ordered = (options != NULL) ? options->ordered : false;
+    state.options = (options != NULL) ? options->options : NULL;
+    state.callback = callback;
+    state.userData = userData;
+
+    if (state.ordered) {
+        state.window = (options->reorderWindow > 0) ? options->reorderWindow : ID3_SCAN_REORDER_WINDOW;
+        state.window = (state.window > count) ? count : state.window;
+        state.results = calloc(state.window, sizeof(ID3 *));
+        state.ready = calloc(state.window, sizeof(bool));
+    }
+
+    if ((state.ordered && (state.results == NULL || state.ready == NULL)) ||
+        (workers = internal_scanStart(&state, n)) == NULL) {
+        free(state.results);
+        free(state.ready);
+        return false;
+    }
+
+#if defined(ID3_HAVE_LIBURING)
+    uring = (options != NULL && options->queueDepth > 0 && internal_scanUring(&state, options->queueDepth));
+#endif
+
+    if (!uring) {
+        internal_scanRun(&state, workers);
+    }
+
+    internal_scanStop(&state, workers);
+
+    free(state.results);
+    free(state.ready);
+    return true;
+}
+
+// internal function ---
+// true if name ends in extension, ignoring case
+static bool internal_scanMatches(const char *name, const char *extension) {
+    size_t namel = 0;
+    size_t extensionl = 0;
+
+    if (extension == NULL) {
+        return true;
+    }
+
+    namel = strlen(name);
+    extensionl = strlen(extension);
+
+    if (extensionl > namel) {
+        return false;
+    }
+
+    for (size_t i = 0; i < extensionl; i++) {
+        if (tolower((unsigned char) name[namel - extensionl + i]) != tolower((unsigned char) extension[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// internal function ---
+// dir joined to name with a separator, NULL on allocation failure
+static char *internal_scanJoin(const char *dir, const char *name) {
+    size_t dirl = strlen(dir);
+    size_t namel = strlen(name);
+    bool separator = (dirl > 0 && dir[dirl - 1] != '/' && dir[dirl - 1] != ID3_SCAN_SEPARATOR);
+    char *path = malloc(dirl + (separator ? 1 : 0) + namel + 1);
+
+    if (path == NULL) {
+        return NULL;
+    }
+
+    memcpy(path, dir, dirl);
+
+    if (separator) {
+        path[dirl++] = ID3_SCAN_SEPARATOR;
+    }
+
+    memcpy(path + dirl, name, namel + 1);
+    return path;
+}
+
+// internal function ---
+// takes ownership of path
+static bool internal_scanAddPath(Id3ScanPaths *list, char *path) {
+    if (list->count == list->capacity) {
+        size_t capacity = (list->capacity == 0) ? 64 : list->capacity * 2;
+        char **tmp = realloc(list->paths, capacity * sizeof(char *));
+
+        if (tmp == NULL) {
+            free(path);
+            return false;
+        }
+
+        list->paths = tmp;
+        list->capacity = capacity;
+    }
+
+    list->paths[list->count++] = path;
+    return true;
+}
+
+// internal function ---
+// adds every matching file below dir, directories that cannot be opened are skipped and links to directories are
+// not followed. false only when dir itself cannot be opened or memory runs out
+static bool internal_scanWalk(Id3ScanPaths *list, const char *dir, const char *extension) {
+    bool ok = true;
+
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    char *pattern = internal_scanJoin(dir, "*");
+    HANDLE find = INVALID_HANDLE_VALUE;
+
+    if (pattern == NULL) {
+        return false;
+    }
+
+    find = FindFirstFileA(pattern, &data);
+    free(pattern);
+
+    if (find == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    do {
+        char *path = NULL;
+
+        if (strcmp(data.cFileName, ".") == 0 || strcmp(data.cFileName, "..") == 0) {
+            continue;
+        }
+
+        if ((path = internal_scanJoin(dir, data.cFileName)) == NULL) {
+            ok = false;
+            break;
+        }
+
+        if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT)) {
+                (void) internal_scanWalk(list, path, extension);
+            }
+
+            free(path);
+        } else if (internal_scanMatches(data.cFileName, extension)) {
+            if (!(ok = internal_scanAddPath(list, path))) {
+                break;
+            }
+        } else {
+            free(path);
+        }
+    } while (FindNextFileA(find, &data));
+
+    (void) FindClose(find);
+#else
+    DIR *d = opendir(dir);
+    struct dirent *entry = NULL;
+
+    if (d == NULL) {
+        return false;
+    }
+
+    while ((entry = readdir(d)) != NULL) {
+        struct stat st;
+        char *path = NULL;
+
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        if ((path = internal_scanJoin(dir, entry->d_name)) == NULL) {
+            ok = false;
+            break;
+        }
+
+        if (lstat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            (void) internal_scanWalk(list, path, extension);
+            free(path);
+            continue;
+        }
+
+        // links to files are read, links to directories are not followed
+        if (S_ISLNK(st.st_mode) && stat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+
+        if (S_ISREG(st.st_mode) && internal_scanMatches(entry->d_name, extension)) {
+            if (!(ok = internal_scanAddPath(list, path))) {
+                break;
+            }
+        } else {
+            free(path);
+        }
+    }
+
+    (void) closedir(d);
+#endif
+
+    return ok;
+}
+
+// internal function ---
+static int internal_scanComparePaths(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/**
+ * @brief Reads the tags of every file below a directory across a pool of worker threads.
+ * @details Walks root and every directory below it, then reads the files found with id3ScanFiles in sorted path
+ * order. Only files ending in the extension of the options are read when one is given. Directories that cannot be
+ * opened are skipped and links to directories are not followed.
+ * @param root - Directory to scan.
+ * @param options - Scan options, or NULL for the defaults.
+ * @param callback - Function receiving the tags of each file.
+ * @param userData - Pointer passed to every call of callback.
+ * @return bool - true if every file found was delivered, false if root could not be opened, on invalid arguments,
+ * or on memory allocation failure in which case nothing is delivered.
+ */
+bool id3ScanDirectory(const char *root, const Id3ScanOptions *options, Id3ScanCallback callback, void *userData) {
+    if (root == NULL || callback == NULL) {
+        return false;
+    }
+
+    Id3ScanPaths list = {NULL, 0, 0};
+    bool ok = internal_scanWalk(&list, root, (options != NULL) ? options->extension : NULL);
+
+    if (ok) {
+        if (list.count > 1) {
+            qsort(list.paths, list.count, sizeof(char *), internal_scanComparePaths);
+        }
+
+        ok = id3ScanFiles((const char *const *) list.paths, list.count, options, callback, userData);
+    }
+
+    for (size_t i = 0; i < list.count; i++) {
+        free(list.paths[i]);
+    }
+
+    free(list.paths);
+    return ok;
+}
+
+/**
+ * @brief Creates a set of options describing how files are edited.
+ * @details No ID3 options are set, assign options directly to use them. Returns NULL on memory allocation failure.
+ * @param threads - Number of worker threads, 0 for one per online processor.
+ * @param memoryLimit - Bytes of tags the workers may hold at once, 0 for no limit.
+ * @return Id3EditOptions* - Pointer to the allocated options, or NULL on failure. Caller must free with id3DestroyEditOptions.
+ */
+Id3EditOptions *id3CreateEditOptions(size_t threads, size_t memoryLimit) {
+    Id3EditOptions *options = malloc(sizeof(Id3EditOptions));
+
+    if (options == NULL) {
+        return NULL;
+    }
+
+    options->threads = threads;
+    options->memoryLimit = memoryLimit;
+    options->options = NULL;
+
+    return options;
+}
+
+/**
+ * @brief Frees a set of edit options and sets the pointer to NULL.
+ * @details The ID3 options are borrowed and are not freed. Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the options pointer to free.
+ */
+void id3DestroyEditOptions(Id3EditOptions **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Changes the tags of a list of files across a pool of worker threads.
+ * @details Each file is read, has every field its edit set gives written with the matching id3Write function, and
+ * is written back with id3WriteToFile, which patches the tags in place whenever the changed ID3v2 tag still fits the
+ * space of the old one. Reserving padding through the write options keeps later edits in place. Work is shared
+ * between the workers as in id3ScanFiles and only the bytes of the tags are read. When a memory limit is given, a
+ * worker waits before reading a file until the tags held by all workers leave room for it, a file is expected to
+ * hold three times the size of its ID3v2 tag. A file that fails to change is left as it was, and files without a tag
+ * are not given one. Each path must appear only once.
+ * @param edits - Files to edit and the changes to make to each.
+ * @param count - Number of edits.
+ * @param options - Edit options, or NULL for the defaults.
+ * @param callback - Function receiving the outcome of each file, may be NULL.
+ * @param userData - Pointer passed to every call of callback.
+ * @return bool - true if every file was attempted, false on invalid arguments or memory allocation failure in which
+ * case no file is changed.
+ */
+bool id3EditFiles(const Id3Edit *edits, size_t count, const Id3EditOptions *options, Id3EditCallback callback,
+                  void *userData) {
+    if (edits == NULL && count > 0) {
+        return false;
+    }
+
+    Id3ScanState state;
+    Id3ScanWorker *workers = NULL;
+    size_t n = (options != NULL && options->threads > 0) ? options->threads : internal_scanProcessors();
+
+    for (size_t i = 0; i < count; i++) {
+        if (edits[i].filePath == NULL) {
+            return false;
+        }
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    n = (n > ID3_SCAN_MAX_THREADS) ? ID3_SCAN_MAX_THREADS : n;
+    n = (n > count) ? count : n;
+
+    memset(&state, 0, sizeof(Id3ScanState));
+    state.count = count;
+    state.tags = ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2;
+    state.options = (options != NULL) ? options->options : NULL;
+    state.userData = userData;
+    state.edits = edits;
+    state.editCallback = callback;
+    state.memoryLimit = (options != NULL) ? options->memoryLimit : 0;
+
+    if ((workers = internal_scanStart(&state, n)) == NULL) {
+        return false;
+    }
+
+    internal_scanRun(&state, workers);
+    internal_scanStop(&state, workers);
+    return true;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file id3Sha1.c
+ * @author Ewan Jones
+ * @brief Function implementations for the SHA-1 digest used to identify binary frame content
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <string.h>
+#include "id3Sha1.h"
+
+//! Number of bytes SHA-1 processes per step
+#define ID3_SHA1_BLOCK_SIZE 64
+
+//! Rotates a 32 bit value left
+#define ID3_SHA1_ROTL(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+// internal function ------------------------------------------------------------------------
+static void internal_id3Sha1Block(uint32_t state[5], const uint8_t *block) {
+    uint32_t w[80];
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+    uint32_t e = state[4];
+
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t) block[i * 4] << 24) | ((uint32_t) block[i * 4 + 1] << 16) |
+               ((uint32_t) block[i * 4 + 2] << 8) | (uint32_t) block[i * 4 + 3];
+    }
+
+    for (int i = 16; i < 80; i++) {
+        w[i] = ID3_SHA1_ROTL(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+    }
+
+    for (int i = 0; i < 80; i++) {
+        uint32_t f = 0;
+        uint32_t k = 0;
+        uint32_t t = 0;
+
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999U;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1U;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDCU;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6U;
+        }
+
+        t = ID3_SHA1_ROTL(a, 5) + f + e + k + w[i];
+        e = d;
+        d = c;
+        c = ID3_SHA1_ROTL(b, 30);
+        b = a;
+        a = t;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+/**
+ * @brief Computes the SHA-1 digest of a block of memory.
+ * @details Implements the hash described in FIPS 180-4. It is used to fingerprint large binary content such as
+ * attached pictures so identical artwork can be recognised without comparing or exporting the bytes themselves.
+ * @param data - Bytes to hash, may be NULL when length is 0.
+ * @param length - Number of bytes in data.
+ * @param digest - Receives the ID3_SHA1_DIGEST_SIZE byte digest.
+ */
+void id3Sha1(const uint8_t *data, size_t length, uint8_t digest[ID3_SHA1_DIGEST_SIZE]) {
+    uint32_t state[5] = {0x67452301U, 0xEFCDAB89U, 0x98BADCFEU, 0x10325476U, 0xC3D2E1F0U};
+    uint8_t tail[ID3_SHA1_BLOCK_SIZE * 2] = {0};
+    const uint64_t bits = (uint64_t) length * 8;
+    size_t remaining = length;
+    size_t tailSize = 0;
+
+    if (digest == NULL) {
+        return;
+    }
+
+    while (data != NULL && remaining >= ID3_SHA1_BLOCK_SIZE) {
+        internal_id3Sha1Block(state, data);
+        data += ID3_SHA1_BLOCK_SIZE;
+        remaining -= ID3_SHA1_BLOCK_SIZE;
+    }
+
+    // the last partial block, a 1 bit and the message length fill one or two more blocks
+    if (data != NULL && remaining > 0) {
+        memcpy(tail, data, remaining);
+    }
+
+    tail[remaining] = 0x80;
+    tailSize = (remaining < ID3_SHA1_BLOCK_SIZE - 8) ? ID3_SHA1_BLOCK_SIZE : ID3_SHA1_BLOCK_SIZE * 2;
+
+    for (int i = 0; i < 8; i++) {
+        tail[tailSize - 1 - i] = (uint8_t) (bits >> (i * 8));
+    }
+
+    internal_id3Sha1Block(state, tail);
+
+    if (tailSize > ID3_SHA1_BLOCK_SIZE) {
+        internal_id3Sha1Block(state, tail + ID3_SHA1_BLOCK_SIZE);
+    }
+
+    for (int i = 0; i < 5; i++) {
+        digest[i * 4] = (uint8_t) (state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t) (state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t) (state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t) state[i];
+    }
+}
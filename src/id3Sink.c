@@ -0,0 +1,386 @@
+/**
+ * @file id3Sink.c
+ * @author Ewan Jones
+ * @brief Implementation of output sinks used to stream serialized tags and JSON without intermediate buffers
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include "id3Sink.h"
+#include "id3File.h"
+
+//! Size of the zeroed block used to write padding
+#define ID3_SINK_ZERO_BLOCK_SIZE 4096
+
+//! Output small enough to be formatted on the stack
+#define ID3_SINK_PRINTF_STACK_SIZE 256
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3SinkFileWrite(void *user, const uint8_t *data, size_t length) {
+    return (fwrite(data, 1, length, (FILE *) user) == length);
+}
+
+static bool internal_id3SinkFdWrite(void *user, const uint8_t *data, size_t length) {
+    const Id3Sink *sink = (const Id3Sink *) user;
+
+    return id3FileWrite(sink->fd, data, length);
+}
+
+static bool internal_id3SinkBufferWrite(void *user, const uint8_t *data, size_t length) {
+    Id3Sink *sink = (Id3Sink *) user;
+
+    if (!id3SinkReserve(sink, length)) {
+        return false;
+    }
+
+    memcpy(sink->buffer + sink->written, data, length);
+    sink->buffer[sink->written + length] = 0;
+
+    return true;
+}
+
+/**
+ * @brief Creates a sink forwarding all output to a callback.
+ * @details The callback receives the user pointer along with each chunk of output. Returns NULL if write is NULL or
+ * memory allocation fails.
+ * @param write - Callback receiving the output.
+ * @param user - Pointer handed to the callback, may be NULL.
+ * @return Id3Sink* - Pointer to the sink, or NULL on failure. Caller must free with id3SinkDestroy.
+ */
+Id3Sink *id3SinkCreate(Id3SinkWriteFunction write, void *user) {
+    if (write == NULL) {
+        return NULL;
+    }
+
+    Id3Sink *sink = malloc(sizeof(Id3Sink));
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    sink->write = write;
+    sink->user = user;
+    sink->written = 0;
+    sink->failed = false;
+    sink->buffer = NULL;
+    sink->capacity = 0;
+    sink->fd = -1;
+
+    return sink;
+}
+
+/**
+ * @brief Creates a sink writing to an open FILE stream.
+ * @details Output is written with fwrite at the current position of the stream. The stream is not closed by id3SinkDestroy.
+ * @param fp - Stream opened for writing.
+ * @return Id3Sink* - Pointer to the sink, or NULL on failure. Caller must free with id3SinkDestroy.
+ */
+Id3Sink *id3SinkCreateFromFile(FILE *fp) {
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    return id3SinkCreate(internal_id3SinkFileWrite, fp);
+}
+
+/**
+ * @brief Creates a sink writing to an open file descriptor.
+ * @details Output is written at the current position of the descriptor, which may be a file, pipe, or socket.
+ * The descriptor is not closed by id3SinkDestroy.
+ * @param fd - Descriptor opened for writing.
+ * @return Id3Sink* - Pointer to the sink, or NULL on failure. Caller must free with id3SinkDestroy.
+ */
+Id3Sink *id3SinkCreateFromFd(int fd) {
+    if (fd < 0) {
+        return NULL;
+    }
+
+    Id3Sink *sink = id3SinkCreate(internal_id3SinkFdWrite, NULL);
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    sink->user = sink;
+    sink->fd = fd;
+
+    return sink;
+}
+
+/**
+ * @brief Creates a sink collecting output in a growable memory buffer.
+ * @details The buffer grows geometrically and is always followed by a null byte, so JSON output can be used as a
+ * string directly. Read it with id3SinkBuffer or take ownership of it with id3SinkTakeBuffer.
+ * @param capacity - Initial number of bytes to allocate, may be 0.
+ * @return Id3Sink* - Pointer to the sink, or NULL on failure. Caller must free with id3SinkDestroy.
+ */
+Id3Sink *id3SinkCreateBuffer(size_t capacity) {
+    Id3Sink *sink = id3SinkCreate(internal_id3SinkBufferWrite, NULL);
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    sink->user = sink;
+
+    if (!id3SinkReserve(sink, capacity)) {
+        free(sink);
+        return NULL;
+    }
+
+    return sink;
+}
+
+/**
+ * @brief Frees a sink and sets the pointer to NULL.
+ * @details Frees the memory of a buffer sink unless it was taken with id3SinkTakeBuffer. Streams and descriptors
+ * given to a sink are left open. Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the sink pointer to free.
+ */
+void id3SinkDestroy(Id3Sink **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free((*toDelete)->buffer);
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Writes bytes to a sink.
+ * @details Nothing is written once a previous write has failed.
+ * @param sink - Sink to write to.
+ * @param data - Bytes to write, may be NULL when length is 0.
+ * @param length - Number of bytes to write.
+ * @return bool - true if the bytes were written, false if this or an earlier write failed.
+ */
+bool id3SinkWrite(Id3Sink *sink, const uint8_t *data, size_t length) {
+    if (sink == NULL || sink->failed) {
+        return false;
+    }
+
+    if (length == 0) {
+        return true;
+    }
+
+    if (data == NULL || !sink->write(sink->user, data, length)) {
+        sink->failed = true;
+        return false;
+    }
+
+    sink->written += length;
+    return true;
+}
+
+/**
+ * @brief Writes a null-terminated string to a sink, without its terminator.
+ * @param sink - Sink to write to.
+ * @param string - String to write.
+ * @return bool - true if the string was written, false otherwise.
+ */
+bool id3SinkWriteString(Id3Sink *sink, const char *string) {
+    if (string == NULL) {
+        return false;
+    }
+
+    return id3SinkWrite(sink, (const uint8_t *) string, strlen(string));
+}
+
+/**
+ * @brief Writes a run of zero bytes to a sink.
+ * @details Used for padding. The zeros come from a static block so no memory is allocated.
+ * @param sink - Sink to write to.
+ * @param length - Number of zero bytes to write.
+ * @return bool - true if the bytes were written, false otherwise.
+ */
+bool id3SinkWriteZeros(Id3Sink *sink, size_t length) {
+    static const uint8_t zeros[ID3_SINK_ZERO_BLOCK_SIZE] = {0};
+
+    while (length > 0) {
+        size_t n = (length > sizeof(zeros)) ? sizeof(zeros) : length;
+
+        if (!id3SinkWrite(sink, zeros, n)) {
+            return false;
+        }
+
+        length -= n;
+    }
+
+    return (sink != NULL && sink->failed == false);
+}
+
+/**
+ * @brief Writes printf style formatted text to a sink.
+ * @details Buffer sinks are formatted in place. Other sinks format short output on the stack and only allocate
+ * for output longer than ID3_SINK_PRINTF_STACK_SIZE bytes.
+ * @param sink - Sink to write to.
+ * @param format - printf format string.
+ * @param ... - Values for the format string.
+ * @return bool - true if the text was written, false otherwise.
+ */
+bool id3SinkPrintf(Id3Sink *sink, const char *format, ...) {
+    if (sink == NULL || format == NULL || sink->failed) {
+        return false;
+    }
+
+    char stack[ID3_SINK_PRINTF_STACK_SIZE];
+    char *heap = NULL;
+    int n = 0;
+    bool ret = false;
+    va_list args;
+
+    va_start(args, format);
+    n = vsnprintf(stack, sizeof(stack), format, args);
+    va_end(args);
+
+    if (n < 0) {
+        sink->failed = true;
+        return false;
+    }
+
+    if ((size_t) n < sizeof(stack)) {
+        return id3SinkWrite(sink, (const uint8_t *) stack, (size_t) n);
+    }
+
+    // format straight into a buffer sink
+    if (sink->write == internal_id3SinkBufferWrite) {
+        if (!id3SinkReserve(sink, (size_t) n)) {
+            sink->failed = true;
+            return false;
+        }
+
+        va_start(args, format);
+        (void) vsnprintf((char *) sink->buffer + sink->written, (size_t) n + 1, format, args);
+        va_end(args);
+
+        sink->written += (size_t) n;
+        return true;
+    }
+
+    heap = malloc((size_t) n + 1);
+
+    if (heap == NULL) {
+        sink->failed = true;
+        return false;
+    }
+
+    va_start(args, format);
+    (void) vsnprintf(heap, (size_t) n + 1, format, args);
+    va_end(args);
+
+    ret = id3SinkWrite(sink, (const uint8_t *) heap, (size_t) n);
+    free(heap);
+
+    return ret;
+}
+
+/**
+ * @brief Makes room for at least length more bytes in a buffer sink.
+ * @details Producers that know their output size call this once up front so a buffer sink allocates a single time.
+ * Sinks that are not buffer sinks ignore the request.
+ * @param sink - Sink to reserve space in.
+ * @param length - Number of bytes about to be written.
+ * @return bool - true if the space is available or the sink is not a buffer sink, false on allocation failure.
+ */
+bool id3SinkReserve(Id3Sink *sink, size_t length) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    if (sink->write != internal_id3SinkBufferWrite) {
+        return true;
+    }
+
+    // room for the terminator
+    size_t needed = sink->written + length + 1;
+    size_t capacity = (sink->capacity > 0) ? sink->capacity : 64;
+    uint8_t *tmp = NULL;
+
+    if (needed < sink->written) {
+        return false;
+    }
+
+    if (sink->buffer != NULL && needed <= sink->capacity) {
+        return true;
+    }
+
+    while (capacity < needed) {
+        capacity = (capacity > SIZE_MAX / 2) ? needed : capacity * 2;
+    }
+
+    tmp = realloc(sink->buffer, capacity);
+
+    if (tmp == NULL) {
+        return false;
+    }
+
+    if (sink->buffer == NULL) {
+        tmp[0] = 0;
+    }
+
+    sink->buffer = tmp;
+    sink->capacity = capacity;
+
+    return true;
+}
+
+/**
+ * @brief Reads the content of a buffer sink.
+ * @details The returned memory stays owned by the sink and is followed by a null byte.
+ * @param sink - Buffer sink to read.
+ * @param length - Receives the number of bytes written to the sink, may be NULL.
+ * @return const uint8_t* - Pointer to the content, or NULL if the sink is not a buffer sink.
+ */
+const uint8_t *id3SinkBuffer(const Id3Sink *sink, size_t *length) {
+    if (sink == NULL || sink->buffer == NULL) {
+        if (length != NULL) {
+            *length = 0;
+        }
+        return NULL;
+    }
+
+    if (length != NULL) {
+        *length = sink->written;
+    }
+
+    return sink->buffer;
+}
+
+/**
+ * @brief Takes ownership of the content of a buffer sink.
+ * @details The sink is left empty and can be reused. The returned memory is followed by a null byte.
+ * @param sink - Buffer sink to take the content of.
+ * @param length - Receives the number of bytes in the returned buffer, may be NULL.
+ * @return uint8_t* - Pointer to the content, or NULL if the sink is not a buffer sink. Caller must free the returned buffer.
+ */
+uint8_t *id3SinkTakeBuffer(Id3Sink *sink, size_t *length) {
+    uint8_t *out = NULL;
+
+    if (sink == NULL || sink->buffer == NULL) {
+        if (length != NULL) {
+            *length = 0;
+        }
+        return NULL;
+    }
+
+    out = sink->buffer;
+
+    if (length != NULL) {
+        *length = sink->written;
+    }
+
+    sink->buffer = NULL;
+    sink->capacity = 0;
+    sink->written = 0;
+    sink->failed = false;
+
+    return out;
+}
@@ -17,6 +17,19 @@
 #include "id3v1/id3v1.h"
 #include "id3v1/id3v1Parser.h"
 #include "id3v2/id3v2Frame.h"
+#include "id3v2/id3v2Parser.h"
+#include "id3File.h"
+#include "id3Hash.h"
+#include "id3dependencies/ByteStream/include/byteStream.h"
+
+//! Initial capacity of the buffer a tag pair is converted to JSON in
+#define ID3_JSON_CAPACITY 4096
+
+//! Bytes read from the start of a file when reading its tags, an ID3v2 tag larger than this takes one more read
+#define ID3_HEAD_READ_SIZE 16384
+
+//! Bytes read at a time when hashing audio from a file that could not be mapped
+#define ID3_HASH_READ_SIZE (1024 * 1024)
 
 /**
  * @brief default standard for reading ID3 tags from a data structure representation.
@@ -33,6 +46,20 @@ static uint8_t id3PreferredStandard = ID3V2_TAG_VERSION_3;
  * @return ID3* - Pointer to allocated ID3 structure on success, NULL on allocation failure. Caller must free with id3Destroy().
  */
 ID3 *id3Create(Id3v2Tag *id3v2, Id3v1Tag *id3v1) {
+    return id3CreateWithOptions(id3v2, id3v1, NULL);
+}
+
+/**
+ * @brief Creates a new ID3 metadata structure that uses its own options.
+ * @details Like id3Create, but the read, write, and convert functions called on the structure use options instead
+ * of the library wide preference, so structures with different preferences can be used from different threads at
+ * the same time. The options are borrowed and must outlive the structure.
+ * @param id3v2 - Pointer to an ID3v2 tag structure, or NULL if not present.
+ * @param id3v1 - Pointer to an ID3v1 tag structure, or NULL if not present.
+ * @param options - Options to use, or NULL for the library wide preference.
+ * @return ID3* - Pointer to allocated ID3 structure on success, NULL on allocation failure. Caller must free with id3Destroy().
+ */
+ID3 *id3CreateWithOptions(Id3v2Tag *id3v2, Id3v1Tag *id3v1, const Id3Options *options) {
     ID3 *metadata = malloc(sizeof(ID3));
     if (metadata == NULL) {
         return NULL;
@@ -40,6 +67,7 @@ ID3 *id3Create(Id3v2Tag *id3v2, Id3v1Tag *id3v1) {
 
     metadata->id3v2 = id3v2;
     metadata->id3v1 = id3v1;
+    metadata->options = options;
 
     return metadata;
 }
@@ -60,11 +88,76 @@ void id3Destroy(ID3 **toDelete) {
     }
 }
 
+/**
+ * @brief Creates a set of options for ID3 structures.
+ * @details The options are fixed once created so they can be shared between threads without locking. The write
+ * options are copied, the user pairings are borrowed and must outlive the options. Returns NULL for an invalid
+ * standard or if memory allocation fails.
+ * @param preferredStandard - ID3 version constant (ID3V1_TAG_VERSION, ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4).
+ * @param userPairs - User identifier and context pairings used when parsing, or NULL.
+ * @param writeOptions - Padding and compression used when writing to a file, or NULL for the defaults.
+ * @return Id3Options* - Pointer to the options, or NULL on failure. Caller must free with id3DestroyOptions.
+ */
+Id3Options *id3CreateOptions(uint8_t preferredStandard, HashTable *userPairs, const Id3v2WriteOptions *writeOptions) {
+    Id3Options *options = NULL;
+
+    switch (preferredStandard) {
+        case ID3V1_TAG_VERSION:
+        case ID3V2_TAG_VERSION_2:
+        case ID3V2_TAG_VERSION_3:
+        case ID3V2_TAG_VERSION_4:
+            break;
+
+        default:
+            return NULL;
+    }
+
+    options = malloc(sizeof(Id3Options));
+
+    if (options == NULL) {
+        return NULL;
+    }
+
+    options->preferredStandard = preferredStandard;
+    options->userPairs = userPairs;
+    options->writeOptions = NULL;
+
+    if (writeOptions != NULL) {
+        options->writeOptions = malloc(sizeof(Id3v2WriteOptions));
+
+        if (options->writeOptions == NULL) {
+            free(options);
+            return NULL;
+        }
+
+        *options->writeOptions = *writeOptions;
+    }
+
+    return options;
+}
+
+/**
+ * @brief Frees a set of options and sets the pointer to NULL.
+ * @details The user pairings given to id3CreateOptions are not freed. Safe to call with NULL or a pointer to NULL.
+ * @param toDelete - Pointer to the options pointer to free.
+ */
+void id3DestroyOptions(Id3Options **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free((*toDelete)->writeOptions);
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
 /**
  * @brief Sets the preferred ID3 standard for reading metadata from tag structures.
  * @details Configures which ID3 version to prioritize when reading metadata from structures containing both ID3v1 and ID3v2 tags.
  * Default is ID3v2.3 (widest adoption with most features). Accepts ID3v1, ID3v2.2, ID3v2.3, or ID3v2.4 version constants.
- * Returns false for invalid version values without changing the current preference.
+ * Returns false for invalid version values without changing the current preference. The preference is shared by
+ * every structure created without options, so it should not be changed while other threads use the library;
+ * use id3CreateOptions to give structures their own preference instead.
  * @param standard - ID3 version constant (ID3V1_TAG_VERSION, ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4).
  * @return bool - true if standard set successfully, false if invalid standard value provided.
  */
@@ -95,16 +188,317 @@ uint8_t id3GetPreferredStandard(void) {
 }
 
 
+// internal function ---
+// reads the size bytes at offset into buffer, growing it when needed, and parses them as an ID3v2 tag
+static Id3v2Tag *internal_readId3v2(int fd, uint8_t **buffer, size_t *bufferSize, size_t have, uint64_t offset,
+                                    uint64_t size, HashTable *userPairs) {
+    if (size > SIZE_MAX) {
+        return NULL;
+    }
+
+    if (*bufferSize < size) {
+        uint8_t *tmp = realloc(*buffer, (size_t) size);
+
+        if (tmp == NULL) {
+            return NULL;
+        }
+
+        *buffer = tmp;
+        *bufferSize = (size_t) size;
+    }
+
+    // bytes already in the buffer are not read again
+    if (have < size && !id3FileReadAt(fd, *buffer + have, (size_t) size - have, offset + have)) {
+        return NULL;
+    }
+
+    return id3v2ParseTagFromBuffer(*buffer, (size_t) size, userPairs);
+}
+
+// internal function ---
+// reads both tags of a file with one open and two positioned reads, the head where an ID3v2 tag starts and the tail
+// holding an ID3v1 tag and the footer of an appended ID3v2.4 tag. A tag larger than the head read or an appended tag
+// takes one more read
+static void internal_readTags(const char *filePath, HashTable *userPairs, Id3v2Tag **id3v2, Id3v1Tag **id3v1) {
+    uint8_t tail[ID3V2_TAG_HEADER_SIZE + ID3V1_MAX_SIZE] = {0};
+    uint8_t *head = NULL;
+    uint8_t *footer = NULL;
+    uint64_t fileSize = 0;
+    uint64_t tagSize = 0;
+    uint64_t end = 0;
+    size_t headSize = 0;
+    size_t tailSize = 0;
+    int fd = id3FileOpen(filePath, false);
+
+    *id3v2 = NULL;
+    *id3v1 = NULL;
+
+    if (fd < 0 || !id3FileSize(fd, &fileSize) || fileSize == 0) {
+        id3FileClose(fd);
+        return;
+    }
+
+    headSize = (fileSize < ID3_HEAD_READ_SIZE) ? (size_t) fileSize : ID3_HEAD_READ_SIZE;
+    tailSize = (fileSize < sizeof(tail)) ? (size_t) fileSize : sizeof(tail);
+    head = malloc(headSize);
+
+    // the tail is kept at the end of its buffer so the ID3v1 tag is always at the same place
+    if (head == NULL || !id3FileReadAt(fd, head, headSize, 0) ||
+        !id3FileReadAt(fd, tail + sizeof(tail) - tailSize, tailSize, fileSize - tailSize)) {
+        free(head);
+        id3FileClose(fd);
+        return;
+    }
+
+    end = fileSize;
+
+    if (fileSize >= ID3V1_MAX_SIZE && memcmp(tail + ID3V2_TAG_HEADER_SIZE, "TAG", ID3V1_TAG_ID_SIZE) == 0) {
+        *id3v1 = id3v1TagFromBuffer(tail + ID3V2_TAG_HEADER_SIZE);
+        end = fileSize - ID3V1_MAX_SIZE;
+    }
+
+    if (headSize >= ID3V2_TAG_HEADER_SIZE && (tagSize = id3FileTagSize(head, false)) > 0 && tagSize <= fileSize) {
+        *id3v2 = internal_readId3v2(fd, &head, &headSize, headSize, 0, tagSize, userPairs);
+    } else if (end >= ID3V2_TAG_HEADER_SIZE && fileSize >= sizeof(tail)) {
+        // an ID3v2.4 tag appended to the end of the file is found from its footer
+        footer = (end == fileSize) ? tail + ID3V1_MAX_SIZE : tail;
+        tagSize = id3FileTagSize(footer, true);
+
+        if (tagSize > 0 && tagSize <= end) {
+            *id3v2 = internal_readId3v2(fd, &head, &headSize, 0, end - tagSize, tagSize, userPairs);
+        }
+    }
+
+    free(head);
+    id3FileClose(fd);
+}
+
 /**
  * @brief Reads both ID3v1 and ID3v2 tags from a file into an ID3 metadata structure.
  * @details Attempts to read both ID3v2 (from file start) and ID3v1 (from file end) tags from the specified file.
+ * The file is opened once and only the bytes of the tags are read: the start of the file and its last bytes, plus
+ * the rest of an ID3v2 tag that does not fit the first read. An ID3v2.4 tag appended to the end of the file, before
+ * any ID3v1 tag, is read when there is none at the start.
  * Always returns an ID3 structure, but individual tag pointers (id3v1, id3v2) will be NULL if not found or if read errors occur.
  * The returned structure must be freed with id3Destroy().
  * @param filePath - Null-terminated string containing the path to the file to read.
  * @return ID3* - Pointer to allocated ID3 structure containing the read tags (tags may be NULL if not found). Caller must free with id3Destroy().
  */
 ID3 *id3FromFile(const char *filePath) {
-    return id3Create(id3v2TagFromFile(filePath), id3v1TagFromFile(filePath));
+    return id3FromFileWithOptions(filePath, NULL);
+}
+
+/**
+ * @brief Reads both ID3v1 and ID3v2 tags from a file into an ID3 structure that uses its own options.
+ * @details Like id3FromFile, but the ID3v2 tag is parsed with the user pairings of the options and the returned
+ * structure uses the options, see id3CreateWithOptions.
+ * @param filePath - Null-terminated string containing the path to the file to read.
+ * @param options - Options to use, or NULL for the library wide preference.
+ * @return ID3* - Pointer to allocated ID3 structure containing the read tags (tags may be NULL if not found). Caller must free with id3Destroy().
+ */
+ID3 *id3FromFileWithOptions(const char *filePath, const Id3Options *options) {
+    Id3v2Tag *id3v2 = NULL;
+    Id3v1Tag *id3v1 = NULL;
+    ID3 *metadata = NULL;
+
+    if (filePath != NULL) {
+        internal_readTags(filePath, (options != NULL) ? options->userPairs : NULL, &id3v2, &id3v1);
+    }
+
+    metadata = id3CreateWithOptions(id3v2, id3v1, options);
+
+    if (metadata == NULL) {
+        id3v2DestroyTag(&id3v2);
+        id3v1DestroyTag(&id3v1);
+    }
+
+    return metadata;
+}
+
+// internal function ---
+// finds the audio between the tags of a file of size bytes. head holds its first headl bytes and tail its last
+// taill bytes
+static void internal_audioRange(const uint8_t *head, size_t headl, const uint8_t *tail, size_t taill, uint64_t size,
+                                uint64_t *start, uint64_t *end) {
+    uint64_t tagSize = 0;
+
+    *start = 0;
+    *end = size;
+
+    if (headl >= ID3V2_TAG_HEADER_SIZE && (tagSize = id3FileTagSize(head, false)) > 0 && tagSize <= size) {
+        *start = tagSize;
+    }
+
+    if (taill >= ID3V1_MAX_SIZE && size - *start >= ID3V1_MAX_SIZE &&
+        memcmp(tail + taill - ID3V1_MAX_SIZE, "TAG", ID3V1_TAG_ID_SIZE) == 0) {
+        *end -= ID3V1_MAX_SIZE;
+    }
+
+    // footer of an ID3v2.4 tag appended before the ID3v1 tag
+    if (*end - *start >= ID3V2_TAG_HEADER_SIZE && size - (*end - ID3V2_TAG_HEADER_SIZE) <= taill) {
+        tagSize = id3FileTagSize(tail + taill - (size - (*end - ID3V2_TAG_HEADER_SIZE)), true);
+
+        if (tagSize > 0 && tagSize <= *end - *start) {
+            *end -= tagSize;
+        }
+    }
+}
+
+/**
+ * @brief Finds where the audio of a file starts and ends.
+ * @details Only the 10 byte ID3v2 header at the start of the file and its last 138 bytes are read, no frame is
+ * parsed and nothing is allocated. The audio starts after an ID3v2 tag at the start of the file, including its
+ * extended header, padding, and footer, and ends before an ID3v1 tag and before an ID3v2.4 tag appended in front of
+ * it. Positions are byte offsets, so [start, end) can be served as a range without the tags.
+ * @param filePath - Null-terminated string containing the path to the file.
+ * @param start - Receives the offset of the first byte of audio.
+ * @param end - Receives the offset one past the last byte of audio.
+ * @return bool - true on success, false if the file could not be read.
+ */
+bool id3AudioRange(const char *filePath, uint64_t *start, uint64_t *end) {
+    if (filePath == NULL || start == NULL || end == NULL) {
+        return false;
+    }
+
+    uint8_t head[ID3V2_TAG_HEADER_SIZE] = {0};
+    uint8_t tail[ID3V2_TAG_HEADER_SIZE + ID3V1_MAX_SIZE] = {0};
+    uint64_t size = 0;
+    size_t headl = 0;
+    size_t taill = 0;
+    bool ok = false;
+    int fd = id3FileOpen(filePath, false);
+
+    if (fd >= 0 && id3FileSize(fd, &size)) {
+        headl = (size < sizeof(head)) ? (size_t) size : sizeof(head);
+        taill = (size < sizeof(tail)) ? (size_t) size : sizeof(tail);
+        ok = (id3FileReadAt(fd, head, headl, 0) && id3FileReadAt(fd, tail, taill, size - taill));
+    }
+
+    id3FileClose(fd);
+
+    if (ok) {
+        internal_audioRange(head, headl, tail, taill, size, start, end);
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Finds where the audio of a file held in memory starts and ends.
+ * @details Works like id3AudioRange on a buffer holding a whole file.
+ * @param buffer - Bytes of the file.
+ * @param size - Number of bytes in buffer.
+ * @param start - Receives the offset of the first byte of audio.
+ * @param end - Receives the offset one past the last byte of audio.
+ * @return bool - true on success, false on invalid arguments.
+ */
+bool id3AudioRangeFromBuffer(const uint8_t *buffer, size_t size, uint64_t *start, uint64_t *end) {
+    if ((buffer == NULL && size > 0) || start == NULL || end == NULL) {
+        return false;
+    }
+
+    internal_audioRange(buffer, size, buffer, size, size, start, end);
+    return true;
+}
+
+/**
+ * @brief Hashes the audio of a file, ignoring its tags.
+ * @details The bytes between the tags found by id3AudioRange are hashed with id3Hash64 using seed 0, so two files
+ * holding the same audio hash the same however their ID3v1 and ID3v2 tags differ, which makes the hash suitable for
+ * finding duplicates. The file is mapped into memory when possible and otherwise read in large sequential pieces.
+ * Store the result with id3v2WriteAudioHash to avoid hashing the file again.
+ * @param filePath - Null-terminated string containing the path to the file.
+ * @param hash - Receives the hash of the audio.
+ * @return bool - true on success, false if the file could not be read.
+ */
+bool id3AudioHash(const char *filePath, uint64_t *hash) {
+    if (filePath == NULL || hash == NULL) {
+        return false;
+    }
+
+    Id3FileMapping mapping = {0};
+    Id3Hash state;
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint8_t *buffer = NULL;
+    bool ok = true;
+    int fd = -1;
+
+    if (id3FileMap(filePath, &mapping)) {
+        internal_audioRange(mapping.data, mapping.length, mapping.data, mapping.length, mapping.length, &start, &end);
+        *hash = id3Hash64(mapping.data + start, (size_t) (end - start), 0);
+        id3FileUnmap(&mapping);
+        return true;
+    }
+
+    // empty files and systems without mapping
+    if (!id3AudioRange(filePath, &start, &end)) {
+        return false;
+    }
+
+    id3HashInit(&state, 0);
+
+    if (end > start) {
+        buffer = malloc(ID3_HASH_READ_SIZE);
+        fd = id3FileOpen(filePath, false);
+        ok = (buffer != NULL && fd >= 0);
+
+        while (ok && start < end) {
+            size_t length = (end - start < ID3_HASH_READ_SIZE) ? (size_t) (end - start) : ID3_HASH_READ_SIZE;
+
+            ok = id3FileReadAt(fd, buffer, length, start);
+
+            if (ok) {
+                id3HashUpdate(&state, buffer, length);
+                start += length;
+            }
+        }
+
+        id3FileClose(fd);
+        free(buffer);
+    }
+
+    if (ok) {
+        *hash = id3HashFinal(&state);
+    }
+
+    return ok;
+}
+
+/**
+ * @brief Hashes the audio of a file held in memory, ignoring its tags.
+ * @details Works like id3AudioHash on a buffer holding a whole file.
+ * @param buffer - Bytes of the file.
+ * @param size - Number of bytes in buffer.
+ * @param hash - Receives the hash of the audio.
+ * @return bool - true on success, false on invalid arguments.
+ */
+bool id3AudioHashFromBuffer(const uint8_t *buffer, size_t size, uint64_t *hash) {
+    uint64_t start = 0;
+    uint64_t end = 0;
+
+    if (hash == NULL || !id3AudioRangeFromBuffer(buffer, size, &start, &end)) {
+        return false;
+    }
+
+    *hash = id3Hash64((buffer != NULL) ? buffer + start : NULL, (size_t) (end - start), 0);
+    return true;
+}
+
+/**
+ * @brief Changes the options an ID3 structure uses.
+ * @details The options are borrowed and must outlive the structure, NULL returns to the library wide preference.
+ * @param metadata - ID3 structure to change.
+ * @param options - Options to use, or NULL.
+ * @return bool - true if the options were set, false if metadata is NULL.
+ */
+bool id3SetOptions(ID3 *metadata, const Id3Options *options) {
+    if (metadata == NULL) {
+        return false;
+    }
+
+    metadata->options = options;
+    return true;
 }
 
 /**
@@ -119,7 +513,7 @@ ID3 *id3Copy(const ID3 *toCopy) {
         return NULL;
     }
 
-    return id3Create(id3v2CopyTag(toCopy->id3v2), id3v1CopyTag(toCopy->id3v1));
+    return id3CreateWithOptions(id3v2CopyTag(toCopy->id3v2), id3v1CopyTag(toCopy->id3v1), toCopy->options);
 }
 
 /**
@@ -156,11 +550,16 @@ bool id3Compare(const ID3 *metadata1, const ID3 *metadata2) {
     return false;
 }
 
+// internal -----------------------------------------------------------------
+// the structure's own preference, or the library wide one
+static int internal_getPrefStd(const ID3 *metadata) {
+    return (metadata->options != NULL) ? metadata->options->preferredStandard : id3PreferredStandard;
+}
 
 /**
  * @brief Converts the ID3v1 tag to an ID3v2 tag within the metadata structure.
  * @details Creates a new ID3v2 tag from the existing ID3v1 tag, copying all non-empty fields (title, artist, album, year, track, genre, comment).
- * Uses the preferred standard to determine the ID3v2 version (2.2, 2.3, or 2.4), defaulting to ID3v2.3 if preferred standard is ID3v1.
+ * Uses the preferred standard of the structure's options, or the library wide one, to determine the ID3v2 version (2.2, 2.3, or 2.4), defaulting to ID3v2.3 if preferred standard is ID3v1.
  * Numeric fields (year, track) are converted to strings. Genre is looked up from the ID3v1 genre table.
  * If an ID3v2 tag already exists, it is destroyed and replaced. Returns false on validation failures (null metadata, null ID3v1 tag, or write errors),
  * cleaning up all allocated memory. Does not modify the original ID3v1 tag.
@@ -183,7 +582,7 @@ bool id3ConvertId3v1ToId3v2(ID3 *metadata) {
     int size = 0;
     int input = 0;
 
-    input = id3GetPreferredStandard() > ID3V1_TAG_VERSION ? id3GetPreferredStandard() : ID3V2_TAG_VERSION_3;
+    input = internal_getPrefStd(metadata) > ID3V1_TAG_VERSION ? internal_getPrefStd(metadata) : ID3V2_TAG_VERSION_3;
 
     switch (input) {
         case ID3V2_TAG_VERSION_2:
@@ -258,8 +657,8 @@ bool id3ConvertId3v1ToId3v2(ID3 *metadata) {
         free(str);
     }
 
-    if (metadata->id3v1->genre < PSYBIENT_GENRE) {
-        if (!id3v2WriteGenre(id3v1GenreFromTable(metadata->id3v1->genre), newTag)) {
+    if (metadata->id3v1->genre <= PSYBIENT_GENRE) {
+        if (!id3v2WriteGenre(id3v1GenreName(metadata->id3v1->genre), newTag)) {
             id3v2DestroyTag(&newTag);
             listFree(frames);
             return false;
@@ -289,7 +688,8 @@ bool id3ConvertId3v1ToId3v2(ID3 *metadata) {
  * @brief Converts the ID3v2 tag to an ID3v1 tag within the metadata structure.
  * @details Creates a new ID3v1 tag from the existing ID3v2 tag, reading and copying all common fields (title, artist, album, year, track, comment, genre).
  * String fields from ID3v2 are converted to ID3v1 format: year and track are parsed as integers, with track parsing stripping leading zeros and extracting
- * only the numeric portion before any delimiter. Genre uses the first character. Fields truncated to ID3v1 limits (30 bytes for most text fields).
+ * only the numeric portion before any delimiter. Genre is matched by name or numeric reference with id3v1GenreFromString and left
+ * as OTHER_GENRE when it names no ID3v1 genre. Fields truncated to ID3v1 limits (30 bytes for most text fields).
  * If an ID3v1 tag already exists, it is destroyed and replaced. Returns false on validation failures (null metadata or null ID3v2 tag).
  * Does not modify the original ID3v2 tag. Frees all intermediate allocations.
  * @param metadata - ID3 structure containing the ID3v2 tag to convert (id3v2 must not be NULL).
@@ -378,7 +778,12 @@ bool id3ConvertId3v2ToId3v1(ID3 *metadata) {
     }
 
     if (genre != NULL) {
-        id3v1WriteGenre(genre[0], newTag);
+        Genre match = id3v1GenreFromString(genre);
+
+        if (match != GENRE_UNKNOWN) {
+            id3v1WriteGenre(match, newTag);
+        }
+
         free(genre);
     }
 
@@ -394,7 +799,7 @@ bool id3ConvertId3v2ToId3v1(ID3 *metadata) {
 // corrects the standard preference if the preferred standard is not available
 static int internal_getSafePrefStd(const ID3 *metadata) {
     int input = 0;
-    int pref = id3GetPreferredStandard();
+    int pref = internal_getPrefStd(metadata);
 
     if (pref > ID3V1_TAG_VERSION && metadata->id3v2 == NULL) {
         input = ID3V1_TAG_VERSION;
@@ -600,12 +1005,14 @@ char *id3ReadGenre(const ID3 *metadata) {
                 return NULL;
             }
 
-            char *genre = NULL;
-            int size = 0;
+            const char *name = id3v1GenreName(metadata->id3v1->genre);
+            size_t size = strlen(name);
+            char *genre = calloc(size + 1, sizeof(char));
+
+            if (genre != NULL) {
+                memcpy(genre, name, size);
+            }
 
-            size = (int) strlen(id3v1GenreFromTable(metadata->id3v1->genre));
-            genre = calloc(size + 1, sizeof(char));
-            memcpy(genre, id3v1GenreFromTable(metadata->id3v1->genre), size);
             return genre;
         }
         case ID3V2_TAG_VERSION_2:
@@ -988,10 +1395,11 @@ int id3WriteYear(const char *year, ID3 *metadata) {
 /**
  * @brief Writes a genre to an ID3 metadata structure using the preferred standard.
  * @details Updates the genre field in either the ID3v1 or ID3v2 tag based on the preferred standard setting.
- * For ID3v1, uses the first byte of the genre string as a genre code (0-192 per standard genre table in id3v1Types.h), clamping values above PSYBIENT_GENRE to OTHER_GENRE.
+ * For ID3v1, the genre is matched by name or numeric reference such as "Rock" or "(17)" with id3v1GenreFromString. A string naming no genre
+ * has its first byte used as a genre code (0-192 per standard genre table in id3v1Types.h), clamping values above PSYBIENT_GENRE to OTHER_GENRE.
  * For ID3v2, writes the genre string directly. If the preferred tag is not available, falls back to the available tag.
  * Returns false on validation failures (null parameters, both tags missing, or write errors) without modifying the metadata.
- * @param genre - Null-terminated string containing the genre to write (first byte used as genre code for ID3v1: 0-192).
+ * @param genre - Null-terminated string containing the genre to write (a genre name, reference, or code in the first byte for ID3v1).
  * @param metadata - ID3 structure to write the genre to (must have at least one tag present).
  * @return int - 1 (true) if genre written successfully, 0 (false) on failure.
  */
@@ -1006,8 +1414,10 @@ int id3WriteGenre(const char *genre, ID3 *metadata) {
 
     switch (internal_getSafePrefStd(metadata)) {
         case ID3V1_TAG_VERSION: {
+            Genre match = id3v1GenreFromString(genre);
             uint8_t usableGenre = (uint8_t) genre[0] > PSYBIENT_GENRE ? OTHER_GENRE : (uint8_t) genre[0];
-            return id3v1WriteGenre(usableGenre, metadata->id3v1);
+
+            return id3v1WriteGenre((match != GENRE_UNKNOWN) ? match : (Genre) usableGenre, metadata->id3v1);
         }
         case ID3V2_TAG_VERSION_2:
         case ID3V2_TAG_VERSION_3:
@@ -1272,43 +1682,225 @@ int id3WritePictureFromFile(const char *filename, const char *kind, uint8_t type
  * ```
  */
 char *id3ToJSON(const ID3 *metadata) {
+    return id3ToJSONWithOptions(metadata, NULL);
+}
+
+/**
+ * @brief Converts an ID3 metadata structure to a JSON string, choosing how binary ID3v2 content is represented.
+ * @details Produces the same structure as id3ToJSON with binary frame content written according to options, see
+ * id3v2FrameToJSONSinkWithOptions.
+ * @param metadata - ID3 structure to serialize to JSON, or NULL.
+ * @param options - Binary content policy, NULL behaves like embed_binary.
+ * @return char* - Pointer to allocated null-terminated JSON string, or NULL on failure. Caller must free the returned string.
+ */
+char *id3ToJSONWithOptions(const ID3 *metadata, const Id3v2JSONOptions *options) {
+    Id3Sink *sink = id3SinkCreateBuffer(ID3_JSON_CAPACITY);
     char *json = NULL;
-    char *id3v1 = NULL;
-    char *id3v2 = NULL;
-    size_t memCount = 3;
 
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3ToJSONSinkWithOptions(metadata, options, sink)) {
+        json = (char *) id3SinkTakeBuffer(sink, NULL);
+    }
+
+    id3SinkDestroy(&sink);
+    return json;
+}
+
+/**
+ * @brief Writes the JSON representation of an ID3 structure into a sink.
+ * @details Writes the same text id3ToJSON returns, without a null terminator. Both tags are written straight into
+ * the sink.
+ * @param metadata - ID3 structure to convert.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 (true) if the JSON was written, 0 (false) on failure.
+ */
+int id3ToJSONSink(const ID3 *metadata, Id3Sink *sink) {
+    return id3ToJSONSinkWithOptions(metadata, NULL, sink);
+}
+
+/**
+ * @brief Writes the JSON representation of an ID3 structure into a sink, choosing how binary ID3v2 content is represented.
+ * @details Writes the same text id3ToJSONWithOptions returns, without a null terminator.
+ * @param metadata - ID3 structure to convert.
+ * @param options - Binary content policy, NULL behaves like embed_binary.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 (true) if the JSON was written, 0 (false) on failure.
+ */
+int id3ToJSONSinkWithOptions(const ID3 *metadata, const Id3v2JSONOptions *options, Id3Sink *sink) {
     if (metadata == NULL) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
+        return id3SinkWriteString(sink, "{}");
     }
 
-    id3v1 = id3v1ToJSON(metadata->id3v1);
-    id3v2 = id3v2TagToJSON(metadata->id3v2);
+    (void) id3SinkWriteString(sink, "{\"ID3v1\":");
+    (void) id3v1ToJSONSink(metadata->id3v1, sink);
+    (void) id3SinkWriteString(sink, ",\"ID3v2\":");
+    (void) id3v2TagToJSONSinkWithOptions(metadata->id3v2, options, sink);
+
+    return id3SinkWriteString(sink, "}");
+}
+
+/**
+ * @brief Builds an ID3 structure from its JSON representation.
+ * @details Reads the object id3ToJSON writes, importing the "ID3v1" member with id3v1TagFromJSONReader and the
+ * "ID3v2" member with id3v2TagFromJSONReader. A member holding "{}" leaves that tag absent. The whole string must
+ * be a single object.
+ * @param json - Null-terminated JSON text as written by id3ToJSON.
+ * @return ID3* - Heap allocated ID3 structure, or NULL if the JSON is empty or invalid. Caller must free with id3Destroy.
+ */
+ID3 *id3FromJSON(const char *json) {
+    Id3JsonReader *reader = NULL;
+    Id3v1Tag *v1 = NULL;
+    Id3v2Tag *v2 = NULL;
+    bool members = false;
+    bool ok = false;
 
-    memCount += snprintf(NULL, 0, "{\"id3v1\":%s,\"id3v2\":%s}", id3v1, id3v2);
-    json = calloc(memCount + 1, sizeof(char));
     if (json == NULL) {
-        free(id3v1);
-        free(id3v2);
         return NULL;
     }
-    (void) snprintf(json, memCount + 1, "{\"ID3v1\":%s,\"ID3v2\":%s}", id3v1, id3v2);
 
-    free(id3v1);
-    free(id3v2);
+    reader = id3JsonReaderCreate(json, strlen(json));
 
-    return json;
+    if (reader == NULL || !id3JsonBeginObject(reader)) {
+        id3JsonReaderDestroy(&reader);
+        return NULL;
+    }
+
+    while (id3JsonNextMember(reader)) {
+        members = true;
+
+        if (strcmp(reader->key, "ID3v1") == 0 && v1 == NULL) {
+            v1 = id3v1TagFromJSONReader(reader);
+        } else if (strcmp(reader->key, "ID3v2") == 0 && v2 == NULL) {
+            v2 = id3v2TagFromJSONReader(reader, NULL);
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    ok = members && !reader->failed && id3JsonReaderFinished(reader);
+    id3JsonReaderDestroy(&reader);
+
+    if (!ok) {
+        id3v1DestroyTag(&v1);
+        id3v2DestroyTag(&v2);
+        return NULL;
+    }
+
+    return id3Create(v2, v1);
+}
+
+/**
+ * @brief Converts an ID3 structure to CBOR.
+ * @details Convenience wrapper around id3ToCBORSink collecting the output in a buffer.
+ * @param metadata - ID3 structure to convert.
+ * @param outl - Receives the number of bytes returned, 0 on failure.
+ * @return uint8_t* - Heap allocated CBOR, or NULL on failure. Caller must free the returned buffer.
+ */
+uint8_t *id3ToCBOR(const ID3 *metadata, size_t *outl) {
+    Id3Sink *sink = NULL;
+    uint8_t *out = NULL;
+
+    if (outl == NULL) {
+        return NULL;
+    }
+
+    *outl = 0;
+    sink = id3SinkCreateBuffer(ID3_JSON_CAPACITY);
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3ToCBORSink(metadata, sink)) {
+        out = id3SinkTakeBuffer(sink, outl);
+    }
+
+    id3SinkDestroy(&sink);
+    return out;
+}
+
+/**
+ * @brief Writes the CBOR representation of an ID3 structure into a sink.
+ * @details Mirrors id3ToJSON in CBOR: a map holding "ID3v1" and "ID3v2", see id3v1ToCBORSink and
+ * id3v2TagToCBORSink. A NULL structure writes an empty map.
+ * @param metadata - ID3 structure to convert.
+ * @param sink - Sink receiving the CBOR.
+ * @return int - 1 (true) if the CBOR was written, 0 (false) on failure.
+ */
+int id3ToCBORSink(const ID3 *metadata, Id3Sink *sink) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    if (metadata == NULL) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    (void) id3CborWriteMap(sink, 2);
+    (void) id3CborWriteString(sink, "ID3v1");
+    (void) id3v1ToCBORSink(metadata->id3v1, sink);
+    (void) id3CborWriteString(sink, "ID3v2");
+
+    return id3v2TagToCBORSink(metadata->id3v2, sink);
+}
+
+/**
+ * @brief Builds an ID3 structure from its CBOR representation.
+ * @details Reads the map id3ToCBORSink writes, see id3FromJSON. The whole buffer must be a single map.
+ * @param cbor - CBOR as written by id3ToCBOR.
+ * @param length - Number of bytes in cbor.
+ * @return ID3* - Heap allocated ID3 structure, or NULL if the CBOR is empty or invalid. Caller must free with id3Destroy.
+ */
+ID3 *id3FromCBOR(const uint8_t *cbor, size_t length) {
+    Id3CborReader *reader = NULL;
+    Id3v1Tag *v1 = NULL;
+    Id3v2Tag *v2 = NULL;
+    bool members = false;
+    bool ok = false;
+
+    reader = id3CborReaderCreate(cbor, length);
+
+    if (reader == NULL || !id3CborBeginMap(reader)) {
+        id3CborReaderDestroy(&reader);
+        return NULL;
+    }
+
+    while (id3CborNextMember(reader)) {
+        members = true;
+
+        if (strcmp(reader->key, "ID3v1") == 0 && v1 == NULL) {
+            v1 = id3v1TagFromCBORReader(reader);
+        } else if (strcmp(reader->key, "ID3v2") == 0 && v2 == NULL) {
+            v2 = id3v2TagFromCBORReader(reader, NULL);
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    ok = members && !reader->failed && id3CborReaderFinished(reader);
+    id3CborReaderDestroy(&reader);
+
+    if (!ok) {
+        id3v1DestroyTag(&v1);
+        id3v2DestroyTag(&v2);
+        return NULL;
+    }
+
+    return id3Create(v2, v1);
 }
 
 /**
  * @brief Writes both ID3v1 and ID3v2 tags to a file using the given ID3 structure.
  * @details Updates existing tags or creates new ones as needed. Writes both tags if present; if only one tag is present, only that tag is written.
- * Returns true if at least one tag is written successfully and the other is either also written or not present.
- * Returns false on validation failures (null parameters, both tags missing, or write errors for all tags).
+ * When both are present the file is opened once and both tags are placed in a single pass: they are patched in place when the ID3v2 tag
+ * keeps its size, otherwise the audio data is copied once into the rewritten file.
+ * Returns false on validation failures (null parameters, both tags missing, or write errors).
  * @param filePath - Null-terminated string containing the path to the file to write.
  * @param metadata - ID3 structure containing the tags to write (must have at least one tag present).
- * @return int - 1 (true) if at least one tag written successfully, 0 (false) on failure.
+ * @return int - 1 (true) if every present tag was written successfully, 0 (false) on failure.
  */
 int id3WriteToFile(const char *filePath, const ID3 *metadata) {
     if (filePath == NULL || metadata == NULL) {
@@ -1320,25 +1912,26 @@ int id3WriteToFile(const char *filePath, const ID3 *metadata) {
         return false;
     }
 
+    uint8_t *trailer = NULL;
+    size_t trailerl = 0;
+    int ret = false;
 
-    bool v1 = false;
-    bool v2 = false;
-
-    v1 = id3v1WriteTagToFile(filePath, metadata->id3v1);
-    v2 = id3v2WriteTagToFile(filePath, metadata->id3v2);
-
-
-    if (v1 && v2) {
-        return true;
+    if (metadata->id3v2 == NULL) {
+        return id3v1WriteTagToFile(filePath, metadata->id3v1);
     }
 
-    if (v1 == false && (v2 == true && metadata->id3v1 == NULL)) {
-        return true;
-    }
+    if (metadata->id3v1 != NULL) {
+        trailer = id3v1TagSerialize(metadata->id3v1, &trailerl);
 
-    if (v2 == false && (v1 == true && metadata->id3v2 == NULL)) {
-        return true;
+        if (trailer == NULL) {
+            return false;
+        }
     }
 
-    return false;
+    ret = id3v2WriteTagToFileWithTrailer(filePath, metadata->id3v2,
+                                         (metadata->options != NULL) ? metadata->options->writeOptions : NULL,
+                                         trailer);
+    free(trailer);
+
+    return ret;
 }
@@ -11,8 +11,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <limits.h>
+#include <ctype.h>
 #include "id3v1/id3v1Parser.h"
 #include "id3v1/id3v1.h"
+#include "id3File.h"
 #include "id3dependencies/ByteStream/include/byteStream.h"
 #include "id3dependencies/ByteStream/include/byteInt.h"
 
@@ -225,403 +228,319 @@ bool id3v1CompareTag(const Id3v1Tag *tag1, const Id3v1Tag *tag2) {
     return true;
 }
 
+// name of every genre, indexed by Genre
+static const char *const internal_id3v1Genres[ID3V1_GENRE_COUNT] = {
+    [BLUES_GENRE] = "Blues",
+    [CLASSIC_ROCK_GENRE] = "Classic Rock",
+    [COUNTRY_GENRE] = "Country",
+    [DANCE_GENRE] = "Dance",
+    [DISCO_GENRE] = "Disco",
+    [FUNK_GENRE] = "Funk",
+    [GRUNGE_GENRE] = "Grunge",
+    [HIP_HOP_GENRE] = "Hip-Hop",
+    [JAZZ_GENRE] = "Jazz",
+    [METAL_GENRE] = "Metal",
+    [NEW_AGE_GENRE] = "New Age",
+    [OLDIES_GENRE] = "Oldies",
+    [OTHER_GENRE] = "Other",
+    [POP_GENRE] = "Pop",
+    [RHYTHM_AND_BLUES_GENRE] = "Rhythm and Blues",
+    [RAP_GENRE] = "Rap",
+    [REGGAE_GENRE] = "Reggae",
+    [ROCK_GENRE] = "Rock",
+    [TECHNO_GENRE] = "Techno",
+    [INDUSTRIAL_GENRE] = "Industrial",
+    [ALTERNATIVE_GENRE] = "Alternative",
+    [SKA_GENRE] = "Ska",
+    [DEATH_METAL_GENRE] = "Death Metal",
+    [PRANKS_GENRE] = "Pranks",
+    [SOUNDTRACK_GENRE] = "Soundtrack",
+    [EURO_TECHNO_GENRE] = "Euro-Techno",
+    [AMBIENT_GENRE] = "Ambient",
+    [TRIP_HOP_GENRE] = "Trip-Hop",
+    [VOCAL_GENRE] = "Vocal",
+    [JAZZ_AND_FUNK_GENRE] = "Jazz and Funk",
+    [FUSION_GENRE] = "Fusion",
+    [TRANCE_GENRE] = "Trance",
+    [CLASSICAL_GENRE] = "Classical",
+    [INSTRUMENTAL_GENRE] = "Instrumental",
+    [ACID_GENRE] = "Acid",
+    [HOUSE_GENRE] = "House",
+    [GAME_GENRE] = "Game",
+    [SOUND_CLIP_GENRE] = "Sound Clip",
+    [GOSPEL_GENRE] = "Gospel",
+    [NOISE_GENRE] = "Noise",
+    [ALTERNATIVE_ROCK_GENRE] = "Alternative Rock",
+    [BASS_GENRE] = "Bass",
+    [SOUL_GENRE] = "Soul",
+    [PUNK_GENRE] = "Punk",
+    [SPACE_GENRE] = "Space",
+    [MEDITATIVE_GENRE] = "Meditative",
+    [INSTRUMENTAL_POP_GENRE] = "Instrumental Pop",
+    [INSTRUMENTAL_ROCK_GENRE] = "Instrumental Rock",
+    [ETHNIC_GENRE] = "Ethnic",
+    [GOTHIC_GENRE] = "Gothic",
+    [DARKWAVE_GENRE] = "Darkwave",
+    [TECHNO_INDUSTRIAL_GENRE] = "Techno Industrial",
+    [ELECTRONIC_GENRE] = "Electronic",
+    [POP_FOLK_GENRE] = "Pop Folk",
+    [EURODANCE_GENRE] = "Eurodance",
+    [DREAM_GENRE] = "Dream",
+    [SOUTHERN_ROCK_GENRE] = "Southern Rock",
+    [COMEDY_GENRE] = "Comedy",
+    [CULT_GENRE] = "Cult",
+    [GANGSTA_GENRE] = "Gangsta",
+    [TOP_40_GENRE] = "Top 40",
+    [CHRISTIAN_RAP_GENRE] = "Christian Rap",
+    [POP_FUNK_GENRE] = "Pop Funk",
+    [JUNGLE_MUSIC_GENRE] = "Jungle Music",
+    [NATIVE_US_GENRE] = "Native US",
+    [CABARET_GENRE] = "Cabaret",
+    [NEW_WAVE_GENRE] = "New Wave",
+    [PSYCHEDELIC_GENRE] = "Psychedelic",
+    [RAVE_GENRE] = "Rave",
+    [SHOWTUNES_GENRE] = "Showtunes",
+    [TRAILER_GENRE] = "Trailer",
+    [LO_FI_GENRE] = "Lo-Fi",
+    [TRIBAL_GENRE] = "Tribal",
+    [ACID_PUNK_GENRE] = "Acid Punk",
+    [ACID_JAZZ_GENRE] = "Acid Jazz",
+    [POLKA_GENRE] = "Polka",
+    [RETRO_GENRE] = "Retro",
+    [MUSICAL_GENRE] = "Musical",
+    [ROCKNROLL_GENRE] = "Rock and Roll",
+    [HARD_ROCK_GENRE] = "Hard Rock",
+    [FOLK_GENRE] = "Folk",
+    [FOLK_ROCK_GENRE] = "Folk Rock",
+    [NATIONAL_FOLK_GENRE] = "National Folk",
+    [SWING_GENRE] = "Swing",
+    [FAST_FUSION_GENRE] = "Fast Fusion",
+    [BEBOP_GENRE] = "Bebop",
+    [LATIN_GENRE] = "Latin",
+    [REVIVAL_GENRE] = "Revival",
+    [CELTIC_GENRE] = "Celtic",
+    [BLUEGRASS_GENRE] = "Bluegrass",
+    [AVANTGARDE_GENRE] = "Avantgarde",
+    [GOTHIC_ROCK_GENRE] = "Gothic Rock",
+    [PROGRESSIVE_ROCK_GENRE] = "Progressive Rock",
+    [PSYCHEDELIC_ROCK_GENRE] = "Psychedelic Rock",
+    [SYMPHONIC_ROCK_GENRE] = "Symphonic Rock",
+    [SLOW_ROCK_GENRE] = "Slow Rock",
+    [BIG_BAND_GENRE] = "Big Band",
+    [CHORUS_GENRE] = "Chorus",
+    [EASY_LISTENING_GENRE] = "Easy Listening",
+    [ACOUSTIC_GENRE] = "Acoustic",
+    [HUMOUR_GENRE] = "Humour",
+    [SPEECH_GENRE] = "Speech",
+    [CHANSON_GENRE] = "Chanson",
+    [OPERA_GENRE] = "Opera",
+    [CHAMBER_MUSIC_GENRE] = "Chamber Music",
+    [SONATA_GENRE] = "Sonata",
+    [SYMPHONY_GENRE] = "Symphony",
+    [BOOTY_BASS_GENRE] = "Booty Bass",
+    [PRIMUS_GENRE] = "Primus",
+    [PORN_GROOVE_GENRE] = "Porn Groove",
+    [SATIRE_GENRE] = "Satire",
+    [SLOW_JAM_GENRE] = "Slow Jam",
+    [CLUB_GENRE] = "Club",
+    [TANGO_GENRE] = "Tango",
+    [SAMBA_GENRE] = "Samba",
+    [FOLKLORE_GENRE] = "Folklore",
+    [BALLAD_GENRE] = "Ballad",
+    [POWER_BALLAD_GENRE] = "Power Ballad",
+    [RHYTHMIC_SOUL_GENRE] = "Rhythmic Soul",
+    [FREESTYLE_GENRE] = "Freestyle",
+    [DUET_GENRE] = "Duet",
+    [PUNK_ROCK_GENRE] = "Punk Rock",
+    [DRUM_SOLO_GENRE] = "Drum Solo",
+    [A_CAPPELLA_GENRE] = "A Cappella",
+    [EURO_HOUSE_GENRE] = "Euro-House",
+    [DANCE_HALL_GENRE] = "Dance Hall",
+    [GOA_MUSIC_GENRE] = "Goa Music",
+    [DRUM_AND_BASS_GENRE] = "Drum and Bass",
+    [CLUB_HOUSE_GENRE] = "Club-House",
+    [HARDCORE_TECHNO_GENRE] = "Hardcore Techno",
+    [TERROR_GENRE] = "Terror",
+    [INDIE_GENRE] = "Indie",
+    [BRITPOP_GENRE] = "Britpop",
+    [NEGERPUNK_GENRE] = "Negerpunk",
+    [POLSK_PUNK_GENRE] = "Polsk Punk",
+    [BEAT_GENRE] = "Beat",
+    [CHRISTIAN_GANGSTA_RAP_GENRE] = "Christian Gangsta Rap",
+    [HEAVY_METAL_GENRE] = "Heavy Metal",
+    [BLACK_METAL_GENRE] = "Black Metal",
+    [CROSSOVER_GENRE] = "Crossover",
+    [CONTEMPORARY_CHRISTIAN_GENRE] = "Contemporary Christian",
+    [CHRISTIAN_ROCK_GENRE] = "Christian Rock",
+    [MERENGUE_GENRE] = "Merengue",
+    [SALSA_GENRE] = "Salsa",
+    [THRASH_METAL_GENRE] = "Thrash Metal",
+    [ANIME_GENRE] = "Anime",
+    [JPOP_GENRE] = "Jpop",
+    [SYNTHPOP_GENRE] = "Synthpop",
+    [CHRISTMAS_GENRE] = "Christmas",
+    [ABSTRACT_GENRE] = "Abstract",
+    [ART_ROCK_GENRE] = "Art Rock",
+    [BAROQUE_GENRE] = "Baroque",
+    [BHANGRA_GENRE] = "Bhangra",
+    [BIG_BEAT_GENRE] = "Big Beat",
+    [BREAKBEAT_GENRE] = "Breakbeat",
+    [CHILLOUT_GENRE] = "Chillout",
+    [DOWNTEMPO_GENRE] = "Downtempo",
+    [DUB_GENRE] = "Dub",
+    [EBM_GENRE] = "EBM",
+    [ECLECTIC_GENRE] = "Eclectic",
+    [ELECTRO_GENRE] = "Electro",
+    [ELECTROCLASH_GENRE] = "Electroclash",
+    [EMO_GENRE] = "Emo",
+    [EXPERIMENTAL_GENRE] = "Experimental",
+    [GARAGE_GENRE] = "Garage",
+    [GLOBAL_GENRE] = "Global",
+    [IDM_GENRE] = "IDM",
+    [ILLBIENT_GENRE] = "Illbient",
+    [INDUSTRO_GOTH_GENRE] = "Industro-Goth",
+    [JAM_BAND_GENRE] = "Jam Band",
+    [KRAUTROCK_GENRE] = "Krautrock",
+    [LEFTFIELD_GENRE] = "Leftfield",
+    [LOUNGE_GENRE] = "Lounge",
+    [MATH_ROCK_GENRE] = "Math Rock",
+    [NEW_ROMANTIC_GENRE] = "New Romantic",
+    [NU_BREAKZ_GENRE] = "Nu-Breakz",
+    [POST_PUNK_GENRE] = "Post-Punk",
+    [POST_ROCK_GENRE] = "Post-Rock",
+    [PSYTRANCE_GENRE] = "Psytrance",
+    [SHOEGAZE_GENRE] = "Shoegaze",
+    [SPACE_ROCK_GENRE] = "Space Rock",
+    [TROP_ROCK_GENRE] = "Trop Rock",
+    [WORLD_MUSIC_GENRE] = "World Music",
+    [NEOCLASSICAL_GENRE] = "Neoclassical",
+    [AUDIOBOOK_GENRE] = "Audiobook",
+    [AUDIO_THEATRE_GENRE] = "Audio Theatre",
+    [NEUE_DEUTSCHE_WELLE_GENRE] = "Neue Deutsche Welle",
+    [PODCAST_GENRE] = "Podcast",
+    [INDIE_ROCK_GENRE] = "Indie-Rock",
+    [G_FUNK_GENRE] = "G-Funk",
+    [DUBSTEP_GENRE] = "Dubstep",
+    [GARAGE_ROCK_GENRE] = "Garage Rock",
+    [PSYBIENT_GENRE] = "Psybient",
+};
+
+// every genre ordered by name ignoring case, searched by id3v1GenreFromString
+static const Genre internal_id3v1GenresByName[ID3V1_GENRE_COUNT] = {
+    A_CAPPELLA_GENRE, ABSTRACT_GENRE, ACID_GENRE, ACID_JAZZ_GENRE, ACID_PUNK_GENRE, ACOUSTIC_GENRE, ALTERNATIVE_GENRE,
+    ALTERNATIVE_ROCK_GENRE, AMBIENT_GENRE, ANIME_GENRE, ART_ROCK_GENRE, AUDIO_THEATRE_GENRE, AUDIOBOOK_GENRE,
+    AVANTGARDE_GENRE, BALLAD_GENRE, BAROQUE_GENRE, BASS_GENRE, BEAT_GENRE, BEBOP_GENRE, BHANGRA_GENRE, BIG_BAND_GENRE,
+    BIG_BEAT_GENRE, BLACK_METAL_GENRE, BLUEGRASS_GENRE, BLUES_GENRE, BOOTY_BASS_GENRE, BREAKBEAT_GENRE, BRITPOP_GENRE,
+    CABARET_GENRE, CELTIC_GENRE, CHAMBER_MUSIC_GENRE, CHANSON_GENRE, CHILLOUT_GENRE, CHORUS_GENRE,
+    CHRISTIAN_GANGSTA_RAP_GENRE, CHRISTIAN_RAP_GENRE, CHRISTIAN_ROCK_GENRE, CHRISTMAS_GENRE, CLASSIC_ROCK_GENRE,
+    CLASSICAL_GENRE, CLUB_GENRE, CLUB_HOUSE_GENRE, COMEDY_GENRE, CONTEMPORARY_CHRISTIAN_GENRE, COUNTRY_GENRE,
+    CROSSOVER_GENRE, CULT_GENRE, DANCE_GENRE, DANCE_HALL_GENRE, DARKWAVE_GENRE, DEATH_METAL_GENRE, DISCO_GENRE,
+    DOWNTEMPO_GENRE, DREAM_GENRE, DRUM_AND_BASS_GENRE, DRUM_SOLO_GENRE, DUB_GENRE, DUBSTEP_GENRE, DUET_GENRE,
+    EASY_LISTENING_GENRE, EBM_GENRE, ECLECTIC_GENRE, ELECTRO_GENRE, ELECTROCLASH_GENRE, ELECTRONIC_GENRE, EMO_GENRE,
+    ETHNIC_GENRE, EURO_HOUSE_GENRE, EURO_TECHNO_GENRE, EURODANCE_GENRE, EXPERIMENTAL_GENRE, FAST_FUSION_GENRE,
+    FOLK_GENRE, FOLK_ROCK_GENRE, FOLKLORE_GENRE, FREESTYLE_GENRE, FUNK_GENRE, FUSION_GENRE, G_FUNK_GENRE, GAME_GENRE,
+    GANGSTA_GENRE, GARAGE_GENRE, GARAGE_ROCK_GENRE, GLOBAL_GENRE, GOA_MUSIC_GENRE, GOSPEL_GENRE, GOTHIC_GENRE,
+    GOTHIC_ROCK_GENRE, GRUNGE_GENRE, HARD_ROCK_GENRE, HARDCORE_TECHNO_GENRE, HEAVY_METAL_GENRE, HIP_HOP_GENRE,
+    HOUSE_GENRE, HUMOUR_GENRE, IDM_GENRE, ILLBIENT_GENRE, INDIE_GENRE, INDIE_ROCK_GENRE, INDUSTRIAL_GENRE,
+    INDUSTRO_GOTH_GENRE, INSTRUMENTAL_GENRE, INSTRUMENTAL_POP_GENRE, INSTRUMENTAL_ROCK_GENRE, JAM_BAND_GENRE,
+    JAZZ_GENRE, JAZZ_AND_FUNK_GENRE, JPOP_GENRE, JUNGLE_MUSIC_GENRE, KRAUTROCK_GENRE, LATIN_GENRE, LEFTFIELD_GENRE,
+    LO_FI_GENRE, LOUNGE_GENRE, MATH_ROCK_GENRE, MEDITATIVE_GENRE, MERENGUE_GENRE, METAL_GENRE, MUSICAL_GENRE,
+    NATIONAL_FOLK_GENRE, NATIVE_US_GENRE, NEGERPUNK_GENRE, NEOCLASSICAL_GENRE, NEUE_DEUTSCHE_WELLE_GENRE, NEW_AGE_GENRE,
+    NEW_ROMANTIC_GENRE, NEW_WAVE_GENRE, NOISE_GENRE, NU_BREAKZ_GENRE, OLDIES_GENRE, OPERA_GENRE, OTHER_GENRE,
+    PODCAST_GENRE, POLKA_GENRE, POLSK_PUNK_GENRE, POP_GENRE, POP_FOLK_GENRE, POP_FUNK_GENRE, PORN_GROOVE_GENRE,
+    POST_PUNK_GENRE, POST_ROCK_GENRE, POWER_BALLAD_GENRE, PRANKS_GENRE, PRIMUS_GENRE, PROGRESSIVE_ROCK_GENRE,
+    PSYBIENT_GENRE, PSYCHEDELIC_GENRE, PSYCHEDELIC_ROCK_GENRE, PSYTRANCE_GENRE, PUNK_GENRE, PUNK_ROCK_GENRE, RAP_GENRE,
+    RAVE_GENRE, REGGAE_GENRE, RETRO_GENRE, REVIVAL_GENRE, RHYTHM_AND_BLUES_GENRE, RHYTHMIC_SOUL_GENRE, ROCK_GENRE,
+    ROCKNROLL_GENRE, SALSA_GENRE, SAMBA_GENRE, SATIRE_GENRE, SHOEGAZE_GENRE, SHOWTUNES_GENRE, SKA_GENRE, SLOW_JAM_GENRE,
+    SLOW_ROCK_GENRE, SONATA_GENRE, SOUL_GENRE, SOUND_CLIP_GENRE, SOUNDTRACK_GENRE, SOUTHERN_ROCK_GENRE, SPACE_GENRE,
+    SPACE_ROCK_GENRE, SPEECH_GENRE, SWING_GENRE, SYMPHONIC_ROCK_GENRE, SYMPHONY_GENRE, SYNTHPOP_GENRE, TANGO_GENRE,
+    TECHNO_GENRE, TECHNO_INDUSTRIAL_GENRE, TERROR_GENRE, THRASH_METAL_GENRE, TOP_40_GENRE, TRAILER_GENRE, TRANCE_GENRE,
+    TRIBAL_GENRE, TRIP_HOP_GENRE, TROP_ROCK_GENRE, VOCAL_GENRE, WORLD_MUSIC_GENRE
+};
+
+// internal function ------------------------------------------------------------------------
+// compares two ASCII strings ignoring case
+static int internal_id3v1GenreCompare(const char *a, const char *b) {
+    size_t i = 0;
+
+    while (tolower((unsigned char) a[i]) == tolower((unsigned char) b[i]) && a[i] != '\0') {
+        i++;
+    }
+
+    return tolower((unsigned char) a[i]) - tolower((unsigned char) b[i]);
+}
+
 /**
  * @brief Converts a Genre enum value to it's string representation.
  * @details Maps genre enum values to their corresponding string names. Returns "Other" for 
- * unrecognized values as specified by the ID3v1 standard
+ * unrecognized values as specified by the ID3v1 standard. The string is borrowed from a static table, see
+ * id3v1GenreName.
  * @param val - The genre enum value to convert
- * @return char* - String representation of the genre, never NULL.
+ * @return char* - String representation of the genre, never NULL. Must not be modified or freed.
  */
 char *id3v1GenreFromTable(Genre val) {
-    //int to string
-    switch (val) {
-        case BLUES_GENRE:
-            return "Blues\0";
-        case CLASSIC_ROCK_GENRE:
-            return "Classic Rock\0";
-        case COUNTRY_GENRE:
-            return "Country\0";
-        case DANCE_GENRE:
-            return "Dance\0";
-        case DISCO_GENRE:
-            return "Disco\0";
-        case FUNK_GENRE:
-            return "Funk\0";
-        case GRUNGE_GENRE:
-            return "Grunge\0";
-        case HIP_HOP_GENRE:
-            return "Hip-Hop\0";
-        case JAZZ_GENRE:
-            return "Jazz\0";
-        case METAL_GENRE:
-            return "Metal\0";
-        case NEW_AGE_GENRE:
-            return "New Age\0";
-        case OLDIES_GENRE:
-            return "Oldies\0";
-        case OTHER_GENRE:
-            return "Other\0";
-        case POP_GENRE:
-            return "Pop\0";
-        case RHYTHM_AND_BLUES_GENRE:
-            return "Rhythm and Blues\0";
-        case RAP_GENRE:
-            return "Rap\0";
-        case REGGAE_GENRE:
-            return "Reggae\0";
-        case ROCK_GENRE:
-            return "Rock\0";
-        case TECHNO_GENRE:
-            return "Techno\0";
-        case INDUSTRIAL_GENRE:
-            return "Industrial\0";
-        case ALTERNATIVE_GENRE:
-            return "Alternative\0";
-        case SKA_GENRE:
-            return "Ska\0";
-        case DEATH_METAL_GENRE:
-            return "Death Metal\0";
-        case PRANKS_GENRE:
-            return "Pranks\0";
-        case SOUNDTRACK_GENRE:
-            return "Soundtrack\0";
-        case EURO_TECHNO_GENRE:
-            return "Euro-Techno\0";
-        case AMBIENT_GENRE:
-            return "Ambient\0";
-        case TRIP_HOP_GENRE:
-            return "Trip-Hop\0";
-        case VOCAL_GENRE:
-            return "Vocal\0";
-        case JAZZ_AND_FUNK_GENRE:
-            return "Jazz and Funk\0";
-        case FUSION_GENRE:
-            return "Fusion\0";
-        case TRANCE_GENRE:
-            return "Trance\0";
-        case CLASSICAL_GENRE:
-            return "Classical\0";
-        case INSTRUMENTAL_GENRE:
-            return "Instrumental\0";
-        case ACID_GENRE:
-            return "Acid\0";
-        case HOUSE_GENRE:
-            return "House\0";
-        case GAME_GENRE:
-            return "Game\0";
-        case SOUND_CLIP_GENRE:
-            return "Sound Clip\0";
-        case GOSPEL_GENRE:
-            return "Gospel\0";
-        case NOISE_GENRE:
-            return "Noise\0";
-        case ALTERNATIVE_ROCK_GENRE:
-            return "Alternative Rock\0";
-        case BASS_GENRE:
-            return "Bass\0";
-        case SOUL_GENRE:
-            return "Soul\0";
-        case PUNK_GENRE:
-            return "Punk\0";
-        case SPACE_GENRE:
-            return "Space\0";
-        case MEDITATIVE_GENRE:
-            return "Meditative\0";
-        case INSTRUMENTAL_POP_GENRE:
-            return "Instrumental Pop\0";
-        case INSTRUMENTAL_ROCK_GENRE:
-            return "Instrumental Rock\0";
-        case ETHNIC_GENRE:
-            return "Ethnic\0";
-        case GOTHIC_GENRE:
-            return "Gothic\0";
-        case DARKWAVE_GENRE:
-            return "Darkwave\0";
-        case TECHNO_INDUSTRIAL_GENRE:
-            return "Techno Industrial\0";
-        case ELECTRONIC_GENRE:
-            return "Electronic\0";
-        case POP_FOLK_GENRE:
-            return "Pop Folk\0";
-        case EURODANCE_GENRE:
-            return "Eurodance\0";
-        case DREAM_GENRE:
-            return "Dream\0";
-        case SOUTHERN_ROCK_GENRE:
-            return "Southern Rock\0";
-        case COMEDY_GENRE:
-            return "Comedy\0";
-        case CULT_GENRE:
-            return "Cult\0";
-        case GANGSTA_GENRE:
-            return "Gangsta\0";
-        case TOP_40_GENRE:
-            return "Top 40\0";
-        case CHRISTIAN_RAP_GENRE:
-            return "Christian Rap\0";
-        case POP_FUNK_GENRE:
-            return "Pop Funk\0";
-        case JUNGLE_MUSIC_GENRE:
-            return "Jungle Music\0";
-        case NATIVE_US_GENRE:
-            return "Native US\0";
-        case CABARET_GENRE:
-            return "Cabaret\0";
-        case NEW_WAVE_GENRE:
-            return "New Wave\0";
-        case PSYCHEDELIC_GENRE:
-            return "Psychedelic\0";
-        case RAVE_GENRE:
-            return "Rave\0";
-        case SHOWTUNES_GENRE:
-            return "Showtunes\0";
-        case TRAILER_GENRE:
-            return "Trailer\0";
-        case LO_FI_GENRE:
-            return "Lo-Fi\0";
-        case TRIBAL_GENRE:
-            return "Tribal\0";
-        case ACID_PUNK_GENRE:
-            return "Acid Punk\0";
-        case ACID_JAZZ_GENRE:
-            return "Acid Jazz\0";
-        case POLKA_GENRE:
-            return "Polka\0";
-        case RETRO_GENRE:
-            return "Retro\0";
-        case MUSICAL_GENRE:
-            return "Musical\0";
-        case ROCKNROLL_GENRE:
-            return "Rock and Roll\0";
-        case HARD_ROCK_GENRE:
-            return "Hard Rock\0";
-        case FOLK_GENRE:
-            return "Folk\0";
-        case FOLK_ROCK_GENRE:
-            return "Folk Rock\0";
-        case NATIONAL_FOLK_GENRE:
-            return "National Folk\0";
-        case SWING_GENRE:
-            return "Swing\0";
-        case FAST_FUSION_GENRE:
-            return "Fast Fusion\0";
-        case BEBOP_GENRE:
-            return "Bebop\0";
-        case LATIN_GENRE:
-            return "Latin\0";
-        case REVIVAL_GENRE:
-            return "Revival\0";
-        case CELTIC_GENRE:
-            return "Celtic\0";
-        case BLUEGRASS_GENRE:
-            return "Bluegrass\0";
-        case AVANTGARDE_GENRE:
-            return "Avantgarde\0";
-        case GOTHIC_ROCK_GENRE:
-            return "Gothic Rock\0";
-        case PROGRESSIVE_ROCK_GENRE:
-            return "Progressive Rock\0";
-        case PSYCHEDELIC_ROCK_GENRE:
-            return "Psychedelic Rock\0";
-        case SYMPHONIC_ROCK_GENRE:
-            return "Symphonic Rock\0";
-        case SLOW_ROCK_GENRE:
-            return "Slow Rock\0";
-        case BIG_BAND_GENRE:
-            return "Big Band\0";
-        case CHORUS_GENRE:
-            return "Chorus\0";
-        case EASY_LISTENING_GENRE:
-            return "Easy Listening\0";
-        case ACOUSTIC_GENRE:
-            return "Acoustic\0";
-        case HUMOUR_GENRE:
-            return "Humour\0";
-        case SPEECH_GENRE:
-            return "Speech\0";
-        case CHANSON_GENRE:
-            return "Chanson\0";
-        case OPERA_GENRE:
-            return "Opera\0";
-        case CHAMBER_MUSIC_GENRE:
-            return "Chamber Music\0";
-        case SONATA_GENRE:
-            return "Sonata\0";
-        case SYMPHONY_GENRE:
-            return "Symphony\0";
-        case BOOTY_BASS_GENRE:
-            return "Booty Bass\0";
-        case PRIMUS_GENRE:
-            return "Primus\0";
-        case PORN_GROOVE_GENRE:
-            return "Porn Groove\0";
-        case SATIRE_GENRE:
-            return "Satire\0";
-        case SLOW_JAM_GENRE:
-            return "Slow Jam\0";
-        case CLUB_GENRE:
-            return "Club\0";
-        case TANGO_GENRE:
-            return "Tango\0";
-        case SAMBA_GENRE:
-            return "Samba\0";
-        case FOLKLORE_GENRE:
-            return "Folklore\0";
-        case BALLAD_GENRE:
-            return "Ballad\0";
-        case POWER_BALLAD_GENRE:
-            return "Power Ballad\0";
-        case RHYTHMIC_SOUL_GENRE:
-            return "Rhythmic Soul\0";
-        case FREESTYLE_GENRE:
-            return "Freestyle\0";
-        case DUET_GENRE:
-            return "Duet\0";
-        case PUNK_ROCK_GENRE:
-            return "Punk Rock\0";
-        case DRUM_SOLO_GENRE:
-            return "Drum Solo\0";
-        case A_CAPPELLA_GENRE:
-            return "A Cappella\0";
-        case EURO_HOUSE_GENRE:
-            return "Euro-House\0";
-        case DANCE_HALL_GENRE:
-            return "Dance Hall\0";
-        case GOA_MUSIC_GENRE:
-            return "Goa Music\0";
-        case DRUM_AND_BASS_GENRE:
-            return "Drum and Bass\0";
-        case CLUB_HOUSE_GENRE:
-            return "Club-House\0";
-        case HARDCORE_TECHNO_GENRE:
-            return "Hardcore Techno\0";
-        case TERROR_GENRE:
-            return "Terror\0";
-        case INDIE_GENRE:
-            return "Indie\0";
-        case BRITPOP_GENRE:
-            return "Britpop\0";
-        case NEGERPUNK_GENRE:
-            return "Negerpunk\0";
-        case POLSK_PUNK_GENRE:
-            return "Polsk Punk\0";
-        case BEAT_GENRE:
-            return "Beat\0";
-        case CHRISTIAN_GANGSTA_RAP_GENRE:
-            return "Christian Gangsta Rap\0";
-        case HEAVY_METAL_GENRE:
-            return "Heavy Metal\0";
-        case BLACK_METAL_GENRE:
-            return "Black Metal\0";
-        case CROSSOVER_GENRE:
-            return "Crossover\0";
-        case CONTEMPORARY_CHRISTIAN_GENRE:
-            return "Contemporary Christian\0";
-        case CHRISTIAN_ROCK_GENRE:
-            return "Christian Rock\0";
-        case MERENGUE_GENRE:
-            return "Merengue\0";
-        case SALSA_GENRE:
-            return "Salsa\0";
-        case THRASH_METAL_GENRE:
-            return "Thrash Metal\0";
-        case ANIME_GENRE:
-            return "Anime\0";
-        case JPOP_GENRE:
-            return "Jpop\0";
-        case SYNTHPOP_GENRE:
-            return "Synthpop\0";
-        case ABSTRACT_GENRE:
-            return "Abstract\0";
-        case ART_ROCK_GENRE:
-            return "Art Rock";
-        case BAROQUE_GENRE:
-            return "Baroque\0";
-        case BIG_BEAT_GENRE:
-            return "Big Beat\0";
-        case BREAKBEAT_GENRE:
-            return "Breakbeat\0";
-        case CHILLOUT_GENRE:
-            return "Chillout\0";
-        case DOWNTEMPO_GENRE:
-            return "Downtempo\0";
-        case DUB_GENRE:
-            return "Dub\0";
-        case EBM_GENRE:
-            return "EBM\0";
-        case ECLECTIC_GENRE:
-            return "Eclectic\0";
-        case ELECTRO_GENRE:
-            return "Electro\0";
-        case ELECTROCLASH_GENRE:
-            return "Electroclash\0";
-        case EMO_GENRE:
-            return "Emo\0";
-        case EXPERIMENTAL_GENRE:
-            return "Experimental\0";
-        case GARAGE_GENRE:
-            return "Garage\0";
-        case GLOBAL_GENRE:
-            return "Global\0";
-        case IDM_GENRE:
-            return "IDM\0";
-        case ILLBIENT_GENRE:
-            return "Illbient\0";
-        case INDUSTRO_GOTH_GENRE:
-            return "Industro-Goth\0";
-        case JAM_BAND_GENRE:
-            return "Jam Band\0";
-        case KRAUTROCK_GENRE:
-            return "Krautrock\0";
-        case LEFTFIELD_GENRE:
-            return "Leftfield\0";
-        case LOUNGE_GENRE:
-            return "Lounge\0";
-        case MATH_ROCK_GENRE:
-            return "Math Rock\0";
-        case NEW_ROMANTIC_GENRE:
-            return "New Romantic\0";
-        case NU_BREAKZ_GENRE:
-            return "Nu-Breakz\0";
-        case POST_PUNK_GENRE:
-            return "Post-Punk\0";
-        case POST_ROCK_GENRE:
-            return "Post-Rock\0";
-        case PSYTRANCE_GENRE:
-            return "Psytrance\0";
-        case SHOEGAZE_GENRE:
-            return "Shoegaze\0";
-        case SPACE_ROCK_GENRE:
-            return "Space Rock\0";
-        case TROP_ROCK_GENRE:
-            return "Trop Rock\0";
-        case WORLD_MUSIC_GENRE:
-            return "World Music\0";
-        case NEOCLASSICAL_GENRE:
-            return "Neoclassical\0";
-        case AUDIOBOOK_GENRE:
-            return "Audiobook\0";
-        case AUDIO_THEATRE_GENRE:
-            return "Audio Theatre\0";
-        case NEUE_DEUTSCHE_WELLE_GENRE:
-            return "Neue Deutsche Welle\0";
-        case PODCAST_GENRE:
-            return "Podcast\0";
-        case INDIE_ROCK_GENRE:
-            return "Indie-Rock\0";
-        case G_FUNK_GENRE:
-            return "G-Funk\0";
-        case DUBSTEP_GENRE:
-            return "Dubstep\0";
-        case GARAGE_ROCK_GENRE:
-            return "Garage Rock\0";
-        case PSYBIENT_GENRE:
-            return "Psybient\0";
-        default:
-            break;
-    }
-    //191 supported genres god this enum is huge
-    return "Other\0";
+    return (char *) id3v1GenreName(val);
+}
+
+/**
+ * @brief Returns the name of a genre.
+ * @details Looks the genre up in a static table, nothing is allocated. Returns "Other" for values outside the
+ * table as specified by the ID3v1 standard.
+ * @param val - The genre enum value to name
+ * @return const char* - Name of the genre, never NULL. Borrowed, must not be freed.
+ */
+const char *id3v1GenreName(Genre val) {
+    if (val < BLUES_GENRE || val > PSYBIENT_GENRE) {
+        return internal_id3v1Genres[OTHER_GENRE];
+    }
+
+    return internal_id3v1Genres[val];
+}
+
+/**
+ * @brief Finds the genre named by a string.
+ * @details Accepts a genre name compared without case, such as "Rock", or a numeric reference as found in ID3v2
+ * genre frames, such as "(17)", "(17)Rock", or "17". A reference takes priority over the text that follows it.
+ * Names are found by binary search over a table sorted at compile time, so nothing is allocated.
+ * @param genre - Null-terminated genre name or reference
+ * @return Genre - The named genre, or GENRE_UNKNOWN if the string names none
+ */
+Genre id3v1GenreFromString(const char *genre) {
+    if (genre == NULL || genre[0] == '\0') {
+        return GENRE_UNKNOWN;
+    }
+
+    const char *digits = (genre[0] == '(') ? genre + 1 : genre;
+    size_t low = 0;
+    size_t high = ID3V1_GENRE_COUNT;
+    int value = 0;
+    int i = 0;
+
+    // numeric reference
+    for (i = 0; i < 3 && isdigit((unsigned char) digits[i]); i++) {
+        value = value * 10 + (digits[i] - '0');
+    }
+
+    if (i > 0 && ((genre[0] == '(' && digits[i] == ')') || (genre[0] != '(' && digits[i] == '\0'))) {
+        return (value <= PSYBIENT_GENRE) ? (Genre) value : GENRE_UNKNOWN;
+    }
+
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        int cmp = internal_id3v1GenreCompare(genre, internal_id3v1Genres[internal_id3v1GenresByName[mid]]);
+
+        if (cmp == 0) {
+            return internal_id3v1GenresByName[mid];
+        }
+
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return GENRE_UNKNOWN;
 }
 
 /**
@@ -744,17 +663,35 @@ int id3v1ReadTrack(const Id3v1Tag *tag) {
  * @return char* - Newly allocated JSON string, never NULL.
  */
 char *id3v1ToJSON(const Id3v1Tag *tag) {
+    Id3Sink *sink = id3SinkCreateBuffer(ID3V1_MAX_SIZE * 2);
     char *json = NULL;
-    int memCount = 3;
 
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3v1ToJSONSink(tag, sink)) {
+        json = (char *) id3SinkTakeBuffer(sink, NULL);
+    }
+
+    id3SinkDestroy(&sink);
+    return json;
+}
+
+/**
+ * @brief Writes the JSON representation of an Id3v1Tag into a sink.
+ * @details Writes the same text id3v1ToJSON returns, without a null terminator.
+ * @param tag - The tag to convert.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 on success, 0 on failure.
+ */
+int id3v1ToJSONSink(const Id3v1Tag *tag, Id3Sink *sink) {
     if (tag == NULL) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
+        return id3SinkWriteString(sink, "{}");
     }
 
-    memCount += snprintf(
-        NULL, 0,
+    return id3SinkPrintf(
+        sink,
         "{\"title\":\"%s\",\"artist\":\"%s\",\"album\":\"%s\",\"year\":%d,\"track\":%d,\"comment\":\"%s\",\"genreNumber\":%d,\"genre\":\"%s\"}",
         (char *) tag->title,
         (char *) tag->artist,
@@ -763,47 +700,298 @@ char *id3v1ToJSON(const Id3v1Tag *tag) {
         tag->track,
         (char *) tag->comment,
         tag->genre,
-        id3v1GenreFromTable(tag->genre));
+        id3v1GenreName(tag->genre));
+}
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3v1JSONField(Id3JsonReader *reader, uint8_t field[ID3V1_FIELD_SIZE + 1]) {
+    size_t length = 0;
+    const char *text = id3JsonReadString(reader, &length);
+
+    if (text == NULL) {
+        return false;
+    }
+
+    memset(field, 0, ID3V1_FIELD_SIZE + 1);
+    memcpy(field, text, (length > ID3V1_FIELD_SIZE) ? ID3V1_FIELD_SIZE : length);
+    return true;
+}
+
+/**
+ * @brief Builds an Id3v1Tag from its JSON representation.
+ * @details Reads the object id3v1ToJSON writes. Text longer than an ID3v1 field is cut to ID3V1_FIELD_SIZE bytes,
+ * the genre is taken from "genreNumber" and the "genre" name is ignored. Unknown members are skipped. Returns NULL
+ * for an empty object "{}" and on failure, check the failed field of the reader to tell them apart.
+ * @param reader - Reader positioned at the tag object.
+ * @return Id3v1Tag* - Heap allocated tag, or NULL. Caller must free with id3v1DestroyTag.
+ */
+Id3v1Tag *id3v1TagFromJSONReader(Id3JsonReader *reader) {
+    uint8_t title[ID3V1_FIELD_SIZE + 1] = {0};
+    uint8_t artist[ID3V1_FIELD_SIZE + 1] = {0};
+    uint8_t album[ID3V1_FIELD_SIZE + 1] = {0};
+    uint8_t comment[ID3V1_FIELD_SIZE + 1] = {0};
+    int64_t year = 0;
+    int64_t track = 0;
+    int64_t genre = OTHER_GENRE;
+    bool members = false;
+
+    if (reader == NULL || !id3JsonBeginObject(reader)) {
+        return NULL;
+    }
+
+    while (id3JsonNextMember(reader)) {
+        members = true;
+
+        if (strcmp(reader->key, "title") == 0) {
+            (void) internal_id3v1JSONField(reader, title);
+        } else if (strcmp(reader->key, "artist") == 0) {
+            (void) internal_id3v1JSONField(reader, artist);
+        } else if (strcmp(reader->key, "album") == 0) {
+            (void) internal_id3v1JSONField(reader, album);
+        } else if (strcmp(reader->key, "comment") == 0) {
+            (void) internal_id3v1JSONField(reader, comment);
+        } else if (strcmp(reader->key, "year") == 0) {
+            (void) id3JsonReadInteger(reader, &year);
+        } else if (strcmp(reader->key, "track") == 0) {
+            (void) id3JsonReadInteger(reader, &track);
+        } else if (strcmp(reader->key, "genreNumber") == 0) {
+            (void) id3JsonReadInteger(reader, &genre);
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !members) {
+        return NULL;
+    }
+
+    if (year < INT_MIN || year > INT_MAX || track < INT_MIN || track > INT_MAX || genre < 0 || genre > UINT8_MAX) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return id3v1CreateTag(title, artist, album, (int) year, (int) track, comment, (Genre) genre);
+}
+
+/**
+ * @brief Builds an Id3v1Tag from a JSON string.
+ * @details Convenience wrapper around id3v1TagFromJSONReader, the whole string must be a single tag object.
+ * @param json - Null-terminated JSON text as written by id3v1ToJSON.
+ * @return Id3v1Tag* - Heap allocated tag, or NULL if the JSON is empty or invalid. Caller must free with id3v1DestroyTag.
+ */
+Id3v1Tag *id3v1TagFromJSON(const char *json) {
+    Id3JsonReader *reader = NULL;
+    Id3v1Tag *tag = NULL;
 
-    json = calloc(memCount + 1, sizeof(char));
     if (json == NULL) {
         return NULL;
     }
-    (void) snprintf(json, memCount + 1,
-                    "{\"title\":\"%s\",\"artist\":\"%s\",\"album\":\"%s\",\"year\":%d,\"track\":%d,\"comment\":\"%s\",\"genreNumber\":%d,\"genre\":\"%s\"}",
-                    (char *) tag->title,
-                    (char *) tag->artist,
-                    (char *) tag->albumTitle,
-                    tag->year,
-                    tag->track,
-                    (char *) tag->comment,
-                    tag->genre,
-                    id3v1GenreFromTable(tag->genre));
 
+    reader = id3JsonReaderCreate(json, strlen(json));
+    tag = id3v1TagFromJSONReader(reader);
 
-    return json;
+    if (tag != NULL && !id3JsonReaderFinished(reader)) {
+        id3v1DestroyTag(&tag);
+    }
+
+    id3JsonReaderDestroy(&reader);
+    return tag;
+}
+
+// internal function ------------------------------------------------------------------------
+static void internal_id3v1CBORField(Id3Sink *sink, const char *key, const uint8_t field[ID3V1_FIELD_SIZE]) {
+    size_t length = 0;
+
+    // fields are only null-terminated when shorter than the field
+    while (length < ID3V1_FIELD_SIZE && field[length] != 0) {
+        length++;
+    }
+
+    (void) id3CborWriteString(sink, key);
+    (void) id3CborWriteText(sink, (const char *) field, length);
 }
 
 /**
- * @brief Writes/Overwrites an Id3v1Tag to the bottom of a file .
- * @details Serializes the tag to ID3v1 binary format and writes it to the file. Creates the file if it doesn't exist,
- * overwrites existing ID3v1 tags if present, or appends to files without tags.
- * @param filePath - The file path to write to. Must not be NULL.
- * @param tag - The tag to write. Must not be NULL.
+ * @brief Converts an Id3v1Tag to CBOR.
+ * @details Convenience wrapper around id3v1ToCBORSink collecting the output in a buffer.
+ * @param tag - The tag to convert.
+ * @param outl - Receives the number of bytes returned, 0 on failure.
+ * @return uint8_t* - Heap allocated CBOR, or NULL on failure. Caller must free the returned buffer.
+ */
+uint8_t *id3v1ToCBOR(const Id3v1Tag *tag, size_t *outl) {
+    Id3Sink *sink = NULL;
+    uint8_t *out = NULL;
+
+    if (outl == NULL) {
+        return NULL;
+    }
+
+    *outl = 0;
+    sink = id3SinkCreateBuffer(ID3V1_MAX_SIZE * 2);
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3v1ToCBORSink(tag, sink)) {
+        out = id3SinkTakeBuffer(sink, outl);
+    }
+
+    id3SinkDestroy(&sink);
+    return out;
+}
+
+/**
+ * @brief Writes the CBOR representation of an Id3v1Tag into a sink.
+ * @details Writes a map with the same members id3v1ToJSON writes, text as text strings and numbers as integers.
+ * A NULL tag writes an empty map.
+ * @param tag - The tag to convert.
+ * @param sink - Sink receiving the CBOR.
  * @return int - 1 on success, 0 on failure.
  */
-int id3v1WriteTagToFile(const char *filePath, const Id3v1Tag *tag) {
-    if (filePath == NULL || tag == NULL) {
-        return 0;
+int id3v1ToCBORSink(const Id3v1Tag *tag, Id3Sink *sink) {
+    const char *genre = NULL;
+
+    if (sink == NULL) {
+        return false;
     }
 
-    char *tmp = NULL;
+    if (tag == NULL) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    (void) id3CborWriteMap(sink, 8);
+    internal_id3v1CBORField(sink, "title", tag->title);
+    internal_id3v1CBORField(sink, "artist", tag->artist);
+    internal_id3v1CBORField(sink, "album", tag->albumTitle);
+    (void) id3CborWriteString(sink, "year");
+    (void) id3CborWriteUnsigned(sink, (tag->year > 0) ? (uint64_t) tag->year : 0);
+    (void) id3CborWriteString(sink, "track");
+    (void) id3CborWriteUnsigned(sink, (tag->track > 0) ? (uint64_t) tag->track : 0);
+    internal_id3v1CBORField(sink, "comment", tag->comment);
+    (void) id3CborWriteString(sink, "genreNumber");
+    (void) id3CborWriteUnsigned(sink, (uint64_t) tag->genre & 0xFF);
+
+    genre = id3v1GenreName(tag->genre);
+    (void) id3CborWriteString(sink, "genre");
+    return id3CborWriteString(sink, (genre != NULL) ? genre : "");
+}
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3v1CBORReadField(Id3CborReader *reader, uint8_t field[ID3V1_FIELD_SIZE + 1]) {
+    size_t length = 0;
+    const char *text = id3CborReadText(reader, &length);
+
+    if (text == NULL) {
+        return false;
+    }
+
+    memset(field, 0, ID3V1_FIELD_SIZE + 1);
+    memcpy(field, text, (length > ID3V1_FIELD_SIZE) ? ID3V1_FIELD_SIZE : length);
+    return true;
+}
+
+/**
+ * @brief Builds an Id3v1Tag from its CBOR representation.
+ * @details Reads the map id3v1ToCBORSink writes, see id3v1TagFromJSONReader. Returns NULL for an empty map and on
+ * failure, check the failed field of the reader to tell them apart.
+ * @param reader - Reader positioned at the tag map.
+ * @return Id3v1Tag* - Heap allocated tag, or NULL. Caller must free with id3v1DestroyTag.
+ */
+Id3v1Tag *id3v1TagFromCBORReader(Id3CborReader *reader) {
+    uint8_t title[ID3V1_FIELD_SIZE + 1] = {0};
+    uint8_t artist[ID3V1_FIELD_SIZE + 1] = {0};
+    uint8_t album[ID3V1_FIELD_SIZE + 1] = {0};
+    uint8_t comment[ID3V1_FIELD_SIZE + 1] = {0};
+    uint64_t year = 0;
+    uint64_t track = 0;
+    uint64_t genre = OTHER_GENRE;
+    bool members = false;
+
+    if (reader == NULL || !id3CborBeginMap(reader)) {
+        return NULL;
+    }
+
+    while (id3CborNextMember(reader)) {
+        members = true;
+
+        if (strcmp(reader->key, "title") == 0) {
+            (void) internal_id3v1CBORReadField(reader, title);
+        } else if (strcmp(reader->key, "artist") == 0) {
+            (void) internal_id3v1CBORReadField(reader, artist);
+        } else if (strcmp(reader->key, "album") == 0) {
+            (void) internal_id3v1CBORReadField(reader, album);
+        } else if (strcmp(reader->key, "comment") == 0) {
+            (void) internal_id3v1CBORReadField(reader, comment);
+        } else if (strcmp(reader->key, "year") == 0) {
+            (void) id3CborReadUnsigned(reader, &year);
+        } else if (strcmp(reader->key, "track") == 0) {
+            (void) id3CborReadUnsigned(reader, &track);
+        } else if (strcmp(reader->key, "genreNumber") == 0) {
+            (void) id3CborReadUnsigned(reader, &genre);
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !members) {
+        return NULL;
+    }
+
+    if (year > INT_MAX || track > INT_MAX || genre > UINT8_MAX) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return id3v1CreateTag(title, artist, album, (int) year, (int) track, comment, (Genre) genre);
+}
+
+/**
+ * @brief Builds an Id3v1Tag from its CBOR representation.
+ * @details Convenience wrapper around id3v1TagFromCBORReader, the whole buffer must be a single tag map.
+ * @param cbor - CBOR as written by id3v1ToCBOR.
+ * @param length - Number of bytes in cbor.
+ * @return Id3v1Tag* - Heap allocated tag, or NULL if the CBOR is empty or invalid. Caller must free with id3v1DestroyTag.
+ */
+Id3v1Tag *id3v1TagFromCBOR(const uint8_t *cbor, size_t length) {
+    Id3CborReader *reader = id3CborReaderCreate(cbor, length);
+    Id3v1Tag *tag = id3v1TagFromCBORReader(reader);
+
+    if (tag != NULL && !id3CborReaderFinished(reader)) {
+        id3v1DestroyTag(&tag);
+    }
+
+    id3CborReaderDestroy(&reader);
+    return tag;
+}
+
+/**
+ * @brief Serializes an Id3v1Tag to its 128 byte binary representation.
+ * @details Writes the "TAG" identifier followed by the title, artist, album, year, comment, track, and genre fields.
+ * The year is written as up to four ASCII digits, and a track between 1 and 255 is stored in the last comment byte
+ * as described by ID3v1.1.
+ * @param tag - The tag to serialize. Must not be NULL.
+ * @param outl - Receives the number of bytes returned, ID3V1_MAX_SIZE on success and 0 on failure.
+ * @return uint8_t* - Pointer to the serialized tag, or NULL on failure. Caller must free the returned buffer.
+ */
+uint8_t *id3v1TagSerialize(const Id3v1Tag *tag, size_t *outl) {
+    if (tag == NULL) {
+        *outl = 0;
+        return NULL;
+    }
+
+    char year[ID3V1_YEAR_SIZE] = {0};
     unsigned char byte = 0x00;
     int n = 0;
     int yearW = 0;
-    FILE *fp = NULL;
+    uint8_t *out = NULL;
     ByteStream *stream = byteStreamCreate(NULL, ID3V1_MAX_SIZE);
 
+    if (stream == NULL) {
+        *outl = 0;
+        return NULL;
+    }
+
     byteStreamWrite(stream, (unsigned char *) "TAG", ID3V1_TAG_ID_SIZE);
     byteStreamWrite(stream, (unsigned char *) tag->title, ID3V1_FIELD_SIZE);
     byteStreamWrite(stream, (unsigned char *) tag->artist, ID3V1_FIELD_SIZE);
@@ -815,21 +1003,16 @@ int id3v1WriteTagToFile(const char *filePath, const Id3v1Tag *tag) {
         yearW = 0;
     } else {
         n = (int) log10(tag->year) + 1;
+        n = (n > ID3V1_YEAR_SIZE) ? ID3V1_YEAR_SIZE : n;
         yearW = tag->year;
     }
-    tmp = calloc(n, sizeof(char));
-    if (tmp == NULL) {
-        byteStreamDestroy(stream);
-        return 0;
-    }
 
     for (int i = n - 1; i >= 0; --i, yearW /= 10) {
-        tmp[i] = (char) ((yearW % 10) + '0');
+        year[i] = (char) ((yearW % 10) + '0');
     }
 
     //write convert
-    byteStreamWrite(stream, (unsigned char *) tmp, ID3V1_YEAR_SIZE);
-    free(tmp);
+    byteStreamWrite(stream, (unsigned char *) year, ID3V1_YEAR_SIZE);
 
     byteStreamWrite(stream, (unsigned char *) tag->comment, ID3V1_FIELD_SIZE);
 
@@ -846,74 +1029,85 @@ int id3v1WriteTagToFile(const char *filePath, const Id3v1Tag *tag) {
 
     byteStreamRewind(stream);
 
-    fp = fopen(filePath, "r+b");
-    if (fp == NULL) {
-        //create a new file and write the bytes to it
-        fp = fopen(filePath, "wb");
-        if (fp == NULL) {
-            byteStreamDestroy(stream);
-            return 0;
-        }
+    out = calloc(ID3V1_MAX_SIZE, sizeof(uint8_t));
 
-        if ((fwrite(byteStreamCursor(stream), 1, ID3V1_MAX_SIZE, fp)) == 0) {
-            byteStreamDestroy(stream);
-            (void) fclose(fp);
-            return 0;
-        }
-    } else {
-        //get file size
-        (void) fseek(fp, 0, SEEK_END);
-        const long index = ftell(fp);
-        unsigned char buffer[ID3V1_MAX_SIZE];
-
-        //seek to tag start
-        //if the file is less than 128 bytes then we can catch that here.
-        //there will be no tag due to size or if there is its corrupt and
-        //will be treated as regular file data and skipped over.
-        if ((fseek(fp, index - ID3V1_MAX_SIZE, SEEK_SET)) != 0) {
-            (void) fseek(fp, 0, SEEK_END);
-            if (fwrite(byteStreamCursor(stream), 1, ID3V1_MAX_SIZE, fp) != 0) {
-                byteStreamDestroy(stream);
-                (void) fclose(fp);
-                return 1;
-            }
-
-            byteStreamDestroy(stream);
-            (void) fclose(fp);
-            return 0;
-        }
+    if (out == NULL) {
+        byteStreamDestroy(stream);
+        *outl = 0;
+        return NULL;
+    }
 
-        //check to see if the file has ID3 metadata
-        if (fread(buffer, 1, ID3V1_TAG_ID_SIZE, fp) == 0) {
-            byteStreamDestroy(stream);
-            (void) fclose(fp);
-            return 0;
-        }
+    byteStreamRead(stream, out, ID3V1_MAX_SIZE);
+    byteStreamDestroy(stream);
+    *outl = ID3V1_MAX_SIZE;
 
-        //coupled not find 'TAG'
-        if (!id3v1HasTag((uint8_t *) buffer)) {
-            if (fseek(fp, 0, SEEK_END) != 0) {
-                byteStreamDestroy(stream);
-                (void) fclose(fp);
-                return 0;
-            }
-        } else {
-            if (fseek(fp, index - ID3V1_MAX_SIZE, SEEK_SET) != 0) {
-                byteStreamDestroy(stream);
-                (void) fclose(fp);
-                return 0;
-            }
-        }
+    return out;
+}
 
-        //write bytes to the file at the right position
-        if ((fwrite(byteStreamCursor(stream), 1, ID3V1_MAX_SIZE, fp)) == 0) {
-            byteStreamDestroy(stream);
-            (void) fclose(fp);
+/**
+ * @brief Serializes an Id3v1Tag into a sink.
+ * @details Writes the same 128 bytes id3v1TagSerialize returns.
+ * @param tag - The tag to serialize. Must not be NULL.
+ * @param sink - Sink receiving the serialized tag.
+ * @return int - 1 on success, 0 on failure.
+ */
+int id3v1TagSerializeToSink(const Id3v1Tag *tag, Id3Sink *sink) {
+    size_t outl = 0;
+    uint8_t *out = id3v1TagSerialize(tag, &outl);
+    int ret = 0;
+
+    if (out != NULL) {
+        ret = id3SinkWrite(sink, out, outl);
+        free(out);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief Writes/Overwrites an Id3v1Tag to the bottom of a file .
+ * @details Serializes the tag to ID3v1 binary format and writes it to the file. Creates the file if it doesn't exist,
+ * overwrites existing ID3v1 tags if present, or appends to files without tags.
+ * @param filePath - The file path to write to. Must not be NULL.
+ * @param tag - The tag to write. Must not be NULL.
+ * @return int - 1 on success, 0 on failure.
+ */
+int id3v1WriteTagToFile(const char *filePath, const Id3v1Tag *tag) {
+    if (filePath == NULL || tag == NULL) {
+        return 0;
+    }
+
+    FILE *fp = NULL;
+    int fd = -1;
+    int ok = 0;
+    size_t outl = 0;
+    uint8_t *out = id3v1TagSerialize(tag, &outl);
+    Id3FileLayout layout;
+
+    if (out == NULL) {
+        return 0;
+    }
+
+    fd = id3FileOpen(filePath, true);
+
+    if (fd < 0) {
+        //create a new file and write the bytes to it
+        fp = fopen(filePath, "wb");
+        if (fp == NULL) {
+            free(out);
             return 0;
         }
+
+        ok = (fwrite(out, 1, outl, fp) == outl);
+        ok = (fclose(fp) == 0) && ok;
+        free(out);
+        return ok;
     }
 
-    byteStreamDestroy(stream);
-    (void) fclose(fp);
-    return 1;
+    //overwrite an existing tag or append a new one
+    ok = id3FileReadLayout(fd, &layout) && id3FileWriteAt(fd, out, outl, layout.id3v1Offset);
+
+    id3FileClose(fd);
+    free(out);
+    return ok;
 }
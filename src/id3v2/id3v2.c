@@ -19,23 +19,39 @@
 #include "id3v2/id3v2Frame.h"
 #include "id3v2/id3v2Parser.h"
 #include "id3v2/id3v2Context.h"
+#include "id3v2/id3v2Unsynchronisation.h"
 #include "id3v2/id3v2TagIdentity.h"
+#include "id3File.h"
+#include "id3Crc32.h"
+#include "id3Hash.h"
+#include "id3Mpeg.h"
+
+//! Initial capacity of the buffer a tag is converted to JSON in
+#define ID3V2_JSON_TAG_CAPACITY 4096
 
 /**
  * @brief Reads and parses an ID3v2 tag from a file.
- * @details Loads file contents into memory, parses the ID3v2 tag structure, and cleans up temporary resources.
- * Returns NULL on any failure (invalid filename, file I/O error, or parse error).
+ * @details Maps the file into memory and parses the tag straight from the mapping, so the file is never copied onto
+ * the heap. When the file cannot be mapped it is read into memory instead. Returns NULL on any failure (invalid
+ * filename, file I/O error, or parse error).
  * @param filename - Path to the file containing an ID3v2 tag.
  * @return Id3v2Tag* - Newly allocated tag on success, NULL on failure. Caller must free with id3v2DestroyTag.
  */
 Id3v2Tag *id3v2TagFromFile(const char *filename) {
     ByteStream *stream = NULL;
     Id3v2Tag *tag = NULL;
+    Id3FileMapping mapping = {0};
 
     if (filename == NULL) {
         return NULL;
     }
 
+    if (id3FileMap(filename, &mapping)) {
+        tag = id3v2TagFromMapping(&mapping);
+        id3FileUnmap(&mapping);
+        return tag;
+    }
+
     stream = byteStreamFromFile(filename);
     if (stream == NULL) {
         return NULL;
@@ -47,6 +63,82 @@ Id3v2Tag *id3v2TagFromFile(const char *filename) {
     return tag;
 }
 
+/**
+ * @brief Reads an ID3v2 tag from a file, leaving the content of pictures and objects in the file.
+ * @details Works like id3v2TagFromFile but the data of APIC, PIC, GEOB, and GEO frames stored as is is not copied,
+ * see id3v2ParseTagFromFileBuffer. It is read from the file whenever it is needed, for example by id3v2ReadPicture or
+ * id3v2TagToJSON, so until the tag is written the memory it takes does not depend on the size of its artwork. Writing
+ * the tag loads the content into it first. Once the file changes other than by writing the tag back to it the content
+ * can no longer be read and whatever needs it fails. When the file cannot be mapped it is read like id3v2TagFromFile
+ * does.
+ * @param filename - Path to the file containing an ID3v2 tag.
+ * @return Id3v2Tag* - Newly allocated tag on success, NULL on failure. Caller must free with id3v2DestroyTag.
+ */
+Id3v2Tag *id3v2TagFromFileLazy(const char *filename) {
+    Id3v2Tag *tag = NULL;
+    Id3v2Source *source = NULL;
+    Id3FileMapping mapping = {0};
+
+    if (filename == NULL) {
+        return NULL;
+    }
+
+    if (!id3FileMap(filename, &mapping)) {
+        return id3v2TagFromFile(filename);
+    }
+
+    source = id3v2CreateSource(filename);
+
+    if (source != NULL) {
+        tag = id3v2ParseTagFromFileBuffer((uint8_t *) mapping.data, mapping.length, NULL, source);
+        id3v2ReleaseSource(&source);
+    }
+
+    id3FileUnmap(&mapping);
+    return tag;
+}
+
+/**
+ * @brief Parses an ID3v2 tag from a file mapped into memory.
+ * @details The tag owns everything it holds, so the mapping may be released as soon as this returns. Keep it when
+ * pictures or objects are to be read with id3v2ReadPictureView.
+ * @param mapping - Mapping created by id3FileMap.
+ * @return Id3v2Tag* - Newly allocated tag on success, NULL on failure. Caller must free with id3v2DestroyTag.
+ */
+Id3v2Tag *id3v2TagFromMapping(const Id3FileMapping *mapping) {
+    if (mapping == NULL || mapping->data == NULL) {
+        return NULL;
+    }
+
+    // the parser never writes to its input, it resynchronises into memory of its own
+    return id3v2ParseTagFromBuffer((uint8_t *) mapping->data, mapping->length, NULL);
+}
+
+/**
+ * @brief Checks the CRC-32 recorded in the extended header of a file's ID3v2 tag.
+ * @details Reads the file and verifies it with id3v2VerifyTagCrc. Tags without a CRC never verify.
+ * @param filename - Path to the file containing an ID3v2 tag.
+ * @return bool - true if the tag has a CRC matching its content, false otherwise.
+ */
+bool id3v2VerifyTagCrcFromFile(const char *filename) {
+    ByteStream *stream = NULL;
+    bool ok = false;
+
+    if (filename == NULL) {
+        return false;
+    }
+
+    stream = byteStreamFromFile(filename);
+    if (stream == NULL) {
+        return false;
+    }
+
+    ok = id3v2VerifyTagCrc(stream->buffer, stream->bufferSize);
+    byteStreamDestroy(stream);
+
+    return ok;
+}
+
 /**
  * @brief Creates a deep copy of an ID3v2 tag structure.
  * @details Recursively duplicates the tag header, extended header (if present), and all frames.
@@ -789,6 +881,7 @@ char *id3v2ReadComment(Id3v2Tag *tag) {
  * @brief Extracts picture/artwork data of a specific type from an ID3v2 tag.
  * @details Searches for picture frames (PIC/APIC) matching the requested picture type, traversing all frames until a match is found.
  * Clamps invalid type values to 0x00 (Other). Returns NULL if no matching picture exists or tag is invalid.
+ * Pictures left in the file by id3v2TagFromFileLazy are read from it.
  * @param type - Picture type to search for.
  * @param tag - Tag to search for picture data.
  * @param dataSize - Output parameter receiving the size of the picture data in bytes, set to 0 on failure.
@@ -805,7 +898,7 @@ uint8_t *id3v2ReadPicture(uint8_t type, const Id3v2Tag *tag, size_t *dataSize) {
     ListIter frames = listCreateIterator(tag->frames);
     uint8_t usableType = ((type > 0x14) ? 0x00 : type); // clamp type
 
-    while ((f = listIteratorNext(&frames)) != NULL) {
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
         ListIter entries = id3v2CreateFrameEntryTraverser(f);
 
         if (memcmp("PIC", f->header->id, ID3V2_FRAME_ID_MAX_SIZE - 1) == 0 ||
@@ -823,6 +916,187 @@ uint8_t *id3v2ReadPicture(uint8_t type, const Id3v2Tag *tag, size_t *dataSize) {
     return NULL;
 }
 
+/**
+ * @brief Finds picture data of a specific type in the file mapping a tag was read from.
+ * @details Works like id3v2ReadPicture but returns a pointer into the mapping instead of a copy. Pictures changed
+ * since the tag was read, or stored unsynchronised or compressed, are not in the mapping as they are held and NULL
+ * is returned for them, id3v2ReadPicture still reads those.
+ * @param type - Picture type to search for.
+ * @param tag - Tag read from mapping.
+ * @param mapping - Mapping of the file the tag was read from, see id3FileMap.
+ * @param dataSize - Output parameter receiving the size of the picture data in bytes, set to 0 on failure.
+ * @return const uint8_t* - Picture data valid until the mapping is released, NULL if not found.
+ */
+const uint8_t *id3v2ReadPictureView(uint8_t type, const Id3v2Tag *tag, const Id3FileMapping *mapping,
+                                    size_t *dataSize) {
+    *dataSize = 0;
+
+    if (tag == NULL || mapping == NULL) {
+        return NULL;
+    }
+
+    Id3v2Frame *f = NULL;
+    ListIter frames = listCreateIterator(tag->frames);
+    uint8_t usableType = ((type > 0x14) ? 0x00 : type); // clamp type
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        ListIter entries = id3v2CreateFrameEntryTraverser(f);
+
+        if (memcmp("PIC", f->header->id, ID3V2_FRAME_ID_MAX_SIZE - 1) == 0 ||
+            memcmp("APIC", f->header->id, ID3V2_FRAME_ID_MAX_SIZE) == 0) {
+            id3v2ReadFrameEntryAsU8(&entries); // encoding
+            id3v2ReadFrameEntryAsU8(&entries); // mime type
+
+            if (id3v2ReadFrameEntryAsU8(&entries) == usableType) {
+                return id3v2FrameEntryView(f, mapping, dataSize);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Copies picture data of a specific type from a file's ID3v2 tag to a file descriptor.
+ * @details The tag is read with id3v2TagFromFileLazy, so the picture is never read into memory. Its bytes are copied
+ * from the file to fd by the kernel with id3FileCopyRange, see there for the fallbacks used when that is not
+ * possible. Pictures stored unsynchronised or compressed cannot be copied as they are and are written from the
+ * parsed tag instead. Nothing is copied from a file that changed after its tag was read, see id3v2OpenContentSource.
+ * fd is written from its current position and is not closed.
+ * @param filePath - Path to the file containing an ID3v2 tag.
+ * @param type - Picture type to search for, clamped like id3v2ReadPicture does.
+ * @param fd - File descriptor to write the picture to, a regular file, pipe, or socket.
+ * @return bool - true if the whole picture was written, false if there is none or reading or writing failed.
+ */
+bool id3v2ExtractPictureToFd(const char *filePath, uint8_t type, int fd) {
+    if (filePath == NULL || fd < 0) {
+        return false;
+    }
+
+    Id3v2Tag *tag = id3v2TagFromFileLazy(filePath);
+
+    if (tag == NULL) {
+        return false;
+    }
+
+    bool ok = false;
+    Id3v2Frame *f = NULL;
+    ListIter frames = listCreateIterator(tag->frames);
+    uint8_t usableType = ((type > 0x14) ? 0x00 : type); // clamp type
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        if (memcmp("PIC", f->header->id, ID3V2_FRAME_ID_MAX_SIZE - 1) != 0 &&
+            memcmp("APIC", f->header->id, ID3V2_FRAME_ID_MAX_SIZE) != 0) {
+            continue;
+        }
+
+        ListIter entries = id3v2CreateFrameEntryTraverser(f);
+        Id3v2ContentEntry *data = NULL;
+
+        id3v2ReadFrameEntryAsU8(&entries); // encoding
+        id3v2ReadFrameEntryAsU8(&entries); // mime type
+
+        if (id3v2ReadFrameEntryAsU8(&entries) != usableType) {
+            continue;
+        }
+
+        id3v2ReadFrameEntryAsU8(&entries); // description
+        data = (Id3v2ContentEntry *) listIteratorNext(&entries);
+
+        if (data == NULL || data->size == 0) {
+            break;
+        }
+
+        // the file may have changed since the tag was read from it
+        if (data->source != NULL) {
+            int in = id3v2OpenContentSource(data);
+
+            ok = (in >= 0 && id3FileCopyRange(in, data->offset, data->size, fd));
+            id3FileClose(in);
+        } else {
+            ok = id3FileWrite(fd, data->entry, data->size);
+        }
+
+        break;
+    }
+
+    id3v2DestroyTag(&tag);
+    return ok;
+}
+
+// internal function ---
+// finds the unique file identifier frame owned by ID3V2_AUDIO_HASH_OWNER
+static Id3v2Frame *internal_id3v2FindAudioHashFrame(const Id3v2Tag *tag) {
+    Id3v2Frame *f = NULL;
+    ListIter frames = listCreateIterator(tag->frames);
+    size_t idSize = (tag->header->majorVersion == ID3V2_TAG_VERSION_2) ? ID3V2_FRAME_ID_MAX_SIZE - 1
+                                                                       : ID3V2_FRAME_ID_MAX_SIZE;
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        ListIter entries = {0};
+        char *owner = NULL;
+        size_t ownerSize = 0;
+        bool match = false;
+
+        if (memcmp("UFID", f->header->id, idSize) != 0) {
+            continue;
+        }
+
+        entries = id3v2CreateFrameEntryTraverser(f);
+        owner = id3v2ReadFrameEntryAsChar(&entries, &ownerSize);
+        match = (owner != NULL && strcmp(owner, ID3V2_AUDIO_HASH_OWNER) == 0);
+        free(owner);
+
+        if (match) {
+            return f;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Reads an audio hash stored in a tag by id3v2WriteAudioHash.
+ * @details Looks for the unique file identifier frame (UFID, UFI for ID3v2.2) owned by ID3V2_AUDIO_HASH_OWNER so a
+ * hash computed by an earlier run can be reused instead of reading the audio again. The hash only stays valid while
+ * the audio of the file is unchanged, editing the tags does not affect it.
+ * @param tag - Tag to read the hash from.
+ * @param hash - Receives the hash.
+ * @return bool - true if a hash was found, false otherwise.
+ */
+bool id3v2ReadAudioHash(const Id3v2Tag *tag, uint64_t *hash) {
+    if (tag == NULL || tag->header == NULL || hash == NULL) {
+        return false;
+    }
+
+    Id3v2Frame *f = internal_id3v2FindAudioHashFrame(tag);
+    ListIter entries = {0};
+    uint8_t *data = NULL;
+    size_t dataSize = 0;
+
+    if (f == NULL) {
+        return false;
+    }
+
+    entries = id3v2CreateFrameEntryTraverser(f);
+    id3v2ReadFrameEntryAsU8(&entries); // owner
+    data = id3v2ReadFrameEntry(&entries, &dataSize);
+
+    if (data == NULL || dataSize != ID3_HASH_DIGEST_SIZE) {
+        free(data);
+        return false;
+    }
+
+    *hash = 0;
+
+    for (int i = 0; i < ID3_HASH_DIGEST_SIZE; i++) {
+        *hash = (*hash << 8) | data[i];
+    }
+
+    free(data);
+    return true;
+}
+
 /**
  * @brief Writes UTF-8 text content to a text frame, creating it if necessary.
  * @details Searches for an existing text frame with the specified ID. If found, converts the input string to the frame's
@@ -1971,524 +2245,1284 @@ int id3v2WritePictureFromFile(const char *filename, const char *kind, uint8_t ty
 }
 
 /**
- * @brief Serializes an ID3v2 tag structure to its binary representation.
- * @details Converts the tag back to raw bytes by serializing all frames, applying unsynchronization if enabled, encoding the header and optional footer,
- * calculating total size (including padding from extended header), and combining all components into a single binary buffer.
- * For ID3v2.4 tags with footer indicator set, generates a footer (10-byte header copy with "3DI" identifier).
- * Unsynchronization doubles buffer size to accommodate potential expansion. Size fields are encoded as synchsafe integers.
- * Returns NULL on validation failures (null tag/header/frames, frame serialization errors, or header serialization errors) and sets outl to 0 without allocating memory.
- * @param tag - Tag structure to serialize.
- * @param outl - Pointer to size_t to receive the output buffer size in bytes.
- * @return uint8_t* - Pointer to allocated binary data on success, NULL on failure. Caller must free the returned buffer.
+ * @brief Stores an audio hash in a tag so later runs can skip hashing the file.
+ * @details Writes the hash big-endian to the unique file identifier frame (UFID, UFI for ID3v2.2) owned by
+ * ID3V2_AUDIO_HASH_OWNER, replacing the hash already stored or adding a new frame. Read it back with
+ * id3v2ReadAudioHash.
+ * @param hash - Hash to store, see id3AudioHash.
+ * @param tag - Tag to store the hash in.
+ * @return int - 1 (true) if the hash was written, 0 (false) on failure.
  */
-uint8_t *id3v2TagSerialize(Id3v2Tag *tag, size_t *outl) {
-    if (tag == NULL) {
-        *outl = 0;
-        return NULL;
+int id3v2WriteAudioHash(uint64_t hash, Id3v2Tag *tag) {
+    if (tag == NULL || tag->header == NULL) {
+        return false;
     }
 
-    if (tag->header == NULL || tag->frames == NULL) {
-        *outl = 0;
-        return NULL;
+    Id3v2Frame *f = internal_id3v2FindAudioHashFrame(tag);
+    ListIter entries = {0};
+    uint8_t data[ID3_HASH_DIGEST_SIZE] = {0};
+    bool created = false;
+
+    for (int i = 0; i < ID3_HASH_DIGEST_SIZE; i++) {
+        data[i] = (uint8_t) (hash >> ((ID3_HASH_DIGEST_SIZE - 1 - i) * 8));
     }
 
-    ByteStream *stream = NULL;
-    ByteStream *headerStream = NULL;
-    ByteStream *frameStream = NULL;
-    ByteStream *footerStream = NULL;
-    Id3v2Frame *f = NULL;
-    ListIter frames = id3v2CreateFrameTraverser(tag);
-    uint32_t fsize = 0;
-    uint32_t padding = 0;
-    uint8_t *sizeBytes = NULL;
-    uint8_t *headerOut = NULL;
-    uint8_t *out = NULL;
-    size_t headerOutl = 0;
+    if (f == NULL) {
+        switch (tag->header->majorVersion) {
+            case ID3V2_TAG_VERSION_2:
+                f = id3v2CreateEmptyFrame("UFI\0", tag->header->majorVersion, NULL);
+                break;
+            case ID3V2_TAG_VERSION_3:
+            case ID3V2_TAG_VERSION_4:
+                f = id3v2CreateEmptyFrame("UFID", tag->header->majorVersion, NULL);
+                break;
+            default:
+                return false;
+        }
 
-    // frame stream
-    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
-        ByteStream *tmp = NULL;
-        size_t frameOutl = 0;
-        uint8_t *frameOut = NULL;
+        if (f == NULL) {
+            return false;
+        }
 
-        frameOut = id3v2FrameSerialize(f, tag->header->majorVersion, &frameOutl);
+        created = true;
+        entries = id3v2CreateFrameEntryTraverser(f);
 
-        if (frameOut == NULL && frameOutl == 0) {
-            break;
+        if (!id3v2WriteFrameEntry(f, &entries, strlen(ID3V2_AUDIO_HASH_OWNER), ID3V2_AUDIO_HASH_OWNER)) {
+            id3v2DestroyFrame(&f);
+            return false;
         }
+    } else {
+        entries = id3v2CreateFrameEntryTraverser(f);
+    }
 
-        tmp = byteStreamCreate(frameOut, frameOutl);
-        free(frameOut);
+    id3v2ReadFrameEntryAsU8(&entries); // owner
 
-        if (tmp == NULL) {
-            break;
+    if (!id3v2WriteFrameEntry(f, &entries, sizeof(data), data)) {
+        if (created) {
+            id3v2DestroyFrame(&f);
         }
 
-        if (frameStream == NULL) {
-            frameStream = byteStreamCreate(byteStreamCursor(tmp), tmp->bufferSize);
-            byteStreamSeek(frameStream, 0, SEEK_END);
-        } else {
-            byteStreamResize(frameStream, frameStream->bufferSize + tmp->bufferSize);
-            byteStreamWrite(frameStream, tmp->buffer, tmp->bufferSize);
-        }
-        byteStreamDestroy(tmp);
+        return false;
     }
 
-    // check if above failed somehow
-    if (frameStream == NULL) {
-        *outl = 0;
-        return NULL;
+    if (created && !id3v2AttachFrameToTag(tag, f)) {
+        id3v2DestroyFrame(&f);
+        return false;
     }
 
-    byteStreamRewind(frameStream);
+    return true;
+}
 
-    // unsync?
-    if (id3v2ReadUnsynchronisationIndicator(tag->header)) {
-        ByteStream *tmp = NULL;
+// internal function ---
+// number of bits needed to hold value
+static uint8_t internal_id3v2BitsFor(uint64_t value) {
+    uint8_t bits = 0;
 
-        tmp = byteStreamCreate(NULL, frameStream->bufferSize * 2);
+    while (value > 0) {
+        bits++;
+        value >>= 1;
+    }
 
-        for (size_t i = 0; i < frameStream->bufferSize; i++) {
-            byteStreamWrite(tmp, byteStreamCursor(frameStream), 1);
+    return bits;
+}
 
-            byteStreamSeek(tmp, 1, SEEK_CUR);
-            byteStreamSeek(frameStream, 1, SEEK_CUR);
+// internal function ---
+// appends the low bits of value to a big-endian bit stream starting at bit *at of out
+static void internal_id3v2PutBits(uint8_t *out, size_t *at, uint64_t value, uint8_t bits) {
+    for (int i = bits - 1; i >= 0; i--) {
+        if ((value >> i) & 1) {
+            out[*at / 8] |= (uint8_t) (0x80 >> (*at % 8));
         }
 
-        byteStreamDestroy(frameStream);
-        frameStream = tmp;
-        fsize = frameStream->bufferSize;
-        byteStreamRewind(frameStream);
-    } else {
-        fsize = frameStream->bufferSize;
+        (*at)++;
     }
+}
 
-    // header stream
-    headerOut = id3v2TagHeaderSerialize(tag->header, 0, &headerOutl);
+// internal function ---
+// builds the body of an ASPI frame with one 16 bit index point per entry of the index, evenly spaced in time
+static uint8_t *internal_id3v2SeekIndexASPI(const Id3MpegIndex *index, size_t *outl) {
+    size_t points = (index->count > 0xFFFF) ? 0xFFFF : index->count;
+    uint64_t dataEnd = index->start + index->length;
+    uint8_t *out = NULL;
 
-    if (headerOut == NULL && headerOutl == 0) {
-        byteStreamDestroy(frameStream);
-        *outl = 0;
+    if (points == 0 || index->length == 0 || dataEnd > UINT32_MAX) {
         return NULL;
     }
 
-    headerStream = byteStreamCreate(headerOut, headerOutl);
-    free(headerOut);
-
-    // unsync?
-    if (id3v2ReadUnsynchronisationIndicator(tag->header) && headerStream->bufferSize > 10) {
-        ByteStream *tmp = NULL;
-        uint32_t size = 0;
+    *outl = 11 + points * 2;
+    out = calloc(*outl, sizeof(uint8_t));
 
-        // ext size
-        size = (headerStream->bufferSize - 10) * 2;
+    if (out == NULL) {
+        return NULL;
+    }
 
-        tmp = byteStreamCreate(NULL, 10 + size);
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t) (index->start >> ((3 - i) * 8));
+        out[4 + i] = (uint8_t) (index->length >> ((3 - i) * 8));
+    }
 
-        // write header back
-        byteStreamWrite(tmp, byteStreamCursor(headerStream), 10);
-        byteStreamSeek(headerStream, 10, SEEK_SET);
+    out[8] = (uint8_t) (points >> 8);
+    out[9] = (uint8_t) points;
+    out[10] = 16;
 
-        for (uint32_t i = 0; i < size; i++) {
-            byteStreamWrite(tmp, byteStreamCursor(headerStream), 1);
+    for (size_t i = 0; i < points; i++) {
+        uint64_t offset = id3MpegIndexOffsetAt(index, index->frames * i / points);
+        uint64_t fraction = offset * 0x10000 / index->length;
 
-            byteStreamSeek(tmp, 1, SEEK_CUR);
-            byteStreamSeek(headerStream, 1, SEEK_CUR);
+        if (fraction > 0xFFFF) {
+            fraction = 0xFFFF;
         }
 
-        byteStreamDestroy(headerStream);
-        headerStream = tmp;
-        fsize += size;
-    } else {
-        fsize += ((headerStream->bufferSize > 10) ? headerStream->bufferSize - 10 : 0);
+        out[11 + i * 2] = (uint8_t) (fraction >> 8);
+        out[12 + i * 2] = (uint8_t) fraction;
+    }
+
+    return out;
+}
+
+// internal function ---
+// builds the body of an MLLT frame with one reference per entry of the index after the first
+static uint8_t *internal_id3v2SeekIndexMLLT(const Id3MpegIndex *index, size_t *outl) {
+    if (index->count == 0 || index->sampleRate == 0) {
+        return NULL;
     }
 
-    byteStreamRewind(headerStream);
+    size_t refs = index->count - 1;
+    uint64_t step = (uint64_t) index->stride * index->samplesPerFrame * 1000;
+    uint64_t bytesBase = (refs > 0) ? UINT64_MAX : index->length;
+    uint64_t msBase = (refs > 0) ? UINT64_MAX : step / index->sampleRate;
+    uint64_t bytesMax = 0;
+    uint64_t msMax = 0;
+    uint8_t bytesBits = 0;
+    uint8_t msBits = 0;
+    size_t at = 0;
+    uint8_t *out = NULL;
+
+    // the distances between references, each stored as its deviation from the smallest
+    for (size_t k = 1; k <= refs; k++) {
+        uint64_t bytes = index->offsets[k] - index->offsets[k - 1];
+        uint64_t ms = step * k / index->sampleRate - step * (k - 1) / index->sampleRate;
 
-    // footer stream?
-    if (id3v2ReadFooterIndicator(tag->header) && tag->header->majorVersion == ID3V2_TAG_VERSION_4) {
-        footerStream = byteStreamCreate(byteStreamCursor(headerStream), 10);
-        byteStreamWrite(footerStream, (unsigned char *) "3DI", ID3V2_TAG_ID_SIZE);
-        byteStreamRewind(footerStream);
+        bytesBase = (bytes < bytesBase) ? bytes : bytesBase;
+        bytesMax = (bytes > bytesMax) ? bytes : bytesMax;
+        msBase = (ms < msBase) ? ms : msBase;
+        msMax = (ms > msMax) ? ms : msMax;
     }
 
-    if (tag->header->extendedHeader != NULL) {
-        fsize += tag->header->extendedHeader->padding;
-        padding = tag->header->extendedHeader->padding;
+    if (bytesBase > 0xFFFFFF || msBase > 0xFFFFFF) {
+        return NULL;
     }
 
-    // insert size
-    sizeBytes = u32tob(byteSyncintEncode(fsize));
-    byteStreamSeek(headerStream, 6, SEEK_SET);
-    byteStreamWrite(headerStream, sizeBytes, 4);
-    byteStreamRewind(headerStream);
+    bytesBits = internal_id3v2BitsFor(bytesMax - ((refs > 0) ? bytesBase : 0));
+    msBits = internal_id3v2BitsFor(msMax - ((refs > 0) ? msBase : 0));
 
-    if (footerStream != NULL) {
-        byteStreamSeek(footerStream, 6, SEEK_SET);
-        byteStreamWrite(footerStream, sizeBytes, 4);
-        byteStreamRewind(footerStream);
+    // the bits of a reference must add up to a multiple of 4
+    while ((bytesBits + msBits) == 0 || (bytesBits + msBits) % 4 != 0) {
+        msBits++;
     }
 
-    free(sizeBytes);
+    *outl = 10 + (refs * (bytesBits + msBits) + 7) / 8;
+    out = calloc(*outl, sizeof(uint8_t));
 
-    // create stream
-    stream = byteStreamCreate(
-        NULL, frameStream->bufferSize + headerStream->bufferSize + ((footerStream != NULL)
-                                                                        ? footerStream->bufferSize
-                                                                        : 0));
-    byteStreamWrite(stream, byteStreamCursor(headerStream), headerStream->bufferSize);
-    byteStreamWrite(stream, byteStreamCursor(frameStream), frameStream->bufferSize);
-    byteStreamSeek(stream, padding, SEEK_CUR);
-    if (footerStream != NULL) {
-        byteStreamWrite(stream, byteStreamCursor(footerStream), footerStream->bufferSize);
-        byteStreamDestroy(footerStream);
+    if (out == NULL) {
+        return NULL;
     }
 
-    byteStreamDestroy(headerStream);
-    byteStreamDestroy(frameStream);
-    byteStreamRewind(stream);
+    out[0] = (uint8_t) (index->stride >> 8);
+    out[1] = (uint8_t) index->stride;
 
-    out = calloc(stream->bufferSize, sizeof(uint8_t));
-    *outl = stream->bufferSize;
-    byteStreamRead(stream, out, stream->bufferSize);
-    byteStreamDestroy(stream);
+    for (int i = 0; i < 3; i++) {
+        out[2 + i] = (uint8_t) (bytesBase >> ((2 - i) * 8));
+        out[5 + i] = (uint8_t) (msBase >> ((2 - i) * 8));
+    }
+
+    out[8] = bytesBits;
+    out[9] = msBits;
+    at = 10 * 8;
+
+    for (size_t k = 1; k <= refs; k++) {
+        uint64_t bytes = index->offsets[k] - index->offsets[k - 1];
+        uint64_t ms = step * k / index->sampleRate - step * (k - 1) / index->sampleRate;
+
+        internal_id3v2PutBits(out, &at, bytes - bytesBase, bytesBits);
+        internal_id3v2PutBits(out, &at, ms - msBase, msBits);
+    }
 
     return out;
 }
 
 /**
- * @brief Serializes an ID3v2 tag structure to JSON format.
- * @details Converts the tag header and all frames to JSON representation. Returns "{}" for invalid tags (null parameters, null frames/header, or unsupported version > ID3v2.4).
- * For valid tags, serializes the header and each frame, concatenates frame JSON with commas, and constructs a JSON object with "header" and "content" array.
- * Allocates and returns a null-terminated JSON string. Frees all intermediate allocations on both success and failure paths.
- * @param tag - Tag structure to serialize to JSON.
- * @return char* - Pointer to allocated null-terminated JSON string. Caller must free the returned buffer.
- * 
- * Example output:
- * ```json
- * {
- *   "header": {
- *      ...
- *   },
- *   "content": [
- *      ...
- *   ]
- * }
- * ```
- * 
- * Invalid tag returns:
- * ```json
- * {}
- * ```
+ * @brief Adds a seek frame built from an index of the audio to a tag.
+ * @details ID3v2.4 tags get an audio seek point index (ASPI) with a 16 bit index point per entry of the index,
+ * ID3v2.3 and ID3v2.2 tags get an MPEG location lookup table (MLLT, MLL in ID3v2.2) with a reference every stride
+ * frames. Either lets a player jump to a time without reading the frames before it. A seek frame of the same kind
+ * already in the tag is replaced. An ASPI frame records where the audio starts in the file, so the tag must be
+ * written back without moving the audio, as happens when it fits in the space the old tag held, or the index built
+ * again afterwards.
+ * @param index - Index of the audio the tag belongs to, see id3MpegIndexFromFile.
+ * @param tag - Tag to add the seek frame to.
+ * @return int - 1 (true) if the frame was added, 0 (false) if the index cannot be described by the frame or memory
+ * ran out.
  */
-char *id3v2TagToJSON(Id3v2Tag *tag) {
-    char *json = NULL;
-    char *headerJson = NULL;
-    char **contentJson = NULL;
-    char *concatenatedString = NULL;
-    size_t contentJsonSize = 0;
-    size_t memCount = 3;
+int id3v2WriteSeekIndex(const Id3MpegIndex *index, Id3v2Tag *tag) {
+    if (index == NULL || tag == NULL || tag->header == NULL) {
+        return false;
+    }
 
-    if (tag == NULL) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
+    Id3v2Frame *f = NULL;
+    ListIter entries = {0};
+    uint8_t *data = NULL;
+    size_t dataSize = 0;
+    const char *id = NULL;
+
+    switch (tag->header->majorVersion) {
+        case ID3V2_TAG_VERSION_2:
+            id = "MLL";
+            data = internal_id3v2SeekIndexMLLT(index, &dataSize);
+            break;
+        case ID3V2_TAG_VERSION_3:
+            id = "MLLT";
+            data = internal_id3v2SeekIndexMLLT(index, &dataSize);
+            break;
+        case ID3V2_TAG_VERSION_4:
+            id = "ASPI";
+            data = internal_id3v2SeekIndexASPI(index, &dataSize);
+            break;
+        default:
+            return false;
     }
 
-    if (tag->frames == NULL || tag->header == NULL) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
+    if (data == NULL) {
+        return false;
     }
 
-    if (tag->header->majorVersion > ID3V2_TAG_VERSION_4) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
+    f = id3v2CreateEmptyFrame(id, tag->header->majorVersion, NULL);
+
+    if (f == NULL) {
+        free(data);
+        return false;
     }
 
-    // get frames
+    entries = id3v2CreateFrameEntryTraverser(f);
 
-    ListIter frames = id3v2CreateFrameTraverser(tag);
+    if (!id3v2WriteFrameEntry(f, &entries, dataSize, data)) {
+        id3v2DestroyFrame(&f);
+        free(data);
+        return false;
+    }
+
+    free(data);
+
+    // drop every earlier seek frame of this kind
+    while (id3v2RemoveFrameByID(id, tag) == 1) {
+        continue;
+    }
+
+    if (!id3v2AttachFrameToTag(tag, f)) {
+        id3v2DestroyFrame(&f);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Creates a set of write options describing how a tag is serialized and written.
+ * @details Allocates an options structure holding a padding policy and its amount. The amount is interpreted per policy:
+ * bytes for fixed_padding, a percentage of the serialized tag for percentage_padding, and a block size for block_padding
+ * (0 selects ID3V2_PADDING_BLOCK_SIZE). extended_padding and preserve_padding ignore the amount. Frame compression
+ * starts disabled, set compressionThreshold to enable it.
+ * Returns NULL on memory allocation failure.
+ * @param paddingPolicy - Policy used to decide how much padding is reserved.
+ * @param paddingAmount - Amount used by the policy.
+ * @return Id3v2WriteOptions* - Pointer to the allocated options, or NULL on failure. Caller must free with id3v2DestroyWriteOptions.
+ */
+Id3v2WriteOptions *id3v2CreateWriteOptions(Id3v2PaddingPolicy paddingPolicy, size_t paddingAmount) {
+    Id3v2WriteOptions *options = malloc(sizeof(Id3v2WriteOptions));
+
+    if (options == NULL) {
+        return NULL;
+    }
+
+    options->paddingPolicy = paddingPolicy;
+    options->paddingAmount = paddingAmount;
+    options->compressionThreshold = 0;
+
+    return options;
+}
+
+/**
+ * @brief Frees a set of write options and sets the pointer to NULL.
+ * @details Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the options pointer to free.
+ */
+void id3v2DestroyWriteOptions(Id3v2WriteOptions **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Creates a set of options describing how a tag is converted to JSON.
+ * @details Returns NULL on memory allocation failure.
+ * @param binaryPolicy - Policy used for binary frame content.
+ * @param binaryLimit - Largest number of bytes embedded by truncate_binary, ignored by the other policies.
+ * @return Id3v2JSONOptions* - Pointer to the allocated options, or NULL on failure. Caller must free with id3v2DestroyJSONOptions.
+ */
+Id3v2JSONOptions *id3v2CreateJSONOptions(Id3v2JSONBinaryPolicy binaryPolicy, size_t binaryLimit) {
+    Id3v2JSONOptions *options = malloc(sizeof(Id3v2JSONOptions));
+
+    if (options == NULL) {
+        return NULL;
+    }
+
+    options->binaryPolicy = binaryPolicy;
+    options->binaryLimit = binaryLimit;
+
+    return options;
+}
+
+/**
+ * @brief Frees a set of JSON options and sets the pointer to NULL.
+ * @details Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the options pointer to free.
+ */
+void id3v2DestroyJSONOptions(Id3v2JSONOptions **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+// internal function ------------------------------------------------------------------------
+static uint32_t internal_id3v2PaddingSize(const Id3v2Tag *tag, const Id3v2WriteOptions *options, size_t minSize,
+                                          size_t contentSize) {
+    uint64_t padding = 0;
+    uint64_t amount = 0;
+
+    // reuse the space of an existing tag when the new one fits inside it
+    if (minSize > 0 && contentSize <= minSize) {
+        padding = minSize - contentSize;
+    } else if (options == NULL || options->paddingPolicy == extended_padding ||
+               options->paddingPolicy == preserve_padding) {
+        padding = (tag->header->extendedHeader != NULL) ? tag->header->extendedHeader->padding : 0;
+    } else {
+        amount = (options->paddingAmount > UINT32_MAX) ? UINT32_MAX : options->paddingAmount;
+
+        switch (options->paddingPolicy) {
+            case fixed_padding:
+                padding = amount;
+                break;
+            case percentage_padding:
+                padding = ((uint64_t) contentSize * amount) / 100;
+                break;
+            case block_padding:
+                amount = (amount == 0) ? ID3V2_PADDING_BLOCK_SIZE : amount;
+                padding = (amount - (contentSize % amount)) % amount;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // the size field cannot describe anything larger
+    if (contentSize - ID3V2_TAG_HEADER_SIZE + padding > ID3V2_MAX_TAG_SIZE) {
+        padding = (contentSize - ID3V2_TAG_HEADER_SIZE > ID3V2_MAX_TAG_SIZE)
+                      ? 0
+                      : ID3V2_MAX_TAG_SIZE - (contentSize - ID3V2_TAG_HEADER_SIZE);
+    }
+
+    return (uint32_t) padding;
+}
+
+static void internal_id3v2UpdateCrc(Id3v2Tag *tag, uint32_t crc, uint8_t *headerOut, size_t headerOutl) {
+    Id3v2ExtendedTagHeader *ext = tag->header->extendedHeader;
+    uint8_t *extOut = NULL;
+    size_t extOutl = 0;
+
+    ext->crc = crc;
+    extOut = id3v2ExtendedTagHeaderSerialize(ext, tag->header->majorVersion, &extOutl);
+
+    // a non zero crc never changes the size of the extended header
+    if (extOut != NULL && extOutl == headerOutl - ID3V2_TAG_HEADER_SIZE) {
+        memcpy(headerOut + ID3V2_TAG_HEADER_SIZE, extOut, extOutl);
+    }
+
+    free(extOut);
+}
+
+// internal function ---
+// bytes of a frame as written to a tag, followed by *tail when it is not NULL. borrowed from the frame when it is
+// written as it was read, otherwise *owned is set and they must be freed
+static const uint8_t *internal_id3v2FrameBytes(Id3v2Frame *f, uint8_t version, bool unsync, size_t compressionThreshold,
+                                               size_t *outl, const uint8_t **tail, size_t *taill, bool *owned) {
+    const uint8_t *bytes = NULL;
+
+    *owned = false;
+    *tail = NULL;
+    *taill = 0;
+
+    if (f->header != NULL && !id3v2FrameIsDirty(f, version) && (!unsync || f->header->unsynchronisation) &&
+        (bytes = id3v2FrameCachedBytes(f, outl, tail, taill)) != NULL) {
+        return bytes;
+    }
+
+    *owned = true;
+    return id3v2FrameSerializeWithOptions(f, version, unsync, compressionThreshold, outl);
+}
+
+// internal function ---
+// writes part of a frame, unsynchronised against the byte following it when the whole tag is
+static bool internal_id3v2WriteFramePart(Id3Sink *sink, const uint8_t *bytes, size_t bytesl, const uint8_t *next,
+                                         bool unsync, size_t *written) {
+    uint8_t *stuffed = NULL;
+    size_t stuffedl = 0;
+    bool ok = false;
+
+    if (bytesl == 0) {
+        return true;
+    }
+
+    if (!unsync) {
+        *written += bytesl;
+        return id3SinkWrite(sink, bytes, bytesl);
+    }
+
+    stuffed = id3v2Unsynchronise(bytes, bytesl, next, &stuffedl);
+    ok = (stuffed != NULL && id3SinkWrite(sink, stuffed, stuffedl));
+    *written += stuffedl;
+    free(stuffed);
+
+    return ok;
+}
+
+// internal function ---
+// loads the content a tag read with id3v2TagFromFileLazy left in a file, so the two passes of a write read it once.
+// a file that changed since the tag was read fails the load rather than the write going on without its content
+static bool internal_id3v2LoadFromSource(Id3v2Tag *tag) {
     Id3v2Frame *f = NULL;
+    ListIter frames = listCreateIterator(tag->frames);
 
-    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
-        char *tmp = NULL;
-        size_t jsonSize = 0;
+    while ((f = (Id3v2Frame *) listIteratorNext(&frames)) != NULL) {
+        Id3v2ContentEntry *e = NULL;
+        ListIter entries = listCreateIterator(f->entries);
+
+        while ((e = (Id3v2ContentEntry *) listIteratorNext(&entries)) != NULL) {
+            if (e->source != NULL && !id3v2LoadContentEntry(e)) {
+                return false;
+            }
+        }
+    }
 
-        tmp = id3v2FrameToJSON(f, tag->header->majorVersion);
-        jsonSize = strlen(tmp);
+    return true;
+}
 
-        contentJsonSize++;
-        if (contentJson == NULL) {
-            // first allocation and returned by the function - false positive
-            // NOLINTNEXTLINE
-            contentJson = (char **) calloc(contentJsonSize, sizeof(char *));
-            contentJson[contentJsonSize - 1] = calloc(jsonSize + 1, sizeof(char));
-        } else {
-            // realloc false positive memory leak - false positive below
-            // NOLINTNEXTLINE
-            char **reallocPtr = realloc(contentJson, (contentJsonSize) * sizeof(char *));
-            if (reallocPtr == NULL) {
-                for (size_t i = 0; i < contentJsonSize - 1; i++) {
-                    free(contentJson[i]);
-                }
-                free((void *) contentJson);
-                free(tmp);
-                // all memory freed above - false positive
-                // NOLINTNEXTLINE
-                return NULL;
+// internal function ---
+// writes a tag in two passes over its frames. the first finds the size and checksum of every frame, the second
+// writes them, so at most one frame is held in memory on top of the tag
+static bool internal_id3v2TagWrite(Id3v2Tag *tag, const Id3v2WriteOptions *options, size_t minSize, Id3Sink *sink) {
+    if (tag == NULL || sink == NULL) {
+        return false;
+    }
+
+    if (tag->header == NULL || tag->frames == NULL) {
+        return false;
+    }
+
+    Id3v2Frame *f = NULL;
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+    const uint8_t *bytes = NULL;
+    const uint8_t *tail = NULL;
+    uint8_t *first = NULL;
+    uint8_t *last = NULL;
+    size_t *frameOutl = NULL;
+    size_t frameCount = 0;
+    size_t bytesl = 0;
+    size_t taill = 0;
+    size_t written = 0;
+    size_t fsize = 0;
+    size_t padding = 0;
+    uint8_t *headerOut = NULL;
+    uint8_t *extOut = NULL;
+    size_t headerOutl = 0;
+    size_t extOutl = 0;
+    uint8_t *sizeBytes = NULL;
+    const uint8_t plain = 0x01;
+    const uint8_t version = tag->header->majorVersion;
+    const size_t threshold = (options != NULL) ? options->compressionThreshold : 0;
+    bool unsync = id3v2ReadUnsynchronisationIndicator(tag->header);
+    bool frameUnsync = (unsync && version == ID3V2_TAG_VERSION_4);
+    bool tagUnsync = false;
+    bool owned = false;
+    bool footer = (id3v2ReadFooterIndicator(tag->header) && version == ID3V2_TAG_VERSION_4);
+    bool crc = (tag->header->extendedHeader != NULL && tag->header->extendedHeader->crc != 0 &&
+                id3v2ReadExtendedHeaderIndicator(tag->header) == 1 && version != ID3V2_TAG_VERSION_2);
+    uint32_t crcValue = 0;
+    bool ok = false;
+
+    if (tag->frames->length == 0 || !internal_id3v2LoadFromSource(tag)) {
+        return false;
+    }
+
+    // only the first and last byte of each frame is kept between passes, unsynchronisation depends on them
+    first = calloc(tag->frames->length, sizeof(uint8_t));
+    last = calloc(tag->frames->length, sizeof(uint8_t));
+    frameOutl = calloc(tag->frames->length, sizeof(size_t));
+
+    if (first == NULL || last == NULL || frameOutl == NULL) {
+        free(first);
+        free(last);
+        free(frameOutl);
+        return false;
+    }
+
+    // earlier versions unsynchronise everything after the header as one stream
+    tagUnsync = (unsync && version != ID3V2_TAG_VERSION_4);
+
+    // frames, v2.4 unsynchronises each frame on its own
+    while ((f = listIteratorNext(&frames)) != NULL && frameCount < tag->frames->length) {
+        bytes = internal_id3v2FrameBytes(f, version, frameUnsync, threshold, &bytesl, &tail, &taill, &owned);
+
+        // a frame that cannot be serialized fails the tag instead of being left out of it
+        if (bytes == NULL || bytesl == 0) {
+            if (owned) {
+                free((uint8_t *) bytes);
             }
-            contentJson = reallocPtr;
-            contentJson[contentJsonSize - 1] = calloc(jsonSize + 1, sizeof(char));
+
+            free(first);
+            free(last);
+            free(frameOutl);
+            return false;
+        }
+
+        // the checksum covers frames as they are before tag level unsynchronisation
+        if (crc) {
+            crcValue = id3Crc32(crcValue, bytes, bytesl);
+            crcValue = id3Crc32(crcValue, tail, taill);
         }
 
-        memcpy(contentJson[contentJsonSize - 1], tmp, jsonSize);
+        // a trailing $FF is counted once the byte following it is known
+        first[frameCount] = bytes[0];
+        last[frameCount] = (taill > 0) ? tail[taill - 1] : bytes[bytesl - 1];
+        frameOutl[frameCount] = bytesl + taill;
+
+        if (tagUnsync) {
+            frameOutl[frameCount] = id3v2UnsynchronisedSize(bytes, bytesl, (taill > 0) ? tail : &plain) +
+                                    ((taill > 0) ? id3v2UnsynchronisedSize(tail, taill, &plain) : 0);
+        }
 
-        free(tmp);
+        if (owned) {
+            free((uint8_t *) bytes);
+        }
+
+        frameCount++;
     }
 
-    // get header
-    headerJson = id3v2TagHeaderToJSON(tag->header);
+    for (size_t i = 0; tagUnsync && i < frameCount; i++) {
+        frameOutl[i] += id3v2UnsynchronisedSize(&last[i], 1, (i + 1 < frameCount) ? &first[i + 1] : NULL) -
+                        id3v2UnsynchronisedSize(&last[i], 1, &plain);
+    }
+
+    for (size_t i = 0; i < frameCount; i++) {
+        fsize += frameOutl[i];
+    }
+
+    // header and extended header
+    headerOut = (frameCount > 0 && fsize > 0) ? id3v2TagHeaderSerialize(tag->header, 0, &headerOutl) : NULL;
+
+    if (headerOut != NULL && headerOutl >= ID3V2_TAG_HEADER_SIZE) {
+        extOutl = headerOutl - ID3V2_TAG_HEADER_SIZE;
+        extOutl = (tagUnsync) ? id3v2UnsynchronisedSize(headerOut + ID3V2_TAG_HEADER_SIZE, extOutl, &first[0])
+                              : extOutl;
 
-    // concatenate all JSON data stored in contentJson into a single string split by ","
-    if (contentJson != NULL) {
-        size_t concatenatedStringLength = 0;
-        for (size_t i = 0; i < contentJsonSize; i++) {
-            concatenatedStringLength += strlen(contentJson[i]) + 1;
+        // tags with a footer must not have padding
+        if (footer == false) {
+            padding = internal_id3v2PaddingSize(tag, options, minSize, ID3V2_TAG_HEADER_SIZE + extOutl + fsize);
         }
 
-        concatenatedString = calloc(concatenatedStringLength + 1, sizeof(char));
+        // v2.4 includes the padding in the checksum
+        if (crc && version == ID3V2_TAG_VERSION_4) {
+            crcValue = id3Crc32Zeros(crcValue, padding);
+        }
+
+        if (crc && crcValue != 0) {
+            internal_id3v2UpdateCrc(tag, crcValue, headerOut, headerOutl);
+        }
+
+        // v2.3 extended headers record the padding size
+        if (version == ID3V2_TAG_VERSION_3 && tag->header->extendedHeader != NULL &&
+            headerOutl >= ID3V2_TAG_HEADER_SIZE + 10) {
+            sizeBytes = u32tob((uint32_t) padding);
+            memcpy(headerOut + ID3V2_TAG_HEADER_SIZE + 6, sizeBytes, 4);
+            free(sizeBytes);
+        }
+
+        if (tagUnsync && extOutl > 0) {
+            extOut = id3v2Unsynchronise(headerOut + ID3V2_TAG_HEADER_SIZE, headerOutl - ID3V2_TAG_HEADER_SIZE,
+                                        &first[0], &extOutl);
+        } else if (extOutl > 0) {
+            extOut = headerOut + ID3V2_TAG_HEADER_SIZE;
+        }
+
+        // insert size
+        sizeBytes = u32tob(byteSyncintEncode((uint32_t) (extOutl + fsize + padding)));
+        memcpy(headerOut + 6, sizeBytes, 4);
+        free(sizeBytes);
+
+        (void) id3SinkReserve(sink, ID3V2_TAG_HEADER_SIZE + extOutl + fsize + padding +
+                                    ((footer) ? ID3V2_TAG_HEADER_SIZE : 0));
+
+        ok = id3SinkWrite(sink, headerOut, ID3V2_TAG_HEADER_SIZE) && (extOutl == 0 || extOut != NULL) &&
+             id3SinkWrite(sink, extOut, extOutl);
+
+        // frames are serialized again one at a time, cached and unchanged frames are written from the tag itself
+        frames = id3v2CreateFrameTraverser(tag);
+
+        for (size_t i = 0; ok && i < frameCount && (f = listIteratorNext(&frames)) != NULL; i++) {
+            const uint8_t *next = (i + 1 < frameCount) ? &first[i + 1] : NULL;
+
+            bytes = internal_id3v2FrameBytes(f, version, frameUnsync, threshold, &bytesl, &tail, &taill, &owned);
+            written = 0;
+
+            ok = (bytes != NULL && bytesl > 0) &&
+                 internal_id3v2WriteFramePart(sink, bytes, bytesl, (taill > 0) ? tail : next, tagUnsync, &written) &&
+                 internal_id3v2WriteFramePart(sink, tail, taill, next, tagUnsync, &written);
 
-        size_t offset = 0;
-        for (size_t i = 0; i < contentJsonSize; i++) {
-            if (i > 0) {
-                concatenatedString[offset++] = ',';
+            // the frame must come out as it did in the first pass or the sizes already written are wrong
+            ok = ok && written == frameOutl[i];
+
+            if (owned) {
+                free((uint8_t *) bytes);
             }
+        }
 
-            const size_t currentLen = strlen(contentJson[i]);
-            memcpy(concatenatedString + offset, contentJson[i], currentLen);
-            offset += currentLen;
+        ok = ok && id3SinkWriteZeros(sink, padding);
+
+        // footer is a copy of the header with "3DI" as its identifier
+        if (ok && footer) {
+            memcpy(headerOut, "3DI", ID3V2_TAG_ID_SIZE);
+            ok = id3SinkWrite(sink, headerOut, ID3V2_TAG_HEADER_SIZE);
         }
-        concatenatedString[offset] = '\0';
     }
 
-    memCount += snprintf(NULL, 0,
-                         "{\"header\":%s,\"content\":[%s]}",
-                         headerJson,
-                         concatenatedString);
-    json = calloc(memCount + 1, sizeof(char));
-    (void) snprintf(json, memCount,
-                    "{\"header\":%s,\"content\":[%s]}",
-                    headerJson,
-                    concatenatedString);
+    if (extOut != NULL && extOut != headerOut + ID3V2_TAG_HEADER_SIZE) {
+        free(extOut);
+    }
 
+    free(first);
+    free(last);
+    free(frameOutl);
+    free(headerOut);
 
-    free(headerJson);
+    return ok;
+}
 
-    if (concatenatedString != NULL) {
-        free(concatenatedString);
+static uint8_t *internal_id3v2TagSerialize(Id3v2Tag *tag, const Id3v2WriteOptions *options, size_t minSize,
+                                           size_t *outl) {
+    Id3Sink *sink = id3SinkCreateBuffer(0);
+    uint8_t *out = NULL;
+
+    if (sink != NULL && internal_id3v2TagWrite(tag, options, minSize, sink)) {
+        out = id3SinkTakeBuffer(sink, outl);
+    } else {
+        *outl = 0;
     }
 
-    if (contentJson != NULL) {
-        for (size_t i = 0; i < contentJsonSize; i++) {
-            free(contentJson[i]);
-        }
-        free((void *) contentJson);
+    id3SinkDestroy(&sink);
+    return out;
+}
+
+/**
+ * @brief Serializes an ID3v2 tag structure to its binary representation.
+ * @details Converts the tag back to raw bytes by serializing all frames, applying unsynchronization if enabled, encoding the header and optional footer,
+ * calculating total size (including padding from extended header), and combining all components into a single binary buffer.
+ * For ID3v2.4 tags with footer indicator set, generates a footer (10-byte header copy with "3DI" identifier).
+ * Unsynchronisation is applied to everything after the header in ID3v2.2 and ID3v2.3 and to every frame in ID3v2.4, only stuffing
+ * a $00 after $FF bytes that would form a false synchronisation. Size fields are encoded as synchsafe integers.
+ * When the extended header has a CRC its value is computed from the serialized frames, plus the padding for ID3v2.4,
+ * and stored back in the tag's extended header. Equivalent to id3v2TagSerializeWithOptions with NULL options.
+ * Returns NULL on validation failures (null tag/header/frames, frame serialization errors, or header serialization errors) and sets outl to 0 without allocating memory.
+ * @param tag - Tag structure to serialize.
+ * @param outl - Pointer to size_t to receive the output buffer size in bytes.
+ * @return uint8_t* - Pointer to allocated binary data on success, NULL on failure. Caller must free the returned buffer.
+ */
+uint8_t *id3v2TagSerialize(Id3v2Tag *tag, size_t *outl) {
+    return id3v2TagSerializeWithOptions(tag, NULL, outl);
+}
+
+/**
+ * @brief Serializes an ID3v2 tag structure to its binary representation using a padding policy.
+ * @details Behaves like id3v2TagSerialize but reserves padding after the last frame as described by options.
+ * fixed_padding appends paddingAmount bytes, percentage_padding appends paddingAmount percent of the serialized tag,
+ * and block_padding rounds the complete tag up to a multiple of paddingAmount (ID3V2_PADDING_BLOCK_SIZE when 0).
+ * extended_padding, preserve_padding, and NULL options use the extended header padding. Tags with a footer are never padded,
+ * and an ID3v2.3 extended header has its padding size field updated to the amount written. When compressionThreshold is
+ * set, modified ID3v2.3/2.4 frames larger than it are compressed with zlib if the library was built with BUILD_ID3_ZLIB.
+ * Returns NULL on validation failures and sets outl to 0 without allocating memory.
+ * @param tag - Tag structure to serialize.
+ * @param options - Write options, may be NULL.
+ * @param outl - Pointer to size_t to receive the output buffer size in bytes.
+ * @return uint8_t* - Pointer to allocated binary data on success, NULL on failure. Caller must free the returned buffer.
+ */
+uint8_t *id3v2TagSerializeWithOptions(Id3v2Tag *tag, const Id3v2WriteOptions *options, size_t *outl) {
+    return internal_id3v2TagSerialize(tag, options, 0, outl);
+}
+
+/**
+ * @brief Serializes an ID3v2 tag structure directly into a sink.
+ * @details Produces the same bytes as id3v2TagSerializeWithOptions without building the complete tag in memory first:
+ * the header, extended header, each frame, padding, and footer are written to the sink one after another. Sizes and the
+ * CRC are found in a first pass over the frames and the frames are serialized again as they are written, so at most
+ * one serialized frame is held at a time and unchanged frames are written straight from the bytes they were read as.
+ * Buffer sinks are sized once up front. On failure the sink may have received part of the tag.
+ * @param tag - Tag structure to serialize.
+ * @param options - Write options, may be NULL.
+ * @param sink - Sink receiving the serialized tag.
+ * @return int - 1 (true) if the whole tag was written, 0 (false) on failure.
+ */
+int id3v2TagSerializeToSink(Id3v2Tag *tag, const Id3v2WriteOptions *options, Id3Sink *sink) {
+    return internal_id3v2TagWrite(tag, options, 0, sink);
+}
+
+/**
+ * @brief Serializes an ID3v2 tag structure to JSON format.
+ * @details Converts the tag header and all frames to JSON representation. Returns "{}" for invalid tags (null parameters, null frames/header, or unsupported version > ID3v2.4).
+ * For valid tags, serializes the header and each frame, concatenates frame JSON with commas, and constructs a JSON object with "header" and "content" array.
+ * Allocates and returns a null-terminated JSON string. Frees all intermediate allocations on both success and failure paths.
+ * @param tag - Tag structure to serialize to JSON.
+ * @return char* - Pointer to allocated null-terminated JSON string. Caller must free the returned buffer.
+ * 
+ * Example output:
+ * ```json
+ * {
+ *   "header": {
+ *      ...
+ *   },
+ *   "content": [
+ *      ...
+ *   ]
+ * }
+ * ```
+ * 
+ * Invalid tag returns:
+ * ```json
+ * {}
+ * ```
+ */
+char *id3v2TagToJSON(Id3v2Tag *tag) {
+    return id3v2TagToJSONWithOptions(tag, NULL);
+}
+
+/**
+ * @brief Converts an ID3v2 tag to JSON, choosing how binary frame content is represented.
+ * @details Produces the same structure as id3v2TagToJSON with binary content written according to options, see
+ * id3v2FrameToJSONSinkWithOptions. Catalog exports can use digest_binary or reference_binary to leave artwork out.
+ * @param tag - Tag structure to serialize to JSON.
+ * @param options - Binary content policy, NULL behaves like embed_binary.
+ * @return char* - Pointer to allocated null-terminated JSON string, or NULL on failure. Caller must free the returned buffer.
+ */
+char *id3v2TagToJSONWithOptions(Id3v2Tag *tag, const Id3v2JSONOptions *options) {
+    Id3Sink *sink = id3SinkCreateBuffer(ID3V2_JSON_TAG_CAPACITY);
+    char *json = NULL;
+
+    if (sink == NULL) {
+        return NULL;
     }
 
-    // all memory is freed of moved to contentJson - false positive
-    // NOLINTNEXTLINE
+    if (id3v2TagToJSONSinkWithOptions(tag, options, sink)) {
+        json = (char *) id3SinkTakeBuffer(sink, NULL);
+    }
+
+    id3SinkDestroy(&sink);
     return json;
 }
 
 /**
- * @brief Writes an ID3v2 tag to a file, creating, prepending, or replacing as needed.
- * @details Serializes the tag and handles three scenarios: (1) If file doesn't exist, creates it and writes the tag; 
- * (2) If file exists without a tag or with the update flag set in the extended header, prepends the new tag to the file; 
- * (3) If file exists with a tag and no update flag, replaces the old tag by reading existing tag size, writing new tag at file start, 
- * and appending remaining file data. Accounts for footer (10 bytes for ID3v2.4) and padding from extended header when calculating offsets.
- * Returns false on validation failures (null parameters, serialization errors, file open/read/write errors, or memory allocation failures) without modifying the file.
- * Frees all allocated memory on both success and failure paths.
- * @param filePath - Null-terminated string containing the path to the file to write.
- * @param tag - Tag structure to write to the file.
- * @return int - 1 (true) if tag written successfully, 0 (false) on failure.
+ * @brief Writes the JSON representation of an ID3v2 tag into a sink.
+ * @details Writes the same text id3v2TagToJSON returns, without a null terminator. Frames are written into the sink
+ * one after another as they are converted, so the JSON of the whole tag is never assembled separately.
+ * @param tag - Tag to convert.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 (true) if the JSON was written, 0 (false) on failure.
  */
-int id3v2WriteTagToFile(const char *filePath, Id3v2Tag *tag) {
-    if (filePath == NULL || tag == NULL) {
+int id3v2TagToJSONSink(Id3v2Tag *tag, Id3Sink *sink) {
+    return id3v2TagToJSONSinkWithOptions(tag, NULL, sink);
+}
+
+/**
+ * @brief Writes the JSON representation of an ID3v2 tag into a sink, choosing how binary frame content is represented.
+ * @details Writes the same text id3v2TagToJSONWithOptions returns, without a null terminator.
+ * @param tag - Tag to convert.
+ * @param options - Binary content policy, NULL behaves like embed_binary.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 (true) if the JSON was written, 0 (false) on failure.
+ */
+int id3v2TagToJSONSinkWithOptions(Id3v2Tag *tag, const Id3v2JSONOptions *options, Id3Sink *sink) {
+    char *headerJson = NULL;
+    Id3v2Frame *f = NULL;
+    ListIter frames;
+    bool first = true;
+    bool ok = true;
+
+    if (sink == NULL) {
         return false;
     }
 
-    FILE *fp = NULL;
-    uint8_t *out = NULL;
-    size_t outl = 0;
-    ByteStream *stream = NULL;
+    if (tag == NULL || tag->frames == NULL || tag->header == NULL || tag->header->majorVersion > ID3V2_TAG_VERSION_4) {
+        return id3SinkWriteString(sink, "{}");
+    }
 
-    out = id3v2TagSerialize(tag, &outl);
+    headerJson = id3v2TagHeaderToJSON(tag->header);
 
-    if (out == NULL && outl == 0) {
-        return false;
+    (void) id3SinkWriteString(sink, "{\"header\":");
+    (void) id3SinkWriteString(sink, (headerJson != NULL) ? headerJson : "{}");
+    (void) id3SinkWriteString(sink, ",\"content\":[");
+
+    free(headerJson);
+
+    frames = id3v2CreateFrameTraverser(tag);
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        if (!first) {
+            (void) id3SinkWrite(sink, (const uint8_t *) ",", 1);
+        }
+
+        ok = id3v2FrameToJSONSinkWithOptions(f, tag->header->majorVersion, options, sink) && ok;
+        first = false;
     }
 
-    stream = byteStreamCreate(out, outl);
-    free(out);
+    return id3SinkWriteString(sink, "]}") && ok;
+}
 
-    fp = fopen(filePath, "r+b");
+/**
+ * @brief Builds an ID3v2 tag from its JSON representation.
+ * @details Reads the object id3v2TagToJSON writes. The header must come before the content because its version
+ * decides how every frame is read, see id3v2FrameFromJSONReader. The identifier pairings are made once for the
+ * whole tag and empty frame objects "{}" are skipped. Returns NULL for an empty object "{}" and on failure, check
+ * the failed field of the reader to tell them apart.
+ * @param reader - Reader positioned at the tag object.
+ * @param userPairs - User supplied identifier pairings, or NULL.
+ * @return Id3v2Tag* - Heap allocated tag, or NULL. Caller must free with id3v2DestroyTag.
+ */
+Id3v2Tag *id3v2TagFromJSONReader(Id3JsonReader *reader, HashTable *userPairs) {
+    Id3v2TagHeader *header = NULL;
+    HashTable *pairs = NULL;
+    List *frames = NULL;
+    bool haveContent = false;
 
-    // write to a new file
-    if (fp == NULL) {
-        // create a new file and write the bytes to it
-        fp = fopen(filePath, "wb");
+    if (reader == NULL || !id3JsonBeginObject(reader)) {
+        return NULL;
+    }
 
-        if (fp == NULL) {
-            byteStreamDestroy(stream);
-            return false;
-        }
+    frames = listCreate(id3v2PrintFrame, id3v2DeleteFrame, id3v2CompareFrame, id3v2CopyFrame);
 
-        if ((fwrite(byteStreamCursor(stream), 1, stream->bufferSize, fp)) == 0) {
-            byteStreamDestroy(stream);
-            (void) fclose(fp);
-            return false;
-        }
+    while (id3JsonNextMember(reader)) {
+        if (strcmp(reader->key, "header") == 0 && header == NULL) {
+            header = id3v2TagHeaderFromJSONReader(reader);
 
-        // update file
-    } else {
-        char id[ID3V2_TAG_ID_SIZE] = {0};
-        bool hasTag = false;
-        long fileSize = 0;
-        bool prepend = 0;
-        uint8_t *tmp = NULL;
-        uint8_t *upperTmp = NULL;
-        size_t upperBytes = 0;
-        uint32_t oldTagSize = 0;
-
-        // does the tag exist?
-        while (hasTag == false && feof(fp) == 0) {
-            const size_t bytesRead = fread(id, sizeof(char), ID3V2_TAG_ID_SIZE, fp);
-            upperBytes += bytesRead;
-            if (bytesRead != ID3V2_TAG_ID_SIZE) {
-                if (ferror(fp)) {
-                    break;
-                }
+            if (header == NULL) {
+                reader->failed = true;
+                break;
+            }
+        } else if (strcmp(reader->key, "content") == 0 && !haveContent) {
+            if (header == NULL || !id3JsonBeginArray(reader)) {
+                reader->failed = true;
                 break;
             }
 
-            hasTag = (memcmp(id, "ID3", ID3V2_TAG_ID_SIZE) == 0);
-        }
+            pairs = id3v2CreateDefaultIdentifierContextPairings(header->majorVersion);
 
-        // 1. update flag is set
-        if (hasTag == true && tag->header->extendedHeader != NULL) {
-            prepend = false;
+            while (pairs != NULL && id3JsonNextElement(reader)) {
+                Id3v2Frame *frame = id3v2FrameFromJSONReader(reader, header->majorVersion, pairs, userPairs);
 
-            if (tag->header->extendedHeader->update == true) {
-                prepend = true;
+                if (frame != NULL) {
+                    listInsertBack(frames, (void *) frame);
+                } else if (reader->failed) {
+                    break;
+                }
             }
 
-            // 2. a tag exists
-        } else if (hasTag == true) {
-            prepend = false;
-
-            // get the tag size
-            (void) fseek(fp, 3, SEEK_CUR); // skips version and flag
-            tmp = malloc(4);
-            (void) fread(tmp, 1, 4, fp);
-            oldTagSize = byteSyncintDecode(btou32(tmp, 4));
-            free(tmp);
+            if (pairs == NULL) {
+                reader->failed = true;
+            }
 
-            // 3. no tag exists
+            haveContent = true;
         } else {
-            prepend = true;
+            (void) id3JsonSkipValue(reader);
         }
+    }
 
-        // correct for ID3 tag
-        upperBytes = (upperBytes > ID3V2_TAG_ID_SIZE) ? upperBytes - ID3V2_TAG_ID_SIZE : 0;
+    if (pairs != NULL) {
+        hashTableFree(pairs);
+    }
 
-        // get file size
-        (void) fseek(fp, 0, SEEK_END);
-        fileSize = ftell(fp);
-        (void) fseek(fp, 0, SEEK_SET);
+    if (reader->failed || header == NULL || !haveContent) {
+        id3v2DestroyTagHeader(&header);
+        listFree(frames);
+        return NULL;
+    }
 
-        // read the file
-        tmp = malloc(fileSize);
-        if (fread(tmp, 1, fileSize, fp) != fileSize) {
-            free(tmp);
-            (void) fclose(fp);
-            byteStreamDestroy(stream);
-            return 0;
-        }
+    return id3v2CreateTag(header, frames);
+}
 
-        (void) fseek(fp, 0, SEEK_SET);
+/**
+ * @brief Builds an ID3v2 tag from a JSON string.
+ * @details Convenience wrapper around id3v2TagFromJSONReader using only the default identifier pairings, the whole
+ * string must be a single tag object. Feeding the output of id3v2TagToJSON back in gives a tag that converts to the
+ * same JSON.
+ * @param json - Null-terminated JSON text as written by id3v2TagToJSON.
+ * @return Id3v2Tag* - Heap allocated tag, or NULL if the JSON is empty or invalid. Caller must free with id3v2DestroyTag.
+ */
+Id3v2Tag *id3v2TagFromJSON(const char *json) {
+    Id3JsonReader *reader = NULL;
+    Id3v2Tag *tag = NULL;
 
-        if (prepend) {
-            // write the stream to a file
-            if (fwrite(byteStreamCursor(stream), 1, stream->bufferSize, fp) != stream->bufferSize) {
-                free(tmp);
-                (void) fclose(fp);
-                byteStreamDestroy(stream);
-                return 0;
-            }
+    if (json == NULL) {
+        return NULL;
+    }
 
-            // write the existing file data back to the file
-            if (fwrite(tmp, 1, fileSize, fp) != fileSize) {
-                free(tmp);
-                (void) fclose(fp);
-                byteStreamDestroy(stream);
-                return 0;
-            }
+    reader = id3JsonReaderCreate(json, strlen(json));
+    tag = id3v2TagFromJSONReader(reader, NULL);
 
-            free(tmp);
-        } else {
-            uint32_t offset = 10;
+    if (tag != NULL && !id3JsonReaderFinished(reader)) {
+        id3v2DestroyTag(&tag);
+    }
 
-            if (id3v2ReadFooterIndicator(tag->header) && tag->header->majorVersion == ID3V2_TAG_VERSION_4) {
-                offset += 10;
-            }
+    id3JsonReaderDestroy(&reader);
+    return tag;
+}
 
-            if (tag->header->extendedHeader != NULL) {
-                if (tag->header->extendedHeader->padding > 0) {
-                    offset += tag->header->extendedHeader->padding;
-                }
+/**
+ * @brief Converts an ID3v2 tag to CBOR.
+ * @details Convenience wrapper around id3v2TagToCBORSink collecting the output in a buffer.
+ * @param tag - Tag structure to convert.
+ * @param outl - Receives the number of bytes returned, 0 on failure.
+ * @return uint8_t* - Heap allocated CBOR, or NULL on failure. Caller must free the returned buffer.
+ */
+uint8_t *id3v2TagToCBOR(Id3v2Tag *tag, size_t *outl) {
+    Id3Sink *sink = NULL;
+    uint8_t *out = NULL;
+
+    if (outl == NULL) {
+        return NULL;
+    }
+
+    *outl = 0;
+    sink = id3SinkCreateBuffer(ID3V2_JSON_TAG_CAPACITY);
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3v2TagToCBORSink(tag, sink)) {
+        out = id3SinkTakeBuffer(sink, outl);
+    }
+
+    id3SinkDestroy(&sink);
+    return out;
+}
+
+/**
+ * @brief Writes the CBOR representation of an ID3v2 tag into a sink.
+ * @details Mirrors id3v2TagToJSON in CBOR (RFC 8949): a map holding the "header" and a "content" array with one
+ * map per frame, see id3v2FrameToCBORSink. Binary content such as artwork is written as raw byte strings, so the
+ * output is close to the size of the tag itself and needs no escaping or base64. Invalid tags write an empty map.
+ * @param tag - Tag to convert.
+ * @param sink - Sink receiving the CBOR.
+ * @return int - 1 (true) if the CBOR was written, 0 (false) on failure.
+ */
+int id3v2TagToCBORSink(Id3v2Tag *tag, Id3Sink *sink) {
+    Id3v2Frame *f = NULL;
+    ListIter frames;
+    bool ok = true;
+
+    if (sink == NULL) {
+        return false;
+    }
+
+    if (tag == NULL || tag->frames == NULL || tag->header == NULL || tag->header->majorVersion > ID3V2_TAG_VERSION_4) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    (void) id3CborWriteMap(sink, 2);
+    (void) id3CborWriteString(sink, "header");
+    (void) id3v2TagHeaderToCBORSink(tag->header, sink);
+    (void) id3CborWriteString(sink, "content");
+    (void) id3CborWriteArrayStart(sink);
+
+    frames = id3v2CreateFrameTraverser(tag);
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        ok = id3v2FrameToCBORSink(f, tag->header->majorVersion, sink) && ok;
+    }
+
+    return id3CborWriteBreak(sink) && ok;
+}
+
+/**
+ * @brief Builds an ID3v2 tag from its CBOR representation.
+ * @details Reads the map id3v2TagToCBORSink writes, the same way id3v2TagFromJSONReader reads JSON. The header
+ * must come before the content. Returns NULL for an empty map and on failure, check the failed field of the reader
+ * to tell them apart.
+ * @param reader - Reader positioned at the tag map.
+ * @param userPairs - User supplied identifier pairings, or NULL.
+ * @return Id3v2Tag* - Heap allocated tag, or NULL. Caller must free with id3v2DestroyTag.
+ */
+Id3v2Tag *id3v2TagFromCBORReader(Id3CborReader *reader, HashTable *userPairs) {
+    Id3v2TagHeader *header = NULL;
+    HashTable *pairs = NULL;
+    List *frames = NULL;
+    bool haveContent = false;
+
+    if (reader == NULL || !id3CborBeginMap(reader)) {
+        return NULL;
+    }
+
+    frames = listCreate(id3v2PrintFrame, id3v2DeleteFrame, id3v2CompareFrame, id3v2CopyFrame);
+
+    while (id3CborNextMember(reader)) {
+        if (strcmp(reader->key, "header") == 0 && header == NULL) {
+            header = id3v2TagHeaderFromCBORReader(reader);
+
+            if (header == NULL) {
+                reader->failed = true;
+                break;
+            }
+        } else if (strcmp(reader->key, "content") == 0 && !haveContent) {
+            if (header == NULL || !id3CborBeginArray(reader)) {
+                reader->failed = true;
+                break;
             }
 
-            // prepend data above the tag
-            if (upperBytes > 0) {
-                upperTmp = calloc(sizeof(uint8_t), upperBytes);
+            pairs = id3v2CreateDefaultIdentifierContextPairings(header->majorVersion);
 
-                if (fread(upperTmp, sizeof(char), upperBytes, fp) != upperBytes) {
-                    free(upperTmp);
-                    free(tmp);
-                    (void) fclose(fp);
-                    byteStreamDestroy(stream);
-                    return false;
-                }
-                free(upperTmp);
+            while (pairs != NULL && id3CborNextElement(reader)) {
+                Id3v2Frame *frame = id3v2FrameFromCBORReader(reader, header->majorVersion, pairs, userPairs);
 
-                (void) fseek(fp, 0, SEEK_SET);
+                if (frame != NULL) {
+                    listInsertBack(frames, (void *) frame);
+                } else if (reader->failed) {
+                    break;
+                }
             }
 
-            // write the stream to a file
-            if (fwrite(byteStreamCursor(stream), 1, stream->bufferSize, fp) != stream->bufferSize) {
-                free(tmp);
-                (void) fclose(fp);
-                byteStreamDestroy(stream);
-                return 0;
+            if (pairs == NULL) {
+                reader->failed = true;
             }
 
-            // no need to read the old tag
-            fileSize = fileSize - ((long) (oldTagSize + offset)) - (long) upperBytes;
+            haveContent = true;
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
 
-            if (fwrite(tmp + upperBytes + oldTagSize + offset, 1, fileSize, fp)) {
-                free(tmp);
-                (void) fclose(fp);
-                byteStreamDestroy(stream);
-                return 0;
-            }
+    if (pairs != NULL) {
+        hashTableFree(pairs);
+    }
+
+    if (reader->failed || header == NULL || !haveContent) {
+        id3v2DestroyTagHeader(&header);
+        listFree(frames);
+        return NULL;
+    }
 
-            free(tmp);
+    return id3v2CreateTag(header, frames);
+}
+
+/**
+ * @brief Builds an ID3v2 tag from its CBOR representation.
+ * @details Convenience wrapper around id3v2TagFromCBORReader using only the default identifier pairings, the whole
+ * buffer must be a single tag map.
+ * @param cbor - CBOR as written by id3v2TagToCBOR.
+ * @param length - Number of bytes in cbor.
+ * @return Id3v2Tag* - Heap allocated tag, or NULL if the CBOR is empty or invalid. Caller must free with id3v2DestroyTag.
+ */
+Id3v2Tag *id3v2TagFromCBOR(const uint8_t *cbor, size_t length) {
+    Id3CborReader *reader = id3CborReaderCreate(cbor, length);
+    Id3v2Tag *tag = id3v2TagFromCBORReader(reader, NULL);
+
+    if (tag != NULL && !id3CborReaderFinished(reader)) {
+        id3v2DestroyTag(&tag);
+    }
+
+    id3CborReaderDestroy(&reader);
+    return tag;
+}
+
+// internal function ------------------------------------------------------------------------
+static uint32_t internal_id3v2ExistingPadding(int fd, const Id3FileLayout *layout) {
+    uint8_t header[ID3V2_TAG_HEADER_SIZE] = {0};
+    uint8_t block[ID3V2_PADDING_BLOCK_SIZE];
+    uint64_t end = 0;
+    uint32_t padding = 0;
+    size_t n = 0;
+
+    if (layout->id3v2Size == 0 || !id3FileReadAt(fd, header, ID3V2_TAG_HEADER_SIZE, 0)) {
+        return 0;
+    }
+
+    // a footer means there is no padding
+    if (header[3] == ID3V2_TAG_VERSION_4 && (header[5] & 0x10) != 0) {
+        return 0;
+    }
+
+    // count trailing zeros
+    end = layout->id3v2Size;
+
+    while (end > ID3V2_TAG_HEADER_SIZE) {
+        n = (end - ID3V2_TAG_HEADER_SIZE > sizeof(block)) ? sizeof(block) : (size_t) (end - ID3V2_TAG_HEADER_SIZE);
+
+        if (!id3FileReadAt(fd, block, n, end - n)) {
+            break;
+        }
+
+        while (n > 0 && block[n - 1] == 0) {
+            n--;
+            end--;
+            padding++;
+        }
+
+        if (n > 0) {
+            break;
         }
     }
 
-    (void) fclose(fp);
-    byteStreamDestroy(stream);
-    return true;
+    return padding;
+}
+
+static int internal_id3v2WriteTagToFile(const char *filePath, Id3v2Tag *tag, const Id3v2WriteOptions *options,
+                                        const uint8_t *trailer) {
+    if (filePath == NULL || tag == NULL || tag->header == NULL) {
+        return false;
+    }
+
+    FILE *fp = NULL;
+    int fd = -1;
+    uint8_t *out = NULL;
+    size_t outl = 0;
+    size_t trailerl = (trailer != NULL) ? ID3V1_MAX_SIZE : 0;
+    uint64_t end = 0;
+    bool ok = false;
+    bool reuse = false;
+    bool update = (tag->header->extendedHeader != NULL && tag->header->extendedHeader->update);
+    Id3FileLayout layout;
+    Id3v2WriteOptions preserved = {fixed_padding, 0, 0};
+
+    fd = id3FileOpen(filePath, true);
+
+    // write to a new file
+    if (fd < 0) {
+        out = internal_id3v2TagSerialize(tag, options, 0, &outl);
+
+        if (out == NULL) {
+            return false;
+        }
+
+        fp = fopen(filePath, "wb");
+
+        if (fp == NULL) {
+            free(out);
+            return false;
+        }
+
+        ok = (fwrite(out, 1, outl, fp) == outl) && (trailerl == 0 || fwrite(trailer, 1, trailerl, fp) == trailerl);
+        ok = (fclose(fp) == 0) && ok;
+        free(out);
+        return ok;
+    }
+
+    if (!id3FileReadLayout(fd, &layout)) {
+        id3FileClose(fd);
+        return false;
+    }
+
+    if (options != NULL && options->paddingPolicy == preserve_padding) {
+        preserved.paddingAmount = internal_id3v2ExistingPadding(fd, &layout);
+        preserved.compressionThreshold = options->compressionThreshold;
+        options = &preserved;
+    }
+
+    // a policy reuses the space of the old tag whenever the new one fits inside it
+    reuse = (options != NULL && options->paddingPolicy != extended_padding && update == false);
+    out = internal_id3v2TagSerialize(tag, options, (reuse) ? (size_t) layout.id3v2Size : 0, &outl);
+
+    if (out == NULL) {
+        id3FileClose(fd);
+        return false;
+    }
+
+    // a trailer replaces an existing ID3v1 tag, without one the end of the file is kept as is
+    end = (trailer != NULL) ? layout.id3v1Offset : layout.fileSize;
+
+    // same size, the audio data stays where it is
+    if (update == false && layout.id3v2Size > 0 && outl == layout.id3v2Size) {
+        ok = id3FileWriteAt(fd, out, outl, 0) && (trailerl == 0 || id3FileWriteAt(fd, trailer, trailerl, end));
+    } else {
+        // stream everything after the old tag behind the new one, an update keeps the old tag
+        ok = id3FileRewrite(filePath, fd, out, outl, (update) ? 0 : layout.id3v2Size, end, trailer, trailerl);
+    }
+
+    id3FileClose(fd);
+    free(out);
+
+    return ok;
+}
+
+/**
+ * @brief Writes an ID3v2 tag to a file, creating, prepending, or replacing as needed.
+ * @details Serializes the tag and handles three scenarios: (1) If file doesn't exist, creates it and writes the tag; 
+ * (2) If file exists without a tag or with the update flag set in the extended header, prepends the new tag to the file; 
+ * (3) If file exists with a tag and no update flag, replaces the old tag. A tag of the same size is written in place, otherwise the file is
+ * rewritten through a temporary file in the same directory with the audio data copied by the kernel, followed by an atomic rename.
+ * Memory use does not depend on the size of the audio data, but the serialized tag is held in memory, so it grows with
+ * the size of the artwork. Content a tag read with id3v2TagFromFileLazy left in a file is loaded into the tag before it
+ * is serialized, and the write fails if that file changed since the tag was read.
+ * Equivalent to id3v2WriteTagToFileWithOptions with NULL options.
+ * Returns false on validation failures (null parameters, serialization errors, file open/read/write errors, or memory allocation failures) without modifying the file.
+ * @param filePath - Null-terminated string containing the path to the file to write.
+ * @param tag - Tag structure to write to the file.
+ * @return int - 1 (true) if tag written successfully, 0 (false) on failure.
+ */
+int id3v2WriteTagToFile(const char *filePath, Id3v2Tag *tag) {
+    return id3v2WriteTagToFileWithOptions(filePath, tag, NULL);
+}
+
+/**
+ * @brief Writes an ID3v2 tag to a file using a padding policy.
+ * @details Behaves like id3v2WriteTagToFile. When options select a policy other than extended_padding and the file
+ * already starts with a tag, the new tag is written in place whenever it fits inside the space of the old one; the
+ * remainder is filled with padding so the audio data does not move. When it does not fit, the file is rewritten with
+ * padding chosen by the policy, where preserve_padding keeps the amount of padding the old tag had.
+ * Tags with the update flag set in the extended header are always prepended.
+ * Returns false on validation failures, serialization errors, or file errors.
+ * @param filePath - Null-terminated string containing the path to the file to write.
+ * @param tag - Tag structure to write to the file.
+ * @param options - Write options, may be NULL.
+ * @return int - 1 (true) if tag written successfully, 0 (false) on failure.
+ */
+int id3v2WriteTagToFileWithOptions(const char *filePath, Id3v2Tag *tag, const Id3v2WriteOptions *options) {
+    return internal_id3v2WriteTagToFile(filePath, tag, options, NULL);
+}
+
+/**
+ * @brief Writes an ID3v2 tag and a serialized ID3v1 tag to a file in a single pass.
+ * @details Behaves like id3v2WriteTagToFileWithOptions while also placing trailer, a 128 byte serialized ID3v1 tag,
+ * at the end of the file, replacing an ID3v1 tag that is already there. The file is opened once: when the new ID3v2
+ * tag fits the space of the old one both tags are patched in place, otherwise the audio data is copied once into
+ * the rewritten file. A NULL trailer leaves the end of the file untouched.
+ * Returns false on validation failures, serialization errors, or file errors.
+ * @param filePath - Null-terminated string containing the path to the file to write.
+ * @param tag - Tag structure to write to the file.
+ * @param options - Write options, may be NULL.
+ * @param trailer - ID3V1_MAX_SIZE bytes to place at the end of the file, may be NULL.
+ * @return int - 1 (true) if both tags were written successfully, 0 (false) on failure.
+ */
+int id3v2WriteTagToFileWithTrailer(const char *filePath, Id3v2Tag *tag, const Id3v2WriteOptions *options,
+                                   const uint8_t trailer[ID3V1_MAX_SIZE]) {
+    return internal_id3v2WriteTagToFile(filePath, tag, options, trailer);
 }
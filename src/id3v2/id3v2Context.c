@@ -1950,6 +1950,52 @@ bool id3v2InsertIdentifierContextPair(HashTable *identifierContextPairs, char ke
     return true;
 }
 
+/**
+ * @brief Looks up the context used to parse a frame.
+ * @details Checks the default pairings, then the user supplied ones, then the catch-all contexts for text ("T") and
+ * URL ("W") frames, and finally falls back to the generic context ("?"). This is the order the parser uses, so
+ * frames imported from other representations get the same structure as frames read from a file.
+ * 
+ * @param identifierContextPairs Default pairings, as made by id3v2CreateDefaultIdentifierContextPairings
+ * @param userPairs User supplied pairings, or NULL
+ * @param id The frame identifier string (3 characters for v2.2, 4 characters for v2.3/v2.4)
+ * 
+ * @return List* - Context owned by one of the tables, or NULL if identifierContextPairs or id is NULL
+ */
+List *id3v2FindIdentifierContext(HashTable *identifierContextPairs, HashTable *userPairs, const char *id) {
+    List *context = NULL;
+
+    if (identifierContextPairs == NULL || id == NULL) {
+        return NULL;
+    }
+
+    // check default pairings (pass 1/4)
+    context = hashTableRetrieve(identifierContextPairs, id);
+
+    // check user supplied ones (pass 2/4)
+    if (context == NULL && userPairs != NULL) {
+        context = hashTableRetrieve(userPairs, id);
+    }
+
+    // special considerations (pass 3/4)
+    if (context == NULL) {
+        if (id[0] == 'T') {
+            context = hashTableRetrieve(identifierContextPairs, "T");
+        }
+
+        if (id[0] == 'W') {
+            context = hashTableRetrieve(identifierContextPairs, "W");
+        }
+    }
+
+    // use generic (pass 4/4)
+    if (context == NULL) {
+        context = hashTableRetrieve(identifierContextPairs, "?");
+    }
+
+    return context;
+}
+
 /**
  * @brief Creates a binary representation of a content context structure for serialization.
  * @details Converts an Id3v2ContentContext structure into a compact binary format suitable for 
@@ -16,34 +16,324 @@
 #include <limits.h>
 #include "id3v2/id3v2Frame.h"
 #include "id3v2/id3v2Context.h"
+#include "id3v2/id3v2Unsynchronisation.h"
+#include "id3v2/id3v2Parser.h"
+#include "id3Base64.h"
+#include "id3Sha1.h"
 #include "id3dependencies/ByteStream/include/byteInt.h"
 #include "id3dependencies/ByteStream/include/byteUnicode.h"
 #include "id3dependencies/ByteStream/include/byteStream.h"
 
-static char *internal_base64Encode(const unsigned char *input, size_t inputLength) {
-    static const unsigned char base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    const size_t outputLength = 4 * ((inputLength + 2) / 3);
-    unsigned char *output = malloc(outputLength + 1);
+#ifdef ID3_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
-    if (output == NULL) {
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+//! Number of bytes base64 encoded at a time when writing JSON, a multiple of 3
+#define ID3V2_JSON_BASE64_BLOCK_SIZE 3072
+
+//! Initial capacity of the buffer a frame is converted to JSON in
+#define ID3V2_JSON_FRAME_CAPACITY 256
+
+// compressed frames are inflated by whichever reader reaches them first, one frame at a time
+#if defined(_WIN32)
+static SRWLOCK internal_id3v2InflateLock = SRWLOCK_INIT;
+
+static void internal_id3v2InflateAcquire(void) {
+    AcquireSRWLockExclusive(&internal_id3v2InflateLock);
+}
+
+static void internal_id3v2InflateRelease(void) {
+    ReleaseSRWLockExclusive(&internal_id3v2InflateLock);
+}
+#else
+static pthread_mutex_t internal_id3v2InflateLock = PTHREAD_MUTEX_INITIALIZER;
+
+static void internal_id3v2InflateAcquire(void) {
+    (void) pthread_mutex_lock(&internal_id3v2InflateLock);
+}
+
+static void internal_id3v2InflateRelease(void) {
+    (void) pthread_mutex_unlock(&internal_id3v2InflateLock);
+}
+#endif
+
+static bool internal_base64EncodeToSink(Id3Sink *sink, const uint8_t *input, size_t inputLength) {
+    char output[(ID3V2_JSON_BASE64_BLOCK_SIZE / 3) * 4];
+
+    (void) id3SinkReserve(sink, id3Base64EncodedSize(inputLength));
+
+    while (inputLength > 0) {
+        const size_t n = (inputLength > ID3V2_JSON_BASE64_BLOCK_SIZE) ? ID3V2_JSON_BASE64_BLOCK_SIZE : inputLength;
+
+        if (!id3SinkWrite(sink, (const uint8_t *) output, id3Base64Encode(input, n, output))) {
+            return false;
+        }
+
+        input += n;
+        inputLength -= n;
+    }
+
+    return true;
+}
+
+// internal function ---
+// last content entry of a frame, NULL if it has none
+static Id3v2ContentEntry *internal_id3v2LastEntry(const Id3v2Frame *frame) {
+    Id3v2ContentEntry *entry = NULL;
+    Id3v2ContentEntry *last = NULL;
+    ListIter entries;
+
+    if (frame == NULL || frame->entries == NULL) {
         return NULL;
     }
 
-    size_t i = 0;
-    size_t j = 0;
-    for (i = 0, j = 0; i < inputLength; i += 3, j += 4) {
-        const unsigned int byte1 = input[i];
-        const unsigned int byte2 = (i + 1 < inputLength) ? input[i + 1] : 0;
-        const unsigned int byte3 = (i + 2 < inputLength) ? input[i + 2] : 0;
+    entries = listCreateIterator(frame->entries);
+
+    while ((entry = (Id3v2ContentEntry *) listIteratorNext(&entries)) != NULL) {
+        last = entry;
+    }
+
+    return last;
+}
+
+// finds binary content inside the bytes a frame was read as, only possible when it is stored verbatim at their end
+static bool internal_id3v2LocateBinary(const Id3v2Frame *frame, uint8_t version, const uint8_t *data, size_t size,
+                                       size_t *offset) {
+    const uint8_t *shared = NULL;
+    size_t sharedSize = 0;
+    size_t rawSize = 0;
+    const uint8_t *raw = id3v2FrameCachedBytes(frame, &rawSize, &shared, &sharedSize);
+
+    if (raw == NULL || frame->rawOffset == 0 || id3v2FrameIsDirty(frame, version) || rawSize + sharedSize < size) {
+        return false;
+    }
+
+    // the end of the frame may be held by its last entry rather than the cache
+    if (size <= sharedSize) {
+        if (memcmp(shared + sharedSize - size, data, size) != 0) {
+            return false;
+        }
+    } else if (memcmp(raw + rawSize - (size - sharedSize), data, size - sharedSize) != 0 ||
+               memcmp(data + size - sharedSize, shared, sharedSize) != 0) {
+        return false;
+    }
+
+    *offset = frame->rawOffset + rawSize + sharedSize - size;
+    return true;
+}
+
+static void internal_id3v2JSONBinary(Id3Sink *sink, bool *first, const Id3v2Frame *frame, uint8_t version,
+                                     const uint8_t *data, size_t size, const Id3v2JSONOptions *options) {
+    const Id3v2JSONBinaryPolicy policy = (options != NULL) ? options->binaryPolicy : embed_binary;
+
+    (void) id3SinkWriteString(sink, (*first) ? "{" : ",{");
+    *first = false;
+
+    switch (policy) {
+        case truncate_binary: {
+            const size_t n = (size > options->binaryLimit) ? options->binaryLimit : size;
+
+            (void) id3SinkWriteString(sink, "\"value\":\"");
+            (void) internal_base64EncodeToSink(sink, data, n);
+            (void) id3SinkPrintf(sink, "\",\"size\":%zu%s}", size, (n < size) ? ",\"truncated\":true" : "");
+        }
+        break;
+
+        case digest_binary: {
+            static const char hex[] = "0123456789abcdef";
+            uint8_t digest[ID3_SHA1_DIGEST_SIZE];
+            char text[ID3_SHA1_DIGEST_SIZE * 2 + 1];
+
+            id3Sha1(data, size, digest);
+
+            for (size_t i = 0; i < ID3_SHA1_DIGEST_SIZE; i++) {
+                text[i * 2] = hex[digest[i] >> 4];
+                text[i * 2 + 1] = hex[digest[i] & 0x0F];
+            }
+
+            text[ID3_SHA1_DIGEST_SIZE * 2] = 0;
+            (void) id3SinkPrintf(sink, "\"size\":%zu,\"sha1\":\"%s\"}", size, text);
+        }
+        break;
+
+        case reference_binary: {
+            size_t offset = 0;
+
+            if (internal_id3v2LocateBinary(frame, version, data, size, &offset)) {
+                (void) id3SinkPrintf(sink, "\"offset\":%zu,\"size\":%zu}", offset, size);
+            } else {
+                (void) id3SinkPrintf(sink, "\"offset\":null,\"size\":%zu}", size);
+            }
+        }
+        break;
+
+        case embed_binary:
+        default:
+            (void) id3SinkWriteString(sink, "\"value\":\"");
+            (void) internal_base64EncodeToSink(sink, data, size);
+            (void) id3SinkPrintf(sink, "\",\"size\":%zu}", size);
+            break;
+    }
+}
+
+// opens a content entry, entries after the first are separated by a comma
+static void internal_id3v2JSONValueStart(Id3Sink *sink, bool *first) {
+    (void) id3SinkWriteString(sink, (*first) ? "{\"value\":\"" : ",{\"value\":\"");
+    *first = false;
+}
+
+static void internal_id3v2JSONValueEnd(Id3Sink *sink, size_t size) {
+    (void) id3SinkPrintf(sink, "\",\"size\":%zu}", size);
+}
+
+static bool internal_id3v2FrameHeaderToJSONSink(const Id3v2FrameHeader *header, uint8_t version, Id3Sink *sink) {
+    if (header == NULL) {
+        return id3SinkWriteString(sink, "{}");
+    }
+
+    switch (version) {
+        case ID3V2_TAG_VERSION_2:
+            return id3SinkPrintf(sink,
+                                 "{\"id\":\"%c%c%c\"}",
+                                 header->id[0],
+                                 header->id[1],
+                                 header->id[2]);
+        case ID3V2_TAG_VERSION_3:
+            return id3SinkPrintf(sink,
+                                 "{\"id\":\"%c%c%c%c\",\"tagAlterPreservation\":%s,\"fileAlterPreservation\":%s,\"readOnly\":%s,\"decompressionSize\":%"
+                                 PRId32",\"encryptionSymbol\":%d,\"groupSymbol\":%d}",
+                                 header->id[0],
+                                 header->id[1],
+                                 header->id[2],
+                                 header->id[3],
+                                 ((header->tagAlterPreservation == true) ? "true" : "false"),
+                                 ((header->fileAlterPreservation == true) ? "true" : "false"),
+                                 ((header->readOnly == true) ? "true" : "false"),
+                                 header->decompressionSize,
+                                 header->encryptionSymbol,
+                                 header->groupSymbol);
+        case ID3V2_TAG_VERSION_4:
+            return id3SinkPrintf(sink,
+                                 "{\"id\":\"%c%c%c%c\",\"tagAlterPreservation\":%s,\"fileAlterPreservation\":%s,\"readOnly\":%s,\"unsynchronisation\":%s,\"decompressionSize\":%"
+                                 PRId32",\"encryptionSymbol\":%d,\"groupSymbol\":%d}",
+                                 header->id[0],
+                                 header->id[1],
+                                 header->id[2],
+                                 header->id[3],
+                                 ((header->tagAlterPreservation == true) ? "true" : "false"),
+                                 ((header->fileAlterPreservation == true) ? "true" : "false"),
+                                 ((header->readOnly == true) ? "true" : "false"),
+                                 ((header->unsynchronisation == true) ? "true" : "false"),
+                                 header->decompressionSize,
+                                 header->encryptionSymbol,
+                                 header->groupSymbol);
+        // no support
+        default:
+            return id3SinkWriteString(sink, "{}");
+    }
+}
+
+static uint8_t *internal_id3v2FrameUnsynchronise(uint8_t *frame, size_t framel, size_t *outl) {
+    // flags in the second format byte add a group symbol, an encryption symbol, and a data length indicator
+    size_t headerSize = 10 + ((frame[9] & 0x40) ? 1 : 0) + ((frame[9] & 0x04) ? 1 : 0) + ((frame[9] & 0x01) ? 4 : 0);
+    size_t bodyl = 0;
+    uint8_t *body = NULL;
+    uint8_t *out = NULL;
+    unsigned char *tmp = NULL;
+
+    if (framel <= headerSize) {
+        *outl = framel;
+        return frame;
+    }
+
+    body = id3v2Unsynchronise(frame + headerSize, framel - headerSize, NULL, &bodyl);
+    out = (body != NULL) ? malloc(headerSize + bodyl) : NULL;
+
+    if (out == NULL) {
+        free(body);
+        free(frame);
+        *outl = 0;
+        return NULL;
+    }
+
+    memcpy(out, frame, headerSize);
+    memcpy(out + headerSize, body, bodyl);
+
+    // v2.4 frame sizes count the unsynchronised bytes
+    tmp = u32tob(byteSyncintEncode((uint32_t) bodyl));
+    memcpy(out + ID3V2_FRAME_ID_MAX_SIZE, tmp, 4);
+    out[9] |= 0x02;
+
+    free(tmp);
+    free(body);
+    free(frame);
+
+    *outl = headerSize + bodyl;
+    return out;
+}
+
+static uint8_t *internal_id3v2FrameCompress(const Id3v2Frame *frame, uint8_t version, size_t threshold, uint8_t *plain,
+                                           size_t plainl, size_t *outl) {
+    *outl = plainl;
+
+#ifdef ID3_HAVE_ZLIB
+    Id3v2FrameHeader h = *frame->header;
+    size_t headerSize = 10 + ((h.groupSymbol > 0) ? 1 : 0);
+    size_t contentl = 0;
+    uLongf packedl = 0;
+    uint8_t *packed = NULL;
+    uint8_t *header = NULL;
+    uint8_t *out = NULL;
+    size_t hl = 0;
+
+    // only version 3 and 4 frames can be compressed, encrypted content is left alone
+    if (version < ID3V2_TAG_VERSION_3 || h.encryptionSymbol > 0 || h.decompressionSize > 0 ||
+        plainl <= headerSize || plainl - headerSize <= threshold) {
+        return plain;
+    }
 
-        output[j] = base64Chars[byte1 >> 2];
-        output[j + 1] = base64Chars[((byte1 & 0x03) << 4) | (byte2 >> 4)];
-        output[j + 2] = (i + 1 < inputLength) ? base64Chars[((byte2 & 0x0F) << 2) | (byte3 >> 6)] : (unsigned char) '=';
-        output[j + 3] = (i + 2 < inputLength) ? base64Chars[byte3 & 0x3F] : (unsigned char) '=';
+    contentl = plainl - headerSize;
+    packedl = compressBound((uLong) contentl);
+    packed = malloc(packedl);
+
+    if (packed == NULL || compress2(packed, &packedl, plain + headerSize, (uLong) contentl, Z_BEST_COMPRESSION) != Z_OK ||
+        packedl >= contentl) {
+        free(packed);
+        return plain;
+    }
+
+    // the header serializer writes the v2.4 data length indicator as is
+    h.decompressionSize = (version == ID3V2_TAG_VERSION_4) ? byteSyncintEncode((uint32_t) contentl) : (uint32_t) contentl;
+    header = id3v2FrameHeaderSerialize(&h, version, (uint32_t) packedl, &hl);
+    out = (header != NULL) ? malloc(hl + packedl) : NULL;
+
+    if (out == NULL) {
+        free(header);
+        free(packed);
+        return plain;
     }
 
-    output[outputLength] = '\0';
-    return (char *) output;
+    memcpy(out, header, hl);
+    memcpy(out + hl, packed, packedl);
+
+    free(header);
+    free(packed);
+    free(plain);
+
+    *outl = hl + packedl;
+    return out;
+#else
+    (void) frame;
+    (void) version;
+    (void) threshold;
+    return plain;
+#endif
 }
 
 
@@ -115,6 +405,9 @@ void id3v2DestroyFrameHeader(Id3v2FrameHeader **toDelete) {
 Id3v2ContentEntry *id3v2CreateContentEntry(void *entry, size_t size) {
     Id3v2ContentEntry *ce = malloc(sizeof(Id3v2ContentEntry));
 
+    ce->source = NULL;
+    ce->offset = 0;
+
     if (!size) {
         ce->entry = NULL;
         ce->size = 0;
@@ -129,6 +422,200 @@ Id3v2ContentEntry *id3v2CreateContentEntry(void *entry, size_t size) {
     return ce;
 }
 
+/**
+ * @brief Creates a source naming a file content entries can be read from.
+ * @details The path is copied along with the identity of the file, see id3FileIdentify. Entries are only read from
+ * the file while its identity is unchanged, so a file that was replaced or written to since is never read from
+ * stale offsets. The caller holds the first reference and every entry created with id3v2CreateFileContentEntry takes
+ * one more, release each with id3v2ReleaseSource.
+ * 
+ * @param path - Path of the file
+ * 
+ * @return Id3v2Source * - Heap-allocated source, or NULL if path is NULL, the file cannot be opened, or memory
+ * allocation fails
+ */
+Id3v2Source *id3v2CreateSource(const char *path) {
+    if (path == NULL) {
+        return NULL;
+    }
+
+    Id3v2Source *source = malloc(sizeof(Id3v2Source));
+    int fd = -1;
+    bool identified = false;
+
+    if (source == NULL) {
+        return NULL;
+    }
+
+    fd = id3FileOpen(path, false);
+    identified = id3FileIdentify(fd, &source->identity);
+    id3FileClose(fd);
+
+    if (!identified) {
+        free(source);
+        return NULL;
+    }
+
+    source->path = malloc(strlen(path) + 1);
+
+    if (source->path == NULL) {
+        free(source);
+        return NULL;
+    }
+
+    memcpy(source->path, path, strlen(path) + 1);
+    source->references = 1;
+
+    return source;
+}
+
+/**
+ * @brief Drops a reference to a source, freeing it once no reference is left, and sets the pointer to NULL.
+ * @details Safe to call with NULL or with a pointer to NULL.
+ * 
+ * @param toRelease - Pointer to the source pointer to release
+ */
+void id3v2ReleaseSource(Id3v2Source **toRelease) {
+    if (toRelease == NULL || *toRelease == NULL) {
+        return;
+    }
+
+    if (--(*toRelease)->references == 0) {
+        free((*toRelease)->path);
+        free(*toRelease);
+    }
+
+    *toRelease = NULL;
+}
+
+/**
+ * @brief Creates a content entry referring to bytes of a file instead of holding them.
+ * @details Nothing is read, the entry takes a reference to source and its bytes are read from the file each time
+ * they are needed, see id3v2ReadFrameEntry. The file must not change while the entry refers to it.
+ * 
+ * @param source - File the bytes are in
+ * @param offset - Offset of the bytes from the start of the file
+ * @param size - Number of bytes
+ * 
+ * @return Id3v2ContentEntry * - Heap-allocated content entry, or NULL if source is NULL or size is 0
+ */
+Id3v2ContentEntry *id3v2CreateFileContentEntry(Id3v2Source *source, uint64_t offset, size_t size) {
+    if (source == NULL || size == 0) {
+        return NULL;
+    }
+
+    Id3v2ContentEntry *ce = malloc(sizeof(Id3v2ContentEntry));
+
+    if (ce == NULL) {
+        return NULL;
+    }
+
+    ce->entry = NULL;
+    ce->size = size;
+    ce->source = source;
+    ce->offset = offset;
+    source->references++;
+
+    return ce;
+}
+
+/**
+ * @brief Opens the file a content entry refers to for reading, if it is still the file the entry was read from.
+ * @details The opened file is checked with id3FileIdentify against the identity its source recorded, so a file that
+ * was replaced or written to since is never read from stale offsets. The entry's bytes start at its offset.
+ * 
+ * @param entry - Entry referring to a file, see id3v2CreateFileContentEntry
+ * 
+ * @return int - Descriptor to close with id3FileClose, or -1 if the entry holds its bytes, the file cannot be opened,
+ * or it changed
+ */
+int id3v2OpenContentSource(const Id3v2ContentEntry *entry) {
+    const Id3FileIdentity *expected = NULL;
+    Id3FileIdentity identity;
+    int fd = -1;
+
+    if (entry == NULL || entry->source == NULL) {
+        return -1;
+    }
+
+    expected = &entry->source->identity;
+    fd = id3FileOpen(entry->source->path, false);
+
+    if (fd >= 0 && !(id3FileIdentify(fd, &identity) && identity.device == expected->device &&
+                     identity.inode == expected->inode && identity.size == expected->size &&
+                     identity.modified == expected->modified)) {
+        id3FileClose(fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+// internal function ---
+// reads the bytes of an entry held in a file into out, which holds at least entry->size bytes. fails once the file
+// is not the one the entry was read from
+static bool internal_id3v2ReadSource(const Id3v2ContentEntry *entry, uint8_t *out) {
+    int fd = id3v2OpenContentSource(entry);
+    bool ok = (fd >= 0 && id3FileReadAt(fd, out, entry->size, entry->offset));
+
+    id3FileClose(fd);
+    return ok;
+}
+
+// internal function ---
+// bytes of an entry wherever they are held. *held is set when they were read from a file and must be freed
+static const uint8_t *internal_id3v2EntryBytes(const Id3v2ContentEntry *entry, bool *held) {
+    uint8_t *bytes = NULL;
+
+    *held = false;
+
+    if (entry->source == NULL) {
+        return entry->entry;
+    }
+
+    bytes = malloc(entry->size);
+
+    if (bytes == NULL || !internal_id3v2ReadSource(entry, bytes)) {
+        free(bytes);
+        return NULL;
+    }
+
+    *held = true;
+    return bytes;
+}
+
+/**
+ * @brief Reads the bytes of a content entry referring to a file into memory.
+ * @details Afterwards the entry holds its bytes like any other and no longer refers to the file. Entries that
+ * already hold their bytes are left as they are.
+ * 
+ * @param entry - Entry to load
+ * 
+ * @return bool - true if the entry holds its bytes, false if it is NULL or the file could not be read
+ */
+bool id3v2LoadContentEntry(Id3v2ContentEntry *entry) {
+    if (entry == NULL) {
+        return false;
+    }
+
+    if (entry->source == NULL) {
+        return true;
+    }
+
+    uint8_t *bytes = malloc(entry->size);
+
+    if (bytes == NULL || !internal_id3v2ReadSource(entry, bytes)) {
+        free(bytes);
+        return false;
+    }
+
+    entry->entry = bytes;
+    entry->offset = 0;
+    id3v2ReleaseSource(&entry->source);
+
+    return true;
+}
+
 /**
  * @brief Compares two content entries byte-by-byte and returns the difference
  * @details Performs lexicographic comparison of entry data up to the smaller of the two sizes.
@@ -151,15 +638,33 @@ int id3v2CompareContentEntry(const void *first, const void *second) {
     }
 
     int diff = 0;
+    bool heldOne = false;
+    bool heldTwo = false;
     const size_t usableSize = (one->size <= two->size) ? one->size : two->size;
-    for (size_t i = 0; i < usableSize; i++) {
-        if (((unsigned char *) one->entry)[i] != ((unsigned char *) two->entry)[i]) {
-            diff = ((unsigned char *) one->entry)[i] - ((unsigned char *) two->entry)[i];
-            return diff;
+    const uint8_t *bytesOne = internal_id3v2EntryBytes(one, &heldOne);
+    const uint8_t *bytesTwo = internal_id3v2EntryBytes(two, &heldTwo);
+
+    // an entry whose file cannot be read equals nothing
+    if ((bytesOne == NULL && one->size > 0) || (bytesTwo == NULL && two->size > 0)) {
+        diff = 1;
+    } else {
+        for (size_t i = 0; i < usableSize; i++) {
+            if (bytesOne[i] != bytesTwo[i]) {
+                diff = bytesOne[i] - bytesTwo[i];
+                break;
+            }
         }
     }
 
-    return 0;
+    if (heldOne) {
+        free((uint8_t *) bytesOne);
+    }
+
+    if (heldTwo) {
+        free((uint8_t *) bytesTwo);
+    }
+
+    return diff;
 }
 
 /**
@@ -196,6 +701,11 @@ char *id3v2PrintContentEntry(const void *toBePrinted) {
 void *id3v2CopyContentEntry(const void *toBeCopied) {
     Id3v2ContentEntry *e = (Id3v2ContentEntry *) toBeCopied;
 
+    // a copy refers to the same file
+    if (e->source != NULL) {
+        return id3v2CreateFileContentEntry(e->source, e->offset, e->size);
+    }
+
     return id3v2CreateContentEntry(e->entry, e->size);
 }
 
@@ -213,6 +723,8 @@ void id3v2DeleteContentEntry(void *toBeDeleted) {
     if (e->entry != NULL) {
         free(e->entry);
     }
+
+    id3v2ReleaseSource(&e->source);
     free(e);
 }
 
@@ -352,17 +864,9 @@ char *id3v2PrintFrame(const void *toBePrinted) {
     return s;
 }
 
-/**
- * @brief Creates a deep copy of an ID3v2 frame structure.
- * @details Duplicates all frame components including header, contexts, and entries with 
- * independently allocated memory. Can be used as a callback for list copy operations.
- * 
- * @param toBeCopied - Frame to copy
- * 
- * @return void* - Heap allocated frame containing deep copies of all components
- */
-void *id3v2CopyFrame(const void *toBeCopied) {
-    Id3v2Frame *f = (Id3v2Frame *) toBeCopied;
+// internal function ---
+// copies a frame, see id3v2CopyFrame
+static Id3v2Frame *internal_id3v2CopyFrame(const Id3v2Frame *f) {
 
     Id3v2FrameHeader *h = id3v2CreateFrameHeader(f->header->id,
                                                  f->header->tagAlterPreservation,
@@ -373,16 +877,64 @@ void *id3v2CopyFrame(const void *toBeCopied) {
                                                  f->header->encryptionSymbol,
                                                  f->header->groupSymbol);
 
-    return id3v2CreateFrame(h, listDeepCopy(f->contexts), listDeepCopy(f->entries));
-}
+    Id3v2Frame *copy = id3v2CreateFrame(h, listDeepCopy(f->contexts), listDeepCopy(f->entries));
 
+    // the copy holds the same last entry, so any bytes shared with it stay shared
+    if (f->raw != NULL && f->rawSize > 0) {
+        copy->raw = malloc(f->rawSize);
 
-/**
- * @brief Creates an ID3v2 frame structure from provided components.
- * @details Allocates a frame on the heap and assembles it from a header, contexts list,
- * and entries list. The frame takes ownership of all provided components.
- * 
- * @param header - Frame header containing ID and flags
+        if (copy->raw != NULL) {
+            memcpy(copy->raw, f->raw, f->rawSize);
+            copy->rawSize = f->rawSize;
+            copy->rawShared = f->rawShared;
+            copy->rawVersion = f->rawVersion;
+            copy->rawHeader = f->rawHeader;
+            copy->rawOffset = f->rawOffset;
+        }
+    }
+
+    if (f->compressedContext != NULL) {
+        copy->compressedContext = listDeepCopy(f->compressedContext);
+        copy->compressed = true;
+    }
+
+    return copy;
+}
+
+/**
+ * @brief Creates a deep copy of an ID3v2 frame structure.
+ * @details Duplicates all frame components including header, contexts, entries, and cached serialized bytes
+ * with independently allocated memory. Can be used as a callback for list copy operations. A compressed frame
+ * another thread is inflating is copied before or after it is inflated, never while.
+ * 
+ * @param toBeCopied - Frame to copy
+ * 
+ * @return void* - Heap allocated frame containing deep copies of all components
+ */
+void *id3v2CopyFrame(const void *toBeCopied) {
+    const Id3v2Frame *f = (const Id3v2Frame *) toBeCopied;
+    Id3v2Frame *copy = NULL;
+
+    if (f->compressed) {
+        internal_id3v2InflateAcquire();
+    }
+
+    copy = internal_id3v2CopyFrame(f);
+
+    if (f->compressed) {
+        internal_id3v2InflateRelease();
+    }
+
+    return copy;
+}
+
+
+/**
+ * @brief Creates an ID3v2 frame structure from provided components.
+ * @details Allocates a frame on the heap and assembles it from a header, contexts list,
+ * and entries list. The frame takes ownership of all provided components.
+ * 
+ * @param header - Frame header containing ID and flags
  * @param context - List of content contexts defining entry structures
  * @param entries - List of content entries containing frame data
  * 
@@ -394,6 +946,14 @@ Id3v2Frame *id3v2CreateFrame(Id3v2FrameHeader *header, List *context, List *entr
     frame->contexts = context;
     frame->entries = entries;
     frame->header = header;
+    frame->raw = NULL;
+    frame->rawSize = 0;
+    frame->rawShared = 0;
+    frame->rawVersion = 0;
+    memset(&frame->rawHeader, 0, sizeof(Id3v2FrameHeader));
+    frame->rawOffset = 0;
+    frame->compressedContext = NULL;
+    frame->compressed = false;
 
     return frame;
 }
@@ -411,6 +971,12 @@ void id3v2DestroyFrame(Id3v2Frame **toDelete) {
         listFree((*toDelete)->contexts);
         listFree((*toDelete)->entries);
         id3v2DestroyFrameHeader(&(*toDelete)->header);
+        free((*toDelete)->raw);
+
+        if ((*toDelete)->compressedContext != NULL) {
+            listFree((*toDelete)->compressedContext);
+        }
+
         free(*toDelete);
         *toDelete = NULL;
         toDelete = NULL;
@@ -540,14 +1106,21 @@ ListIter id3v2CreateFrameTraverser(Id3v2Tag *tag) {
  * @brief Advances the iterator and returns the next frame in the list.
  * @details Wrapper around listIteratorNext that advances the iterator position and returns 
  * the current frame. Returns NULL when the end of the list is reached, indicating iteration 
- * is complete.
+ * is complete. Compressed frames are decompressed the first time they are returned so their 
+ * entries can be read like any other frame, see id3v2DecompressFrame.
  * 
  * @param traverser - List iterator to advance
  * 
  * @return Id3v2Frame* - Pointer to the next frame in the list, or NULL if at the end
  */
 Id3v2Frame *id3v2FrameTraverse(ListIter *traverser) {
-    return (Id3v2Frame *) listIteratorNext(traverser);
+    Id3v2Frame *frame = (Id3v2Frame *) listIteratorNext(traverser);
+
+    if (frame != NULL && frame->compressed) {
+        (void) id3v2DecompressFrame(frame);
+    }
+
+    return frame;
 }
 
 /**
@@ -581,7 +1154,7 @@ ListIter id3v2CreateFrameEntryTraverser(Id3v2Frame *frame) {
  * @details Retrieves the content entry at the iterator's current position and creates an 
  * independently allocated copy of its data. Advances the iterator to the next entry. Returns 
  * NULL and sets dataSize to 0 if the traverser is NULL, the current entry is NULL, or the 
- * entry has zero size.
+ * entry has zero size. Entries referring to a file are read from it, NULL is also returned when that fails.
  * 
  * @param traverser - Iterator positioned at the entry to read
  * @param dataSize - Output parameter receiving the size of returned data in bytes, or 0 on failure
@@ -610,35 +1183,32 @@ void *id3v2ReadFrameEntry(ListIter *traverser, size_t *dataSize) {
 
     ret = malloc(data->size);
     memset(ret, 0, data->size);
-    memcpy(ret, data->entry, data->size);
+
+    if (data->source != NULL) {
+        if (!internal_id3v2ReadSource(data, ret)) {
+            free(ret);
+            *dataSize = 0;
+            return NULL;
+        }
+    } else {
+        memcpy(ret, data->entry, data->size);
+    }
 
     *dataSize = data->size;
     return ret;
 }
 
 
-/**
- * @brief Reads a frame entry as a UTF-8 encoded string with escaped special characters, advancing the iterator.
- * @details Retrieves the content entry at the iterator's current position, automatically detects its encoding, 
- * and converts it to UTF-8. Strips UTF-8 BOM if present and escapes quotes and backslashes for JSON/C std 
- * compatibility. Advances the iterator to the next entry. Returns NULL and sets dataSize to 0 if the traverser 
- * is NULL, the current entry is NULL, memory allocation fails, or encoding conversion fails.
- * 
- * @param traverser - Iterator positioned at the entry to read and convert
- * @param dataSize - Output parameter receiving the final escaped string length in bytes, or 0 on failure
- * 
- * @return char* - Heap allocated UTF-8 string with escaped quotes and backslashes. Caller must free. NULL on failure
- */
-char *id3v2ReadFrameEntryAsChar(ListIter *traverser, size_t *dataSize) {
+// internal function ---
+// converts the entry at the iterator to UTF-8, the text is *dataSize bytes from *start which skips any UTF-8 BOM
+static unsigned char *internal_id3v2ReadFrameEntryAsUtf8(ListIter *traverser, size_t *dataSize, size_t *start) {
     unsigned char *tmp = NULL;
     unsigned char *outString = NULL;
     unsigned char encoding = 0;
-    char *escapedStr = NULL;
     bool convi = false;
-    int utf8BomOffset = 0;
     size_t outLen = 0;
-    size_t j = 0;
 
+    *start = 0;
     tmp = (unsigned char *) id3v2ReadFrameEntry(traverser, dataSize);
 
     // Failed
@@ -701,14 +1271,43 @@ char *id3v2ReadFrameEntryAsChar(ListIter *traverser, size_t *dataSize) {
 
     // check for UTF8 BOM
     if (*dataSize >= 3 && outString[0] == 0xEF && outString[1] == 0xBB && outString[2] == 0xBF) {
-        utf8BomOffset = 3;
+        *start = 3;
+    }
+
+    *dataSize -= *start;
+    return outString;
+}
+
+/**
+ * @brief Reads a frame entry as a UTF-8 encoded string with escaped special characters, advancing the iterator.
+ * @details Retrieves the content entry at the iterator's current position, automatically detects its encoding, 
+ * and converts it to UTF-8. Strips UTF-8 BOM if present and escapes quotes and backslashes for JSON/C std 
+ * compatibility. Advances the iterator to the next entry. Returns NULL and sets dataSize to 0 if the traverser 
+ * is NULL, the current entry is NULL, memory allocation fails, or encoding conversion fails.
+ * 
+ * @param traverser - Iterator positioned at the entry to read and convert
+ * @param dataSize - Output parameter receiving the final escaped string length in bytes, or 0 on failure
+ * 
+ * @return char* - Heap allocated UTF-8 string with escaped quotes and backslashes. Caller must free. NULL on failure
+ */
+char *id3v2ReadFrameEntryAsChar(ListIter *traverser, size_t *dataSize) {
+    unsigned char *outString = NULL;
+    char *escapedStr = NULL;
+    size_t utf8BomOffset = 0;
+    size_t j = 0;
+
+    outString = internal_id3v2ReadFrameEntryAsUtf8(traverser, dataSize, &utf8BomOffset);
+
+    // Failed
+    if (!outString) {
+        return NULL;
     }
 
     // escape quotes and backslashes
-    escapedStr = malloc((2 * (*dataSize - utf8BomOffset)) + 1);
+    escapedStr = malloc((2 * (*dataSize)) + 1);
     j = 0;
 
-    for (size_t i = 0; i < *dataSize - utf8BomOffset; i++) {
+    for (size_t i = 0; i < *dataSize; i++) {
         if (outString[i + utf8BomOffset] == '"' || outString[i + utf8BomOffset] == '\\') {
             escapedStr[j++] = '\\';
             escapedStr[j++] = (char) outString[i + utf8BomOffset];
@@ -853,7 +1452,8 @@ uint32_t id3v2ReadFrameEntryAsU32(ListIter *traverser) {
  * context definition, and replaces the entry's data with a deep copy of the provided data. The written size is 
  * clamped to the context's min/max bounds to maintain frame structure integrity. The iterator position is not 
  * advanced. Returns false if any parameter is NULL, entrySize is 0, the iterator's current position is invalid, 
- * the entry cannot be located, or the corresponding context cannot be found.
+ * the entry cannot be located, or the corresponding context cannot be found. A successful write marks the frame
+ * dirty so it is encoded from its entries the next time it is serialized.
  * 
  * @param frame - Frame containing the entry to modify
  * @param entries - Iterator positioned at the entry to write. Iterator position is not advanced
@@ -932,6 +1532,10 @@ bool id3v2WriteFrameEntry(Id3v2Frame *frame, ListIter *entries, size_t entrySize
     free(((Id3v2ContentEntry *) entries->current->data)->entry);
     ((Id3v2ContentEntry *) entries->current->data)->entry = newData;
     ((Id3v2ContentEntry *) entries->current->data)->size = newSize;
+    ((Id3v2ContentEntry *) entries->current->data)->offset = 0;
+    id3v2ReleaseSource(&((Id3v2ContentEntry *) entries->current->data)->source);
+
+    id3v2MarkFrameDirty(frame);
 
     return true;
 }
@@ -983,6 +1587,352 @@ Id3v2Frame *id3v2DetachFrameFromTag(Id3v2Tag *tag, Id3v2Frame *frame) {
     return listDeleteData(tag->frames, (void *) frame);
 }
 
+/**
+ * @brief Stores the serialized bytes of a frame so unchanged frames can be written without encoding them again.
+ * @details Keeps a copy of bytes along with the version they were encoded for and the current header. The parser
+ * caches the bytes of every frame it reads, which makes unmodified frames, including ones with unknown or
+ * compressed content, round-trip byte for byte. When bytes end with the data of the frame's last entry and it is at
+ * least ID3V2_FRAME_CACHE_SHARE_SIZE bytes, that data is not copied and is read from the entry instead, so pictures
+ * and objects are only held once. Any previously cached bytes are replaced. Returns false if frame or bytes is NULL,
+ * size is 0, or memory allocation fails, leaving the frame dirty.
+ * 
+ * @param frame - Frame the bytes belong to
+ * @param version - ID3v2 version the bytes were encoded for
+ * @param bytes - Complete frame, header included, as id3v2FrameSerialize would return it
+ * @param size - Number of bytes in bytes
+ * 
+ * @return bool - true if the bytes were cached, false otherwise
+ */
+bool id3v2CacheFrameBytes(Id3v2Frame *frame, uint8_t version, const uint8_t *bytes, size_t size) {
+    if (frame == NULL) {
+        return false;
+    }
+
+    id3v2MarkFrameDirty(frame);
+
+    if (bytes == NULL || size == 0 || frame->header == NULL) {
+        return false;
+    }
+
+    Id3v2ContentEntry *last = internal_id3v2LastEntry(frame);
+    size_t shared = 0;
+
+    if (last != NULL && last->entry != NULL && last->size >= ID3V2_FRAME_CACHE_SHARE_SIZE && last->size < size &&
+        memcmp(bytes + size - last->size, last->entry, last->size) == 0) {
+        shared = last->size;
+    }
+
+    frame->raw = malloc(size - shared);
+
+    if (frame->raw == NULL) {
+        return false;
+    }
+
+    memcpy(frame->raw, bytes, size - shared);
+    frame->rawSize = size - shared;
+    frame->rawShared = shared;
+    frame->rawVersion = version;
+    frame->rawHeader = *frame->header;
+
+    return true;
+}
+
+/**
+ * @brief Marks a frame as modified so it is encoded from its entries the next time it is serialized.
+ * @details Frees any cached serialized bytes. id3v2WriteFrameEntry calls this on its own, it only needs to be
+ * called after changing the entries or contexts lists of a frame directly. Changes made directly to the header
+ * are noticed without it. Safe to call with NULL.
+ * 
+ * @param frame - Frame to mark as modified
+ */
+void id3v2MarkFrameDirty(Id3v2Frame *frame) {
+    if (frame == NULL) {
+        return;
+    }
+
+    free(frame->raw);
+    frame->raw = NULL;
+    frame->rawSize = 0;
+    frame->rawShared = 0;
+    frame->rawVersion = 0;
+    frame->rawOffset = 0;
+}
+
+/**
+ * @brief Checks whether a frame has to be encoded from its entries to be serialized for a version.
+ * @details A frame is clean when it holds cached bytes for the same version and its header has not changed since
+ * the bytes were cached.
+ * 
+ * @param frame - Frame to check
+ * @param version - ID3v2 version the frame is about to be serialized for
+ * 
+ * @return bool - true if the frame must be encoded again, false if its cached bytes can be written as is
+ */
+bool id3v2FrameIsDirty(const Id3v2Frame *frame, uint8_t version) {
+    if (frame == NULL || frame->header == NULL || frame->raw == NULL || frame->rawVersion != version) {
+        return true;
+    }
+
+    const Id3v2FrameHeader *h = frame->header;
+    const Id3v2FrameHeader *r = &frame->rawHeader;
+
+    return (memcmp(h->id, r->id, ID3V2_FRAME_ID_MAX_SIZE) != 0 ||
+            h->tagAlterPreservation != r->tagAlterPreservation ||
+            h->fileAlterPreservation != r->fileAlterPreservation ||
+            h->readOnly != r->readOnly ||
+            h->unsynchronisation != r->unsynchronisation ||
+            h->decompressionSize != r->decompressionSize ||
+            h->encryptionSymbol != r->encryptionSymbol ||
+            h->groupSymbol != r->groupSymbol);
+}
+
+/**
+ * @brief Returns the bytes cached on a frame by id3v2CacheFrameBytes.
+ * @details The cached frame is the returned bytes followed by the shared bytes, which are the data of the frame's last
+ * entry when id3v2CacheFrameBytes did not copy them. Nothing is copied, the pointers are valid until the frame is
+ * modified or destroyed.
+ * 
+ * @param frame - Frame to read the cache of
+ * @param size - Output parameter receiving the number of bytes returned
+ * @param shared - Output parameter receiving the bytes following them, NULL when there are none
+ * @param sharedSize - Output parameter receiving the number of shared bytes, 0 when there are none
+ * 
+ * @return const uint8_t* - Cached bytes or NULL if the frame holds none
+ */
+const uint8_t *id3v2FrameCachedBytes(const Id3v2Frame *frame, size_t *size, const uint8_t **shared, size_t *sharedSize) {
+    Id3v2ContentEntry *last = NULL;
+
+    *size = 0;
+    *shared = NULL;
+    *sharedSize = 0;
+
+    if (frame == NULL || frame->raw == NULL) {
+        return NULL;
+    }
+
+    if (frame->rawShared > 0) {
+        last = internal_id3v2LastEntry(frame);
+
+        // the entries were changed without marking the frame dirty
+        if (last == NULL || last->entry == NULL || last->size != frame->rawShared) {
+            return NULL;
+        }
+
+        *shared = last->entry;
+        *sharedSize = last->size;
+    }
+
+    *size = frame->rawSize;
+    return frame->raw;
+}
+
+/**
+ * @brief Locates the last content entry of a frame inside the file mapping it was read from.
+ * @details Binary frames such as APIC and GEOB keep their data in the last entry. When the frame is unchanged since it
+ * was read and its bytes were stored verbatim (not unsynchronised or compressed), that data is also present in the
+ * mapping and a pointer to it is returned instead of a heap copy. The tag is found in the mapping the same way
+ * id3v2ParseTagFromBuffer finds it. Data left in the file by id3v2TagFromFileLazy is found from its offset.
+ * @param frame - Frame read from the tag in mapping.
+ * @param mapping - Mapping of the file the frame was read from, see id3FileMap.
+ * @param dataSize - Output parameter receiving the size of the entry in bytes, set to 0 on failure.
+ * @return const uint8_t* - Pointer into the mapping valid until it is released, NULL if the entry is not in it.
+ */
+const uint8_t *id3v2FrameEntryView(const Id3v2Frame *frame, const Id3FileMapping *mapping, size_t *dataSize) {
+    if (dataSize == NULL) {
+        return NULL;
+    }
+
+    *dataSize = 0;
+
+    if (frame == NULL || frame->entries == NULL || mapping == NULL || mapping->data == NULL) {
+        return NULL;
+    }
+
+    Id3v2ContentEntry *entry = NULL;
+    Id3v2ContentEntry *last = NULL;
+    ListIter entries = listCreateIterator(frame->entries);
+    size_t tagStart = 0;
+    size_t offset = 0;
+    size_t idSize = (frame->rawVersion == ID3V2_TAG_VERSION_2) ? ID3V2_FRAME_ID_MAX_SIZE - 1 : ID3V2_FRAME_ID_MAX_SIZE;
+
+    while ((entry = (Id3v2ContentEntry *) listIteratorNext(&entries)) != NULL) {
+        last = entry;
+    }
+
+    // left in the file by id3v2TagFromFileLazy, its offset is already known
+    if (last != NULL && last->source != NULL) {
+        if (last->offset > mapping->length || mapping->length - last->offset < last->size) {
+            return NULL;
+        }
+
+        *dataSize = last->size;
+        return mapping->data + last->offset;
+    }
+
+    if (last == NULL || last->size == 0 ||
+        !internal_id3v2LocateBinary(frame, frame->rawVersion, last->entry, last->size, &offset)) {
+        return NULL;
+    }
+
+    while (true) {
+        if (mapping->length - tagStart < ID3V2_TAG_ID_SIZE) {
+            return NULL;
+        }
+
+        if (memcmp(mapping->data + tagStart, "ID3", ID3V2_TAG_ID_SIZE) == 0) {
+            break;
+        }
+
+        tagStart += ID3V2_TAG_ID_SIZE;
+    }
+
+    // the frame must still start where it was read from, otherwise the mapping is of another file
+    if (frame->rawOffset > mapping->length - tagStart ||
+        mapping->length - tagStart - frame->rawOffset < frame->rawSize + frame->rawShared ||
+        memcmp(mapping->data + tagStart + frame->rawOffset, frame->raw, idSize) != 0) {
+        return NULL;
+    }
+
+    *dataSize = last->size;
+    return mapping->data + tagStart + offset;
+}
+
+/**
+ * @brief Reports whether frames can be compressed and decompressed.
+ * @details Compression support is optional and enabled by building with the BUILD_ID3_ZLIB CMake option.
+ * 
+ * @return bool - true if the library was built with zlib, false otherwise
+ */
+bool id3v2CompressionSupported(void) {
+#ifdef ID3_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+// internal function ---
+// inflates a compressed frame once, the caller holds the inflate lock
+static bool internal_id3v2InflateFrame(Id3v2Frame *frame) {
+    if (frame->compressedContext == NULL) {
+        return (frame->header->decompressionSize == 0);
+    }
+
+    bool ret = false;
+
+#ifdef ID3_HAVE_ZLIB
+    Id3v2ContentEntry *ce = (frame->entries != NULL && frame->entries->head != NULL)
+                                ? (Id3v2ContentEntry *) frame->entries->head->data
+                                : NULL;
+    Id3v2FrameHeader plain;
+    Id3v2Frame *parsed = NULL;
+    uint8_t *buffer = NULL;
+    uint8_t *header = NULL;
+    size_t headerSize = 0;
+    uLongf contentl = frame->header->decompressionSize;
+
+    // a plain version 3 frame holding the inflated content, its layout is the same in every version
+    memset(&plain, 0, sizeof(Id3v2FrameHeader));
+    memcpy(plain.id, frame->header->id, ID3V2_FRAME_ID_MAX_SIZE);
+    header = id3v2FrameHeaderSerialize(&plain, ID3V2_TAG_VERSION_3, (uint32_t) contentl, &headerSize);
+
+    // a size no tag can hold or zlib cannot reach from the compressed content is not allocated
+    if (ce != NULL && ce->entry != NULL && header != NULL && frame->header->encryptionSymbol == 0 && contentl > 0 &&
+        contentl <= ID3V2_MAX_TAG_SIZE && (uint64_t) contentl <= (uint64_t) ce->size * ID3V2_FRAME_MAX_INFLATE_RATIO) {
+        buffer = malloc(headerSize + contentl);
+    }
+
+    if (buffer != NULL) {
+        memcpy(buffer, header, headerSize);
+
+        if (uncompress(buffer + headerSize, &contentl, ce->entry, (uLong) ce->size) == Z_OK &&
+            contentl == frame->header->decompressionSize &&
+            id3v2ParseFrame(buffer, headerSize + contentl, frame->compressedContext, ID3V2_TAG_VERSION_3, &parsed) &&
+            parsed != NULL) {
+            List *tmp = NULL;
+            Id3v2ContentEntry *last = internal_id3v2LastEntry(frame);
+            uint8_t *raw = NULL;
+
+            // cached bytes shared with the compressed entry are copied before it is replaced
+            if (frame->raw != NULL && frame->rawShared > 0) {
+                raw = (last != NULL && last->size == frame->rawShared)
+                          ? realloc(frame->raw, frame->rawSize + frame->rawShared)
+                          : NULL;
+
+                if (raw != NULL) {
+                    memcpy(raw + frame->rawSize, last->entry, frame->rawShared);
+                    frame->raw = raw;
+                    frame->rawSize += frame->rawShared;
+                    frame->rawShared = 0;
+                } else {
+                    id3v2MarkFrameDirty(frame);
+                }
+            }
+
+            tmp = frame->contexts;
+            frame->contexts = parsed->contexts;
+            parsed->contexts = tmp;
+
+            tmp = frame->entries;
+            frame->entries = parsed->entries;
+            parsed->entries = tmp;
+
+            // the cached bytes still describe this frame
+            if (frame->raw != NULL && frame->rawHeader.decompressionSize == frame->header->decompressionSize) {
+                frame->rawHeader.decompressionSize = 0;
+            }
+
+            frame->header->decompressionSize = 0;
+            ret = true;
+        }
+
+        id3v2DestroyFrame(&parsed);
+        free(buffer);
+    }
+
+    free(header);
+#endif
+
+    listFree(frame->compressedContext);
+    frame->compressedContext = NULL;
+
+    return ret;
+}
+
+/**
+ * @brief Decompresses the content of a compressed frame and parses it with the context of its frame ID.
+ * @details The parser keeps compressed ID3v2.3/2.4 frames as a single binary entry and defers decompression
+ * until the frame is first reached through id3v2FrameTraverse, serialized after being modified, or converted to
+ * JSON or CBOR. Inflating happens under a lock, so threads reading the same tag can reach a compressed frame
+ * together and the first one inflates it for all of them. On success the frame's contexts and entries are replaced
+ * with the parsed content and its decompressionSize is cleared. The cached bytes stay valid, so an unchanged frame
+ * is still written back in its compressed form. Decompression is attempted once, a frame that fails to decompress,
+ * claims a size above ID3V2_MAX_TAG_SIZE or ID3V2_FRAME_MAX_INFLATE_RATIO times its compressed size, is encrypted,
+ * or was read without zlib support keeps its binary entry.
+ * 
+ * @param frame - Frame to decompress
+ * 
+ * @return bool - true if the frame holds decompressed content, false if it is still compressed or frame is NULL
+ */
+bool id3v2DecompressFrame(Id3v2Frame *frame) {
+    bool ret = false;
+
+    if (frame == NULL || frame->header == NULL) {
+        return false;
+    }
+
+    // only frames created compressed ever change here
+    if (!frame->compressed) {
+        return (frame->header->decompressionSize == 0);
+    }
+
+    internal_id3v2InflateAcquire();
+    ret = internal_id3v2InflateFrame(frame);
+    internal_id3v2InflateRelease();
+
+    return ret;
+}
+
 
 /**
  * @brief Serializes a frame header to binary format according to the specified ID3v2 version.
@@ -1134,150 +2084,46 @@ uint8_t *id3v2FrameHeaderSerialize(Id3v2FrameHeader *header, uint8_t version, ui
  * @return char* - Heap allocated JSON string. Caller must free. Returns "{}" if header is NULL or version is unsupported
  */
 char *id3v2FrameHeaderToJSON(const Id3v2FrameHeader *header, uint8_t version) {
+    Id3Sink *sink = id3SinkCreateBuffer(ID3V2_JSON_FRAME_CAPACITY);
     char *json = NULL;
-    size_t memCount = 3;
 
-    if (header == NULL) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
+    if (sink == NULL) {
+        return NULL;
     }
 
-    switch (version) {
-        case ID3V2_TAG_VERSION_2:
+    if (internal_id3v2FrameHeaderToJSONSink(header, version, sink)) {
+        json = (char *) id3SinkTakeBuffer(sink, NULL);
+    }
 
-            memCount += snprintf(NULL, 0,
-                                 "{\"id\":\"%c%c%c\"}",
-                                 header->id[0],
-                                 header->id[1],
-                                 header->id[2]);
+    id3SinkDestroy(&sink);
+    return json;
+}
 
-            json = calloc(memCount + 1, sizeof(char));
+// encodes a frame from its contexts and entries
+// internal function ---
+// true if the entry at the iterator is left in a file, failing to read it means the file changed
+static bool internal_id3v2EntryInFile(ListIter trav) {
+    return trav.current != NULL && trav.current->data != NULL &&
+           ((Id3v2ContentEntry *) trav.current->data)->source != NULL;
+}
 
-            (void) snprintf(json, memCount,
-                            "{\"id\":\"%c%c%c\"}",
-                            header->id[0],
-                            header->id[1],
-                            header->id[2]);
+static uint8_t *internal_id3v2FrameEncode(Id3v2Frame *frame, uint8_t version, size_t *outl) {
+    ByteStream *stream = NULL;
+    Id3v2ContentContext *cc = NULL;
 
-            break;
-        case ID3V2_TAG_VERSION_3:
-
-            memCount += snprintf(NULL, 0,
-                                 "{\"id\":\"%c%c%c%c\",\"tagAlterPreservation\":%s,\"fileAlterPreservation\":%s,\"readOnly\":%s,\"decompressionSize\":%"
-                                 PRId32",\"encryptionSymbol\":%d,\"groupSymbol\":%d}",
-                                 header->id[0],
-                                 header->id[1],
-                                 header->id[2],
-                                 header->id[3],
-                                 ((header->tagAlterPreservation == true) ? "true" : "false"),
-                                 ((header->fileAlterPreservation == true) ? "true" : "false"),
-                                 ((header->readOnly == true) ? "true" : "false"),
-                                 header->decompressionSize,
-                                 header->encryptionSymbol,
-                                 header->groupSymbol);
-
-            json = calloc(memCount + 1, sizeof(char));
-
-            (void) snprintf(json, memCount,
-                            "{\"id\":\"%c%c%c%c\",\"tagAlterPreservation\":%s,\"fileAlterPreservation\":%s,\"readOnly\":%s,\"decompressionSize\":%"
-                            PRId32",\"encryptionSymbol\":%d,\"groupSymbol\":%d}",
-                            header->id[0],
-                            header->id[1],
-                            header->id[2],
-                            header->id[3],
-                            ((header->tagAlterPreservation == true) ? "true" : "false"),
-                            ((header->fileAlterPreservation == true) ? "true" : "false"),
-                            ((header->readOnly == true) ? "true" : "false"),
-                            header->decompressionSize,
-                            header->encryptionSymbol,
-                            header->groupSymbol);
-
-            break;
-        case ID3V2_TAG_VERSION_4:
-
-            memCount += snprintf(NULL, 0,
-                                 "{\"id\":\"%c%c%c%c\",\"tagAlterPreservation\":%s,\"fileAlterPreservation\":%s,\"readOnly\":%s,\"unsynchronisation\":%s,\"decompressionSize\":%"
-                                 PRId32",\"encryptionSymbol\":%d,\"groupSymbol\":%d}",
-                                 header->id[0],
-                                 header->id[1],
-                                 header->id[2],
-                                 header->id[3],
-                                 ((header->tagAlterPreservation == true) ? "true" : "false"),
-                                 ((header->fileAlterPreservation == true) ? "true" : "false"),
-                                 ((header->readOnly == true) ? "true" : "false"),
-                                 ((header->unsynchronisation == true) ? "true" : "false"),
-                                 header->decompressionSize,
-                                 header->encryptionSymbol,
-                                 header->groupSymbol);
-
-            json = calloc(memCount + 1, sizeof(char));
-
-            (void) snprintf(json, memCount,
-                            "{\"id\":\"%c%c%c%c\",\"tagAlterPreservation\":%s,\"fileAlterPreservation\":%s,\"readOnly\":%s,\"unsynchronisation\":%s,\"decompressionSize\":%"
-                            PRId32",\"encryptionSymbol\":%d,\"groupSymbol\":%d}",
-                            header->id[0],
-                            header->id[1],
-                            header->id[2],
-                            header->id[3],
-                            ((header->tagAlterPreservation == true) ? "true" : "false"),
-                            ((header->fileAlterPreservation == true) ? "true" : "false"),
-                            ((header->readOnly == true) ? "true" : "false"),
-                            ((header->unsynchronisation == true) ? "true" : "false"),
-                            header->decompressionSize,
-                            header->encryptionSymbol,
-                            header->groupSymbol);
-
-            break;
-
-        // no support
-        default:
-            json = calloc(memCount, sizeof(char));
-            memcpy(json, "{}\0", memCount);
-            break;
-    }
-
-    return json;
-}
-
-/**
- * @brief Serializes a complete ID3v2 frame to binary format according to the specified version.
- * @details Converts a frame structure into its binary representation by serializing the header and 
- * processing each content entry according to its context type. Handles encoding conversions (UTF-8, 
- * UTF-16LE/BE, Latin-1), null terminator insertion, bit-packing, and size adjustments. The serialization 
- * process iterates through frame contexts and applies type-specific transformations: encoded strings are 
- * converted to their target encoding with BOM prepending where required, binary/numeric data is written 
- * directly, bit contexts are packed into compact byte representations, and adjustment contexts modify 
- * data sizes dynamically. Returns NULL and sets outl to 0 if the frame is NULL, version is invalid 
- * (greater than ID3V2_TAG_VERSION_4), or memory allocation fails during processing.
- * 
- * @param frame - Frame structure containing header, contexts, and entries to serialize
- * @param version - ID3v2 version (ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4)
- * @param outl - Output parameter receiving the total serialized frame size in bytes (header + content), or 0 on failure
- * 
- * @return uint8_t* - Heap allocated binary frame data ready for writing to file. Caller must free. NULL on failure
- */
-uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl) {
-    ByteStream *stream = NULL;
-    Id3v2ContentContext *cc = NULL;
-
-    if (frame == NULL || version > ID3V2_TAG_VERSION_4) {
-        *outl = 0;
-        return NULL;
-    }
-
-    ListIter context = listCreateIterator(frame->contexts);
-    ListIter trav = id3v2CreateFrameEntryTraverser(frame);
-    ListIter iterStorage;
-    size_t readSize = 0;
-    size_t contentSize = 0;
-    size_t currIterations = 0;
-    size_t headerSize = 0;
-    uint8_t *header = NULL;
-    uint8_t *out = NULL;
-    unsigned char *tmp = NULL;
-    bool exit = false;
-    bool bitFlag = false;
+    ListIter context = listCreateIterator(frame->contexts);
+    ListIter trav = id3v2CreateFrameEntryTraverser(frame);
+    ListIter iterStorage;
+    size_t readSize = 0;
+    size_t contentSize = 0;
+    size_t currIterations = 0;
+    size_t headerSize = 0;
+    uint8_t *header = NULL;
+    uint8_t *out = NULL;
+    unsigned char *tmp = NULL;
+    bool exit = false;
+    bool failed = false;
+    bool bitFlag = false;
 
     // the frame size will be updated later as it cannot be calculated
     // before processing frame entries
@@ -1412,13 +2258,17 @@ uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl) {
             case noEncoding_context:
             case binary_context:
             case precision_context:
+                failed = internal_id3v2EntryInFile(trav);
                 tmp = id3v2ReadFrameEntry(&trav, &readSize);
 
+                // content that can no longer be read must not be written as if the frame ended here
                 if (tmp == NULL) {
                     exit = true;
                     break;
                 }
 
+                failed = false;
+
                 byteStreamResize(stream, stream->bufferSize + readSize);
                 byteStreamWrite(stream, tmp, readSize);
                 free(tmp);
@@ -1798,6 +2648,12 @@ uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl) {
             break;
     }
 
+    if (failed) {
+        byteStreamDestroy(stream);
+        *outl = 0;
+        return NULL;
+    }
+
     byteStreamRewind(stream);
     *outl = stream->bufferSize;
     out = calloc(stream->bufferSize, sizeof(uint8_t));
@@ -1807,6 +2663,150 @@ uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl) {
     return out;
 }
 
+// internal function ---
+// checks for entries left in a file by id3v2TagFromFileLazy
+static bool internal_id3v2FrameRefersToFile(const Id3v2Frame *frame) {
+    Id3v2ContentEntry *entry = NULL;
+    ListIter entries = listCreateIterator(frame->entries);
+
+    while ((entry = (Id3v2ContentEntry *) listIteratorNext(&entries)) != NULL) {
+        if (entry->source != NULL) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Serializes a complete ID3v2 frame to binary format according to the specified version.
+ * @details Converts a frame structure into its binary representation by serializing the header and 
+ * processing each content entry according to its context type. Handles encoding conversions (UTF-8, 
+ * UTF-16LE/BE, Latin-1), null terminator insertion, bit-packing, and size adjustments. The serialization 
+ * process iterates through frame contexts and applies type-specific transformations: encoded strings are 
+ * converted to their target encoding with BOM prepending where required, binary/numeric data is written 
+ * directly, bit contexts are packed into compact byte representations, and adjustment contexts modify 
+ * data sizes dynamically. Returns NULL and sets outl to 0 if the frame is NULL, version is invalid 
+ * (greater than ID3V2_TAG_VERSION_4), or memory allocation fails during processing. ID3v2.4 frames with the
+ * unsynchronisation flag set have their content unsynchronised and their size updated to match. Frames that are not
+ * dirty (see id3v2FrameIsDirty) are returned as a copy of their cached bytes, and the bytes of freshly encoded
+ * frames are cached for the next call. Equivalent to id3v2FrameSerializeWithOptions without unsynchronisation or
+ * compression.
+ * 
+ * @param frame - Frame structure containing header, contexts, and entries to serialize
+ * @param version - ID3v2 version (ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4)
+ * @param outl - Output parameter receiving the total serialized frame size in bytes (header + content), or 0 on failure
+ * 
+ * @return uint8_t* - Heap allocated binary frame data ready for writing to file. Caller must free. NULL on failure
+ */
+uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl) {
+    return id3v2FrameSerializeWithOptions(frame, version, false, 0, outl);
+}
+
+/**
+ * @brief Serializes an ID3v2 frame, optionally unsynchronising and compressing it.
+ * @details Behaves like id3v2FrameSerialize with two additions. When unsync is true an ID3v2.4 frame is unsynchronised
+ * and flagged as such even if its own header does not ask for it, as required for every frame of a tag with the
+ * unsynchronisation flag set. When compressionThreshold is above 0 a modified ID3v2.3/2.4 frame whose content is
+ * longer than the threshold is compressed with zlib, provided the library was built with BUILD_ID3_ZLIB, the frame
+ * is not encrypted, and compression makes it smaller. Unchanged frames are written as they were read.
+ * @param frame - Frame structure to serialize
+ * @param version - ID3v2 version (ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4)
+ * @param unsync - Apply frame level unsynchronisation to ID3v2.4 frames regardless of their header
+ * @param compressionThreshold - Content size in bytes above which modified frames are compressed, 0 to never compress
+ * @param outl - Output parameter receiving the total serialized frame size in bytes, or 0 on failure
+ * @return uint8_t* - Heap allocated binary frame data. Caller must free. NULL on failure
+ */
+uint8_t *id3v2FrameSerializeWithOptions(Id3v2Frame *frame, uint8_t version, bool unsync, size_t compressionThreshold,
+                                        size_t *outl) {
+    uint8_t *out = NULL;
+    const uint8_t *raw = NULL;
+    const uint8_t *shared = NULL;
+    size_t rawSize = 0;
+    size_t sharedSize = 0;
+
+    if (frame == NULL || frame->header == NULL || version > ID3V2_TAG_VERSION_4) {
+        *outl = 0;
+        return NULL;
+    }
+
+    // unchanged frames are written as they were read
+    if (!id3v2FrameIsDirty(frame, version) &&
+        (raw = id3v2FrameCachedBytes(frame, &rawSize, &shared, &sharedSize)) != NULL) {
+        out = malloc(rawSize + sharedSize);
+
+        if (out != NULL) {
+            memcpy(out, raw, rawSize);
+
+            if (sharedSize > 0) {
+                memcpy(out + rawSize, shared, sharedSize);
+            }
+
+            *outl = rawSize + sharedSize;
+        }
+    }
+
+    if (out == NULL) {
+        // compressed content must be inflated before it can be encoded again
+        (void) id3v2DecompressFrame(frame);
+
+        out = internal_id3v2FrameEncode(frame, version, outl);
+
+        if (out != NULL && compressionThreshold > 0) {
+            out = internal_id3v2FrameCompress(frame, version, compressionThreshold, out, *outl, outl);
+        }
+
+        if (out != NULL && version == ID3V2_TAG_VERSION_4 && frame->header->unsynchronisation) {
+            out = internal_id3v2FrameUnsynchronise(out, *outl, outl);
+        }
+
+        // caching would hold the content left in the file after all
+        if (!internal_id3v2FrameRefersToFile(frame)) {
+            (void) id3v2CacheFrameBytes(frame, version, out, *outl);
+        }
+    }
+
+    // the tag header asks for every frame to be unsynchronised
+    if (out != NULL && unsync && version == ID3V2_TAG_VERSION_4 && !frame->header->unsynchronisation) {
+        out = internal_id3v2FrameUnsynchronise(out, *outl, outl);
+    }
+
+    return out;
+}
+
+/**
+ * @brief Serializes an ID3v2 frame into a sink.
+ * @details Writes the same bytes id3v2FrameSerialize returns. Unchanged frames are written straight from the bytes they
+ * were read as without copying them first.
+ * @param frame - Frame to serialize.
+ * @param version - ID3v2 major version to serialize for.
+ * @param sink - Sink receiving the serialized frame.
+ * @return int - 1 (true) if the frame was written, 0 (false) on failure.
+ */
+int id3v2FrameSerializeToSink(Id3v2Frame *frame, uint8_t version, Id3Sink *sink) {
+    size_t outl = 0;
+    uint8_t *out = NULL;
+    const uint8_t *raw = NULL;
+    const uint8_t *shared = NULL;
+    size_t sharedSize = 0;
+    int ret = false;
+
+    if (frame != NULL && frame->header != NULL && version <= ID3V2_TAG_VERSION_4 &&
+        !id3v2FrameIsDirty(frame, version) &&
+        (raw = id3v2FrameCachedBytes(frame, &outl, &shared, &sharedSize)) != NULL) {
+        return id3SinkWrite(sink, raw, outl) && id3SinkWrite(sink, shared, sharedSize);
+    }
+
+    out = id3v2FrameSerialize(frame, version, &outl);
+
+    if (out != NULL) {
+        ret = id3SinkWrite(sink, out, outl);
+        free(out);
+    }
+
+    return ret;
+}
+
 /**
  * @brief Converts a complete ID3v2 frame structure to its JSON representation.
  * @details Serializes frame metadata and content entries into a JSON object with header information 
@@ -1841,30 +2841,77 @@ uint8_t *id3v2FrameSerialize(Id3v2Frame *frame, uint8_t version, size_t *outl) {
  * @return char* - Heap allocated JSON string. Caller must free. Returns "{}" if frame is NULL or version is invalid
  */
 char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
+    Id3Sink *sink = id3SinkCreateBuffer(ID3V2_JSON_FRAME_CAPACITY);
     char *json = NULL;
-    char *headerJson = NULL;
-    char **contentJson = NULL;
-    char *concatenatedString = NULL;
-    size_t contentJsonSize = 0;
-    size_t memCount = 3;
-    size_t concatenatedStringLength = 0;
-    size_t currIterations = 0;
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3v2FrameToJSONSink(frame, version, sink)) {
+        json = (char *) id3SinkTakeBuffer(sink, NULL);
+    }
+
+    id3SinkDestroy(&sink);
+    return json;
+}
+
+/**
+ * @brief Writes the JSON representation of an ID3v2 frame into a sink.
+ * @details Writes the same text id3v2FrameToJSON returns, without a null terminator. The header and every content
+ * entry are appended to the sink as they are read, binary content is base64 encoded in blocks, so no intermediate
+ * strings are built. Writes "{}" if the frame is NULL or the version is invalid.
+ * @param frame - Frame to convert.
+ * @param version - ID3v2 major version of the frame.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 (true) if the JSON was written, 0 (false) on failure.
+ */
+int id3v2FrameToJSONSink(Id3v2Frame *frame, uint8_t version, Id3Sink *sink) {
+    return id3v2FrameToJSONSinkWithOptions(frame, version, NULL, sink);
+}
+
+/**
+ * @brief Writes the JSON representation of an ID3v2 frame into a sink, choosing how binary content is represented.
+ * @details Text and numeric entries are written as id3v2FrameToJSONSink writes them. Binary entries follow the policy
+ * in options: embed_binary writes {"value":"<base64>","size":n}, truncate_binary encodes at most binaryLimit bytes
+ * and adds "truncated":true when content was cut short, digest_binary writes {"size":n,"sha1":"<hex>"} and
+ * reference_binary writes {"offset":o,"size":n}. The offset counts from the first byte of the tag the frame was read
+ * from and is null when the frame was modified since, came from an unsynchronised tag, or does not store the content
+ * verbatim at its end.
+ * @param frame - Frame to convert.
+ * @param version - ID3v2 major version of the frame.
+ * @param options - Binary content policy, NULL behaves like embed_binary.
+ * @param sink - Sink receiving the JSON.
+ * @return int - 1 (true) if the JSON was written, 0 (false) on failure.
+ */
+int id3v2FrameToJSONSinkWithOptions(Id3v2Frame *frame, uint8_t version, const Id3v2JSONOptions *options,
+                                    Id3Sink *sink) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    if (frame == NULL || version > ID3V2_TAG_VERSION_4) {
+        return id3SinkWriteString(sink, "{}");
+    }
+
+    // compressed content is shown once inflated
+    (void) id3v2DecompressFrame(frame);
 
     ListIter trav = id3v2CreateFrameEntryTraverser(frame);
     ListIter context = listCreateIterator(frame->contexts);
     ListIter iterStorage;
 
-
     Id3v2ContentContext *cc = NULL;
+    size_t currIterations = 0;
+    bool first = true;
     bool exit = false;
+    bool failed = false;
 
     unsigned char *tmp = NULL;
 
-    if (frame == NULL || version > ID3V2_TAG_VERSION_4) {
-        json = calloc(memCount, sizeof(char));
-        memcpy(json, "{}\0", memCount);
-        return json;
-    }
+    (void) id3SinkWriteString(sink, "{\"header\":");
+    (void) internal_id3v2FrameHeaderToJSONSink(frame->header, version, sink);
+    (void) id3SinkWriteString(sink, ",\"content\":[");
 
     while ((cc = (Id3v2ContentContext *) listIteratorNext(&context)) != NULL) {
         switch (cc->type) {
@@ -1872,110 +2919,41 @@ char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
             case noEncoding_context:
             case bit_context:
             case binary_context: {
-                size_t readSize = 0;
-                size_t contentMemCount = 3;
-                char *b64 = NULL;
-
-                tmp = id3v2ReadFrameEntry(&trav, &readSize);
+                // read in place, binary content can be large
+                Id3v2ContentEntry *ce = (Id3v2ContentEntry *) listIteratorNext(&trav);
+                bool held = false;
+                const uint8_t *bytes = NULL;
 
-                if (tmp == NULL || readSize == 0) {
+                if (ce == NULL || ce->size == 0 || (bytes = internal_id3v2EntryBytes(ce, &held)) == NULL) {
+                    failed = (ce != NULL && ce->source != NULL);
                     exit = true;
                     break;
                 }
 
+                internal_id3v2JSONBinary(sink, &first, frame, version, bytes, ce->size, options);
 
-                b64 = internal_base64Encode(tmp, readSize);
-
-                contentMemCount += snprintf(NULL, 0,
-                                            "{\"value\":\"%s\",\"size\":%zu}",
-                                            b64,
-                                            strlen(b64));
-
-                contentJsonSize++;
-                if (contentJson == NULL) {
-                    contentJson = (char **) calloc(contentJsonSize, sizeof(char *));
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%s\",\"size\":%zu}",
-                                    b64,
-                                    readSize);
-                } else {
-                    char **reallocContentJson = (char **) realloc((void *) contentJson,
-                                                                  (contentJsonSize) * sizeof(char *));
-
-                    if (reallocContentJson == NULL) {
-                        for (size_t i = 0; i < contentJsonSize - 1; i++) {
-                            free(contentJson[i]);
-                        }
-                        free((void *) contentJson);
-                        free(b64);
-                        free(tmp);
-                        return NULL;
-                    }
-
-                    contentJson = reallocContentJson;
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%s\",\"size\":%zu}",
-                                    b64,
-                                    readSize);
+                if (held) {
+                    free((uint8_t *) bytes);
                 }
-
-                free(tmp);
-                free(b64);
             }
             break;
 
-
             // will always be treated as utf8 when in json
             case encodedString_context:
             case latin1Encoding_context: {
                 size_t readSize = 0;
-                size_t contentMemCount = 3;
 
                 tmp = (unsigned char *) id3v2ReadFrameEntryAsChar(&trav, &readSize);
 
                 if (tmp == NULL || readSize == 0) {
+                    free(tmp);
                     exit = true;
                     break;
                 }
 
-
-                contentMemCount += snprintf(NULL, 0,
-                                            "{\"value\":\"%s\",\"size\":%zu}",
-                                            (char *) tmp,
-                                            readSize);
-
-                contentJsonSize++;
-                if (contentJson == NULL) {
-                    contentJson = (char **) calloc(contentJsonSize, sizeof(char *));
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%s\",\"size\":%zu}",
-                                    (char *) tmp,
-                                    readSize);
-                } else {
-                    char **reallocContentJson = (char **) realloc((void *) contentJson,
-                                                                  (contentJsonSize) * sizeof(char *));
-
-                    if (reallocContentJson == NULL) {
-                        for (size_t i = 0; i < contentJsonSize - 1; i++) {
-                            free(contentJson[i]);
-                        }
-                        free((void *) contentJson);
-                        free(tmp);
-                        return NULL;
-                    }
-
-                    contentJson = reallocContentJson;
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%s\",\"size\":%zu}",
-                                    (char *) tmp,
-                                    readSize);
-                }
+                internal_id3v2JSONValueStart(sink, &first);
+                (void) id3SinkWriteString(sink, (char *) tmp);
+                internal_id3v2JSONValueEnd(sink, readSize);
 
                 free(tmp);
             }
@@ -1983,12 +2961,12 @@ char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
 
             case numeric_context: {
                 size_t readSize = 0;
-                size_t contentMemCount = 3;
                 size_t num = 0;
 
                 tmp = id3v2ReadFrameEntry(&trav, &readSize);
 
                 if (tmp == NULL || readSize == 0) {
+                    free(tmp);
                     exit = true;
                     break;
                 }
@@ -1996,90 +2974,30 @@ char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
                 num = btost(tmp, (int) readSize);
                 free(tmp);
 
-                contentMemCount += snprintf(NULL, 0,
-                                            "{\"value\":\"%zu\",\"size\":%zu}",
-                                            num,
-                                            readSize);
-
-                contentJsonSize++;
-                if (contentJson == NULL) {
-                    contentJson = (char **) calloc(contentJsonSize, sizeof(char *));
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%zu\",\"size\":%zu}",
-                                    num,
-                                    readSize);
-                } else {
-                    char **reallocContentJson = (char **) realloc((void *) contentJson,
-                                                                  (contentJsonSize) * sizeof(char *));
-
-                    if (reallocContentJson == NULL) {
-                        for (size_t i = 0; i < contentJsonSize - 1; i++) {
-                            free(contentJson[i]);
-                        }
-                        free((void *) contentJson);
-                        return NULL;
-                    }
-
-                    contentJson = reallocContentJson;
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%zu\",\"size\":%zu}",
-                                    num,
-                                    readSize);
-                }
+                internal_id3v2JSONValueStart(sink, &first);
+                (void) id3SinkPrintf(sink, "%zu", num);
+                internal_id3v2JSONValueEnd(sink, readSize);
             }
             break;
 
             case precision_context: {
                 size_t readSize = 0;
-                size_t contentMemCount = 0;
                 float value = 0;
 
                 tmp = id3v2ReadFrameEntry(&trav, &readSize);
 
                 if (tmp == NULL || readSize == 0) {
+                    free(tmp);
                     exit = true;
                     break;
                 }
 
-
                 memcpy(&value, tmp, sizeof(value));
                 free(tmp);
 
-                contentMemCount = snprintf(NULL, 0,
-                                           "{\"value\":\"%f\",\"size\":%zu}",
-                                           value,
-                                           readSize);
-
-                contentJsonSize++;
-                if (contentJson == NULL) {
-                    contentJson = (char **) calloc(contentJsonSize, sizeof(char *));
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%f\",\"size\":%zu}",
-                                    value,
-                                    readSize);
-                } else {
-                    char **reallocContentJson = (char **) realloc((void *) contentJson,
-                                                                  (contentJsonSize) * sizeof(char *));
-
-                    if (reallocContentJson == NULL) {
-                        for (size_t i = 0; i < contentJsonSize - 1; i++) {
-                            free(contentJson[i]);
-                        }
-                        free((void *) contentJson);
-                        return NULL;
-                    }
-                    contentJson = reallocContentJson;
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%f\",\"size\":%zu}",
-                                    value,
-                                    readSize);
-                }
+                internal_id3v2JSONValueStart(sink, &first);
+                (void) id3SinkPrintf(sink, "%f", value);
+                internal_id3v2JSONValueEnd(sink, readSize);
             }
             break;
 
@@ -2131,9 +3049,7 @@ char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
                 size_t poscc = 0;
                 size_t posce = 0;
                 size_t readSize = 0;
-                size_t contentMemCount = 0;
                 void *iterNext = NULL;
-                char *b64 = NULL;
 
 
                 // hunt down "adjustment" key
@@ -2164,50 +3080,13 @@ char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
                 tmp = id3v2ReadFrameEntry(&trav, &readSize);
 
                 if (tmp == NULL || readSize == 0) {
+                    free(tmp);
                     exit = true;
                     break;
                 }
 
-
-                b64 = internal_base64Encode(tmp, readSize);
+                internal_id3v2JSONBinary(sink, &first, frame, version, tmp, readSize, options);
                 free(tmp);
-
-
-                contentMemCount = snprintf(NULL, 0,
-                                           "{\"value\":\"%s\",\"size\":%zu}",
-                                           b64,
-                                           strlen(b64));
-
-                contentJsonSize++;
-                if (contentJson == NULL) {
-                    contentJson = (char **) calloc(contentJsonSize, sizeof(char *));
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%s\",\"size\":%zu}",
-                                    b64,
-                                    readSize);
-                } else {
-                    char **reallocContentJson = (char **) realloc((void *) contentJson,
-                                                                  (contentJsonSize) * sizeof(char *));
-
-                    if (reallocContentJson == NULL) {
-                        for (size_t i = 0; i < contentJsonSize - 1; i++) {
-                            free(contentJson[i]);
-                        }
-                        free((void *) contentJson);
-                        free(b64);
-                        return NULL;
-                    }
-                    contentJson = reallocContentJson;
-                    contentJson[contentJsonSize - 1] = calloc(contentMemCount + 1, sizeof(char));
-                    (void) snprintf(contentJson[contentJsonSize - 1], contentMemCount,
-                                    "{\"value\":\"%s\",\"size\":%zu}",
-                                    b64,
-                                    readSize);
-                }
-
-                free(b64);
             }
             break;
 
@@ -2222,53 +3101,1099 @@ char *id3v2FrameToJSON(Id3v2Frame *frame, uint8_t version) {
         }
     }
 
-    headerJson = id3v2FrameHeaderToJSON(frame->header, version);
+    // a frame missing content left in a file that changed is not written as complete
+    return id3SinkWriteString(sink, "]}") && !failed;
+}
+
+// internal function ------------------------------------------------------------------------
+static Id3v2ContentEntry *internal_id3v2TextEntry(const char *text, size_t length, uint8_t encoding,
+                                                  const Id3v2ContentContext *cc) {
+    Id3v2ContentEntry *ce = NULL;
+    unsigned char *data = NULL;
+    size_t dataSize = 0;
+    bool convi = false;
+
+    // empty strings are stored as a terminator, like the parser does
+    if (length == 0) {
+        dataSize = (encoding == BYTE_UTF16BE || encoding == BYTE_UTF16LE) ? 2 : 1;
+        data = calloc(dataSize + BYTE_PADDING, 1);
+    } else {
+        convi = byteConvertTextFormat((unsigned char *) text, BYTE_UTF8, length, &data, encoding, &dataSize);
 
-    // concatenate all JSON data stored in contentJson into a single string split by ","
-    if (contentJson != NULL) {
-        for (size_t i = 0; i < contentJsonSize; i++) {
-            concatenatedStringLength += strlen(contentJson[i]) + 1;
+        if (!convi && dataSize == 0 && data == NULL) {
+            return NULL;
         }
 
-        concatenatedString = calloc(concatenatedStringLength + 1, sizeof(char));
+        // data is already in the right encoding
+        if (convi && dataSize == 0) {
+            free(data);
+            data = malloc(length + BYTE_PADDING);
 
-        size_t offset = 0;
-        for (size_t i = 0; i < contentJsonSize; i++) {
-            if (i > 0) {
-                concatenatedString[offset++] = ',';
+            if (data != NULL) {
+                memcpy(data, text, length);
             }
 
-            size_t currentLen = strlen(contentJson[i]);
-            memcpy(concatenatedString + offset, contentJson[i], currentLen);
-            offset += currentLen;
+            dataSize = length;
+        }
+
+        if (data != NULL) {
+            (void) bytePrependBOM(encoding, &data, &dataSize);
         }
-        concatenatedString[offset] = '\0';
     }
 
-    memCount += snprintf(NULL, 0,
-                         "{\"header\":%s,\"content\":[%s]}",
-                         headerJson,
-                         concatenatedString);
+    if (data == NULL) {
+        return NULL;
+    }
+
+    // terminate so the length can be measured in the target encoding
+    unsigned char *reallocPtr = realloc(data, dataSize + BYTE_PADDING);
 
-    json = calloc(memCount + 1, sizeof(char));
-    (void) snprintf(json, memCount,
-                    "{\"header\":%s,\"content\":[%s]}",
-                    headerJson,
-                    concatenatedString);
+    if (reallocPtr == NULL) {
+        free(data);
+        return NULL;
+    }
 
+    data = reallocPtr;
+    memset(data + dataSize, 0, BYTE_PADDING);
 
-    free(headerJson);
+    if (length > 0) {
+        dataSize = byteStrlen(encoding, data);
+    }
 
-    if (concatenatedString != NULL) {
-        free(concatenatedString);
+    if (dataSize > cc->max) {
+        dataSize = cc->max;
     }
 
-    if (contentJson != NULL) {
-        for (size_t i = 0; i < contentJsonSize; i++) {
-            free(contentJson[i]);
+    if (dataSize < cc->min) {
+        reallocPtr = realloc(data, cc->min);
+
+        if (reallocPtr == NULL) {
+            free(data);
+            return NULL;
         }
-        free((void *) contentJson);
+
+        data = reallocPtr;
+        memset(data + dataSize, 0, cc->min - dataSize);
+        dataSize = cc->min;
     }
 
-    return json;
+    ce = id3v2CreateContentEntry(data, dataSize);
+    free(data);
+
+    return ce;
+}
+
+// numbers are stored in the entry size the export recorded
+static Id3v2ContentEntry *internal_id3v2SizedEntry(const Id3v2ContentContext *cc, int64_t size,
+                                                   unsigned long long number, float precision) {
+    Id3v2ContentEntry *ce = NULL;
+    uint8_t *data = NULL;
+
+    if (size <= 0 || (size_t) size > cc->max) {
+        return NULL;
+    }
+
+    data = calloc((size_t) size, 1);
+
+    if (data == NULL) {
+        return NULL;
+    }
+
+    if (cc->type == numeric_context) {
+        // big endian, as btost reads it
+        for (int64_t i = size - 1; i >= 0 && number > 0; i--) {
+            data[i] = (uint8_t) (number & 0xFF);
+            number >>= 8;
+        }
+    } else {
+        memcpy(data, &precision, ((size_t) size < sizeof(precision)) ? (size_t) size : sizeof(precision));
+    }
+
+    ce = id3v2CreateContentEntry(data, (size_t) size);
+    free(data);
+
+    return ce;
+}
+
+// reads one {"value":...,"size":...} object into an entry for a context
+static Id3v2ContentEntry *internal_id3v2JSONReadEntry(Id3JsonReader *reader, const Id3v2ContentContext *cc,
+                                                      uint8_t encoding) {
+    Id3v2ContentEntry *ce = NULL;
+    unsigned long long number = 0;
+    float precision = 0;
+    int64_t size = -1;
+    bool haveValue = false;
+    bool truncated = false;
+
+    if (!id3JsonBeginObject(reader)) {
+        return NULL;
+    }
+
+    while (id3JsonNextMember(reader)) {
+        if (strcmp(reader->key, "value") == 0 && !haveValue) {
+            size_t length = 0;
+            const char *text = id3JsonReadString(reader, &length);
+
+            if (text == NULL) {
+                break;
+            }
+
+            haveValue = true;
+
+            switch (cc->type) {
+                // base64, decoded in place
+                case noEncoding_context:
+                case bit_context:
+                case binary_context:
+                case adjustment_context: {
+                    size_t datal = 0;
+
+                    if (id3Base64Decode(text, length, (uint8_t *) reader->value, &datal) && datal > 0) {
+                        ce = id3v2CreateContentEntry(reader->value, datal);
+                    }
+                }
+                break;
+
+                case encodedString_context:
+                    ce = internal_id3v2TextEntry(text, length, encoding, cc);
+                    break;
+
+                case latin1Encoding_context:
+                    ce = internal_id3v2TextEntry(text, length, BYTE_ISO_8859_1, cc);
+                    break;
+
+                // need the size before an entry can be made
+                case numeric_context:
+                    number = strtoull(text, NULL, 10);
+                    break;
+
+                case precision_context:
+                    precision = strtof(text, NULL);
+                    break;
+
+                default:
+                    break;
+            }
+        } else if (strcmp(reader->key, "size") == 0) {
+            (void) id3JsonReadInteger(reader, &size);
+        } else if (strcmp(reader->key, "truncated") == 0) {
+            (void) id3JsonReadBool(reader, &truncated);
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !haveValue || truncated) {
+        if (ce != NULL) {
+            id3v2DeleteContentEntry(ce);
+        }
+
+        return NULL;
+    }
+
+    if (cc->type == numeric_context || cc->type == precision_context) {
+        ce = internal_id3v2SizedEntry(cc, size, number, precision);
+    }
+
+    return ce;
+}
+
+static bool internal_id3v2FrameHeaderFromJSON(Id3JsonReader *reader, uint8_t version, Id3v2FrameHeader **header) {
+    uint8_t id[ID3V2_FRAME_ID_MAX_SIZE] = {0};
+    bool tagAlter = false;
+    bool fileAlter = false;
+    bool readOnly = false;
+    bool unsync = false;
+    int64_t decompressionSize = 0;
+    int64_t encryptionSymbol = 0;
+    int64_t groupSymbol = 0;
+    bool haveId = false;
+
+    if (!id3JsonBeginObject(reader)) {
+        return false;
+    }
+
+    while (id3JsonNextMember(reader)) {
+        if (strcmp(reader->key, "id") == 0) {
+            size_t length = 0;
+            const char *text = id3JsonReadString(reader, &length);
+            const size_t idSize = (version == ID3V2_TAG_VERSION_2) ? ID3V2_FRAME_ID_MAX_SIZE - 1 : ID3V2_FRAME_ID_MAX_SIZE;
+
+            if (text == NULL || length != idSize) {
+                return false;
+            }
+
+            memcpy(id, text, idSize);
+            haveId = true;
+        } else if (strcmp(reader->key, "tagAlterPreservation") == 0) {
+            (void) id3JsonReadBool(reader, &tagAlter);
+        } else if (strcmp(reader->key, "fileAlterPreservation") == 0) {
+            (void) id3JsonReadBool(reader, &fileAlter);
+        } else if (strcmp(reader->key, "readOnly") == 0) {
+            (void) id3JsonReadBool(reader, &readOnly);
+        } else if (strcmp(reader->key, "unsynchronisation") == 0) {
+            (void) id3JsonReadBool(reader, &unsync);
+        } else if (strcmp(reader->key, "decompressionSize") == 0) {
+            (void) id3JsonReadInteger(reader, &decompressionSize);
+        } else if (strcmp(reader->key, "encryptionSymbol") == 0) {
+            (void) id3JsonReadInteger(reader, &encryptionSymbol);
+        } else if (strcmp(reader->key, "groupSymbol") == 0) {
+            (void) id3JsonReadInteger(reader, &groupSymbol);
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !haveId || decompressionSize < 0 || decompressionSize > UINT32_MAX ||
+        encryptionSymbol < 0 || encryptionSymbol > UINT8_MAX || groupSymbol < 0 || groupSymbol > UINT8_MAX) {
+        return false;
+    }
+
+    *header = id3v2CreateFrameHeader(id, tagAlter, fileAlter, readOnly, unsync, (uint32_t) decompressionSize,
+                                     (uint8_t) encryptionSymbol, (uint8_t) groupSymbol);
+
+    return (*header != NULL);
+}
+
+static bool internal_id3v2FrameContentFromJSON(Id3JsonReader *reader, List *contexts, List *entries) {
+    const size_t encodingKey = id3v2djb2("encoding");
+    ListIter context = listCreateIterator(contexts);
+    ListIter iterStorage;
+    Id3v2ContentContext *cc = NULL;
+    size_t currIterations = 0;
+    uint8_t encoding = 0;
+    bool ended = false;
+
+    if (!id3JsonBeginArray(reader)) {
+        return false;
+    }
+
+    // contexts are walked the same way id3v2FrameToJSONSink walks them, one JSON value per entry
+    while ((cc = (Id3v2ContentContext *) listIteratorNext(&context)) != NULL) {
+        Id3v2ContentEntry *ce = NULL;
+
+        if (cc->type == iter_context) {
+            if (currIterations == 0) {
+                iterStorage = context;
+
+                context = listCreateIterator(contexts);
+
+                for (size_t i = 0; i < cc->min; i++) {
+                    listIteratorNext(&context);
+                }
+            }
+
+            if (currIterations != cc->max && currIterations != 0) {
+                context = listCreateIterator(contexts);
+
+                for (size_t i = 0; i < cc->min; i++) {
+                    listIteratorNext(&context);
+                }
+            }
+
+            if (currIterations >= cc->max) {
+                context = iterStorage;
+
+                for (size_t i = 0; i < currIterations; i++) {
+                    listIteratorNext(&context);
+                }
+
+                currIterations = 0;
+            }
+
+            currIterations++;
+            continue;
+        }
+
+        if (cc->type == unknown_context) {
+            break;
+        }
+
+        if (!id3JsonNextElement(reader)) {
+            ended = true;
+            break;
+        }
+
+        ce = internal_id3v2JSONReadEntry(reader, cc, encoding);
+
+        if (ce == NULL) {
+            return false;
+        }
+
+        if (cc->type == numeric_context && cc->key == encodingKey) {
+            encoding = ((uint8_t *) ce->entry)[0];
+        }
+
+        listInsertBack(entries, ce);
+    }
+
+    // values the contexts have no room for
+    while (!ended && id3JsonNextElement(reader)) {
+        (void) id3JsonSkipValue(reader);
+    }
+
+    return !reader->failed;
+}
+
+/**
+ * @brief Builds an ID3v2 frame from its JSON representation.
+ * @details Reads the object id3v2FrameToJSON writes, {"header":{...},"content":[...]}, with the header first. The
+ * frame structure comes from the context the parser would use for its ID, see id3v2FindIdentifierContext, and the
+ * content values are matched to the contexts in the order id3v2FrameToJSON writes them. Text is converted from
+ * UTF-8 to the encoding selected by the frame, base64 is decoded in place inside the reader, and each entry is
+ * allocated once. Frames that are still compressed or encrypted keep their content as a single binary entry like
+ * the parser leaves them. Content written with a binary policy other than embed_binary, or cut short by
+ * truncate_binary, cannot be imported. Returns NULL for an empty object "{}" and on failure, check the failed field
+ * of the reader to tell them apart.
+ * 
+ * @param reader - Reader positioned at the frame object
+ * @param version - ID3v2 major version of the tag the frame belongs to
+ * @param identifierContextPairs - Default pairings, as made by id3v2CreateDefaultIdentifierContextPairings
+ * @param userPairs - User supplied pairings, or NULL
+ * 
+ * @return Id3v2Frame* - Heap allocated frame, or NULL. Caller must free with id3v2DestroyFrame()
+ */
+Id3v2Frame *id3v2FrameFromJSONReader(Id3JsonReader *reader, uint8_t version, HashTable *identifierContextPairs,
+                                     HashTable *userPairs) {
+    Id3v2FrameHeader *header = NULL;
+    List *entries = NULL;
+    List *context = NULL;
+    List *contexts = NULL;
+    Id3v2Frame *frame = NULL;
+    bool haveContent = false;
+
+    if (reader == NULL || identifierContextPairs == NULL || version > ID3V2_TAG_VERSION_4 ||
+        !id3JsonBeginObject(reader)) {
+        return NULL;
+    }
+
+    entries = listCreate(id3v2PrintContentEntry, id3v2DeleteContentEntry, id3v2CompareContentEntry,
+                         id3v2CopyContentEntry);
+
+    while (id3JsonNextMember(reader)) {
+        if (strcmp(reader->key, "header") == 0 && header == NULL) {
+            if (!internal_id3v2FrameHeaderFromJSON(reader, version, &header)) {
+                reader->failed = true;
+                break;
+            }
+        } else if (strcmp(reader->key, "content") == 0 && !haveContent) {
+            char id[ID3V2_FRAME_ID_MAX_SIZE + 1] = {0};
+
+            // the header decides how the content is read
+            if (header == NULL) {
+                reader->failed = true;
+                break;
+            }
+
+            memcpy(id, header->id, ID3V2_FRAME_ID_MAX_SIZE);
+            context = id3v2FindIdentifierContext(identifierContextPairs, userPairs, id);
+
+            if (context == NULL) {
+                reader->failed = true;
+                break;
+            }
+
+            // compressed or encrypted content is kept as is, see id3v2ParseFrame
+            if (header->encryptionSymbol > 0 || header->decompressionSize > 0) {
+                contexts = id3v2CreateGenericFrameContext();
+            } else {
+                contexts = listDeepCopy(context);
+            }
+
+            if (!internal_id3v2FrameContentFromJSON(reader, contexts, entries)) {
+                reader->failed = true;
+                break;
+            }
+
+            haveContent = true;
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || header == NULL || !haveContent) {
+        id3v2DestroyFrameHeader(&header);
+        listFree(entries);
+
+        if (contexts != NULL) {
+            listFree(contexts);
+        }
+
+        return NULL;
+    }
+
+    frame = id3v2CreateFrame(header, contexts, entries);
+
+    if (header->encryptionSymbol == 0 && header->decompressionSize > 0) {
+        frame->compressedContext = listDeepCopy(context);
+        frame->compressed = true;
+    }
+
+    return frame;
+}
+
+/**
+ * @brief Builds an ID3v2 frame from its JSON representation.
+ * @details Convenience wrapper around id3v2FrameFromJSONReader using the default pairings for the version.
+ * 
+ * @param json - Null-terminated JSON text of a single frame
+ * @param version - ID3v2 major version of the tag the frame belongs to
+ * 
+ * @return Id3v2Frame* - Heap allocated frame, or NULL if the JSON is empty, invalid, or not a complete frame.
+ * Caller must free with id3v2DestroyFrame()
+ */
+Id3v2Frame *id3v2FrameFromJSON(const char *json, uint8_t version) {
+    if (json == NULL) {
+        return NULL;
+    }
+
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+    HashTable *pairs = id3v2CreateDefaultIdentifierContextPairings(version);
+    Id3v2Frame *frame = NULL;
+
+    if (reader != NULL && pairs != NULL) {
+        frame = id3v2FrameFromJSONReader(reader, version, pairs, NULL);
+
+        if (frame != NULL && !id3JsonReaderFinished(reader)) {
+            id3v2DestroyFrame(&frame);
+        }
+    }
+
+    if (pairs != NULL) {
+        hashTableFree(pairs);
+    }
+
+    id3JsonReaderDestroy(&reader);
+    return frame;
+}
+
+// internal function ------------------------------------------------------------------------
+static void internal_id3v2CBORValueStart(Id3Sink *sink) {
+    (void) id3CborWriteMap(sink, 2);
+    (void) id3CborWriteString(sink, "value");
+}
+
+static void internal_id3v2CBORValueEnd(Id3Sink *sink, size_t size) {
+    (void) id3CborWriteString(sink, "size");
+    (void) id3CborWriteUnsigned(sink, size);
+}
+
+static bool internal_id3v2FrameHeaderToCBORSink(const Id3v2FrameHeader *header, uint8_t version, Id3Sink *sink) {
+    if (header == NULL || version < ID3V2_TAG_VERSION_2 || version > ID3V2_TAG_VERSION_4) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    if (version == ID3V2_TAG_VERSION_2) {
+        (void) id3CborWriteMap(sink, 1);
+        (void) id3CborWriteString(sink, "id");
+        return id3CborWriteText(sink, (const char *) header->id, ID3V2_FRAME_ID_MAX_SIZE - 1);
+    }
+
+    (void) id3CborWriteMap(sink, (version == ID3V2_TAG_VERSION_4) ? 8 : 7);
+    (void) id3CborWriteString(sink, "id");
+    (void) id3CborWriteText(sink, (const char *) header->id, ID3V2_FRAME_ID_MAX_SIZE);
+    (void) id3CborWriteString(sink, "tagAlterPreservation");
+    (void) id3CborWriteBool(sink, header->tagAlterPreservation);
+    (void) id3CborWriteString(sink, "fileAlterPreservation");
+    (void) id3CborWriteBool(sink, header->fileAlterPreservation);
+    (void) id3CborWriteString(sink, "readOnly");
+    (void) id3CborWriteBool(sink, header->readOnly);
+
+    if (version == ID3V2_TAG_VERSION_4) {
+        (void) id3CborWriteString(sink, "unsynchronisation");
+        (void) id3CborWriteBool(sink, header->unsynchronisation);
+    }
+
+    (void) id3CborWriteString(sink, "decompressionSize");
+    (void) id3CborWriteUnsigned(sink, header->decompressionSize);
+    (void) id3CborWriteString(sink, "encryptionSymbol");
+    (void) id3CborWriteUnsigned(sink, header->encryptionSymbol);
+    (void) id3CborWriteString(sink, "groupSymbol");
+    return id3CborWriteUnsigned(sink, header->groupSymbol);
+}
+
+/**
+ * @brief Converts an ID3v2 frame to CBOR.
+ * @details Convenience wrapper around id3v2FrameToCBORSink collecting the output in a buffer.
+ * 
+ * @param frame - Frame to convert
+ * @param version - ID3v2 major version
+ * @param outl - Receives the number of bytes returned, 0 on failure
+ * 
+ * @return uint8_t* - Heap allocated CBOR, or NULL on failure. Caller must free.
+ */
+uint8_t *id3v2FrameToCBOR(Id3v2Frame *frame, uint8_t version, size_t *outl) {
+    Id3Sink *sink = NULL;
+    uint8_t *out = NULL;
+
+    if (outl == NULL) {
+        return NULL;
+    }
+
+    *outl = 0;
+    sink = id3SinkCreateBuffer(ID3V2_JSON_FRAME_CAPACITY);
+
+    if (sink == NULL) {
+        return NULL;
+    }
+
+    if (id3v2FrameToCBORSink(frame, version, sink)) {
+        out = id3SinkTakeBuffer(sink, outl);
+    }
+
+    id3SinkDestroy(&sink);
+    return out;
+}
+
+/**
+ * @brief Writes the CBOR representation of an ID3v2 frame into a sink.
+ * @details Produces the same structure as id3v2FrameToJSON, a map holding "header" and "content", in CBOR
+ * (RFC 8949). Values keep their natural type instead of being formatted as text: binary content is written as raw
+ * byte strings, numbers as unsigned integers, precision values as single precision floats, and text as UTF-8
+ * without escaping. Entries are written straight from the frame's contexts into an indefinite length array, so
+ * the content is never counted or assembled first. A NULL frame or unsupported version writes an empty map.
+ * 
+ * @param frame - Frame to convert
+ * @param version - ID3v2 major version
+ * @param sink - Sink receiving the CBOR
+ * 
+ * @return int - 1 (true) if the CBOR was written, 0 (false) on failure
+ */
+int id3v2FrameToCBORSink(Id3v2Frame *frame, uint8_t version, Id3Sink *sink) {
+    if (sink == NULL) {
+        return false;
+    }
+
+    if (frame == NULL || version > ID3V2_TAG_VERSION_4) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    // compressed content is shown once inflated
+    (void) id3v2DecompressFrame(frame);
+
+    ListIter trav = id3v2CreateFrameEntryTraverser(frame);
+    ListIter context = listCreateIterator(frame->contexts);
+    ListIter iterStorage;
+
+    Id3v2ContentContext *cc = NULL;
+    size_t currIterations = 0;
+    bool exit = false;
+    bool failed = false;
+
+    unsigned char *tmp = NULL;
+
+    (void) id3CborWriteMap(sink, 2);
+    (void) id3CborWriteString(sink, "header");
+    (void) internal_id3v2FrameHeaderToCBORSink(frame->header, version, sink);
+    (void) id3CborWriteString(sink, "content");
+    (void) id3CborWriteArrayStart(sink);
+
+    while ((cc = (Id3v2ContentContext *) listIteratorNext(&context)) != NULL) {
+        switch (cc->type) {
+            // raw bytes
+            case noEncoding_context:
+            case bit_context:
+            case binary_context: {
+                Id3v2ContentEntry *ce = (Id3v2ContentEntry *) listIteratorNext(&trav);
+                bool held = false;
+                const uint8_t *bytes = NULL;
+
+                if (ce == NULL || ce->size == 0 || (bytes = internal_id3v2EntryBytes(ce, &held)) == NULL) {
+                    failed = (ce != NULL && ce->source != NULL);
+                    exit = true;
+                    break;
+                }
+
+                internal_id3v2CBORValueStart(sink);
+                (void) id3CborWriteBytes(sink, bytes, ce->size);
+                internal_id3v2CBORValueEnd(sink, ce->size);
+
+                if (held) {
+                    free((uint8_t *) bytes);
+                }
+            }
+            break;
+
+            // utf8 like the json, but CBOR strings carry the text as it is so it is not escaped
+            case encodedString_context:
+            case latin1Encoding_context: {
+                size_t readSize = 0;
+                size_t start = 0;
+                const unsigned char *end = NULL;
+
+                tmp = internal_id3v2ReadFrameEntryAsUtf8(&trav, &readSize, &start);
+
+                if (tmp == NULL) {
+                    exit = true;
+                    break;
+                }
+
+                // the text ends at its terminator
+                if ((end = memchr(tmp + start, 0, readSize)) != NULL) {
+                    readSize = (size_t) (end - (tmp + start));
+                }
+
+                internal_id3v2CBORValueStart(sink);
+                (void) id3CborWriteText(sink, (char *) tmp + start, readSize);
+                internal_id3v2CBORValueEnd(sink, readSize);
+
+                free(tmp);
+            }
+            break;
+
+            case numeric_context: {
+                size_t readSize = 0;
+                size_t num = 0;
+
+                tmp = id3v2ReadFrameEntry(&trav, &readSize);
+
+                if (tmp == NULL || readSize == 0) {
+                    free(tmp);
+                    exit = true;
+                    break;
+                }
+
+                num = btost(tmp, (int) readSize);
+                free(tmp);
+
+                internal_id3v2CBORValueStart(sink);
+                (void) id3CborWriteUnsigned(sink, num);
+                internal_id3v2CBORValueEnd(sink, readSize);
+            }
+            break;
+
+            case precision_context: {
+                size_t readSize = 0;
+                float value = 0;
+
+                tmp = id3v2ReadFrameEntry(&trav, &readSize);
+
+                if (tmp == NULL || readSize == 0) {
+                    free(tmp);
+                    exit = true;
+                    break;
+                }
+
+                memcpy(&value, tmp, (readSize < sizeof(value)) ? readSize : sizeof(value));
+                free(tmp);
+
+                internal_id3v2CBORValueStart(sink);
+                (void) id3CborWriteFloat(sink, value);
+                internal_id3v2CBORValueEnd(sink, readSize);
+            }
+            break;
+
+            // produces no cbor, see id3v2FrameToJSONSinkWithOptions
+            case iter_context: {
+                if (currIterations == 0) {
+                    iterStorage = context;
+
+                    context = listCreateIterator(frame->contexts);
+
+                    for (size_t i = 0; i < cc->min; i++) {
+                        listIteratorNext(&context);
+                    }
+                }
+
+                if (currIterations != cc->max && currIterations != 0) {
+                    context = listCreateIterator(frame->contexts);
+
+                    for (size_t i = 0; i < cc->min; i++) {
+                        listIteratorNext(&context);
+                    }
+                }
+
+                if (currIterations >= cc->max) {
+                    context = iterStorage;
+
+                    for (size_t i = 0; i < currIterations; i++) {
+                        listIteratorNext(&context);
+                    }
+
+                    currIterations = 0;
+                }
+
+                currIterations++;
+            }
+            break;
+
+            // the remaining bytes of the frame
+            case adjustment_context: {
+                size_t readSize = 0;
+
+                tmp = id3v2ReadFrameEntry(&trav, &readSize);
+
+                if (tmp == NULL || readSize == 0) {
+                    free(tmp);
+                    exit = true;
+                    break;
+                }
+
+                internal_id3v2CBORValueStart(sink);
+                (void) id3CborWriteBytes(sink, tmp, readSize);
+                internal_id3v2CBORValueEnd(sink, readSize);
+                free(tmp);
+            }
+            break;
+
+            case unknown_context:
+            default:
+                exit = true;
+                break;
+        }
+
+        if (exit == true) {
+            break;
+        }
+    }
+
+    // a frame missing content left in a file that changed is not written as complete
+    return id3CborWriteBreak(sink) && !failed;
+}
+
+// internal function ------------------------------------------------------------------------
+// reads one {"value":...,"size":...} map into an entry for a context
+static Id3v2ContentEntry *internal_id3v2CBORReadEntry(Id3CborReader *reader, const Id3v2ContentContext *cc,
+                                                      uint8_t encoding) {
+    Id3v2ContentEntry *ce = NULL;
+    uint64_t number = 0;
+    uint64_t size = 0;
+    float precision = 0;
+    bool haveValue = false;
+    bool haveSize = false;
+
+    if (!id3CborBeginMap(reader)) {
+        return NULL;
+    }
+
+    while (id3CborNextMember(reader)) {
+        if (strcmp(reader->key, "value") == 0 && !haveValue) {
+            size_t length = 0;
+
+            haveValue = true;
+
+            switch (cc->type) {
+                // byte strings are used in place
+                case noEncoding_context:
+                case bit_context:
+                case binary_context:
+                case adjustment_context: {
+                    const uint8_t *data = id3CborReadBytes(reader, &length);
+
+                    if (data != NULL && length > 0) {
+                        ce = id3v2CreateContentEntry((void *) data, length);
+                    }
+                }
+                break;
+
+                case encodedString_context:
+                case latin1Encoding_context: {
+                    const char *text = id3CborReadText(reader, &length);
+
+                    if (text != NULL) {
+                        ce = internal_id3v2TextEntry(text, length,
+                                                     (cc->type == latin1Encoding_context) ? BYTE_ISO_8859_1 : encoding,
+                                                     cc);
+                    }
+                }
+                break;
+
+                // need the size before an entry can be made
+                case numeric_context:
+                    (void) id3CborReadUnsigned(reader, &number);
+                    break;
+
+                case precision_context:
+                    (void) id3CborReadFloat(reader, &precision);
+                    break;
+
+                default:
+                    (void) id3CborSkipValue(reader);
+                    break;
+            }
+        } else if (strcmp(reader->key, "size") == 0 && !haveSize) {
+            haveSize = id3CborReadUnsigned(reader, &size);
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !haveValue) {
+        if (ce != NULL) {
+            id3v2DeleteContentEntry(ce);
+        }
+
+        return NULL;
+    }
+
+    if (cc->type == numeric_context || cc->type == precision_context) {
+        ce = (size <= INT64_MAX) ? internal_id3v2SizedEntry(cc, (int64_t) size, number, precision) : NULL;
+    }
+
+    return ce;
+}
+
+static bool internal_id3v2FrameHeaderFromCBOR(Id3CborReader *reader, uint8_t version, Id3v2FrameHeader **header) {
+    uint8_t id[ID3V2_FRAME_ID_MAX_SIZE] = {0};
+    bool tagAlter = false;
+    bool fileAlter = false;
+    bool readOnly = false;
+    bool unsync = false;
+    uint64_t decompressionSize = 0;
+    uint64_t encryptionSymbol = 0;
+    uint64_t groupSymbol = 0;
+    bool haveId = false;
+
+    if (!id3CborBeginMap(reader)) {
+        return false;
+    }
+
+    while (id3CborNextMember(reader)) {
+        if (strcmp(reader->key, "id") == 0) {
+            size_t length = 0;
+            const char *text = id3CborReadText(reader, &length);
+            const size_t idSize = (version == ID3V2_TAG_VERSION_2) ? ID3V2_FRAME_ID_MAX_SIZE - 1 : ID3V2_FRAME_ID_MAX_SIZE;
+
+            if (text == NULL || length != idSize) {
+                return false;
+            }
+
+            memcpy(id, text, idSize);
+            haveId = true;
+        } else if (strcmp(reader->key, "tagAlterPreservation") == 0) {
+            (void) id3CborReadBool(reader, &tagAlter);
+        } else if (strcmp(reader->key, "fileAlterPreservation") == 0) {
+            (void) id3CborReadBool(reader, &fileAlter);
+        } else if (strcmp(reader->key, "readOnly") == 0) {
+            (void) id3CborReadBool(reader, &readOnly);
+        } else if (strcmp(reader->key, "unsynchronisation") == 0) {
+            (void) id3CborReadBool(reader, &unsync);
+        } else if (strcmp(reader->key, "decompressionSize") == 0) {
+            (void) id3CborReadUnsigned(reader, &decompressionSize);
+        } else if (strcmp(reader->key, "encryptionSymbol") == 0) {
+            (void) id3CborReadUnsigned(reader, &encryptionSymbol);
+        } else if (strcmp(reader->key, "groupSymbol") == 0) {
+            (void) id3CborReadUnsigned(reader, &groupSymbol);
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !haveId || decompressionSize > UINT32_MAX || encryptionSymbol > UINT8_MAX ||
+        groupSymbol > UINT8_MAX) {
+        return false;
+    }
+
+    *header = id3v2CreateFrameHeader(id, tagAlter, fileAlter, readOnly, unsync, (uint32_t) decompressionSize,
+                                     (uint8_t) encryptionSymbol, (uint8_t) groupSymbol);
+
+    return (*header != NULL);
+}
+
+static bool internal_id3v2FrameContentFromCBOR(Id3CborReader *reader, List *contexts, List *entries) {
+    const size_t encodingKey = id3v2djb2("encoding");
+    ListIter context = listCreateIterator(contexts);
+    ListIter iterStorage;
+    Id3v2ContentContext *cc = NULL;
+    size_t currIterations = 0;
+    uint8_t encoding = 0;
+    bool ended = false;
+
+    if (!id3CborBeginArray(reader)) {
+        return false;
+    }
+
+    // contexts are walked the same way id3v2FrameToCBORSink walks them, one item per entry
+    while ((cc = (Id3v2ContentContext *) listIteratorNext(&context)) != NULL) {
+        Id3v2ContentEntry *ce = NULL;
+
+        if (cc->type == iter_context) {
+            if (currIterations == 0) {
+                iterStorage = context;
+
+                context = listCreateIterator(contexts);
+
+                for (size_t i = 0; i < cc->min; i++) {
+                    listIteratorNext(&context);
+                }
+            }
+
+            if (currIterations != cc->max && currIterations != 0) {
+                context = listCreateIterator(contexts);
+
+                for (size_t i = 0; i < cc->min; i++) {
+                    listIteratorNext(&context);
+                }
+            }
+
+            if (currIterations >= cc->max) {
+                context = iterStorage;
+
+                for (size_t i = 0; i < currIterations; i++) {
+                    listIteratorNext(&context);
+                }
+
+                currIterations = 0;
+            }
+
+            currIterations++;
+            continue;
+        }
+
+        if (cc->type == unknown_context) {
+            break;
+        }
+
+        if (!id3CborNextElement(reader)) {
+            ended = true;
+            break;
+        }
+
+        ce = internal_id3v2CBORReadEntry(reader, cc, encoding);
+
+        if (ce == NULL) {
+            return false;
+        }
+
+        if (cc->type == numeric_context && cc->key == encodingKey) {
+            encoding = ((uint8_t *) ce->entry)[0];
+        }
+
+        listInsertBack(entries, ce);
+    }
+
+    // items the contexts have no room for
+    while (!ended && id3CborNextElement(reader)) {
+        (void) id3CborSkipValue(reader);
+    }
+
+    return !reader->failed;
+}
+
+/**
+ * @brief Builds an ID3v2 frame from its CBOR representation.
+ * @details Reads the map id3v2FrameToCBORSink writes, with the header first, the same way
+ * id3v2FrameFromJSONReader reads JSON. Byte strings are copied straight into their entries without a decoding
+ * step. Returns NULL for an empty map and on failure, check the failed field of the reader to tell them apart.
+ * 
+ * @param reader - Reader positioned at the frame map
+ * @param version - ID3v2 major version of the tag the frame belongs to
+ * @param identifierContextPairs - Default pairings, as made by id3v2CreateDefaultIdentifierContextPairings
+ * @param userPairs - User supplied pairings, or NULL
+ * 
+ * @return Id3v2Frame* - Heap allocated frame, or NULL. Caller must free with id3v2DestroyFrame()
+ */
+Id3v2Frame *id3v2FrameFromCBORReader(Id3CborReader *reader, uint8_t version, HashTable *identifierContextPairs,
+                                     HashTable *userPairs) {
+    Id3v2FrameHeader *header = NULL;
+    List *entries = NULL;
+    List *context = NULL;
+    List *contexts = NULL;
+    Id3v2Frame *frame = NULL;
+    bool haveContent = false;
+
+    if (reader == NULL || identifierContextPairs == NULL || version > ID3V2_TAG_VERSION_4 ||
+        !id3CborBeginMap(reader)) {
+        return NULL;
+    }
+
+    entries = listCreate(id3v2PrintContentEntry, id3v2DeleteContentEntry, id3v2CompareContentEntry,
+                         id3v2CopyContentEntry);
+
+    while (id3CborNextMember(reader)) {
+        if (strcmp(reader->key, "header") == 0 && header == NULL) {
+            if (!internal_id3v2FrameHeaderFromCBOR(reader, version, &header)) {
+                reader->failed = true;
+                break;
+            }
+        } else if (strcmp(reader->key, "content") == 0 && !haveContent) {
+            char id[ID3V2_FRAME_ID_MAX_SIZE + 1] = {0};
+
+            // the header decides how the content is read
+            if (header == NULL) {
+                reader->failed = true;
+                break;
+            }
+
+            memcpy(id, header->id, ID3V2_FRAME_ID_MAX_SIZE);
+            context = id3v2FindIdentifierContext(identifierContextPairs, userPairs, id);
+
+            if (context == NULL) {
+                reader->failed = true;
+                break;
+            }
+
+            // compressed or encrypted content is kept as is, see id3v2ParseFrame
+            if (header->encryptionSymbol > 0 || header->decompressionSize > 0) {
+                contexts = id3v2CreateGenericFrameContext();
+            } else {
+                contexts = listDeepCopy(context);
+            }
+
+            if (!internal_id3v2FrameContentFromCBOR(reader, contexts, entries)) {
+                reader->failed = true;
+                break;
+            }
+
+            haveContent = true;
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || header == NULL || !haveContent) {
+        id3v2DestroyFrameHeader(&header);
+        listFree(entries);
+
+        if (contexts != NULL) {
+            listFree(contexts);
+        }
+
+        return NULL;
+    }
+
+    frame = id3v2CreateFrame(header, contexts, entries);
+
+    if (header->encryptionSymbol == 0 && header->decompressionSize > 0) {
+        frame->compressedContext = listDeepCopy(context);
+        frame->compressed = true;
+    }
+
+    return frame;
+}
+
+/**
+ * @brief Builds an ID3v2 frame from its CBOR representation.
+ * @details Convenience wrapper around id3v2FrameFromCBORReader using the default pairings for the version.
+ * 
+ * @param cbor - CBOR as written by id3v2FrameToCBOR
+ * @param length - Number of bytes in cbor
+ * @param version - ID3v2 major version of the tag the frame belongs to
+ * 
+ * @return Id3v2Frame* - Heap allocated frame, or NULL if the CBOR is empty, invalid, or not a complete frame.
+ * Caller must free with id3v2DestroyFrame()
+ */
+Id3v2Frame *id3v2FrameFromCBOR(const uint8_t *cbor, size_t length, uint8_t version) {
+    if (cbor == NULL) {
+        return NULL;
+    }
+
+    Id3CborReader *reader = id3CborReaderCreate(cbor, length);
+    HashTable *pairs = id3v2CreateDefaultIdentifierContextPairings(version);
+    Id3v2Frame *frame = NULL;
+
+    if (reader != NULL && pairs != NULL) {
+        frame = id3v2FrameFromCBORReader(reader, version, pairs, NULL);
+
+        if (frame != NULL && !id3CborReaderFinished(reader)) {
+            id3v2DestroyFrame(&frame);
+        }
+    }
+
+    if (pairs != NULL) {
+        hashTableFree(pairs);
+    }
+
+    id3CborReaderDestroy(&reader);
+    return frame;
 }
@@ -17,6 +17,8 @@
 #include "id3v2/id3v2Frame.h"
 #include "id3v2/id3v2Parser.h"
 #include "id3v2/id3v2TagIdentity.h"
+#include "id3v2/id3v2Unsynchronisation.h"
+#include "id3Crc32.h"
 #include "id3dependencies/ByteStream/include/byteStream.h"
 #include "id3dependencies/ByteStream/include/byteInt.h"
 #include "id3dependencies/ByteStream/include/byteUnicode.h"
@@ -47,6 +49,19 @@ static void internal_copyNBits(const unsigned char *src, unsigned char *dest, in
     }
 }
 
+// internal function ---
+// stream over bytes owned by someone else, reading it copies nothing and it must never be destroyed or resized
+static ByteStream internal_borrowStream(uint8_t *in, size_t inl) {
+    ByteStream stream;
+
+    memset(&stream, 0, sizeof(ByteStream));
+    stream.buffer = in;
+    stream.bufferSize = inl;
+    stream.cursor = 0;
+
+    return stream;
+}
+
 /**
  * @brief Parses an ID3v2 extended tag header from a byte buffer.
  * @details Extracts and decodes extended header fields from binary data according to the 
@@ -76,12 +91,8 @@ uint32_t id3v2ParseExtendedTagHeader(uint8_t *in, size_t inl, uint8_t version,
         return 0;
     }
 
-    ByteStream *stream = byteStreamCreate(in, inl);
-
-    if (!stream) {
-        *extendedTagHeader = NULL;
-        return 0;
-    }
+    ByteStream view = internal_borrowStream(in, inl);
+    ByteStream *stream = &view;
 
     // values needed
     uint32_t padding = 0;
@@ -96,7 +107,8 @@ uint32_t id3v2ParseExtendedTagHeader(uint8_t *in, size_t inl, uint8_t version,
     unsigned char crcBytes[5] = {0, 0, 0, 0, 0};
     bool hasCrc = false;
     bool hasRestrictions = false;
-    ByteStream *innerStream = NULL;
+    ByteStream innerView;
+    ByteStream *innerStream = &innerView;
 
     // size return
     uint32_t hSize = 0;
@@ -106,7 +118,6 @@ uint32_t id3v2ParseExtendedTagHeader(uint8_t *in, size_t inl, uint8_t version,
         hSize = byteStreamReturnInt(stream);
         if (!hSize) {
             *extendedTagHeader = NULL;
-            byteStreamDestroy(stream);
             return 0;
         }
 
@@ -115,7 +126,7 @@ uint32_t id3v2ParseExtendedTagHeader(uint8_t *in, size_t inl, uint8_t version,
         }
     }
 
-    innerStream = byteStreamCreate(byteStreamCursor(stream), hSize - offset);
+    innerView = internal_borrowStream(stream->buffer + stream->cursor, hSize - offset);
 
     switch (version) {
         case ID3V2_TAG_VERSION_3:
@@ -180,7 +191,10 @@ uint32_t id3v2ParseExtendedTagHeader(uint8_t *in, size_t inl, uint8_t version,
                     break;
                 }
 
-                crc = byteSyncintDecode(btoi(crcBytes, 5));
+                // 35 bit syncsafe integer
+                for (int k = 0; k < 5; k++) {
+                    crc = (crc << 7) | (crcBytes[k] & 0x7F);
+                }
             }
 
             // read restrictions
@@ -206,20 +220,13 @@ uint32_t id3v2ParseExtendedTagHeader(uint8_t *in, size_t inl, uint8_t version,
 
         // no support
         default:
-            byteStreamDestroy(innerStream);
             *extendedTagHeader = NULL;
             return 0;
     }
 
-    // clean up
-    byteStreamDestroy(stream);
     *extendedTagHeader = id3v2CreateExtendedTagHeader(padding, crc, update, tagRestrictions, restrictions);
     walk = innerStream->cursor + 4;
 
-    if (innerStream != NULL) {
-        byteStreamDestroy(innerStream);
-    }
-
     return walk;
 }
 
@@ -253,13 +260,9 @@ uint32_t id3v2ParseTagHeader(uint8_t *in, size_t inl, Id3v2TagHeader **tagHeader
         return 0;
     }
 
-    ByteStream *stream = byteStreamCreate(in, inl);
-
-
-    if (!stream) {
-        *tagHeader = NULL;
-        return 0;
-    }
+    // only the header is read, nothing is copied
+    ByteStream view = internal_borrowStream(in, (inl < ID3V2_TAG_HEADER_SIZE) ? inl : ID3V2_TAG_HEADER_SIZE);
+    ByteStream *stream = &view;
 
     // values needed
     uint8_t major = 0;
@@ -315,7 +318,6 @@ uint32_t id3v2ParseTagHeader(uint8_t *in, size_t inl, Id3v2TagHeader **tagHeader
     walk = stream->cursor;
     *tagSize = hSize;
     *tagHeader = id3v2CreateTagHeader(major, minor, flags, NULL);
-    byteStreamDestroy(stream);
     return walk;
 }
 
@@ -356,12 +358,9 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
         return 0;
     }
 
-    ByteStream *stream = byteStreamCreate(in, inl);
-
-    if (!stream) {
-        *frameHeader = NULL;
-        return 0;
-    }
+    // a header never reads past its largest size, nothing is copied
+    ByteStream view = internal_borrowStream(in, (inl < ID3V2_FRAME_HEADER_MAX_SIZE) ? inl : ID3V2_FRAME_HEADER_MAX_SIZE);
+    ByteStream *stream = &view;
 
     // values needed
     uint8_t id[ID3V2_FRAME_ID_MAX_SIZE] = {0, 0, 0, 0};
@@ -385,14 +384,12 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
             if (!byteStreamRead(stream, id, ID3V2_FRAME_ID_MAX_SIZE - 1)) {
                 *frameHeader = NULL;
                 *frameSize = 0;
-                byteStreamDestroy(stream);
                 return 0;
             }
 
             if (!byteStreamRead(stream, sizeBytes, ID3V2_FRAME_ID_MAX_SIZE - 1)) {
                 *frameHeader = NULL;
                 *frameSize = 0;
-                byteStreamDestroy(stream);
                 return ID3V2_FRAME_ID_MAX_SIZE - 1;
             }
 
@@ -406,7 +403,6 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
             if (!byteStreamRead(stream, id, ID3V2_FRAME_ID_MAX_SIZE)) {
                 *frameHeader = NULL;
                 *frameSize = 0;
-                byteStreamDestroy(stream);
                 return 0;
             }
 
@@ -414,14 +410,12 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
             if (!tSize) {
                 *frameHeader = NULL;
                 *frameSize = 0;
-                byteStreamDestroy(stream);
                 return ID3V2_FRAME_ID_MAX_SIZE;
             }
 
             if (!(byteStreamRead(stream, flagBytes, ID3V2_FRAME_FLAG_SIZE))) {
                 *frameHeader = NULL;
                 *frameSize = tSize;
-                byteStreamDestroy(stream);
                 return ID3V2_FRAME_ID_MAX_SIZE * 2;
             }
 
@@ -462,7 +456,6 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
             if (!byteStreamRead(stream, id, ID3V2_FRAME_ID_MAX_SIZE)) {
                 *frameHeader = NULL;
                 *frameSize = 0;
-                byteStreamDestroy(stream);
                 return 0;
             }
 
@@ -470,14 +463,12 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
             if (!tSize) {
                 *frameHeader = NULL;
                 *frameSize = 0;
-                byteStreamDestroy(stream);
                 return ID3V2_FRAME_ID_MAX_SIZE;
             }
 
             if (!(byteStreamRead(stream, flagBytes, ID3V2_FRAME_FLAG_SIZE))) {
                 *frameHeader = NULL;
                 *frameSize = tSize;
-                byteStreamDestroy(stream);
                 return ID3V2_FRAME_ID_MAX_SIZE * 2;
             }
 
@@ -519,7 +510,6 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
         default:
             *frameHeader = NULL;
             *frameSize = 0;
-            byteStreamDestroy(stream);
             return 0;
     }
 
@@ -527,50 +517,78 @@ uint32_t id3v2ParseFrameHeader(uint8_t *in, size_t inl, uint8_t version, Id3v2Fr
                                           encryptionSymbol, groupSymbol);
     *frameSize = tSize;
     walk = stream->cursor;
-    byteStreamDestroy(stream);
     // printf("[*] frameSize = %zu, walk = %zu stream->cursor = %zu\n", *frameSize, walk, stream->cursor); // debug info i dont wanna rewrite
     return walk;
 }
 
-/**
- * @brief Parses an ID3v2 frame (header + content) from a byte buffer using context-driven interpretation.
- * @details Extracts a complete frame by first parsing the header, then interpreting frame content 
- * according to a context list that provides "hints" about data types and structure. The context-driven 
- * approach allows flexible parsing of the diverse frame types in the ID3v2 specification.
- * 
- * **Encrypted/Compressed Frame Handling:**
- * Frames with encryptionSymbol or decompressionSize set are parsed as raw binary using a generic 
- * context. The caller must decrypt/decompress and reparse to access structured content.
- * 
- * **Context Types Supported:**
- * - encodedString_context: Null-terminated strings with encoding determined by prior "encoding" byte 
- * (ISO-8859-1, UTF-8, UTF-16BE/LE)
- * - latin1Encoding_context: Null-terminated Latin-1 (ISO-8859-1) strings only
- * - binary_context/noEncoding_context/precision_context/numeric_context: Fixed-size raw binary/numeric data
- * - bit_context: Bit-level extraction (WARNING: incorrect implementation as of jan 13 2026)
- * - iter_context: Loop control marker for repeated field groups
- * - adjustment_context: Variable-length data where size comes from previously parsed "adjustment" field
- * - unknown_context: Skip remaining content
- * 
- * The function creates heap-allocated content entries for each parsed field and assembles them into 
- * a complete frame structure. On success, caller must free with id3v2DestroyFrame.
- * 
- * @param in - Pointer to byte buffer containing complete frame data.
- * @param inl - Size of input buffer in bytes.
- * @param context - List of Id3v2ContentContext structures defining frame structure and data types.
- * @param version - ID3v2 version (ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4).
- * @param frame - Output parameter receiving pointer to heap-allocated frame structure, or NULL on failure.
- * @return uint32_t - Total bytes consumed on success, header size on partial success, or 0 on complete failure.
- */
-uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version, Id3v2Frame **frame) {
+// internal function ---
+// buffer of at least size bytes to resynchronise in, owned by the parser when one is given. a tag is only
+// resynchronised as a whole before ID3v2.4 and frames only on their own from it, so one buffer serves both
+static uint8_t *internal_parserScratch(Id3v2Parser *parser, size_t size) {
+    uint8_t *tmp = NULL;
+
+    // one spare byte so an empty tag body still gets a buffer
+    if (parser == NULL) {
+        return malloc(size + 1);
+    }
+
+    if (parser->scratch == NULL || parser->scratchSize < size + 1) {
+        tmp = realloc(parser->scratch, size + 1);
+
+        if (tmp == NULL) {
+            return NULL;
+        }
+
+        parser->scratch = tmp;
+        parser->scratchSize = size + 1;
+    }
+
+    return parser->scratch;
+}
+
+// internal function ---
+// frees a buffer from internal_parserScratch unless the parser keeps it
+static void internal_parserScratchRelease(Id3v2Parser *parser, uint8_t *scratch) {
+    if (parser == NULL) {
+        free(scratch);
+    }
+}
+
+// internal function ---
+// creates an entry from the next size bytes of a stream without copying them anywhere else first. when fewer are
+// left the entry holds zeros, like the buffer of a failed byteStreamRead did
+static Id3v2ContentEntry *internal_readContentEntry(ByteStream *stream, size_t size) {
+    Id3v2ContentEntry *ce = NULL;
+    uint8_t *zeros = NULL;
+
+    if (size <= stream->bufferSize - stream->cursor) {
+        ce = id3v2CreateContentEntry(stream->buffer + stream->cursor, size);
+        stream->cursor += size;
+        return ce;
+    }
+
+    zeros = calloc(size, sizeof(uint8_t));
+
+    if (zeros != NULL) {
+        ce = id3v2CreateContentEntry(zeros, size);
+        free(zeros);
+    }
+
+    return ce;
+}
+
+// internal function ---
+// parses a frame, see id3v2ParseFrame. content is read from in, or the parser scratch when it has to be
+// resynchronised, and copied only into the entries. with a source the binary content a frame ends in is not read but
+// referred to, in then holds the bytes of the source from offset
+static uint32_t internal_parseFrame(uint8_t *in, size_t inl, List *context, uint8_t version, Id3v2Frame **frame,
+                                    Id3v2Parser *parser, Id3v2Source *source, uint64_t offset) {
     if (in == NULL || inl == 0) {
         *frame = NULL;
         return 0;
     }
 
-    ByteStream *stream = byteStreamCreate(in, inl);
-
-    if (!stream || !context) {
+    if (!context) {
         *frame = NULL;
         return 0;
     }
@@ -586,20 +604,22 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
     size_t concurrentBitCount = 0;
     uint32_t expectedHeaderSize = 0;
     uint32_t expectedContentSize = 0;
-    ByteStream *innerStream = NULL;
+    size_t unsyncSize = 0;
+    bool deferred = false;
+    uint8_t *scratch = NULL;
+    ByteStream view;
+    ByteStream *innerStream = &view;
     ListIter iter;
     ListIter iterStorage;
     void *contextData = NULL;
 
-    expectedHeaderSize = id3v2ParseFrameHeader(stream->buffer, stream->bufferSize, version, &header,
-                                               &expectedContentSize);
+    expectedHeaderSize = id3v2ParseFrameHeader(in, inl, version, &header, &expectedContentSize);
     walk += expectedHeaderSize;
     if (!expectedHeaderSize) {
         if (header != NULL) {
             id3v2DestroyFrameHeader(&header);
         }
 
-        byteStreamDestroy(stream);
         return 0;
     }
 
@@ -609,22 +629,48 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
             id3v2DestroyFrameHeader(&header);
         }
 
-        byteStreamDestroy(stream);
         return expectedHeaderSize;
     }
 
-    byteStreamSeek(stream, expectedHeaderSize, SEEK_CUR);
+    // content is read straight from the input, a frame claiming more than is left only gets what is left
+    if (expectedHeaderSize >= inl) {
+        id3v2DestroyFrameHeader(&header);
+        return expectedHeaderSize;
+    }
+
+    if (expectedContentSize > inl - expectedHeaderSize) {
+        expectedContentSize = (uint32_t) (inl - expectedHeaderSize);
+    }
+
+    view = internal_borrowStream(in + expectedHeaderSize, expectedContentSize);
+
+    // frame level unsynchronisation, in is left as read so it can be cached
+    if (version == ID3V2_TAG_VERSION_4 && header->unsynchronisation) {
+        size_t resyncSize = 0;
+
+        scratch = internal_parserScratch(parser, expectedContentSize);
+
+        if (scratch == NULL) {
+            id3v2DestroyFrameHeader(&header);
+            return 0;
+        }
+
+        memcpy(scratch, in + expectedHeaderSize, expectedContentSize);
+        resyncSize = id3v2Resynchronise(scratch, expectedContentSize);
+
+        unsyncSize = expectedContentSize - resyncSize;
+        expectedContentSize = (uint32_t) resyncSize;
+        view = internal_borrowStream(scratch, resyncSize);
+    }
 
-    innerStream = byteStreamCreate(byteStreamCursor(stream), expectedContentSize);
     entries = listCreate(id3v2PrintContentEntry, id3v2DeleteContentEntry, id3v2CompareContentEntry,
                          id3v2CopyContentEntry);
 
 
     // is a frame compressed or encrypted?
-    // if so a generic context will be used meaning it's not up to me to decompress or unencrypted + if it's a text frame none
-    // of the reads or writes will work until someone reparses the data after its changed.
+    // if so a generic context will be used and encrypted content is left to the caller. compressed content keeps the
+    // context of its frame ID so id3v2DecompressFrame can parse it once it is first used.
     if (header->encryptionSymbol > 0 || header->decompressionSize > 0) {
-        uint8_t *data = NULL;
         size_t dataSize = 0;
         List *gContext = id3v2CreateGenericFrameContext();
         Id3v2ContentContext *cc = (Id3v2ContentContext *) gContext->head->data;
@@ -640,19 +686,22 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
             dataSize = expectedContentSize;
         }
 
-        data = malloc(dataSize);
+        listInsertBack(entries, internal_readContentEntry(innerStream, dataSize));
 
-        if (!byteStreamRead(innerStream, data, dataSize)) {
-            memset(data, 0, dataSize);
+        walk += innerStream->cursor + unsyncSize;
+        *frame = id3v2CreateFrame(header, gContext, entries);
+
+        if ((*frame)->header->encryptionSymbol == 0) {
+            (*frame)->compressedContext = listDeepCopy(context);
+            (*frame)->compressed = true;
         }
 
-        listInsertBack(entries, id3v2CreateContentEntry(data, dataSize));
-        free(data);
+        // content that cannot be interpreted is kept exactly as read
+        if (walk <= inl) {
+            (void) id3v2CacheFrameBytes(*frame, version, in, walk);
+        }
 
-        walk += innerStream->cursor;
-        *frame = id3v2CreateFrame(header, gContext, entries);
-        byteStreamDestroy(innerStream);
-        byteStreamDestroy(stream);
+        internal_parserScratchRelease(parser, scratch);
         return walk;
     }
 
@@ -727,8 +776,7 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                     if (reallocPtr == NULL) {
                         free(data);
                         listFree(entries);
-                        byteStreamDestroy(innerStream);
-                        byteStreamDestroy(stream);
+                        internal_parserScratchRelease(parser, scratch);
                         id3v2DestroyFrameHeader(&header);
                         *frame = NULL;
                         return 0;
@@ -740,8 +788,7 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                     if (reallocPtr == NULL) {
                         free(data);
                         listFree(entries);
-                        byteStreamDestroy(innerStream);
-                        byteStreamDestroy(stream);
+                        internal_parserScratchRelease(parser, scratch);
                         id3v2DestroyFrameHeader(&header);
                         *frame = NULL;
                         return 0;
@@ -770,8 +817,7 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                     if (reallocPtr == NULL) {
                         free(data);
                         listFree(entries);
-                        byteStreamDestroy(innerStream);
-                        byteStreamDestroy(stream);
+                        internal_parserScratchRelease(parser, scratch);
                         id3v2DestroyFrameHeader(&header);
                         *frame = NULL;
                         return 0;
@@ -782,8 +828,7 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                     if (reallocPtr == NULL) {
                         free(data);
                         listFree(entries);
-                        byteStreamDestroy(innerStream);
-                        byteStreamDestroy(stream);
+                        internal_parserScratchRelease(parser, scratch);
                         id3v2DestroyFrameHeader(&header);
                         *frame = NULL;
                         return 0;
@@ -804,7 +849,6 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
             case noEncoding_context:
             case precision_context:
             case numeric_context: {
-                uint8_t *data = NULL;
                 size_t dataSize = 0;
 
                 if (cc->min >= cc->max) {
@@ -818,19 +862,28 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                     dataSize = expectedContentSize;
                 }
 
-                data = calloc(sizeof(uint8_t), dataSize);
-
-                if (!byteStreamRead(innerStream, data, dataSize)) {
-                    memset(data, 0, dataSize);
+                // binary content ending a frame stored as is stays in the source
+                if (source != NULL && cc->type == binary_context && !header->unsynchronisation && dataSize > 0 &&
+                    dataSize <= innerStream->bufferSize - innerStream->cursor && !listIteratorHasNext(iter)) {
+                    Id3v2ContentEntry *ce = id3v2CreateFileContentEntry(source, offset + expectedHeaderSize +
+                                                                                innerStream->cursor, dataSize);
+
+                    if (ce != NULL) {
+                        listInsertBack(entries, ce);
+                        (void) byteStreamSeek(innerStream, (long) dataSize, SEEK_CUR);
+                        expectedContentSize = 0;
+                        deferred = true;
+                        break;
+                    }
                 }
 
-                listInsertBack(entries, id3v2CreateContentEntry(data, dataSize));
-                free(data);
+                listInsertBack(entries, internal_readContentEntry(innerStream, dataSize));
 
                 expectedContentSize = ((expectedContentSize < dataSize) ? 0 : expectedContentSize - dataSize);
             }
             break;
             case bit_context: {
+                uint8_t bits[sizeof(uint64_t)];
                 uint8_t *data = NULL;
                 size_t nBits = 0;
                 size_t dataSize = 0;
@@ -845,7 +898,8 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
 
                 dataSize = (nBits + (CHAR_BIT - 1)) / CHAR_BIT;
 
-                data = malloc(dataSize);
+                // fields of a few bits are gathered on the stack
+                data = (dataSize > sizeof(bits)) ? malloc(dataSize) : bits;
                 memset(data, 0, dataSize);
                 internal_copyNBits(byteStreamCursor(innerStream), data, (int) concurrentBitCount, (int) nBits);
 
@@ -866,7 +920,10 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                 }
 
                 listInsertBack(entries, id3v2CreateContentEntry(data, dataSize));
-                free(data);
+
+                if (data != bits) {
+                    free(data);
+                }
             }
             break;
             case iter_context: {
@@ -903,7 +960,6 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
             }
             break;
             case adjustment_context: {
-                uint8_t *data = NULL;
                 size_t dataSize = 0;
 
                 size_t posce = 0;
@@ -938,12 +994,7 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
                     dataSize = expectedContentSize;
                 }
 
-                data = malloc(dataSize);
-                memset(data, 0, dataSize); //ensure data exists
-                byteStreamRead(innerStream, data, dataSize); // no need to check error code do to above memset
-
-                listInsertBack(entries, id3v2CreateContentEntry(data, dataSize));
-                free(data);
+                listInsertBack(entries, internal_readContentEntry(innerStream, dataSize));
 
                 expectedContentSize = ((expectedContentSize < dataSize) ? 0 : expectedContentSize - dataSize);
             }
@@ -962,111 +1013,153 @@ uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version
 
 
     // enforce frame size from header parsing
-    walk += innerStream->bufferSize;
+    walk += innerStream->bufferSize + unsyncSize;
 
     *frame = id3v2CreateFrame(header, listDeepCopy(context), entries);
-    byteStreamDestroy(innerStream);
-    byteStreamDestroy(stream);
+
+    // unchanged frames are written back exactly as read, unless that would hold the content left in the source
+    if (walk <= inl && !deferred) {
+        (void) id3v2CacheFrameBytes(*frame, version, in, walk);
+    }
+    internal_parserScratchRelease(parser, scratch);
     return walk;
 }
 
- /**
- * @brief Parses a complete ID3v2 tag from a byte buffer, including header, optional extended header, and all frames.
- * @details Orchestrates the full tag parsing workflow by locating the "ID3" identifier, parsing headers, 
- * processing unsynchronisation if present, and iteratively parsing all frames using a multi-pass context 
- * resolution strategy. Returns a heap-allocated tag structure containing all successfully parsed components.
+/**
+ * @brief Parses an ID3v2 frame (header + content) from a byte buffer using context-driven interpretation.
+ * @details Extracts a complete frame by first parsing the header, then interpreting frame content 
+ * according to a context list that provides "hints" about data types and structure. The context-driven 
+ * approach allows flexible parsing of the diverse frame types in the ID3v2 specification.
  * 
- * **Parsing Process:**
- * 1. Scans buffer to locate "ID3" magic number identifier
- * 2. Parses tag header (version, flags, size)
- * 3. If unsynchronisation flag set: strips $00 bytes following $FF
- * 4. If extended header flag set: parses version-specific extended header
- * 5. Iterates through frame data, parsing each frame using 4-pass context lookup
+ * **Encrypted/Compressed Frame Handling:**
+ * Frames with encryptionSymbol or decompressionSize set are parsed as raw binary using a generic 
+ * context. The caller must decrypt/decompress and reparse to access structured content.
  * 
- * **Frame Context Resolution (4-Pass System):**
- * - Pass 1: Exact frame ID match in default context mappings (e.g., "TIT2", "APIC")
- * - Pass 2: Exact frame ID match in user-supplied custom mappings (userPairs parameter)
- * - Pass 3: Generic frame type patterns - 'T' prefix (text frames), 'W' prefix (URL frames)
- * - Pass 4: Fallback to generic binary context ('?') for unknown frame types
+ * **Context Types Supported:**
+ * - encodedString_context: Null-terminated strings with encoding determined by prior "encoding" byte 
+ * (ISO-8859-1, UTF-8, UTF-16BE/LE)
+ * - latin1Encoding_context: Null-terminated Latin-1 (ISO-8859-1) strings only
+ * - binary_context/noEncoding_context/precision_context/numeric_context: Fixed-size raw binary/numeric data
+ * - bit_context: Bit-level extraction (WARNING: incorrect implementation as of jan 13 2026)
+ * - iter_context: Loop control marker for repeated field groups
+ * - adjustment_context: Variable-length data where size comes from previously parsed "adjustment" field
+ * - unknown_context: Skip remaining content
  * 
- * Parsing continues until all frames are extracted or an unrecoverable error occurs. On partial 
- * failure, returns a tag structure with successfully parsed frames. Returns NULL only on complete 
- * failure. Caller must free returned structure with id3v2DestroyTag.
+ * The function creates heap-allocated content entries for each parsed field and assembles them into 
+ * a complete frame structure. The bytes the frame was parsed from are cached on it with id3v2CacheFrameBytes so
+ * it serializes back byte for byte until it is modified. On success, caller must free with id3v2DestroyFrame.
  * 
- * @param in - Pointer to byte buffer containing ID3v2 tag data (may include non-tag data before/after).
+ * @param in - Pointer to byte buffer containing complete frame data.
  * @param inl - Size of input buffer in bytes.
- * @param userPairs - Optional hash table mapping frame IDs to custom context lists (NULL for default mappings only).
- * @return Id3v2Tag* - Heap-allocated complete tag structure on success, partial tag on partial failure, or NULL on complete failure.
+ * @param context - List of Id3v2ContentContext structures defining frame structure and data types.
+ * @param version - ID3v2 version (ID3V2_TAG_VERSION_2, ID3V2_TAG_VERSION_3, or ID3V2_TAG_VERSION_4).
+ * @param frame - Output parameter receiving pointer to heap-allocated frame structure, or NULL on failure.
+ * @return uint32_t - Total bytes consumed on success, header size on partial success, or 0 on complete failure.
  */
-Id3v2Tag *id3v2ParseTagFromBuffer(uint8_t *in, size_t inl, HashTable *userPairs) {
-    if (in == NULL || inl == 0) {
-        return NULL;
+uint32_t id3v2ParseFrame(uint8_t *in, size_t inl, List *context, uint8_t version, Id3v2Frame **frame) {
+    return internal_parseFrame(in, inl, context, version, frame, NULL, NULL, 0);
+}
+
+// internal function ---
+// default pairings for a version, kept by the parser when one is given
+static HashTable *internal_parserPairs(Id3v2Parser *parser, uint8_t version) {
+    if (parser == NULL || version < ID3V2_TAG_VERSION_2 || version > ID3V2_TAG_VERSION_4) {
+        return id3v2CreateDefaultIdentifierContextPairings(version);
     }
 
-    ByteStream *stream = byteStreamCreate(in, inl);
+    if (parser->pairs[version - ID3V2_TAG_VERSION_2] == NULL) {
+        parser->pairs[version - ID3V2_TAG_VERSION_2] = id3v2CreateDefaultIdentifierContextPairings(version);
+    }
+
+    return parser->pairs[version - ID3V2_TAG_VERSION_2];
+}
 
-    if (!stream) {
+// internal function ---
+// checks whether a frame holds a picture or object that can be left in the file it was read from
+static bool internal_isLazyFrame(const uint8_t *frameId, uint8_t version) {
+    if (version == ID3V2_TAG_VERSION_2) {
+        return memcmp(frameId, "PIC", ID3V2_FRAME_ID_MAX_SIZE - 1) == 0 ||
+               memcmp(frameId, "GEO", ID3V2_FRAME_ID_MAX_SIZE - 1) == 0;
+    }
+
+    return memcmp(frameId, "APIC", ID3V2_FRAME_ID_MAX_SIZE) == 0 ||
+           memcmp(frameId, "GEOB", ID3V2_FRAME_ID_MAX_SIZE) == 0;
+}
+
+// internal function ---
+// parses a tag, see id3v2ParseTagFromBuffer. frames are parsed straight from the input unless the tag has to be
+// resynchronised first. with a source, in holds the source from its start and the content of pictures and objects
+// stored as is stays there
+static Id3v2Tag *internal_parseTag(uint8_t *in, size_t inl, HashTable *userPairs, Id3v2Parser *parser,
+                                   Id3v2Source *source) {
+    if (in == NULL || inl == 0) {
         return NULL;
     }
 
-    bool exit = false;
+    bool verbatim = true;
+    size_t tagStart = 0;
+    size_t pos = 0;
+    size_t bodyl = 0;
     uint32_t read = 0;
+    uint32_t headerSize = 0;
     uint32_t tagSize = 0;
-    uint8_t id[ID3V2_TAG_ID_SIZE];
+    uint8_t *body = NULL;
+    uint8_t *scratch = NULL;
     Id3v2TagHeader *header = NULL;
     Id3v2ExtendedTagHeader *ext = NULL;
     List *frames = NULL;
     HashTable *pairs = NULL;
 
-    frames = listCreate(id3v2PrintFrame, id3v2DeleteFrame, id3v2CompareFrame, id3v2CopyFrame);
-
     // locate the start of the tag
     while (true) {
-        if (!byteStreamRead(stream, id, ID3V2_TAG_ID_SIZE)) {
-            listFree(frames);
-            byteStreamDestroy(stream);
+        if (inl - tagStart < ID3V2_TAG_ID_SIZE) {
             return NULL;
         }
 
-        if (btoi(id, ID3V2_TAG_ID_SIZE) == ID3V2_TAG_ID_MAGIC_NUMBER_H) {
-            stream->cursor = stream->cursor - ID3V2_TAG_ID_SIZE;
+        if (btoi(in + tagStart, ID3V2_TAG_ID_SIZE) == ID3V2_TAG_ID_MAGIC_NUMBER_H) {
             break;
         }
+
+        tagStart += ID3V2_TAG_ID_SIZE;
     }
 
+    frames = listCreate(id3v2PrintFrame, id3v2DeleteFrame, id3v2CompareFrame, id3v2CopyFrame);
+
     while (true) {
-        read = id3v2ParseTagHeader(byteStreamCursor(stream), stream->bufferSize - stream->cursor, &header, &tagSize);
+        headerSize = id3v2ParseTagHeader(in + tagStart, inl - tagStart, &header, &tagSize);
 
-        if (read == 0 || header == NULL || tagSize == 0) {
+        if (headerSize == 0 || header == NULL || tagSize == 0 || headerSize > inl - tagStart) {
             break;
         }
 
-        if (!byteStreamSeek(stream, read, SEEK_CUR)) {
-            break;
+        // exclude none tag data
+        body = in + tagStart + headerSize;
+        bodyl = inl - tagStart - headerSize;
+
+        if (bodyl > tagSize) {
+            bodyl = tagSize;
         }
 
-        // shorten to exclude none tag data
-        byteStreamResize(stream, tagSize + read);
+        // v2.4 unsynchronises frames on their own, see id3v2ParseFrame
+        if (id3v2ReadUnsynchronisationIndicator(header) == 1 && header->majorVersion != ID3V2_TAG_VERSION_4) {
+            scratch = internal_parserScratch(parser, bodyl);
 
-        if (id3v2ReadUnsynchronisationIndicator(header) == 1) {
-            size_t readCount = 0;
-            tagSize = tagSize / 2; // format is $xx $00 ...
-            while (readCount < tagSize) {
-                byteStreamSeek(stream, 1, SEEK_CUR);
-                if (!byteStreamDeleteCh(stream)) {
-                    break;
-                }
-
-                readCount++;
+            if (scratch == NULL) {
+                break;
             }
 
-            byteStreamSeek(stream, 10, SEEK_SET);
+            memcpy(scratch, body, bodyl);
+            body = scratch;
+            bodyl = id3v2Resynchronise(body, bodyl);
+            tagSize = (uint32_t) bodyl;
+
+            // frames no longer sit where they do in the tag
+            verbatim = false;
         }
 
         if ((header->majorVersion == ID3V2_TAG_VERSION_3 || header->majorVersion == ID3V2_TAG_VERSION_4) &&
             id3v2ReadExtendedHeaderIndicator(header) == 1) {
-            read = id3v2ParseExtendedTagHeader(byteStreamCursor(stream), stream->bufferSize - stream->cursor,
-                                               header->majorVersion, &ext);
+            read = id3v2ParseExtendedTagHeader(body, bodyl, header->majorVersion, &ext);
             header->extendedHeader = ext;
 
             if (read == 0 || ext == NULL) {
@@ -1074,82 +1167,251 @@ Id3v2Tag *id3v2ParseTagFromBuffer(uint8_t *in, size_t inl, HashTable *userPairs)
             }
 
             tagSize = ((tagSize < read) ? 0 : tagSize - read);
-            byteStreamSeek(stream, read, SEEK_CUR);
+            pos = (read < bodyl) ? read : bodyl;
         }
 
-        pairs = id3v2CreateDefaultIdentifierContextPairings(header->majorVersion);
+        pairs = internal_parserPairs(parser, header->majorVersion);
 
         while (tagSize) {
             Id3v2Frame *frame = NULL;
             List *context = NULL;
             uint8_t frameId[ID3V2_FRAME_ID_MAX_SIZE] = {0};
+            size_t idSize = (header->majorVersion == ID3V2_TAG_VERSION_2) ? ID3V2_FRAME_ID_MAX_SIZE - 1
+                                                                          : ID3V2_FRAME_ID_MAX_SIZE;
 
-            if (header->majorVersion == ID3V2_TAG_VERSION_3 || header->majorVersion == ID3V2_TAG_VERSION_4) {
-                if (!byteStreamRead(stream, frameId, ID3V2_FRAME_ID_MAX_SIZE)) {
-                    exit = true;
-                    break;
-                }
-
-                stream->cursor = stream->cursor - ID3V2_FRAME_ID_MAX_SIZE;
-            } else if (header->majorVersion == ID3V2_TAG_VERSION_2) {
-                if (!byteStreamRead(stream, frameId, ID3V2_FRAME_ID_MAX_SIZE - 1)) {
-                    exit = true;
-                    break;
-                }
-
-                stream->cursor = stream->cursor - (ID3V2_FRAME_ID_MAX_SIZE - 1);
-            }
-
-            // check default pairings (pass 1/4)
-            context = hashTableRetrieve(pairs, (char *) frameId);
-
-            // check user supplied ones (pass 2/4)
-            if (context == NULL) {
-                context = hashTableRetrieve(userPairs, (char *) frameId);
+            if (bodyl - pos < idSize) {
+                break;
             }
 
-            // special considerations (pass 3/4)
-            if (context == NULL) {
-                if (frameId[0] == 'T') {
-                    context = hashTableRetrieve(pairs, "T");
-                }
+            memcpy(frameId, body + pos, idSize);
 
-                if (frameId[0] == 'W') {
-                    context = hashTableRetrieve(pairs, "W");
-                }
-            }
+            context = id3v2FindIdentifierContext(pairs, userPairs, (char *) frameId);
 
-            // use generic (pass 4/4)
-            if (context == NULL) {
-                context = hashTableRetrieve(pairs, "?");
+            if (source != NULL && verbatim && internal_isLazyFrame(frameId, header->majorVersion)) {
+                read = internal_parseFrame(body + pos, bodyl - pos, context, header->majorVersion, &frame, parser,
+                                           source, tagStart + headerSize + pos);
+            } else {
+                read = internal_parseFrame(body + pos, bodyl - pos, context, header->majorVersion, &frame, parser,
+                                           NULL, 0);
             }
 
-            read = id3v2ParseFrame(byteStreamCursor(stream), stream->bufferSize - stream->cursor, context,
-                                   header->majorVersion, &frame);
-
             if (read == 0 || frame == NULL) {
-                exit = true;
                 break;
             }
 
+            if (verbatim && frame->raw != NULL) {
+                frame->rawOffset = headerSize + pos;
+            }
+
             listInsertBack(frames, frame);
             tagSize = ((tagSize < read) ? 0 : tagSize - read);
-            byteStreamSeek(stream, read, SEEK_CUR);
+            pos = (read < bodyl - pos) ? pos + read : bodyl;
         }
 
-        if (pairs != NULL) {
+        if (pairs != NULL && parser == NULL) {
             hashTableFree(pairs);
         }
 
-        // double loop break
-        if (exit) {
-            break;
+        // only the first tag in the buffer is read
+        break;
+    }
+
+    internal_parserScratchRelease(parser, scratch);
+
+    return id3v2CreateTag(header, frames);
+}
+
+ /**
+ * @brief Parses a complete ID3v2 tag from a byte buffer, including header, optional extended header, and all frames.
+ * @details Orchestrates the full tag parsing workflow by locating the "ID3" identifier, parsing headers, 
+ * processing unsynchronisation if present, and iteratively parsing all frames using a multi-pass context 
+ * resolution strategy. Returns a heap-allocated tag structure containing all successfully parsed components.
+ * 
+ * **Parsing Process:**
+ * 1. Scans buffer to locate "ID3" magic number identifier
+ * 2. Parses tag header (version, flags, size)
+ * 3. If unsynchronisation flag set (v2.2/v2.3): strips $00 bytes following $FF, v2.4 frames are resynchronised individually
+ * 4. If extended header flag set: parses version-specific extended header
+ * 5. Iterates through frame data, parsing each frame using 4-pass context lookup
+ * 
+ * **Frame Context Resolution (4-Pass System):**
+ * - Pass 1: Exact frame ID match in default context mappings (e.g., "TIT2", "APIC")
+ * - Pass 2: Exact frame ID match in user-supplied custom mappings (userPairs parameter)
+ * - Pass 3: Generic frame type patterns - 'T' prefix (text frames), 'W' prefix (URL frames)
+ * - Pass 4: Fallback to generic binary context ('?') for unknown frame types
+ * 
+ * Parsing continues until all frames are extracted or an unrecoverable error occurs. On partial 
+ * failure, returns a tag structure with successfully parsed frames. Returns NULL only on complete 
+ * failure. Caller must free returned structure with id3v2DestroyTag.
+ * 
+ * @param in - Pointer to byte buffer containing ID3v2 tag data (may include non-tag data before/after).
+ * @param inl - Size of input buffer in bytes.
+ * @param userPairs - Optional hash table mapping frame IDs to custom context lists (NULL for default mappings only).
+ * @return Id3v2Tag* - Heap-allocated complete tag structure on success, partial tag on partial failure, or NULL on complete failure.
+ */
+Id3v2Tag *id3v2ParseTagFromBuffer(uint8_t *in, size_t inl, HashTable *userPairs) {
+    return internal_parseTag(in, inl, userPairs, NULL, NULL);
+}
+
+/**
+ * @brief Parses an ID3v2 tag from the contents of a file, leaving the content of pictures and objects in the file.
+ * @details Produces the same tag as id3v2ParseTagFromBuffer except that the picture or object data ending each
+ * APIC, PIC, GEOB, and GEO frame is not copied. Its entry refers to source instead and is read from the file when it
+ * is needed, so the memory the tag takes does not depend on the size of its artwork. Frames that are unsynchronised,
+ * compressed, or encrypted, or in an unsynchronised ID3v2.2/2.3 tag, are not stored as is and are copied as usual.
+ * The file must not be changed while the tag refers to it, other than by writing the tag back with
+ * id3v2WriteTagToFile.
+ * @param in - Pointer to the contents of the file from its first byte.
+ * @param inl - Size of input buffer in bytes.
+ * @param userPairs - Optional hash table mapping frame IDs to custom context lists (NULL for default mappings only).
+ * @param source - File in was read from, see id3v2CreateSource. Every entry left in the file takes a reference.
+ * @return Id3v2Tag* - Heap-allocated complete tag structure on success, partial tag on partial failure, or NULL on complete failure.
+ */
+Id3v2Tag *id3v2ParseTagFromFileBuffer(uint8_t *in, size_t inl, HashTable *userPairs, Id3v2Source *source) {
+    return internal_parseTag(in, inl, userPairs, NULL, source);
+}
+
+/**
+ * @brief Creates a parser that can be reused to parse many ID3v2 tags.
+ * @details Nothing is built up front, the default pairings of a version are created the first time a tag of that
+ * version is parsed and kept until the parser is destroyed. The user pairings are borrowed and must outlive the
+ * parser. Returns NULL on memory allocation failure.
+ * @param userPairs - Optional hash table mapping frame IDs to custom context lists (NULL for default mappings only).
+ * @return Id3v2Parser* - Pointer to the allocated parser, or NULL on failure. Caller must free with id3v2DestroyParser.
+ */
+Id3v2Parser *id3v2CreateParser(HashTable *userPairs) {
+    Id3v2Parser *parser = calloc(1, sizeof(Id3v2Parser));
+
+    if (parser == NULL) {
+        return NULL;
+    }
+
+    parser->userPairs = userPairs;
+
+    return parser;
+}
+
+/**
+ * @brief Frees a parser and sets the pointer to NULL.
+ * @details Tags returned by id3v2ParserParse do not depend on the parser and stay valid. The user pairings given to
+ * id3v2CreateParser are not freed. Safe to call with NULL or with a pointer to NULL.
+ * @param toDelete - Pointer to the parser pointer to free.
+ */
+void id3v2DestroyParser(Id3v2Parser **toDelete) {
+    if (toDelete == NULL || *toDelete == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < sizeof((*toDelete)->pairs) / sizeof((*toDelete)->pairs[0]); i++) {
+        if ((*toDelete)->pairs[i] != NULL) {
+            hashTableFree((*toDelete)->pairs[i]);
+        }
+    }
+
+    free((*toDelete)->scratch);
+    free(*toDelete);
+    *toDelete = NULL;
+}
+
+/**
+ * @brief Parses a complete ID3v2 tag from a byte buffer using a reusable parser.
+ * @details Produces the same tag as id3v2ParseTagFromBuffer given the parser's user pairings, but reuses the
+ * default pairings and resynchronisation buffer kept by the parser. Headers and content are read straight from in,
+ * or from that buffer when a tag or frame has to be resynchronised, and copied only into the tag. Once every version
+ * has been seen and the largest unsynchronised tag or frame has been met, a parse allocates the returned tag and the
+ * strings read into it. Strings are returned allocated by the ByteStream readers that find their terminator and
+ * encoding before they are copied into their entries.
+ * @param parser - Parser to use.
+ * @param in - Pointer to byte buffer containing ID3v2 tag data (may include non-tag data before/after).
+ * @param inl - Size of input buffer in bytes.
+ * @return Id3v2Tag* - Heap-allocated complete tag structure on success, partial tag on partial failure, or NULL on complete failure.
+ */
+Id3v2Tag *id3v2ParserParse(Id3v2Parser *parser, uint8_t *in, size_t inl) {
+    if (parser == NULL) {
+        return NULL;
+    }
+
+    return internal_parseTag(in, inl, parser->userPairs, parser, NULL);
+}
+
+/**
+ * @brief Checks the CRC-32 recorded in the extended header of an ID3v2 tag against its content.
+ * @details Verification is optional and never done by id3v2ParseTagFromBuffer, call this on the same buffer when
+ * the integrity of a tag matters. The tag is located the same way the parser locates it. For ID3v2.3 the checksum
+ * covers the frames after unsynchronisation is removed, excluding the padding recorded in the extended header.
+ * For ID3v2.4 it covers everything between the extended header and the end of the tag, padding included.
+ * @param in - Pointer to byte buffer containing ID3v2 tag data (may include non-tag data before/after).
+ * @param inl - Size of input buffer in bytes.
+ * @return bool - true if the tag has a CRC and it matches, false if it does not match, the tag has no CRC, or
+ * no tag could be read.
+ */
+bool id3v2VerifyTagCrc(uint8_t *in, size_t inl) {
+    if (in == NULL || inl < ID3V2_TAG_ID_SIZE) {
+        return false;
+    }
+
+    Id3v2TagHeader *header = NULL;
+    Id3v2ExtendedTagHeader *ext = NULL;
+    uint8_t *body = NULL;
+    uint8_t *copy = NULL;
+    size_t start = 0;
+    size_t bodyl = 0;
+    uint32_t tagSize = 0;
+    uint32_t read = 0;
+    uint32_t extl = 0;
+    bool ok = false;
+
+    // locate the start of the tag
+    while (start + ID3V2_TAG_ID_SIZE <= inl && memcmp(in + start, "ID3", ID3V2_TAG_ID_SIZE) != 0) {
+        start++;
+    }
+
+    if (start + ID3V2_TAG_ID_SIZE > inl) {
+        return false;
+    }
+
+    read = id3v2ParseTagHeader(in + start, inl - start, &header, &tagSize);
+
+    if (read == 0 || header == NULL || tagSize == 0 || tagSize > inl - start - read ||
+        (header->majorVersion != ID3V2_TAG_VERSION_3 && header->majorVersion != ID3V2_TAG_VERSION_4) ||
+        id3v2ReadExtendedHeaderIndicator(header) != 1) {
+        id3v2DestroyTagHeader(&header);
+        return false;
+    }
+
+    body = in + start + read;
+    bodyl = tagSize;
+
+    // the checksum is taken before unsynchronisation so leave the callers buffer alone
+    if (id3v2ReadUnsynchronisationIndicator(header) == 1 && header->majorVersion == ID3V2_TAG_VERSION_3) {
+        copy = malloc(bodyl);
+
+        if (copy == NULL) {
+            id3v2DestroyTagHeader(&header);
+            return false;
         }
 
-        byteStreamDestroy(stream);
-        return id3v2CreateTag(header, frames);
+        memcpy(copy, body, bodyl);
+        body = copy;
+        bodyl = id3v2Resynchronise(body, bodyl);
     }
 
-    byteStreamDestroy(stream);
-    return id3v2CreateTag(header, frames);
+    extl = id3v2ParseExtendedTagHeader(body, bodyl, header->majorVersion, &ext);
+
+    if (extl > 0 && ext != NULL && ext->crc != 0 && extl <= bodyl) {
+        bodyl -= extl;
+
+        // v2.3 leaves padding out of the checksum
+        if (header->majorVersion == ID3V2_TAG_VERSION_3) {
+            bodyl = (ext->padding <= bodyl) ? bodyl - ext->padding : 0;
+        }
+
+        ok = (bodyl > 0 && id3Crc32(0, body + extl, bodyl) == ext->crc);
+    }
+
+    id3v2DestroyExtendedTagHeader(&ext);
+    id3v2DestroyTagHeader(&header);
+    free(copy);
+
+    return ok;
 }
@@ -737,27 +737,14 @@ uint8_t *id3v2ExtendedTagHeaderSerialize(Id3v2ExtendedTagHeader *ext, uint8_t ve
             byteStreamWriteBit(stream, ext->tagRestrictions, 4);
             byteStreamSeek(stream, 1, SEEK_CUR);
 
-            // crc
+            // crc, a 32 bit value needs 5 syncsafe bytes
             if (ext->crc) {
-                int offset = 0;
-                int toWrite = 0;
-                tmp = sttob(byteSyncintEncode(ext->crc));
-
-                while (offset < sizeof(size_t) && tmp[offset] == 0) {
-                    offset++;
-                }
-
-                // c4c is 5 bytes if the 0s are there they must be kept
-                if (offset > 3) {
-                    offset = 3;
+                for (int k = 0; k < 5; k++) {
+                    crcb[k] = (unsigned char) ((ext->crc >> (7 * (4 - k))) & 0x7F);
                 }
 
-                toWrite = ((int) (sizeof(size_t) - offset) > 5) ? 5 : (int) (sizeof(size_t) - offset);
-                memcpy(crcb, tmp + offset, toWrite);
-
                 byteStreamSeek(stream, 6, SEEK_SET);
                 byteStreamWrite(stream, crcb, 5);
-                free(tmp);
             }
 
             if (ext->tagRestrictions) {
@@ -1072,3 +1059,260 @@ char *id3v2TagHeaderToJSON(const Id3v2TagHeader *header) {
 
     return json;
 }
+
+/**
+ * @brief Builds an ID3v2 extended header from its JSON representation.
+ * @details Reads the object id3v2ExtendedTagHeaderToJSON writes. Members that do not apply to the version are
+ * accepted and ignored by the serializer, unknown members are skipped. Returns NULL for an empty object "{}" and on
+ * failure, check the failed field of the reader to tell them apart.
+ * @param reader - Reader positioned at the extended header object.
+ * @return Id3v2ExtendedTagHeader* - Heap allocated extended header, or NULL. Caller must free with id3v2DestroyExtendedTagHeader.
+ */
+Id3v2ExtendedTagHeader *id3v2ExtendedTagHeaderFromJSONReader(Id3JsonReader *reader) {
+    int64_t padding = 0;
+    int64_t crc = 0;
+    int64_t restrictions = 0;
+    bool update = false;
+    bool tagRestrictions = false;
+    bool members = false;
+
+    if (reader == NULL || !id3JsonBeginObject(reader)) {
+        return NULL;
+    }
+
+    while (id3JsonNextMember(reader)) {
+        members = true;
+
+        if (strcmp(reader->key, "padding") == 0) {
+            (void) id3JsonReadInteger(reader, &padding);
+        } else if (strcmp(reader->key, "crc") == 0) {
+            (void) id3JsonReadInteger(reader, &crc);
+        } else if (strcmp(reader->key, "update") == 0) {
+            (void) id3JsonReadBool(reader, &update);
+        } else if (strcmp(reader->key, "tagRestrictions") == 0) {
+            (void) id3JsonReadBool(reader, &tagRestrictions);
+        } else if (strcmp(reader->key, "restrictions") == 0) {
+            (void) id3JsonReadInteger(reader, &restrictions);
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !members) {
+        return NULL;
+    }
+
+    if (padding < 0 || padding > UINT32_MAX || crc < 0 || crc > UINT32_MAX || restrictions < 0 ||
+        restrictions > UINT8_MAX) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return id3v2CreateExtendedTagHeader((uint32_t) padding, (uint32_t) crc, update, tagRestrictions,
+                                        (uint8_t) restrictions);
+}
+
+/**
+ * @brief Builds an ID3v2 tag header from its JSON representation.
+ * @details Reads the object id3v2TagHeaderToJSON writes, including the extended header when one is present. The
+ * flags are taken as written. Returns NULL for an empty object "{}", for an unsupported version, and on failure.
+ * @param reader - Reader positioned at the header object.
+ * @return Id3v2TagHeader* - Heap allocated tag header, or NULL. Caller must free with id3v2DestroyTagHeader.
+ */
+Id3v2TagHeader *id3v2TagHeaderFromJSONReader(Id3JsonReader *reader) {
+    Id3v2ExtendedTagHeader *ext = NULL;
+    Id3v2TagHeader *header = NULL;
+    int64_t major = -1;
+    int64_t minor = 0;
+    int64_t flags = 0;
+
+    if (reader == NULL || !id3JsonBeginObject(reader)) {
+        return NULL;
+    }
+
+    while (id3JsonNextMember(reader)) {
+        if (strcmp(reader->key, "major") == 0) {
+            (void) id3JsonReadInteger(reader, &major);
+        } else if (strcmp(reader->key, "minor") == 0) {
+            (void) id3JsonReadInteger(reader, &minor);
+        } else if (strcmp(reader->key, "flags") == 0) {
+            (void) id3JsonReadInteger(reader, &flags);
+        } else if (strcmp(reader->key, "extended") == 0 && ext == NULL) {
+            ext = id3v2ExtendedTagHeaderFromJSONReader(reader);
+        } else {
+            (void) id3JsonSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || major < ID3V2_TAG_VERSION_2 || major > ID3V2_TAG_VERSION_4 || minor < 0 ||
+        minor > UINT8_MAX || flags < 0 || flags > UINT8_MAX) {
+        id3v2DestroyExtendedTagHeader(&ext);
+        return NULL;
+    }
+
+    header = id3v2CreateTagHeader((uint8_t) major, (uint8_t) minor, (uint8_t) flags, ext);
+
+    if (header == NULL) {
+        id3v2DestroyExtendedTagHeader(&ext);
+    }
+
+    return header;
+}
+
+/**
+ * @brief Writes the CBOR representation of an ID3v2 extended header into a sink.
+ * @details Writes a map with the same members id3v2ExtendedTagHeaderToJSON writes for the version, numbers as
+ * unsigned integers and flags as booleans. A NULL header, ID3v2.2, and unsupported versions write an empty map.
+ * @param ext - Extended header to convert, may be NULL.
+ * @param version - ID3v2 version deciding which members are written.
+ * @param sink - Sink receiving the CBOR.
+ * @return int - 1 (true) if the CBOR was written, 0 (false) on failure.
+ */
+int id3v2ExtendedTagHeaderToCBORSink(const Id3v2ExtendedTagHeader *ext, uint8_t version, Id3Sink *sink) {
+    if (ext == NULL || (version != ID3V2_TAG_VERSION_3 && version != ID3V2_TAG_VERSION_4)) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    (void) id3CborWriteMap(sink, (version == ID3V2_TAG_VERSION_4) ? 5 : 2);
+    (void) id3CborWriteString(sink, "padding");
+    (void) id3CborWriteUnsigned(sink, ext->padding);
+    (void) id3CborWriteString(sink, "crc");
+
+    if (version == ID3V2_TAG_VERSION_3) {
+        return id3CborWriteUnsigned(sink, ext->crc);
+    }
+
+    (void) id3CborWriteUnsigned(sink, ext->crc);
+    (void) id3CborWriteString(sink, "update");
+    (void) id3CborWriteBool(sink, ext->update);
+    (void) id3CborWriteString(sink, "tagRestrictions");
+    (void) id3CborWriteBool(sink, ext->tagRestrictions);
+    (void) id3CborWriteString(sink, "restrictions");
+    return id3CborWriteUnsigned(sink, ext->restrictions);
+}
+
+/**
+ * @brief Writes the CBOR representation of an ID3v2 tag header into a sink.
+ * @details Writes a map with the same members id3v2TagHeaderToJSON writes: major, minor, and flags, plus the
+ * extended header for ID3v2.3 and ID3v2.4. A NULL header or unsupported version writes an empty map.
+ * @param header - Tag header to convert, may be NULL.
+ * @param sink - Sink receiving the CBOR.
+ * @return int - 1 (true) if the CBOR was written, 0 (false) on failure.
+ */
+int id3v2TagHeaderToCBORSink(const Id3v2TagHeader *header, Id3Sink *sink) {
+    if (header == NULL || header->majorVersion < ID3V2_TAG_VERSION_2 || header->majorVersion > ID3V2_TAG_VERSION_4) {
+        return id3CborWriteMap(sink, 0);
+    }
+
+    (void) id3CborWriteMap(sink, (header->majorVersion == ID3V2_TAG_VERSION_2) ? 3 : 4);
+    (void) id3CborWriteString(sink, "major");
+    (void) id3CborWriteUnsigned(sink, header->majorVersion);
+    (void) id3CborWriteString(sink, "minor");
+    (void) id3CborWriteUnsigned(sink, header->minorVersion);
+    (void) id3CborWriteString(sink, "flags");
+
+    if (header->majorVersion == ID3V2_TAG_VERSION_2) {
+        return id3CborWriteUnsigned(sink, header->flags);
+    }
+
+    (void) id3CborWriteUnsigned(sink, header->flags);
+    (void) id3CborWriteString(sink, "extended");
+    return id3v2ExtendedTagHeaderToCBORSink(header->extendedHeader, header->majorVersion, sink);
+}
+
+/**
+ * @brief Builds an ID3v2 extended header from its CBOR representation.
+ * @details Reads the map id3v2ExtendedTagHeaderToCBORSink writes, see id3v2ExtendedTagHeaderFromJSONReader. Returns
+ * NULL for an empty map and on failure, check the failed field of the reader to tell them apart.
+ * @param reader - Reader positioned at the extended header map.
+ * @return Id3v2ExtendedTagHeader* - Heap allocated extended header, or NULL. Caller must free with id3v2DestroyExtendedTagHeader.
+ */
+Id3v2ExtendedTagHeader *id3v2ExtendedTagHeaderFromCBORReader(Id3CborReader *reader) {
+    uint64_t padding = 0;
+    uint64_t crc = 0;
+    uint64_t restrictions = 0;
+    bool update = false;
+    bool tagRestrictions = false;
+    bool members = false;
+
+    if (reader == NULL || !id3CborBeginMap(reader)) {
+        return NULL;
+    }
+
+    while (id3CborNextMember(reader)) {
+        members = true;
+
+        if (strcmp(reader->key, "padding") == 0) {
+            (void) id3CborReadUnsigned(reader, &padding);
+        } else if (strcmp(reader->key, "crc") == 0) {
+            (void) id3CborReadUnsigned(reader, &crc);
+        } else if (strcmp(reader->key, "update") == 0) {
+            (void) id3CborReadBool(reader, &update);
+        } else if (strcmp(reader->key, "tagRestrictions") == 0) {
+            (void) id3CborReadBool(reader, &tagRestrictions);
+        } else if (strcmp(reader->key, "restrictions") == 0) {
+            (void) id3CborReadUnsigned(reader, &restrictions);
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || !members) {
+        return NULL;
+    }
+
+    if (padding > UINT32_MAX || crc > UINT32_MAX || restrictions > UINT8_MAX) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    return id3v2CreateExtendedTagHeader((uint32_t) padding, (uint32_t) crc, update, tagRestrictions,
+                                        (uint8_t) restrictions);
+}
+
+/**
+ * @brief Builds an ID3v2 tag header from its CBOR representation.
+ * @details Reads the map id3v2TagHeaderToCBORSink writes, see id3v2TagHeaderFromJSONReader. Returns NULL for an
+ * empty map, for an unsupported version, and on failure.
+ * @param reader - Reader positioned at the header map.
+ * @return Id3v2TagHeader* - Heap allocated tag header, or NULL. Caller must free with id3v2DestroyTagHeader.
+ */
+Id3v2TagHeader *id3v2TagHeaderFromCBORReader(Id3CborReader *reader) {
+    Id3v2ExtendedTagHeader *ext = NULL;
+    Id3v2TagHeader *header = NULL;
+    uint64_t major = 0;
+    uint64_t minor = 0;
+    uint64_t flags = 0;
+
+    if (reader == NULL || !id3CborBeginMap(reader)) {
+        return NULL;
+    }
+
+    while (id3CborNextMember(reader)) {
+        if (strcmp(reader->key, "major") == 0) {
+            (void) id3CborReadUnsigned(reader, &major);
+        } else if (strcmp(reader->key, "minor") == 0) {
+            (void) id3CborReadUnsigned(reader, &minor);
+        } else if (strcmp(reader->key, "flags") == 0) {
+            (void) id3CborReadUnsigned(reader, &flags);
+        } else if (strcmp(reader->key, "extended") == 0 && ext == NULL) {
+            ext = id3v2ExtendedTagHeaderFromCBORReader(reader);
+        } else {
+            (void) id3CborSkipValue(reader);
+        }
+    }
+
+    if (reader->failed || major < ID3V2_TAG_VERSION_2 || major > ID3V2_TAG_VERSION_4 || minor > UINT8_MAX ||
+        flags > UINT8_MAX) {
+        id3v2DestroyExtendedTagHeader(&ext);
+        return NULL;
+    }
+
+    header = id3v2CreateTagHeader((uint8_t) major, (uint8_t) minor, (uint8_t) flags, ext);
+
+    if (header == NULL) {
+        id3v2DestroyExtendedTagHeader(&ext);
+    }
+
+    return header;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file id3v2Unsynchronisation.c
+ * @author Ewan Jones
+ * @brief Function implementations for applying and removing the ID3v2 unsynchronisation scheme
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "id3v2/id3v2Unsynchronisation.h"
+
+// internal function ------------------------------------------------------------------------
+static bool internal_id3v2NeedsStuffing(const uint8_t *in, size_t inl, size_t i, const uint8_t *next) {
+    uint8_t after = 0;
+
+    // data followed by the end of the tag or padding always needs it
+    if (i + 1 == inl) {
+        if (next == NULL) {
+            return true;
+        }
+
+        after = *next;
+    } else {
+        after = in[i + 1];
+    }
+
+    return (after >= ID3V2_UNSYNC_SYNC_MIN || after == 0x00);
+}
+
+/**
+ * @brief Calculates the size of a buffer once unsynchronisation is applied.
+ * @details Counts every $FF byte followed by %111xxxxx or $00, each of which gains a $00 stuffing byte.
+ * Scanning jumps from one $FF to the next with memchr so runs without one are skipped a machine word or
+ * vector at a time.
+ * @param in - Bytes to be unsynchronised.
+ * @param inl - Number of bytes in in.
+ * @param next - Byte written directly after in, or NULL when in is followed by padding or the end of the tag.
+ * @return size_t - Size in bytes of the unsynchronised data, 0 if in is NULL or empty.
+ */
+size_t id3v2UnsynchronisedSize(const uint8_t *in, size_t inl, const uint8_t *next) {
+    if (in == NULL || inl == 0) {
+        return 0;
+    }
+
+    size_t size = inl;
+    size_t i = 0;
+    const uint8_t *hit = NULL;
+
+    while (i < inl && (hit = memchr(in + i, ID3V2_UNSYNC_MARKER, inl - i)) != NULL) {
+        i = (size_t) (hit - in);
+
+        if (internal_id3v2NeedsStuffing(in, inl, i, next)) {
+            size++;
+        }
+
+        i++;
+    }
+
+    return size;
+}
+
+/**
+ * @brief Applies unsynchronisation to a buffer.
+ * @details Inserts a $00 after every $FF that is followed by %111xxxxx or $00 and leaves every other byte untouched,
+ * as described in section 6.1 of the ID3v2.4 structure document. The output is sized exactly with
+ * id3v2UnsynchronisedSize and filled in a single pass that copies the bytes between markers with memcpy. A trailing
+ * $FF is stuffed when next is NULL so padding following the data is not mistaken for part of it.
+ * Returns NULL and sets outl to 0 if in is NULL, inl is 0, or memory allocation fails.
+ * @param in - Bytes to unsynchronise.
+ * @param inl - Number of bytes in in.
+ * @param next - Byte written directly after in, or NULL when in is followed by padding or the end of the tag.
+ * @param outl - Receives the size of the returned buffer.
+ * @return uint8_t* - Heap allocated unsynchronised data. Caller must free.
+ */
+uint8_t *id3v2Unsynchronise(const uint8_t *in, size_t inl, const uint8_t *next, size_t *outl) {
+    size_t size = id3v2UnsynchronisedSize(in, inl, next);
+    uint8_t *out = NULL;
+    size_t i = 0;
+    size_t o = 0;
+    const uint8_t *hit = NULL;
+
+    if (size == 0 || (out = malloc(size)) == NULL) {
+        *outl = 0;
+        return NULL;
+    }
+
+    while (i < inl && (hit = memchr(in + i, ID3V2_UNSYNC_MARKER, inl - i)) != NULL) {
+        size_t run = (size_t) (hit - (in + i)) + 1;
+
+        memcpy(out + o, in + i, run);
+        o += run;
+        i += run;
+
+        if (internal_id3v2NeedsStuffing(in, inl, i - 1, next)) {
+            out[o++] = 0x00;
+        }
+    }
+
+    memcpy(out + o, in + i, inl - i);
+
+    *outl = size;
+    return out;
+}
+
+/**
+ * @brief Removes unsynchronisation from a buffer in place.
+ * @details Drops every $00 that directly follows a $FF, reversing id3v2Unsynchronise. Bytes are only moved once
+ * the first stuffing byte is found so data without any is left as is.
+ * @param buffer - Unsynchronised bytes, overwritten with the original data.
+ * @param length - Number of bytes in buffer.
+ * @return size_t - Number of bytes of original data now at the start of buffer.
+ */
+size_t id3v2Resynchronise(uint8_t *buffer, size_t length) {
+    if (buffer == NULL || length == 0) {
+        return 0;
+    }
+
+    size_t i = 0;
+    size_t o = 0;
+    uint8_t *hit = NULL;
+
+    while (i < length && (hit = memchr(buffer + i, ID3V2_UNSYNC_MARKER, length - i)) != NULL) {
+        size_t run = (size_t) (hit - (buffer + i)) + 1;
+
+        if (o != i) {
+            memmove(buffer + o, buffer + i, run);
+        }
+
+        o += run;
+        i += run;
+
+        if (i < length && buffer[i] == 0x00) {
+            i++;
+        }
+    }
+
+    if (o != i) {
+        memmove(buffer + o, buffer + i, length - i);
+    }
+
+    return o + (length - i);
+}
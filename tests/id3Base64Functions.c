@@ -0,0 +1,139 @@
+/**
+ * @file id3Base64Functions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Base64.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Base64.h"
+
+static void id3Base64Encode_rfc4648(void **state) {
+    (void) state;
+    const char *input[] = {"f", "fo", "foo", "foob", "fooba", "foobar"};
+    const char *expected[] = {"Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    char out[16];
+
+    for (size_t i = 0; i < sizeof(input) / sizeof(input[0]); i++) {
+        size_t n = id3Base64Encode((const uint8_t *) input[i], strlen(input[i]), out);
+
+        assert_int_equal(n, strlen(expected[i]));
+        assert_int_equal(n, id3Base64EncodedSize(strlen(input[i])));
+        assert_memory_equal(out, expected[i], n);
+    }
+}
+
+static void id3Base64Encode_empty(void **state) {
+    (void) state;
+    char out[4] = {0};
+
+    assert_int_equal(id3Base64Encode(NULL, 0, out), 0);
+    assert_int_equal(id3Base64Encode((const uint8_t *) "a", 0, out), 0);
+    assert_int_equal(id3Base64EncodedSize(0), 0);
+}
+
+static void id3Base64Encode_pieces(void **state) {
+    (void) state;
+    uint8_t data[600];
+    char whole[800];
+    char piece[800];
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i * 97 + 13);
+    }
+
+    // every length takes a mix of the vector and scalar paths, groups of 3 must encode the same on their own
+    for (size_t length = 1; length <= sizeof(data); length++) {
+        size_t n = id3Base64Encode(data, length, whole);
+        size_t o = 0;
+
+        assert_int_equal(n, id3Base64EncodedSize(length));
+
+        for (size_t i = 0; i < length; i += 3) {
+            o += id3Base64Encode(data + i, (length - i < 3) ? length - i : 3, piece + o);
+        }
+
+        assert_int_equal(o, n);
+        assert_memory_equal(whole, piece, n);
+    }
+}
+
+static void id3Base64Decode_rfc4648(void **state) {
+    (void) state;
+    const char *input[] = {"Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    const char *expected[] = {"f", "fo", "foo", "foob", "fooba", "foobar"};
+    uint8_t out[16];
+
+    for (size_t i = 0; i < sizeof(input) / sizeof(input[0]); i++) {
+        size_t n = 0;
+
+        assert_true(id3Base64Decode(input[i], strlen(input[i]), out, &n));
+        assert_int_equal(n, strlen(expected[i]));
+        assert_true(n <= id3Base64DecodedSize(strlen(input[i])));
+        assert_memory_equal(out, expected[i], n);
+    }
+}
+
+static void id3Base64Decode_invalid(void **state) {
+    (void) state;
+    uint8_t out[16];
+    size_t n = 0;
+
+    assert_false(id3Base64Decode("Zm9", 3, out, &n));
+    assert_false(id3Base64Decode("Zm9*", 4, out, &n));
+    assert_false(id3Base64Decode("Z===", 4, out, &n));
+    assert_false(id3Base64Decode("Zg==Zg==", 8, out, &n));
+    assert_false(id3Base64Decode(NULL, 4, out, &n));
+
+    assert_true(id3Base64Decode("", 0, out, &n));
+    assert_int_equal(n, 0);
+}
+
+static void id3Base64Decode_roundTrip(void **state) {
+    (void) state;
+    uint8_t data[600];
+    uint8_t back[600];
+    char text[800];
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i * 31 + 7);
+    }
+
+    for (size_t length = 0; length <= sizeof(data); length++) {
+        size_t n = id3Base64Encode(data, length, text);
+        size_t o = 0;
+
+        assert_true(id3Base64Decode(text, n, back, &o));
+        assert_int_equal(o, length);
+        assert_memory_equal(back, data, length);
+
+        // decoding in place must give the same bytes
+        assert_true(id3Base64Decode(text, n, (uint8_t *) text, &o));
+        assert_int_equal(o, length);
+        assert_memory_equal(text, data, length);
+    }
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3Base64Encode
+        cmocka_unit_test(id3Base64Encode_rfc4648),
+        cmocka_unit_test(id3Base64Encode_empty),
+        cmocka_unit_test(id3Base64Encode_pieces),
+
+        // id3Base64Decode
+        cmocka_unit_test(id3Base64Decode_rfc4648),
+        cmocka_unit_test(id3Base64Decode_invalid),
+        cmocka_unit_test(id3Base64Decode_roundTrip),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,264 @@
+/**
+ * @file id3CborFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Cbor.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Cbor.h"
+
+static void id3CborWriteUnsigned_rfc8949(void **state) {
+    (void) state;
+    const uint64_t values[] = {0, 23, 24, 100, 1000, 1000000, 1000000000000ULL};
+    const char *expected[] = {
+        "\x00", "\x17", "\x18\x18", "\x18\x64", "\x19\x03\xe8", "\x1a\x00\x0f\x42\x40",
+        "\x1b\x00\x00\x00\xe8\xd4\xa5\x10\x00"
+    };
+    const size_t sizes[] = {1, 1, 2, 2, 3, 5, 9};
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        Id3Sink *sink = id3SinkCreateBuffer(16);
+        size_t length = 0;
+        const uint8_t *out = NULL;
+
+        assert_true(id3CborWriteUnsigned(sink, values[i]));
+
+        out = id3SinkBuffer(sink, &length);
+        assert_int_equal(length, sizes[i]);
+        assert_memory_equal(out, expected[i], sizes[i]);
+
+        id3SinkDestroy(&sink);
+    }
+}
+
+static void id3CborWrite_items(void **state) {
+    (void) state;
+    const uint8_t expected[] = {
+        0xa3, 0x61, 'a', 0xf5, 0x61, 'b', 0x43, 0x01, 0x02, 0x03, 0x61, 'c', 0x9f, 0xfa, 0x3f, 0xc0, 0x00, 0x00, 0x60,
+        0xff
+    };
+    const uint8_t bytes[] = {1, 2, 3};
+    Id3Sink *sink = id3SinkCreateBuffer(16);
+    const uint8_t *out = NULL;
+    size_t length = 0;
+
+    assert_true(id3CborWriteMap(sink, 3));
+    assert_true(id3CborWriteString(sink, "a"));
+    assert_true(id3CborWriteBool(sink, true));
+    assert_true(id3CborWriteString(sink, "b"));
+    assert_true(id3CborWriteBytes(sink, bytes, sizeof(bytes)));
+    assert_true(id3CborWriteString(sink, "c"));
+    assert_true(id3CborWriteArrayStart(sink));
+    assert_true(id3CborWriteFloat(sink, 1.5f));
+    assert_true(id3CborWriteText(sink, NULL, 0));
+    assert_true(id3CborWriteBreak(sink));
+
+    out = id3SinkBuffer(sink, &length);
+    assert_int_equal(length, sizeof(expected));
+    assert_memory_equal(out, expected, sizeof(expected));
+
+    assert_false(id3CborWriteBytes(sink, NULL, 1));
+    assert_false(id3CborWriteUnsigned(NULL, 1));
+
+    id3SinkDestroy(&sink);
+}
+
+static void id3CborReader_walk(void **state) {
+    (void) state;
+    const uint8_t cbor[] = {
+        0xa4, 0x61, 'a', 0x19, 0x03, 0xe8, 0x61, 'b', 0x42, 0xde, 0xad, 0x61, 'c', 0x9f, 0xf4, 0xfa, 0x3f, 0xc0, 0x00,
+        0x00, 0xff, 0x64, 's', 'k', 'i', 'p', 0x82, 0xa1, 0x61, 'x', 0xf6, 0xc1, 0x00
+    };
+    Id3CborReader *reader = id3CborReaderCreate(cbor, sizeof(cbor));
+    uint64_t n = 0;
+    bool b = true;
+    float f = 0;
+    size_t length = 0;
+    const uint8_t *data = NULL;
+
+    assert_true(id3CborBeginMap(reader));
+
+    assert_true(id3CborNextMember(reader));
+    assert_string_equal(reader->key, "a");
+    assert_true(id3CborReadUnsigned(reader, &n));
+    assert_int_equal(n, 1000);
+
+    assert_true(id3CborNextMember(reader));
+    assert_string_equal(reader->key, "b");
+    data = id3CborReadBytes(reader, &length);
+    assert_non_null(data);
+    assert_int_equal(length, 2);
+    assert_memory_equal(data, "\xde\xad", 2);
+
+    assert_true(id3CborNextMember(reader));
+    assert_string_equal(reader->key, "c");
+    assert_true(id3CborBeginArray(reader));
+    assert_true(id3CborNextElement(reader));
+    assert_true(id3CborReadBool(reader, &b));
+    assert_false(b);
+    assert_true(id3CborNextElement(reader));
+    assert_true(id3CborReadFloat(reader, &f));
+    assert_true(f == 1.5f);
+    assert_false(id3CborNextElement(reader));
+
+    assert_true(id3CborNextMember(reader));
+    assert_string_equal(reader->key, "skip");
+    assert_true(id3CborSkipValue(reader));
+
+    assert_false(id3CborNextMember(reader));
+    assert_false(reader->failed);
+    assert_true(id3CborReaderFinished(reader));
+
+    id3CborReaderDestroy(&reader);
+    assert_null(reader);
+}
+
+static void id3CborReader_roundTrip(void **state) {
+    (void) state;
+    Id3Sink *sink = id3SinkCreateBuffer(16);
+    Id3CborReader *reader = NULL;
+    const uint8_t *out = NULL;
+    const char *text = NULL;
+    size_t length = 0;
+    uint64_t n = 0;
+    uint8_t big[300];
+
+    for (size_t i = 0; i < sizeof(big); i++) {
+        big[i] = (uint8_t) i;
+    }
+
+    assert_true(id3CborWriteArray(sink, 3));
+    assert_true(id3CborWriteUnsigned(sink, UINT64_MAX));
+    assert_true(id3CborWriteBytes(sink, big, sizeof(big)));
+    assert_true(id3CborWriteString(sink, "caf\xc3\xa9"));
+
+    out = id3SinkBuffer(sink, &length);
+    reader = id3CborReaderCreate(out, length);
+
+    assert_true(id3CborBeginArray(reader));
+    assert_true(id3CborNextElement(reader));
+    assert_true(id3CborReadUnsigned(reader, &n));
+    assert_true(n == UINT64_MAX);
+    assert_true(id3CborNextElement(reader));
+    assert_memory_equal(id3CborReadBytes(reader, &length), big, sizeof(big));
+    assert_int_equal(length, sizeof(big));
+    assert_true(id3CborNextElement(reader));
+    text = id3CborReadText(reader, &length);
+    assert_int_equal(length, 5);
+    assert_memory_equal(text, "caf\xc3\xa9", 5);
+    assert_false(id3CborNextElement(reader));
+    assert_true(id3CborReaderFinished(reader));
+
+    id3CborReaderDestroy(&reader);
+    id3SinkDestroy(&sink);
+}
+
+static void id3CborReader_invalid(void **state) {
+    (void) state;
+    // truncated argument, string longer than the document, reserved additional information, stray break,
+    // indefinite string, map count larger than the document
+    const uint8_t *inputs[] = {
+        (const uint8_t *) "\x19\x03", (const uint8_t *) "\x45\x01", (const uint8_t *) "\x1c",
+        (const uint8_t *) "\xff", (const uint8_t *) "\x5f\x41\x00\xff", (const uint8_t *) "\xb8\xff"
+    };
+    const size_t sizes[] = {2, 2, 1, 1, 4, 2};
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        Id3CborReader *reader = id3CborReaderCreate(inputs[i], sizes[i]);
+
+        assert_false(id3CborSkipValue(reader));
+        assert_true(reader->failed);
+        assert_false(id3CborReaderFinished(reader));
+
+        id3CborReaderDestroy(&reader);
+    }
+}
+
+static void id3CborReader_wrongType(void **state) {
+    (void) state;
+    const uint8_t cbor[] = {0x61, 'a'};
+    Id3CborReader *reader = id3CborReaderCreate(cbor, sizeof(cbor));
+    uint64_t n = 0;
+    size_t length = 0;
+
+    assert_false(id3CborReadUnsigned(reader, &n));
+    assert_true(reader->failed);
+    assert_null(id3CborReadText(reader, &length));
+
+    id3CborReaderDestroy(&reader);
+
+    reader = id3CborReaderCreate(cbor, sizeof(cbor));
+    assert_null(id3CborReadBytes(reader, &length));
+    id3CborReaderDestroy(&reader);
+
+    assert_null(id3CborReaderCreate(NULL, 1));
+}
+
+static void id3CborSkipValue_depth(void **state) {
+    (void) state;
+    uint8_t cbor[ID3_CBOR_MAX_DEPTH + 2];
+    Id3CborReader *reader = NULL;
+
+    memset(cbor, 0x81, sizeof(cbor));
+    cbor[sizeof(cbor) - 1] = 0x00;
+
+    // one array more than allowed
+    reader = id3CborReaderCreate(cbor, sizeof(cbor));
+    assert_false(id3CborSkipValue(reader));
+    id3CborReaderDestroy(&reader);
+
+    reader = id3CborReaderCreate(cbor + 1, sizeof(cbor) - 1);
+    assert_true(id3CborSkipValue(reader));
+    assert_true(id3CborReaderFinished(reader));
+    id3CborReaderDestroy(&reader);
+}
+
+static void id3CborSkipValue_tags(void **state) {
+    (void) state;
+    size_t length = 300000;
+    uint8_t *cbor = malloc(length + 1);
+    Id3CborReader *reader = NULL;
+
+    assert_non_null(cbor);
+    memset(cbor, 0xC6, length);
+    cbor[length] = 0x00;
+
+    // tags on nothing
+    reader = id3CborReaderCreate(cbor, length);
+    assert_false(id3CborSkipValue(reader));
+    id3CborReaderDestroy(&reader);
+
+    reader = id3CborReaderCreate(cbor, length + 1);
+    assert_true(id3CborSkipValue(reader));
+    assert_true(id3CborReaderFinished(reader));
+    id3CborReaderDestroy(&reader);
+
+    free(cbor);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // writing
+        cmocka_unit_test(id3CborWriteUnsigned_rfc8949),
+        cmocka_unit_test(id3CborWrite_items),
+
+        // reading
+        cmocka_unit_test(id3CborReader_walk),
+        cmocka_unit_test(id3CborReader_roundTrip),
+        cmocka_unit_test(id3CborReader_invalid),
+        cmocka_unit_test(id3CborReader_wrongType),
+        cmocka_unit_test(id3CborSkipValue_depth),
+        cmocka_unit_test(id3CborSkipValue_tags),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file id3Crc32Functions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Crc32.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Crc32.h"
+
+static void id3Crc32_checkValue(void **state) {
+    (void) state;
+
+    // standard check value for CRC-32
+    assert_int_equal(id3Crc32(0, (const uint8_t *) "123456789", 9), 0xCBF43926);
+}
+
+static void id3Crc32_empty(void **state) {
+    (void) state;
+
+    assert_int_equal(id3Crc32(0, NULL, 0), 0);
+    assert_int_equal(id3Crc32(0x1234, NULL, 10), 0x1234);
+}
+
+static void id3Crc32_pieces(void **state) {
+    (void) state;
+    uint8_t data[1000];
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i * 31 + 7);
+    }
+
+    // every split takes a mix of the table and the accelerated path
+    uint32_t whole = id3Crc32(0, data, sizeof(data));
+
+    for (size_t split = 0; split <= sizeof(data); split += 37) {
+        uint32_t crc = id3Crc32(0, data, split);
+        assert_int_equal(id3Crc32(crc, data + split, sizeof(data) - split), whole);
+    }
+}
+
+static void id3Crc32_table(void **state) {
+    (void) state;
+    uint8_t data[300];
+    uint32_t expected = 0;
+
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t) (i ^ 0xA5);
+    }
+
+    // byte at a time reference
+    for (size_t i = 0; i < sizeof(data); i++) {
+        expected = id3Crc32(expected, data + i, 1);
+    }
+
+    assert_int_equal(id3Crc32(0, data, sizeof(data)), expected);
+}
+
+static void id3Crc32Zeros_matchesBuffer(void **state) {
+    (void) state;
+    uint8_t *zeros = calloc(10000, 1);
+    uint32_t crc = id3Crc32(0, (const uint8_t *) "padding", 7);
+
+    assert_non_null(zeros);
+    assert_int_equal(id3Crc32Zeros(crc, 10000), id3Crc32(crc, zeros, 10000));
+    assert_int_equal(id3Crc32Zeros(crc, 0), crc);
+
+    free(zeros);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3Crc32
+        cmocka_unit_test(id3Crc32_checkValue),
+        cmocka_unit_test(id3Crc32_empty),
+        cmocka_unit_test(id3Crc32_pieces),
+        cmocka_unit_test(id3Crc32_table),
+
+        // id3Crc32Zeros
+        cmocka_unit_test(id3Crc32Zeros_matchesBuffer),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,331 @@
+/**
+ * @file id3FileFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3File.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3File.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+static void id3FileOpen_noFile(void **state) {
+    (void) state;
+
+    assert_int_equal(id3FileOpen(NULL, false), -1);
+    assert_int_equal(id3FileOpen("assets/doesNotExist.mp3", false), -1);
+}
+
+static void id3FileSize_sorry4dying(void **state) {
+    (void) state;
+
+    uint64_t size = 0;
+    int fd = id3FileOpen("assets/sorry4dying.mp3", false);
+
+    assert_true(fd >= 0);
+    assert_true(id3FileSize(fd, &size));
+    assert_int_equal(size, 3099209);
+
+    id3FileClose(fd);
+}
+
+static void id3FileIdentify_paths(void **state) {
+    (void) state;
+
+    Id3FileIdentity a;
+    Id3FileIdentity b;
+    Id3FileIdentity c;
+    int fd = id3FileOpen("assets/sorry4dying.mp3", false);
+    int other = id3FileOpen("./assets/../assets/sorry4dying.mp3", false);
+    int different = id3FileOpen("assets/OnGP.mp3", false);
+
+    assert_true(id3FileIdentify(fd, &a));
+    assert_true(id3FileIdentify(other, &b));
+    assert_true(id3FileIdentify(different, &c));
+    assert_false(id3FileIdentify(-1, &a));
+
+    assert_true(a.device == b.device && a.inode == b.inode);
+    assert_true(a.size == 3099209 && a.modified == b.modified);
+    assert_true(a.size != c.size);
+
+    id3FileClose(fd);
+    id3FileClose(other);
+    id3FileClose(different);
+}
+
+static void id3FileReadAt_header(void **state) {
+    (void) state;
+
+    uint8_t bytes[3] = {0};
+    int fd = id3FileOpen("assets/sorry4dying.mp3", false);
+
+    assert_true(fd >= 0);
+    assert_true(id3FileReadAt(fd, bytes, 3, 0));
+    assert_memory_equal(bytes, "ID3", 3);
+
+    // past the end of the file
+    assert_false(id3FileReadAt(fd, bytes, 3, 3099208));
+
+    id3FileClose(fd);
+}
+
+static void id3FileRewrite_headRangeTail(void **state) {
+    (void) state;
+
+    uint8_t bytes[16] = {0};
+    uint64_t size = 0;
+    FILE *fp = fopen("assets/tmp", "wb");
+    int fd = -1;
+
+    assert_non_null(fp);
+    (void) fwrite("0123456789", 1, 10, fp);
+    (void) fclose(fp);
+
+    fd = id3FileOpen("assets/tmp", false);
+    assert_true(fd >= 0);
+    assert_true(id3FileRewrite("assets/tmp", fd, (const uint8_t *) "head", 4, 2, 8, (const uint8_t *) "tail", 4));
+    id3FileClose(fd);
+
+    fd = id3FileOpen("assets/tmp", false);
+    assert_true(fd >= 0);
+    assert_true(id3FileSize(fd, &size));
+    assert_int_equal(size, 14);
+    assert_true(id3FileReadAt(fd, bytes, 14, 0));
+    assert_memory_equal(bytes, "head234567tail", 14);
+    id3FileClose(fd);
+
+    (void) remove("assets/tmp");
+}
+
+static void id3FileRewrite_noFile(void **state) {
+    (void) state;
+
+    assert_false(id3FileRewrite("assets/doesNotExist.mp3", -1, NULL, 0, 0, 0, NULL, 0));
+    assert_false(id3FileRewrite(NULL, -1, NULL, 0, 0, 0, NULL, 0));
+}
+
+#if !defined(_WIN32)
+static void id3FileRewrite_links(void **state) {
+    (void) state;
+
+    uint8_t bytes[16] = {0};
+    struct stat st;
+    FILE *fp = fopen("assets/tmp", "wb");
+    int fd = -1;
+
+    assert_non_null(fp);
+    (void) fwrite("0123456789", 1, 10, fp);
+    (void) fclose(fp);
+
+    (void) remove("assets/tmpLink");
+    (void) remove("assets/tmpHard");
+    assert_int_equal(symlink("tmp", "assets/tmpLink"), 0);
+    assert_int_equal(link("assets/tmp", "assets/tmpHard"), 0);
+
+    // rewritten through the symbolic link, every name sees the new content
+    fd = id3FileOpen("assets/tmpLink", false);
+    assert_true(fd >= 0);
+    assert_true(id3FileRewrite("assets/tmpLink", fd, (const uint8_t *) "head", 4, 2, 8, NULL, 0));
+    id3FileClose(fd);
+
+    assert_int_equal(lstat("assets/tmpLink", &st), 0);
+    assert_true(S_ISLNK(st.st_mode));
+    assert_int_equal(stat("assets/tmp", &st), 0);
+    assert_int_equal(st.st_nlink, 2);
+    assert_int_equal(st.st_size, 10);
+
+    fd = id3FileOpen("assets/tmpHard", false);
+    assert_true(fd >= 0);
+    assert_true(id3FileReadAt(fd, bytes, 10, 0));
+    assert_memory_equal(bytes, "head234567", 10);
+    id3FileClose(fd);
+
+    (void) remove("assets/tmpLink");
+    (void) remove("assets/tmpHard");
+    (void) remove("assets/tmp");
+}
+#endif
+
+static void id3FileCopyRange_large(void **state) {
+    (void) state;
+
+    uint8_t bytes[10] = {0};
+    uint8_t expected[10] = {0};
+    uint64_t size = 0;
+    uint64_t copied = 0;
+    FILE *fp = fopen("assets/tmp", "wb");
+    int in = id3FileOpen("assets/OnGP.mp3", false);
+    int out = -1;
+
+    assert_non_null(fp);
+    (void) fclose(fp);
+    out = id3FileOpen("assets/tmp", true);
+
+    assert_true(in >= 0);
+    assert_true(out >= 0);
+    assert_true(id3FileSize(in, &size));
+
+    // spans many copy buffers
+    assert_true(size > ID3_FILE_COPY_BUFFER_SIZE * 4);
+    assert_true(id3FileCopyRange(in, 100, size - 100, out));
+    assert_true(id3FileSize(out, &copied));
+    assert_int_equal(copied, size - 100);
+
+    assert_true(id3FileReadAt(in, expected, 10, size - 10));
+    assert_true(id3FileReadAt(out, bytes, 10, copied - 10));
+    assert_memory_equal(bytes, expected, 10);
+
+    id3FileClose(in);
+    id3FileClose(out);
+    (void) remove("assets/tmp");
+}
+
+static void id3FileReadLayout_v2v1(void **state) {
+    (void) state;
+
+    Id3FileLayout layout;
+    int fd = id3FileOpen("assets/sorry4dying.mp3", false);
+
+    assert_true(fd >= 0);
+    assert_true(id3FileReadLayout(fd, &layout));
+    assert_int_equal(layout.fileSize, 3099209);
+    assert_int_equal(layout.id3v2Size, 3099081);
+    assert_int_equal(layout.id3v1Offset, 3099209 - 128);
+
+    id3FileClose(fd);
+}
+
+static void id3FileReadLayout_v1Only(void **state) {
+    (void) state;
+
+    Id3FileLayout layout;
+    int fd = id3FileOpen("assets/Beetlebum.mp3", false);
+
+    assert_true(fd >= 0);
+    assert_true(id3FileReadLayout(fd, &layout));
+    assert_int_equal(layout.id3v2Size, 0);
+    assert_int_equal(layout.id3v1Offset, 0);
+
+    id3FileClose(fd);
+}
+
+static void id3FileReadLayout_noTags(void **state) {
+    (void) state;
+
+    Id3FileLayout layout;
+    int fd = id3FileOpen("assets/null.mp3", false);
+
+    assert_true(fd >= 0);
+    assert_true(id3FileReadLayout(fd, &layout));
+    assert_int_equal(layout.id3v2Size, 0);
+    assert_int_equal(layout.id3v1Offset, layout.fileSize);
+
+    id3FileClose(fd);
+}
+
+static void id3FileTagSize_headerFooter(void **state) {
+    (void) state;
+
+    uint8_t v3[10] = {'I', 'D', '3', 0x03, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00};
+    uint8_t v4[10] = {'I', 'D', '3', 0x04, 0x00, 0x10, 0x00, 0x00, 0x01, 0x00};
+    uint8_t footer[10] = {'3', 'D', 'I', 0x04, 0x00, 0x10, 0x00, 0x00, 0x01, 0x00};
+
+    assert_int_equal(id3FileTagSize(v3, false), 10 + 128);
+    assert_int_equal(id3FileTagSize(v4, false), 10 + 128 + 10);
+    assert_int_equal(id3FileTagSize(footer, true), 10 + 128 + 10);
+
+    // wrong marker
+    assert_int_equal(id3FileTagSize(v4, true), 0);
+    assert_int_equal(id3FileTagSize(footer, false), 0);
+
+    // footers only exist in v2.4
+    footer[3] = 0x03;
+    assert_int_equal(id3FileTagSize(footer, true), 0);
+
+    // not a synchsafe size
+    v3[9] = 0x80;
+    assert_int_equal(id3FileTagSize(v3, false), 0);
+
+    assert_int_equal(id3FileTagSize(NULL, false), 0);
+}
+
+static void id3FileMap_sorry4dying(void **state) {
+    (void) state;
+
+    Id3FileMapping mapping = {0};
+
+    assert_true(id3FileMap("assets/sorry4dying.mp3", &mapping));
+    assert_non_null(mapping.data);
+    assert_int_equal(mapping.length, 3099209);
+    assert_memory_equal(mapping.data, "ID3", 3);
+
+    id3FileUnmap(&mapping);
+    assert_null(mapping.data);
+    assert_int_equal(mapping.length, 0);
+
+    // already released
+    id3FileUnmap(&mapping);
+}
+
+static void id3FileMap_noFile(void **state) {
+    (void) state;
+
+    Id3FileMapping mapping = {0};
+
+    assert_false(id3FileMap(NULL, &mapping));
+    assert_false(id3FileMap("assets/doesNotExist.mp3", &mapping));
+    assert_null(mapping.data);
+    assert_false(id3FileMap("assets/sorry4dying.mp3", NULL));
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3FileOpen
+        cmocka_unit_test(id3FileOpen_noFile),
+
+        // id3FileSize
+        cmocka_unit_test(id3FileSize_sorry4dying),
+
+        // id3FileIdentify
+        cmocka_unit_test(id3FileIdentify_paths),
+
+        // id3FileReadAt
+        cmocka_unit_test(id3FileReadAt_header),
+
+        // id3FileRewrite
+        cmocka_unit_test(id3FileRewrite_headRangeTail),
+        cmocka_unit_test(id3FileRewrite_noFile),
+#if !defined(_WIN32)
+        cmocka_unit_test(id3FileRewrite_links),
+#endif
+
+        // id3FileCopyRange
+        cmocka_unit_test(id3FileCopyRange_large),
+
+        // id3FileReadLayout
+        cmocka_unit_test(id3FileReadLayout_v2v1),
+        cmocka_unit_test(id3FileReadLayout_v1Only),
+        cmocka_unit_test(id3FileReadLayout_noTags),
+
+        // id3FileTagSize
+        cmocka_unit_test(id3FileTagSize_headerFooter),
+
+        // id3FileMap
+        cmocka_unit_test(id3FileMap_sorry4dying),
+        cmocka_unit_test(id3FileMap_noFile),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
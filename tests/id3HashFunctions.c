@@ -0,0 +1,89 @@
+/**
+ * @file id3HashFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Hash.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Hash.h"
+
+static void id3Hash64_vectors(void **state) {
+    (void) state;
+    const char *sentence = "Nobody inspects the spammish repetition";
+
+    assert_true(id3Hash64(NULL, 0, 0) == 0xEF46DB3751D8E999ULL);
+    assert_true(id3Hash64((const uint8_t *) "a", 1, 0) == 0xD24EC4F1A98C6E5BULL);
+    assert_true(id3Hash64((const uint8_t *) "abc", 3, 0) == 0x44BC2CF5AD770999ULL);
+    assert_true(id3Hash64((const uint8_t *) sentence, strlen(sentence), 0) == 0xFBCEA83C8A378BF1ULL);
+}
+
+static void id3Hash64_seed(void **state) {
+    (void) state;
+
+    assert_true(id3Hash64((const uint8_t *) "abc", 3, 0) != id3Hash64((const uint8_t *) "abc", 3, 1));
+}
+
+static void id3HashUpdate_pieces(void **state) {
+    (void) state;
+    uint8_t *data = malloc(100000);
+    Id3Hash hash;
+    uint64_t whole = 0;
+    size_t offset = 0;
+    size_t piece = 0;
+
+    assert_non_null(data);
+
+    for (size_t i = 0; i < 100000; i++) {
+        data[i] = (uint8_t) (i * 31 + 7);
+    }
+
+    whole = id3Hash64(data, 100000, 5);
+
+    // pieces of every size up to two stripes give the same hash as one call
+    id3HashInit(&hash, 5);
+
+    while (offset < 100000) {
+        size_t length = piece % (ID3_HASH_STRIPE_SIZE * 2 + 1);
+
+        if (offset + length > 100000) {
+            length = 100000 - offset;
+        }
+
+        id3HashUpdate(&hash, data + offset, length);
+        offset += length;
+        piece++;
+    }
+
+    assert_true(id3HashFinal(&hash) == whole);
+
+    // reading does not end the hash
+    id3HashInit(&hash, 5);
+    id3HashUpdate(&hash, data, 50000);
+    assert_true(id3HashFinal(&hash) == id3Hash64(data, 50000, 5));
+    id3HashUpdate(&hash, data + 50000, 50000);
+    assert_true(id3HashFinal(&hash) == whole);
+
+    free(data);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3Hash64
+        cmocka_unit_test(id3Hash64_vectors),
+        cmocka_unit_test(id3Hash64_seed),
+
+        // id3HashUpdate
+        cmocka_unit_test(id3HashUpdate_pieces),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
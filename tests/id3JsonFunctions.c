@@ -0,0 +1,262 @@
+/**
+ * @file id3JsonFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Json.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Json.h"
+
+static void id3JsonReaderCreate_valid(void **state) {
+    (void) state;
+    Id3JsonReader *reader = id3JsonReaderCreate("{}", 2);
+
+    assert_non_null(reader);
+    assert_false(reader->failed);
+    assert_int_equal(reader->cursor, 0);
+
+    id3JsonReaderDestroy(&reader);
+    assert_null(reader);
+}
+
+static void id3JsonReaderCreate_null(void **state) {
+    (void) state;
+    Id3JsonReader *reader = id3JsonReaderCreate(NULL, 2);
+
+    assert_null(reader);
+    id3JsonReaderDestroy(&reader);
+    id3JsonReaderDestroy(NULL);
+}
+
+static void id3JsonNextMember_walk(void **state) {
+    (void) state;
+    const char *json = " { \"a\" : 1 , \"b\":\"two\", \"c\":true, \"d\":[1,{\"x\":null}], \"e\":-42 } ";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+    int64_t n = 0;
+    bool b = false;
+    size_t length = 0;
+
+    assert_true(id3JsonBeginObject(reader));
+
+    assert_true(id3JsonNextMember(reader));
+    assert_string_equal(reader->key, "a");
+    assert_true(id3JsonReadInteger(reader, &n));
+    assert_int_equal(n, 1);
+
+    assert_true(id3JsonNextMember(reader));
+    assert_string_equal(reader->key, "b");
+    assert_string_equal(id3JsonReadString(reader, &length), "two");
+    assert_int_equal(length, 3);
+
+    assert_true(id3JsonNextMember(reader));
+    assert_string_equal(reader->key, "c");
+    assert_true(id3JsonReadBool(reader, &b));
+    assert_true(b);
+
+    assert_true(id3JsonNextMember(reader));
+    assert_string_equal(reader->key, "d");
+    assert_true(id3JsonSkipValue(reader));
+
+    assert_true(id3JsonNextMember(reader));
+    assert_string_equal(reader->key, "e");
+    assert_true(id3JsonReadInteger(reader, &n));
+    assert_int_equal(n, -42);
+
+    assert_false(id3JsonNextMember(reader));
+    assert_false(reader->failed);
+    assert_true(id3JsonReaderFinished(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonNextElement_walk(void **state) {
+    (void) state;
+    const char *json = "[10,20,30]";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+    int64_t expected = 10;
+    int64_t n = 0;
+    int count = 0;
+
+    assert_true(id3JsonBeginArray(reader));
+
+    while (id3JsonNextElement(reader)) {
+        assert_true(id3JsonReadInteger(reader, &n));
+        assert_int_equal(n, expected);
+        expected += 10;
+        count++;
+    }
+
+    assert_int_equal(count, 3);
+    assert_true(id3JsonReaderFinished(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonNextElement_empty(void **state) {
+    (void) state;
+    const char *json = "{\"list\":[ ]}";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+
+    assert_true(id3JsonBeginObject(reader));
+    assert_true(id3JsonNextMember(reader));
+    assert_true(id3JsonBeginArray(reader));
+    assert_false(id3JsonNextElement(reader));
+    assert_false(id3JsonNextMember(reader));
+    assert_true(id3JsonReaderFinished(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonReadString_escapes(void **state) {
+    (void) state;
+    const char *json = "\"q\\\"b\\\\s\\/n\\nt\\tu\\u00e9s\\ud83c\\udfb5\"";
+    const char expected[] = "q\"b\\s/n\nt\tu\xc3\xa9s\xf0\x9f\x8e\xb5";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+    size_t length = 0;
+    const char *text = id3JsonReadString(reader, &length);
+
+    assert_non_null(text);
+    assert_int_equal(length, sizeof(expected) - 1);
+    assert_memory_equal(text, expected, length);
+    assert_true(id3JsonReaderFinished(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonReadString_reuse(void **state) {
+    (void) state;
+    const char *json = "[\"a long string to grow the buffer\",\"short\"]";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+    size_t length = 0;
+
+    assert_true(id3JsonBeginArray(reader));
+    assert_true(id3JsonNextElement(reader));
+    assert_string_equal(id3JsonReadString(reader, &length), "a long string to grow the buffer");
+    assert_true(id3JsonNextElement(reader));
+    assert_string_equal(id3JsonReadString(reader, &length), "short");
+    assert_int_equal(length, 5);
+    assert_false(id3JsonNextElement(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonReadString_invalid(void **state) {
+    (void) state;
+    const char *inputs[] = {"\"open", "\"bad\\q\"", "\"\\ud83c\"", "\"\\u12\"", "12"};
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        Id3JsonReader *reader = id3JsonReaderCreate(inputs[i], strlen(inputs[i]));
+        size_t length = 0;
+
+        assert_null(id3JsonReadString(reader, &length));
+        assert_true(reader->failed);
+
+        id3JsonReaderDestroy(&reader);
+    }
+}
+
+static void id3JsonReadInteger_invalid(void **state) {
+    (void) state;
+    const char *inputs[] = {"1.5", "1e3", "-", "\"1\"", "99999999999999999999"};
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        Id3JsonReader *reader = id3JsonReaderCreate(inputs[i], strlen(inputs[i]));
+        int64_t n = 0;
+
+        assert_false(id3JsonReadInteger(reader, &n));
+        assert_true(reader->failed);
+
+        id3JsonReaderDestroy(&reader);
+    }
+}
+
+static void id3JsonReaderFailed_sticky(void **state) {
+    (void) state;
+    const char *json = "{\"a\" 1}";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+    int64_t n = 0;
+
+    assert_true(id3JsonBeginObject(reader));
+    assert_false(id3JsonNextMember(reader));
+    assert_true(reader->failed);
+    assert_false(id3JsonReadInteger(reader, &n));
+    assert_false(id3JsonReaderFinished(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonSkipValue_depth(void **state) {
+    (void) state;
+    char json[ID3_JSON_MAX_DEPTH * 2 + 8];
+    size_t n = 0;
+    Id3JsonReader *reader = NULL;
+
+    for (int i = 0; i < ID3_JSON_MAX_DEPTH + 1; i++) {
+        json[n++] = '[';
+    }
+
+    for (int i = 0; i < ID3_JSON_MAX_DEPTH + 1; i++) {
+        json[n++] = ']';
+    }
+
+    reader = id3JsonReaderCreate(json, n);
+    assert_false(id3JsonSkipValue(reader));
+    assert_true(reader->failed);
+    id3JsonReaderDestroy(&reader);
+
+    // one level less is fine
+    reader = id3JsonReaderCreate(json + 1, n - 2);
+    assert_true(id3JsonSkipValue(reader));
+    assert_true(id3JsonReaderFinished(reader));
+    id3JsonReaderDestroy(&reader);
+}
+
+static void id3JsonReaderFinished_trailing(void **state) {
+    (void) state;
+    const char *json = "{} x";
+    Id3JsonReader *reader = id3JsonReaderCreate(json, strlen(json));
+
+    assert_true(id3JsonSkipValue(reader));
+    assert_false(id3JsonReaderFinished(reader));
+
+    id3JsonReaderDestroy(&reader);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3JsonReaderCreate
+        cmocka_unit_test(id3JsonReaderCreate_valid),
+        cmocka_unit_test(id3JsonReaderCreate_null),
+
+        // id3JsonNextMember
+        cmocka_unit_test(id3JsonNextMember_walk),
+
+        // id3JsonNextElement
+        cmocka_unit_test(id3JsonNextElement_walk),
+        cmocka_unit_test(id3JsonNextElement_empty),
+
+        // id3JsonReadString
+        cmocka_unit_test(id3JsonReadString_escapes),
+        cmocka_unit_test(id3JsonReadString_reuse),
+        cmocka_unit_test(id3JsonReadString_invalid),
+
+        // id3JsonReadInteger
+        cmocka_unit_test(id3JsonReadInteger_invalid),
+
+        // failure handling
+        cmocka_unit_test(id3JsonReaderFailed_sticky),
+        cmocka_unit_test(id3JsonSkipValue_depth),
+        cmocka_unit_test(id3JsonReaderFinished_trailing),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
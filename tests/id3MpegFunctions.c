@@ -0,0 +1,332 @@
+/**
+ * @file id3MpegFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Mpeg.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Mpeg.h"
+#include "id3v1/id3v1Types.h"
+
+//! Size of the ID3v2 tag the test streams start with
+#define TEST_TAG_SIZE 100
+
+//! Frames in the test streams
+#define TEST_FRAMES 200
+
+// writes an MPEG 1 layer 3 44.1kHz stereo frame using bitrate index rate and returns its size
+static size_t mpegFrame(uint8_t *out, uint8_t rate) {
+    const uint8_t header[4] = {0xFF, 0xFB, (uint8_t) (rate << 4), 0x00};
+    size_t size = (rate == 9) ? 417 : 626;
+
+    memset(out, 0, size);
+    memcpy(out, header, sizeof(header));
+    return size;
+}
+
+// builds a tagged stream alternating between 128 and 192kbps frames, offsets receives where each frame starts
+static uint8_t *mpegStream(size_t *size, size_t offsets[TEST_FRAMES]) {
+    uint8_t *out = calloc(TEST_TAG_SIZE + TEST_FRAMES * 626 + ID3V1_MAX_SIZE, 1);
+    const uint8_t tag[10] = {'I', 'D', '3', 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, TEST_TAG_SIZE - 10};
+    size_t at = TEST_TAG_SIZE;
+
+    assert_non_null(out);
+    memcpy(out, tag, sizeof(tag));
+
+    for (size_t i = 0; i < TEST_FRAMES; i++) {
+        offsets[i] = at - TEST_TAG_SIZE;
+        at += mpegFrame(out + at, (i % 3 == 0) ? 11 : 9);
+    }
+
+    memcpy(out + at, "TAG", 3);
+    *size = at + ID3V1_MAX_SIZE;
+    return out;
+}
+
+static void id3MpegReadFrameHeader_layers(void **state) {
+    (void) state;
+    Id3MpegFrameHeader h = {0};
+    const uint8_t l3[4] = {0xFF, 0xFB, 0x90, 0x00};
+    const uint8_t l3Padded[4] = {0xFF, 0xFB, 0x92, 0xC0};
+    const uint8_t l3Mpeg2[4] = {0xFF, 0xF3, 0x90, 0x00};
+    const uint8_t l2[4] = {0xFF, 0xFD, 0x90, 0x00};
+    const uint8_t l1[4] = {0xFF, 0xFF, 0x90, 0x00};
+
+    assert_true(id3MpegReadFrameHeader(l3, sizeof(l3), &h));
+    assert_int_equal(h.version, 1);
+    assert_int_equal(h.layer, 3);
+    assert_int_equal(h.channels, 2);
+    assert_int_equal(h.bitrate, 128000);
+    assert_int_equal(h.sampleRate, 44100);
+    assert_int_equal(h.samples, 1152);
+    assert_int_equal(h.size, 417);
+
+    assert_true(id3MpegReadFrameHeader(l3Padded, sizeof(l3Padded), &h));
+    assert_int_equal(h.channels, 1);
+    assert_int_equal(h.size, 418);
+
+    assert_true(id3MpegReadFrameHeader(l3Mpeg2, sizeof(l3Mpeg2), &h));
+    assert_int_equal(h.version, 2);
+    assert_int_equal(h.bitrate, 80000);
+    assert_int_equal(h.sampleRate, 22050);
+    assert_int_equal(h.samples, 576);
+    assert_int_equal(h.size, 261);
+
+    assert_true(id3MpegReadFrameHeader(l2, sizeof(l2), &h));
+    assert_int_equal(h.layer, 2);
+    assert_int_equal(h.bitrate, 160000);
+    assert_int_equal(h.size, 522);
+
+    assert_true(id3MpegReadFrameHeader(l1, sizeof(l1), &h));
+    assert_int_equal(h.layer, 1);
+    assert_int_equal(h.bitrate, 288000);
+    assert_int_equal(h.samples, 384);
+    assert_int_equal(h.size, 312);
+}
+
+static void id3MpegReadFrameHeader_invalid(void **state) {
+    (void) state;
+    Id3MpegFrameHeader h = {0};
+    const uint8_t freeFormat[4] = {0xFF, 0xFB, 0x00, 0x00};
+    const uint8_t badBitrate[4] = {0xFF, 0xFB, 0xF0, 0x00};
+    const uint8_t badRate[4] = {0xFF, 0xFB, 0x9C, 0x00};
+    const uint8_t badVersion[4] = {0xFF, 0xEB, 0x90, 0x00};
+    const uint8_t badLayer[4] = {0xFF, 0xF9, 0x90, 0x00};
+    const uint8_t noSync[4] = {'I', 'D', '3', 0x03};
+
+    assert_false(id3MpegReadFrameHeader(freeFormat, 4, &h));
+    assert_false(id3MpegReadFrameHeader(badBitrate, 4, &h));
+    assert_false(id3MpegReadFrameHeader(badRate, 4, &h));
+    assert_false(id3MpegReadFrameHeader(badVersion, 4, &h));
+    assert_false(id3MpegReadFrameHeader(badLayer, 4, &h));
+    assert_false(id3MpegReadFrameHeader(noSync, 4, &h));
+    assert_false(id3MpegReadFrameHeader(noSync, 3, &h));
+    assert_false(id3MpegReadFrameHeader(NULL, 4, &h));
+}
+
+static void id3MpegIndexFromBuffer_walk(void **state) {
+    (void) state;
+    size_t offsets[TEST_FRAMES] = {0};
+    size_t size = 0;
+    uint8_t *stream = mpegStream(&size, offsets);
+    Id3MpegIndex *index = id3MpegIndexFromBuffer(stream, size, 1000, false);
+
+    assert_non_null(index);
+    assert_false(index->estimated);
+    assert_int_equal(index->start, TEST_TAG_SIZE);
+    assert_int_equal(index->length, size - TEST_TAG_SIZE - ID3V1_MAX_SIZE);
+    assert_int_equal(index->frames, TEST_FRAMES);
+    assert_int_equal(index->samplesPerFrame, 1152);
+    assert_int_equal(index->sampleRate, 44100);
+
+    // 1000ms is 38 frames of 1152 samples at 44.1kHz
+    assert_int_equal(index->stride, 38);
+    assert_int_equal(index->count, 6);
+
+    for (size_t i = 0; i < index->count; i++) {
+        assert_int_equal(index->offsets[i], offsets[i * 38]);
+    }
+
+    assert_int_equal(id3MpegIndexDuration(index), 5224);
+    assert_int_equal(id3MpegIndexOffsetAt(index, 76), offsets[76]);
+    assert_int_equal(id3MpegIndexOffsetAt(index, TEST_FRAMES), index->length);
+
+    id3MpegDestroyIndex(&index);
+    assert_null(index);
+
+    // smaller interval
+    index = id3MpegIndexFromBuffer(stream, size, 100, true);
+    assert_int_equal(index->stride, 3);
+    assert_int_equal(index->count, 67);
+    assert_int_equal(index->offsets[66], offsets[198]);
+    id3MpegDestroyIndex(&index);
+
+    free(stream);
+}
+
+static void id3MpegIndexFromBuffer_damaged(void **state) {
+    (void) state;
+    size_t offsets[TEST_FRAMES] = {0};
+    size_t size = 0;
+    uint8_t *stream = mpegStream(&size, offsets);
+    uint8_t *damaged = calloc(size + 7, 1);
+    Id3MpegIndex *index = NULL;
+
+    // junk that even starts with a sync byte between frames 50 and 51
+    memcpy(damaged, stream, TEST_TAG_SIZE + offsets[51]);
+    memcpy(damaged + TEST_TAG_SIZE + offsets[51], "\xFF\xFB\x00junk", 7);
+    memcpy(damaged + TEST_TAG_SIZE + offsets[51] + 7, stream + TEST_TAG_SIZE + offsets[51],
+           size - TEST_TAG_SIZE - offsets[51]);
+
+    index = id3MpegIndexFromBuffer(damaged, size + 7, 1000, true);
+    assert_non_null(index);
+    assert_int_equal(index->frames, TEST_FRAMES);
+    assert_int_equal(index->offsets[1], offsets[38]);
+    assert_int_equal(index->offsets[2], offsets[76] + 7);
+    id3MpegDestroyIndex(&index);
+
+    // no audio at all
+    memset(damaged, 0, size + 7);
+    assert_null(id3MpegIndexFromBuffer(damaged, size + 7, 1000, true));
+    assert_null(id3MpegIndexFromBuffer(NULL, 0, 1000, true));
+
+    free(damaged);
+    free(stream);
+}
+
+static void id3MpegIndexFromBuffer_xing(void **state) {
+    (void) state;
+    size_t offsets[TEST_FRAMES] = {0};
+    size_t size = 0;
+    uint8_t *stream = mpegStream(&size, offsets);
+    uint8_t *withXing = calloc(size + 417, 1);
+    uint8_t *xing = withXing + TEST_TAG_SIZE;
+    uint32_t bytes = (uint32_t) (size - TEST_TAG_SIZE - ID3V1_MAX_SIZE + 417);
+    Id3MpegIndex *index = NULL;
+
+    memcpy(withXing, stream, TEST_TAG_SIZE);
+    mpegFrame(xing, 9);
+    memcpy(xing + 36, "Xing\x00\x00\x00\x07", 8);
+    xing[44 + 2] = TEST_FRAMES >> 8;
+    xing[44 + 3] = TEST_FRAMES & 0xFF;
+    xing[48] = (uint8_t) (bytes >> 24);
+    xing[49] = (uint8_t) (bytes >> 16);
+    xing[50] = (uint8_t) (bytes >> 8);
+    xing[51] = (uint8_t) bytes;
+
+    for (int i = 0; i < 100; i++) {
+        xing[52 + i] = (uint8_t) (i * 256 / 100);
+    }
+
+    memcpy(withXing + TEST_TAG_SIZE + 417, stream + TEST_TAG_SIZE, size - TEST_TAG_SIZE);
+
+    // the table of contents is used without walking the frames
+    index = id3MpegIndexFromBuffer(withXing, size + 417, 1000, false);
+    assert_non_null(index);
+    assert_true(index->estimated);
+    assert_int_equal(index->start, TEST_TAG_SIZE + 417);
+    assert_int_equal(index->frames, TEST_FRAMES);
+    assert_int_equal(index->length, bytes - 417);
+    assert_int_equal(index->count, 6);
+    assert_int_equal(index->offsets[0], 0);
+
+    for (size_t i = 1; i < index->count; i++) {
+        assert_true(index->offsets[i] > index->offsets[i - 1]);
+        assert_true(index->offsets[i] <= index->length);
+    }
+
+    id3MpegDestroyIndex(&index);
+
+    // walking skips the Xing frame
+    index = id3MpegIndexFromBuffer(withXing, size + 417, 1000, true);
+    assert_non_null(index);
+    assert_false(index->estimated);
+    assert_int_equal(index->start, TEST_TAG_SIZE + 417);
+    assert_int_equal(index->frames, TEST_FRAMES);
+    assert_int_equal(index->offsets[1], offsets[38]);
+    id3MpegDestroyIndex(&index);
+
+    free(withXing);
+    free(stream);
+}
+
+static void id3MpegIndexFromBuffer_vbri(void **state) {
+    (void) state;
+    const size_t frames = 200;
+    size_t size = TEST_TAG_SIZE + 417 * (frames + 1);
+    uint8_t *stream = calloc(size, 1);
+    uint8_t *vbri = stream + TEST_TAG_SIZE + 36;
+    const uint8_t tag[10] = {'I', 'D', '3', 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, TEST_TAG_SIZE - 10};
+    Id3MpegIndex *index = NULL;
+
+    memcpy(stream, tag, sizeof(tag));
+
+    for (size_t i = 0; i <= frames; i++) {
+        mpegFrame(stream + TEST_TAG_SIZE + i * 417, 9);
+    }
+
+    // 5 entries of 40 frames of 417 bytes, stored as 2 byte sizes
+    memcpy(vbri, "VBRI", 4);
+    vbri[17] = (uint8_t) frames;
+    vbri[19] = 5;
+    vbri[21] = 1;
+    vbri[23] = 2;
+    vbri[25] = 40;
+
+    for (int i = 0; i < 5; i++) {
+        vbri[26 + i * 2] = (uint8_t) ((40 * 417) >> 8);
+        vbri[27 + i * 2] = (uint8_t) ((40 * 417) & 0xFF);
+    }
+
+    index = id3MpegIndexFromBuffer(stream, size, 1000, false);
+    assert_non_null(index);
+    assert_true(index->estimated);
+    assert_int_equal(index->start, TEST_TAG_SIZE + 417);
+    assert_int_equal(index->frames, frames);
+
+    for (size_t i = 0; i < index->count; i++) {
+        assert_int_equal(index->offsets[i], i * 38 * 417);
+    }
+
+    id3MpegDestroyIndex(&index);
+    free(stream);
+}
+
+static void id3MpegIndexFromFile_matchesBuffer(void **state) {
+    (void) state;
+    size_t offsets[TEST_FRAMES] = {0};
+    size_t size = 0;
+    uint8_t *stream = mpegStream(&size, offsets);
+    Id3MpegIndex *fromBuffer = id3MpegIndexFromBuffer(stream, size, 500, true);
+    Id3MpegIndex *fromFile = NULL;
+    FILE *fp = fopen("assets/tmp", "wb");
+
+    assert_non_null(fp);
+    assert_int_equal(fwrite(stream, 1, size, fp), size);
+    fclose(fp);
+
+    fromFile = id3MpegIndexFromFile("assets/tmp", 500, true);
+    (void) remove("assets/tmp");
+
+    assert_non_null(fromFile);
+    assert_int_equal(fromFile->frames, fromBuffer->frames);
+    assert_int_equal(fromFile->count, fromBuffer->count);
+    assert_memory_equal(fromFile->offsets, fromBuffer->offsets, fromFile->count * sizeof(uint64_t));
+
+    // tags only
+    assert_null(id3MpegIndexFromFile("assets/sorry4dying.mp3", 1000, true));
+    assert_null(id3MpegIndexFromFile("assets/doesNotExist.mp3", 1000, true));
+    assert_null(id3MpegIndexFromFile(NULL, 1000, true));
+
+    id3MpegDestroyIndex(&fromFile);
+    id3MpegDestroyIndex(&fromBuffer);
+    free(stream);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3MpegReadFrameHeader
+        cmocka_unit_test(id3MpegReadFrameHeader_layers),
+        cmocka_unit_test(id3MpegReadFrameHeader_invalid),
+
+        // id3MpegIndexFromBuffer
+        cmocka_unit_test(id3MpegIndexFromBuffer_walk),
+        cmocka_unit_test(id3MpegIndexFromBuffer_damaged),
+        cmocka_unit_test(id3MpegIndexFromBuffer_xing),
+        cmocka_unit_test(id3MpegIndexFromBuffer_vbri),
+
+        // id3MpegIndexFromFile
+        cmocka_unit_test(id3MpegIndexFromFile_matchesBuffer),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
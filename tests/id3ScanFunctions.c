@@ -0,0 +1,465 @@
+/**
+ * @file id3ScanFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Scan.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Scan.h"
+
+#define SCAN_TEST_MAX_RESULTS 64
+
+typedef struct _ScanResults {
+    size_t count;
+    char *paths[SCAN_TEST_MAX_RESULTS];
+    ID3 *metadata[SCAN_TEST_MAX_RESULTS];
+} ScanResults;
+
+static void collect(const char *filePath, ID3 *metadata, void *userData) {
+    ScanResults *results = (ScanResults *) userData;
+
+    if (results->count == SCAN_TEST_MAX_RESULTS) {
+        id3Destroy(&metadata);
+        return;
+    }
+
+    results->paths[results->count] = strdup(filePath);
+    results->metadata[results->count] = metadata;
+    results->count++;
+}
+
+static void clearResults(ScanResults *results) {
+    for (size_t i = 0; i < results->count; i++) {
+        free(results->paths[i]);
+        id3Destroy(&results->metadata[i]);
+    }
+
+    results->count = 0;
+}
+
+static const char *files[5] = {
+    "assets/OnGP.mp3",
+    "assets/sorry4dying.mp3",
+    "assets/danybrown2.mp3",
+    "assets/Beetlebum.mp3",
+    "assets/doesNotExist.mp3"
+};
+
+static void id3CreateScanOptions_valid(void **state) {
+    (void) state;
+
+    Id3ScanOptions *options = id3CreateScanOptions(4, ID3_SCAN_ID3V2, true);
+
+    assert_non_null(options);
+    assert_int_equal(options->threads, 4);
+    assert_int_equal(options->tags, ID3_SCAN_ID3V2);
+    assert_true(options->ordered);
+    assert_int_equal(options->reorderWindow, 0);
+    assert_int_equal(options->queueDepth, 0);
+    assert_null(options->extension);
+    assert_null(options->options);
+
+    id3DestroyScanOptions(&options);
+    assert_null(options);
+    id3DestroyScanOptions(&options);
+    id3DestroyScanOptions(NULL);
+}
+
+static void id3ScanFiles_ordered(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    Id3ScanOptions *options = id3CreateScanOptions(3, ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2, true);
+    ID3 *expected = NULL;
+
+    assert_true(id3ScanFiles(files, 5, options, collect, &results));
+    assert_int_equal(results.count, 5);
+
+    for (size_t i = 0; i < 5; i++) {
+        assert_string_equal(results.paths[i], files[i]);
+        assert_non_null(results.metadata[i]);
+    }
+
+    // same tags id3FromFile reads
+    for (size_t i = 0; i < 4; i++) {
+        expected = id3FromFile(files[i]);
+
+        assert_int_equal(results.metadata[i]->id3v2 == NULL, expected->id3v2 == NULL);
+        assert_int_equal(results.metadata[i]->id3v1 == NULL, expected->id3v1 == NULL);
+
+        if (expected->id3v2 != NULL) {
+            assert_int_equal(results.metadata[i]->id3v2->header->majorVersion, expected->id3v2->header->majorVersion);
+            assert_int_equal(results.metadata[i]->id3v2->frames->length, expected->id3v2->frames->length);
+        }
+
+        id3Destroy(&expected);
+    }
+
+    assert_null(results.metadata[4]->id3v2);
+    assert_null(results.metadata[4]->id3v1);
+
+    clearResults(&results);
+    id3DestroyScanOptions(&options);
+}
+
+static void id3ScanFiles_unordered(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    Id3ScanOptions *options = id3CreateScanOptions(4, ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2, false);
+    size_t seen = 0;
+
+    assert_true(id3ScanFiles(files, 5, options, collect, &results));
+    assert_int_equal(results.count, 5);
+
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            if (strcmp(results.paths[j], files[i]) == 0) {
+                seen++;
+            }
+        }
+    }
+
+    assert_int_equal(seen, 5);
+
+    clearResults(&results);
+    id3DestroyScanOptions(&options);
+}
+
+static void id3ScanFiles_tagSelection(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    Id3ScanOptions *options = id3CreateScanOptions(2, ID3_SCAN_ID3V1, true);
+
+    assert_true(id3ScanFiles(files, 4, options, collect, &results));
+    assert_int_equal(results.count, 4);
+
+    for (size_t i = 0; i < 4; i++) {
+        assert_null(results.metadata[i]->id3v2);
+    }
+
+    assert_non_null(results.metadata[3]->id3v1);
+
+    clearResults(&results);
+    id3DestroyScanOptions(&options);
+}
+
+static void id3ScanFiles_invalid(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    const char *withNull[2] = {"assets/OnGP.mp3", NULL};
+
+    assert_false(id3ScanFiles(files, 5, NULL, NULL, &results));
+    assert_false(id3ScanFiles(NULL, 5, NULL, collect, &results));
+    assert_false(id3ScanFiles(withNull, 2, NULL, collect, &results));
+    assert_true(id3ScanFiles(NULL, 0, NULL, collect, &results));
+    assert_int_equal(results.count, 0);
+}
+
+static void id3ScanFiles_queueDepth(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    Id3ScanOptions *options = id3CreateScanOptions(2, ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2, true);
+    ID3 *expected = NULL;
+
+    // read through io_uring when it is supported, by worker threads otherwise
+    options->queueDepth = 2;
+
+    assert_true(id3ScanFiles(files, 5, options, collect, &results));
+    assert_int_equal(results.count, 5);
+
+    for (size_t i = 0; i < 4; i++) {
+        expected = id3FromFile(files[i]);
+
+        assert_string_equal(results.paths[i], files[i]);
+        assert_int_equal(results.metadata[i]->id3v2 == NULL, expected->id3v2 == NULL);
+        assert_int_equal(results.metadata[i]->id3v1 == NULL, expected->id3v1 == NULL);
+
+        if (expected->id3v2 != NULL) {
+            assert_int_equal(results.metadata[i]->id3v2->frames->length, expected->id3v2->frames->length);
+        }
+
+        id3Destroy(&expected);
+    }
+
+    assert_null(results.metadata[4]->id3v2);
+    assert_null(results.metadata[4]->id3v1);
+
+    clearResults(&results);
+    id3DestroyScanOptions(&options);
+}
+
+static void id3ScanFiles_reorderWindow(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    Id3ScanOptions *options = id3CreateScanOptions(4, ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2, true);
+    const char *paths[40];
+
+    for (size_t i = 0; i < 40; i++) {
+        paths[i] = files[i % 5];
+    }
+
+    // no more than one file is read ahead of delivery, every worker waits for the one before
+    options->reorderWindow = 1;
+
+    assert_true(id3ScanFiles(paths, 40, options, collect, &results));
+    assert_int_equal(results.count, 40);
+
+    for (size_t i = 0; i < 40; i++) {
+        assert_string_equal(results.paths[i], paths[i]);
+        assert_non_null(results.metadata[i]);
+    }
+
+    clearResults(&results);
+
+    // a window smaller than the queue depth leaves the other slots idle
+    options->reorderWindow = 2;
+    options->queueDepth = 8;
+
+    assert_true(id3ScanFiles(paths, 40, options, collect, &results));
+    assert_int_equal(results.count, 40);
+
+    for (size_t i = 0; i < 40; i++) {
+        assert_string_equal(results.paths[i], paths[i]);
+        assert_non_null(results.metadata[i]);
+    }
+
+    clearResults(&results);
+    id3DestroyScanOptions(&options);
+}
+
+static void id3ScanDirectory_assets(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+    Id3ScanOptions *options = id3CreateScanOptions(0, ID3_SCAN_ID3V1 | ID3_SCAN_ID3V2, true);
+    bool found = false;
+
+    options->extension = ".MP3";
+
+    assert_true(id3ScanDirectory("assets", options, collect, &results));
+    assert_true(results.count >= 8);
+
+    for (size_t i = 0; i < results.count; i++) {
+        size_t length = strlen(results.paths[i]);
+
+        assert_true(length > 4);
+        assert_string_equal(results.paths[i] + length - 4, ".mp3");
+
+        if (i > 0) {
+            assert_true(strcmp(results.paths[i - 1], results.paths[i]) < 0);
+        }
+
+        if (strstr(results.paths[i], "OnGP.mp3") != NULL) {
+            assert_non_null(results.metadata[i]->id3v2);
+            assert_int_equal(results.metadata[i]->id3v2->header->majorVersion, ID3V2_TAG_VERSION_4);
+            found = true;
+        }
+    }
+
+    assert_true(found);
+
+    clearResults(&results);
+    id3DestroyScanOptions(&options);
+}
+
+static void id3ScanDirectory_invalid(void **state) {
+    (void) state;
+
+    ScanResults results = {0};
+
+    assert_false(id3ScanDirectory(NULL, NULL, collect, &results));
+    assert_false(id3ScanDirectory("assets", NULL, NULL, &results));
+    assert_false(id3ScanDirectory("assets/doesNotExist", NULL, collect, &results));
+    assert_int_equal(results.count, 0);
+}
+
+typedef struct _EditResults {
+    size_t count;
+    size_t lastDone;
+    Id3EditStatus status[SCAN_TEST_MAX_RESULTS];
+} EditResults;
+
+static void collectEdit(const char *filePath, Id3EditStatus status, size_t done, size_t count, void *userData) {
+    EditResults *results = (EditResults *) userData;
+
+    (void) filePath;
+
+    assert_int_equal(done, results->lastDone + 1);
+    assert_true(done <= count);
+
+    results->lastDone = done;
+
+    if (results->count < SCAN_TEST_MAX_RESULTS) {
+        results->status[results->count++] = status;
+    }
+}
+
+static void copyAsset(const char *from, const char *to) {
+    uint8_t buffer[4096];
+    size_t read = 0;
+    FILE *in = fopen(from, "rb");
+    FILE *out = fopen(to, "wb");
+
+    assert_non_null(in);
+    assert_non_null(out);
+
+    while ((read = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+        assert_int_equal(fwrite(buffer, 1, read, out), read);
+    }
+
+    fclose(in);
+    fclose(out);
+}
+
+static void id3CreateEditOptions_valid(void **state) {
+    (void) state;
+
+    Id3EditOptions *options = id3CreateEditOptions(2, 4096);
+
+    assert_non_null(options);
+    assert_int_equal(options->threads, 2);
+    assert_int_equal(options->memoryLimit, 4096);
+    assert_null(options->options);
+
+    id3DestroyEditOptions(&options);
+    assert_null(options);
+
+    // safe on NULL
+    id3DestroyEditOptions(&options);
+    id3DestroyEditOptions(NULL);
+}
+
+static void id3EditFiles_fields(void **state) {
+    (void) state;
+
+    const char *paths[2] = {"assets/edit0", "assets/edit1"};
+    EditResults results = {0};
+    Id3EditSet changes = {{NULL}};
+    Id3EditSet nothing = {{NULL}};
+    Id3EditOptions *options = id3CreateEditOptions(2, 1);
+    Id3Edit edits[4] = {
+        {"assets/edit0", &changes},
+        {"assets/edit1", &changes},
+        {"assets/doesNotExist.mp3", &changes},
+        {"assets/edit1", NULL}
+    };
+
+    copyAsset("assets/sorry4dying.mp3", paths[0]);
+    copyAsset("assets/OnGP.mp3", paths[1]);
+
+    changes.values[title_edit] = "Batch Title";
+    changes.values[albumArtist_edit] = "Batch Artist";
+
+    // a memory limit of one byte edits one file at a time
+    assert_true(id3EditFiles(edits, 3, options, collectEdit, &results));
+    assert_int_equal(results.count, 3);
+    assert_int_equal(results.lastDone, 3);
+
+    for (size_t i = 0; i < 2; i++) {
+        ID3 *metadata = id3FromFile(paths[i]);
+        char *title = id3ReadTitle(metadata);
+        char *albumArtist = id3ReadAlbumArtist(metadata);
+
+        assert_string_equal(title, "Batch Title");
+        assert_string_equal(albumArtist, "Batch Artist");
+
+        free(title);
+        free(albumArtist);
+        id3Destroy(&metadata);
+    }
+
+    // an empty or missing set writes the tags back unchanged
+    edits[2].edits = &nothing;
+    edits[2].filePath = "assets/edit0";
+    assert_true(id3EditFiles(edits + 2, 2, NULL, NULL, NULL));
+
+    (void) remove(paths[0]);
+    (void) remove(paths[1]);
+    id3DestroyEditOptions(&options);
+}
+
+static void id3EditFiles_statuses(void **state) {
+    (void) state;
+
+    EditResults results = {0};
+    Id3EditSet changes = {{NULL}};
+    Id3Edit edits[2] = {
+        {"assets/doesNotExist.mp3", &changes},
+        {"assets/edit2", &changes}
+    };
+    FILE *fp = fopen("assets/edit2", "wb");
+
+    assert_non_null(fp);
+    assert_int_equal(fwrite("no tags here", 1, 12, fp), 12);
+    fclose(fp);
+
+    changes.values[genre_edit] = "Rock";
+
+    assert_true(id3EditFiles(edits, 2, NULL, collectEdit, &results));
+    assert_int_equal(results.count, 2);
+
+    // delivered as each file finishes
+    if (results.status[0] == readFailed_edit) {
+        assert_int_equal(results.status[1], noTag_edit);
+    } else {
+        assert_int_equal(results.status[0], noTag_edit);
+        assert_int_equal(results.status[1], readFailed_edit);
+    }
+
+    (void) remove("assets/edit2");
+}
+
+static void id3EditFiles_invalid(void **state) {
+    (void) state;
+
+    Id3Edit edits[1] = {{NULL, NULL}};
+
+    assert_false(id3EditFiles(NULL, 1, NULL, NULL, NULL));
+    assert_false(id3EditFiles(edits, 1, NULL, NULL, NULL));
+    assert_true(id3EditFiles(NULL, 0, NULL, NULL, NULL));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+
+        // id3CreateScanOptions
+        cmocka_unit_test(id3CreateScanOptions_valid),
+
+        // id3ScanFiles
+        cmocka_unit_test(id3ScanFiles_ordered),
+        cmocka_unit_test(id3ScanFiles_unordered),
+        cmocka_unit_test(id3ScanFiles_tagSelection),
+        cmocka_unit_test(id3ScanFiles_invalid),
+        cmocka_unit_test(id3ScanFiles_queueDepth),
+        cmocka_unit_test(id3ScanFiles_reorderWindow),
+
+        // id3ScanDirectory
+        cmocka_unit_test(id3ScanDirectory_assets),
+        cmocka_unit_test(id3ScanDirectory_invalid),
+
+        // id3CreateEditOptions
+        cmocka_unit_test(id3CreateEditOptions_valid),
+
+        // id3EditFiles
+        cmocka_unit_test(id3EditFiles_fields),
+        cmocka_unit_test(id3EditFiles_statuses),
+        cmocka_unit_test(id3EditFiles_invalid)
+
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
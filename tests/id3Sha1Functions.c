@@ -0,0 +1,78 @@
+/**
+ * @file id3Sha1Functions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Sha1.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Sha1.h"
+
+static void sha1Hex(const uint8_t *data, size_t length, char out[ID3_SHA1_DIGEST_SIZE * 2 + 1]) {
+    uint8_t digest[ID3_SHA1_DIGEST_SIZE];
+
+    id3Sha1(data, length, digest);
+
+    for (size_t i = 0; i < ID3_SHA1_DIGEST_SIZE; i++) {
+        sprintf(out + i * 2, "%02x", digest[i]);
+    }
+}
+
+static void id3Sha1_fips180(void **state) {
+    (void) state;
+    char hex[ID3_SHA1_DIGEST_SIZE * 2 + 1];
+
+    sha1Hex((const uint8_t *) "abc", 3, hex);
+    assert_string_equal(hex, "a9993e364706816aba3e25717850c26c9cd0d89d");
+
+    sha1Hex((const uint8_t *) "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, hex);
+    assert_string_equal(hex, "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+}
+
+static void id3Sha1_empty(void **state) {
+    (void) state;
+    char hex[ID3_SHA1_DIGEST_SIZE * 2 + 1];
+
+    sha1Hex(NULL, 0, hex);
+    assert_string_equal(hex, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+}
+
+static void id3Sha1_millionA(void **state) {
+    (void) state;
+    char hex[ID3_SHA1_DIGEST_SIZE * 2 + 1];
+    uint8_t *data = malloc(1000000);
+
+    assert_non_null(data);
+    memset(data, 'a', 1000000);
+
+    sha1Hex(data, 1000000, hex);
+    assert_string_equal(hex, "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+    // length field spilling into a second padding block
+    sha1Hex(data, 55, hex);
+    assert_string_equal(hex, "c1c8bbdc22796e28c0e15163d20899b65621d65a");
+
+    sha1Hex(data, 64, hex);
+    assert_string_equal(hex, "0098ba824b5c16427bd7a1122a5a442a25ec644d");
+
+    free(data);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3Sha1
+        cmocka_unit_test(id3Sha1_fips180),
+        cmocka_unit_test(id3Sha1_empty),
+        cmocka_unit_test(id3Sha1_millionA),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
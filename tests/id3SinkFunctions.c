@@ -0,0 +1,213 @@
+/**
+ * @file id3SinkFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3Sink.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3Sink.h"
+#include "id3File.h"
+
+static bool countingWrite(void *user, const uint8_t *data, size_t length) {
+    (void) data;
+    *(size_t *) user += length;
+    return true;
+}
+
+static bool failingWrite(void *user, const uint8_t *data, size_t length) {
+    (void) user;
+    (void) data;
+    (void) length;
+    return false;
+}
+
+static void id3SinkCreate_callback(void **state) {
+    (void) state;
+
+    size_t count = 0;
+    Id3Sink *sink = id3SinkCreate(countingWrite, &count);
+
+    assert_non_null(sink);
+    assert_true(id3SinkWrite(sink, (const uint8_t *) "abc", 3));
+    assert_true(id3SinkWriteString(sink, "defg"));
+    assert_int_equal(count, 7);
+    assert_int_equal(sink->written, 7);
+
+    id3SinkDestroy(&sink);
+    assert_null(sink);
+}
+
+static void id3SinkCreate_noCallback(void **state) {
+    (void) state;
+
+    assert_null(id3SinkCreate(NULL, NULL));
+    assert_null(id3SinkCreateFromFile(NULL));
+    assert_null(id3SinkCreateFromFd(-1));
+}
+
+static void id3SinkWrite_failureIsSticky(void **state) {
+    (void) state;
+
+    Id3Sink *sink = id3SinkCreate(failingWrite, NULL);
+
+    assert_false(id3SinkWrite(sink, (const uint8_t *) "abc", 3));
+    assert_true(sink->failed);
+    assert_false(id3SinkWriteString(sink, "abc"));
+    assert_int_equal(sink->written, 0);
+
+    id3SinkDestroy(&sink);
+}
+
+static void id3SinkCreateBuffer_grows(void **state) {
+    (void) state;
+
+    size_t l = 0;
+    Id3Sink *sink = id3SinkCreateBuffer(0);
+
+    assert_non_null(sink);
+
+    for (int i = 0; i < 1000; i++) {
+        assert_true(id3SinkWrite(sink, (const uint8_t *) "0123456789", 10));
+    }
+
+    const uint8_t *buffer = id3SinkBuffer(sink, &l);
+
+    assert_int_equal(l, 10000);
+    assert_memory_equal(buffer + 9990, "0123456789", 10);
+    assert_int_equal(buffer[10000], 0);
+
+    id3SinkDestroy(&sink);
+}
+
+static void id3SinkPrintf_longOutput(void **state) {
+    (void) state;
+
+    size_t l = 0;
+    char *big = malloc(1001);
+    Id3Sink *sink = id3SinkCreateBuffer(0);
+    Id3Sink *counter = NULL;
+    size_t count = 0;
+
+    memset(big, 'a', 1000);
+    big[1000] = '\0';
+
+    assert_true(id3SinkPrintf(sink, "{\"n\":%d}", 42));
+    assert_true(id3SinkPrintf(sink, "%s", big));
+
+    uint8_t *out = id3SinkTakeBuffer(sink, &l);
+
+    assert_int_equal(l, 8 + 1000);
+    assert_memory_equal(out, "{\"n\":42}", 8);
+    assert_int_equal(strlen((char *) out), l);
+    assert_null(id3SinkBuffer(sink, NULL));
+
+    counter = id3SinkCreate(countingWrite, &count);
+    assert_true(id3SinkPrintf(counter, "%s", big));
+    assert_int_equal(count, 1000);
+
+    free(out);
+    free(big);
+    id3SinkDestroy(&sink);
+    id3SinkDestroy(&counter);
+}
+
+static void id3SinkWriteZeros_padding(void **state) {
+    (void) state;
+
+    size_t l = 0;
+    Id3Sink *sink = id3SinkCreateBuffer(16);
+
+    assert_true(id3SinkWriteZeros(sink, 10000));
+
+    const uint8_t *buffer = id3SinkBuffer(sink, &l);
+
+    assert_int_equal(l, 10000);
+
+    for (size_t i = 0; i < l; i++) {
+        assert_int_equal(buffer[i], 0);
+    }
+
+    id3SinkDestroy(&sink);
+}
+
+static void id3SinkCreateFromFile_write(void **state) {
+    (void) state;
+
+    char str[6] = {0};
+    FILE *fp = fopen("assets/tmp", "wb");
+    Id3Sink *sink = id3SinkCreateFromFile(fp);
+
+    assert_non_null(sink);
+    assert_true(id3SinkWriteString(sink, "music"));
+    id3SinkDestroy(&sink);
+    (void) fclose(fp);
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fread(str, 1, 5, fp);
+    (void) fclose(fp);
+    (void) remove("assets/tmp");
+
+    assert_string_equal(str, "music");
+}
+
+static void id3SinkCreateFromFd_write(void **state) {
+    (void) state;
+
+    uint8_t str[5] = {0};
+    FILE *fp = fopen("assets/tmp", "wb");
+    int fd = -1;
+    Id3Sink *sink = NULL;
+
+    assert_non_null(fp);
+    (void) fclose(fp);
+
+    fd = id3FileOpen("assets/tmp", true);
+    sink = id3SinkCreateFromFd(fd);
+
+    assert_non_null(sink);
+    assert_true(id3SinkPrintf(sink, "%s", "music"));
+    assert_true(id3FileReadAt(fd, str, 5, 0));
+    assert_memory_equal(str, "music", 5);
+
+    id3SinkDestroy(&sink);
+    id3FileClose(fd);
+    (void) remove("assets/tmp");
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3SinkCreate
+        cmocka_unit_test(id3SinkCreate_callback),
+        cmocka_unit_test(id3SinkCreate_noCallback),
+
+        // id3SinkWrite
+        cmocka_unit_test(id3SinkWrite_failureIsSticky),
+
+        // id3SinkCreateBuffer
+        cmocka_unit_test(id3SinkCreateBuffer_grows),
+
+        // id3SinkPrintf
+        cmocka_unit_test(id3SinkPrintf_longOutput),
+
+        // id3SinkWriteZeros
+        cmocka_unit_test(id3SinkWriteZeros_padding),
+
+        // id3SinkCreateFromFile
+        cmocka_unit_test(id3SinkCreateFromFile_write),
+
+        // id3SinkCreateFromFd
+        cmocka_unit_test(id3SinkCreateFromFd_write),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -8,6 +8,7 @@
 #include "id3v2/id3v2.h"
 #include "id3v1/id3v1.h"
 #include "id3v1/id3v1Parser.h"
+#include "id3Hash.h"
 
 static void id3CreateAndDestroy_allInOne(void **state) {
     (void) state;
@@ -76,6 +77,165 @@ static void id3FromFile_noV2(void **state) {
     id3Destroy(&metadata);
 }
 
+static void id3FromFile_appendedV24(void **state) {
+    (void) state;
+
+    // v2.4 tag holding TIT2 "Appended", with a footer, placed after the audio and before an ID3v1 tag
+    const uint8_t header[10] = {'I', 'D', '3', 0x04, 0x00, 0x10, 0x00, 0x00, 0x00, 0x13};
+    const uint8_t frame[19] = {'T', 'I', 'T', '2', 0x00, 0x00, 0x00, 0x09, 0x00, 0x00,
+                               0x03, 'A', 'p', 'p', 'e', 'n', 'd', 'e', 'd'};
+    const uint8_t footer[10] = {'3', 'D', 'I', 0x04, 0x00, 0x10, 0x00, 0x00, 0x00, 0x13};
+    uint8_t audio[1024] = {0};
+    uint8_t trailer[ID3V1_MAX_SIZE] = {'T', 'A', 'G', 'v', '1'};
+    char *title = NULL;
+    ID3 *metadata = NULL;
+    FILE *fp = fopen("assets/tmp", "wb");
+
+    assert_non_null(fp);
+    assert_int_equal(fwrite(audio, 1, sizeof(audio), fp), sizeof(audio));
+    assert_int_equal(fwrite(header, 1, sizeof(header), fp), sizeof(header));
+    assert_int_equal(fwrite(frame, 1, sizeof(frame), fp), sizeof(frame));
+    assert_int_equal(fwrite(footer, 1, sizeof(footer), fp), sizeof(footer));
+    assert_int_equal(fwrite(trailer, 1, sizeof(trailer), fp), sizeof(trailer));
+    fclose(fp);
+
+    metadata = id3FromFile("assets/tmp");
+    (void) remove("assets/tmp");
+
+    assert_non_null(metadata->id3v2);
+    assert_non_null(metadata->id3v1);
+    assert_int_equal(metadata->id3v2->header->majorVersion, ID3V2_TAG_VERSION_4);
+
+    title = id3v2ReadTitle(metadata->id3v2);
+    assert_string_equal(title, "Appended");
+    free(title);
+
+    id3Destroy(&metadata);
+}
+
+static void id3AudioRange_assets(void **state) {
+    (void) state;
+
+    uint64_t start = 1;
+    uint64_t end = 1;
+
+    // the assets hold tags only, so the audio between them is empty
+    assert_true(id3AudioRange("assets/sorry4dying.mp3", &start, &end));
+    assert_int_equal(start, 3099081);
+    assert_int_equal(end, 3099081);
+
+    assert_true(id3AudioRange("assets/Beetlebum.mp3", &start, &end));
+    assert_int_equal(start, 0);
+    assert_int_equal(end, 0);
+
+    // no tags at all
+    assert_true(id3AudioRange("assets/null.mp3", &start, &end));
+    assert_int_equal(start, 0);
+    assert_int_equal(end, 168);
+
+    assert_false(id3AudioRange("assets/doesNotExist.mp3", &start, &end));
+    assert_false(id3AudioRange(NULL, &start, &end));
+}
+
+static void id3AudioRangeFromBuffer_tags(void **state) {
+    (void) state;
+
+    uint8_t file[1024] = {0};
+    uint64_t start = 0;
+    uint64_t end = 0;
+
+    // v2.4 tag of 100 bytes with a footer, audio, appended v2.4 tag of 50 bytes with a footer, ID3v1 tag
+    const uint8_t header[10] = {'I', 'D', '3', 0x04, 0x00, 0x10, 0x00, 0x00, 0x00, 80};
+    const uint8_t appended[10] = {'3', 'D', 'I', 0x04, 0x00, 0x10, 0x00, 0x00, 0x00, 30};
+
+    memcpy(file, header, sizeof(header));
+    memcpy(file + 1024 - ID3V1_MAX_SIZE - 10, appended, sizeof(appended));
+    memcpy(file + 1024 - ID3V1_MAX_SIZE, "TAG", 3);
+
+    assert_true(id3AudioRangeFromBuffer(file, sizeof(file), &start, &end));
+    assert_int_equal(start, 100);
+    assert_int_equal(end, 1024 - ID3V1_MAX_SIZE - 50);
+
+    // no ID3v1 tag
+    memset(file + 1024 - ID3V1_MAX_SIZE, 0, 3);
+    assert_true(id3AudioRangeFromBuffer(file, sizeof(file), &start, &end));
+    assert_int_equal(start, 100);
+    assert_int_equal(end, 1024);
+
+    assert_true(id3AudioRangeFromBuffer(NULL, 0, &start, &end));
+    assert_int_equal(start, 0);
+    assert_int_equal(end, 0);
+
+    assert_false(id3AudioRangeFromBuffer(NULL, 1, &start, &end));
+}
+
+static void id3AudioHash_ignoresTags(void **state) {
+    (void) state;
+
+    uint8_t tagged[1024] = {0};
+    uint8_t plain[1024 - 100 - ID3V1_MAX_SIZE] = {0};
+    uint64_t hash = 0;
+    uint64_t hash2 = 0;
+    FILE *fp = NULL;
+
+    const uint8_t header[10] = {'I', 'D', '3', 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 90};
+
+    for (size_t i = 0; i < sizeof(plain); i++) {
+        plain[i] = (uint8_t) (i * 7 + 3);
+    }
+
+    memcpy(tagged, header, sizeof(header));
+    memcpy(tagged + 100, plain, sizeof(plain));
+    memcpy(tagged + 1024 - ID3V1_MAX_SIZE, "TAGtitle", 8);
+
+    assert_true(id3AudioHashFromBuffer(tagged, sizeof(tagged), &hash));
+    assert_true(id3AudioHashFromBuffer(plain, sizeof(plain), &hash2));
+    assert_true(hash == hash2);
+    assert_true(hash == id3Hash64(plain, sizeof(plain), 0));
+
+    // different tag contents, same audio
+    memcpy(tagged + 20, "different", 9);
+    memcpy(tagged + 1024 - ID3V1_MAX_SIZE, "TAGother", 8);
+    assert_true(id3AudioHashFromBuffer(tagged, sizeof(tagged), &hash2));
+    assert_true(hash == hash2);
+
+    // different audio
+    tagged[500] ^= 0xFF;
+    assert_true(id3AudioHashFromBuffer(tagged, sizeof(tagged), &hash2));
+    assert_true(hash != hash2);
+    tagged[500] ^= 0xFF;
+
+    fp = fopen("assets/tmp", "wb");
+    assert_non_null(fp);
+    assert_int_equal(fwrite(tagged, 1, sizeof(tagged), fp), sizeof(tagged));
+    fclose(fp);
+
+    assert_true(id3AudioHash("assets/tmp", &hash2));
+    (void) remove("assets/tmp");
+    assert_true(hash == hash2);
+}
+
+static void id3AudioHash_assets(void **state) {
+    (void) state;
+
+    uint64_t hash = 0;
+    uint64_t empty = id3Hash64(NULL, 0, 0);
+
+    // the assets hold tags only
+    assert_true(id3AudioHash("assets/sorry4dying.mp3", &hash));
+    assert_true(hash == empty);
+
+    assert_true(id3AudioHash("assets/Beetlebum.mp3", &hash));
+    assert_true(hash == empty);
+
+    assert_true(id3AudioHash("assets/OnGP.mp3", &hash));
+    assert_true(hash == empty);
+
+    assert_false(id3AudioHash("assets/doesNotExist.mp3", &hash));
+    assert_false(id3AudioHash(NULL, &hash));
+    assert_false(id3AudioHashFromBuffer(NULL, 1, &hash));
+}
+
 static void id3Copy_fullTags(void **state) {
     (void) state;
 
@@ -308,7 +468,8 @@ static void id3ConvertId3v2ToId3v1_noId3v1(void **state) {
 
     assert_int_equal(9, id3v1ReadTrack(metadata->id3v1));
     assert_int_equal(0, id3v1ReadYear(metadata->id3v1));
-    assert_int_equal(69, id3v1ReadGenre(metadata->id3v1));
+    // "Experimental Hip-Hop, Glitch" names no ID3v1 genre
+    assert_int_equal(OTHER_GENRE, id3v1ReadGenre(metadata->id3v1));
 
     v1Str = id3v1ReadComment(metadata->id3v1);
     assert_int_equal(0, v1Str[0]);
@@ -354,7 +515,7 @@ static void id3ConvertId3v2ToId3v1_overwriteId3v1(void **state) {
 
     assert_int_equal(99, id3v1ReadTrack(metadata->id3v1));
     assert_int_equal(9999, id3v1ReadYear(metadata->id3v1));
-    assert_int_equal(65, id3v1ReadGenre(metadata->id3v1));
+    assert_int_equal(ALTERNATIVE_GENRE, id3v1ReadGenre(metadata->id3v1));
 
     strv1 = id3v1ReadComment(metadata->id3v1);
     strv2 = id3v2ReadComment(metadata->id3v2);
@@ -740,6 +901,15 @@ static void id3WriteGenre_v1v2(void **state) {
     assert_string_equal(str, id3v1GenreFromTable(1));
     free(str);
 
+    // names and references are looked up
+    v = id3WriteGenre("Grunge", metadata);
+    assert_true(v);
+    assert_int_equal(id3v1ReadGenre(metadata->id3v1), GRUNGE_GENRE);
+
+    v = id3WriteGenre("(17)", metadata);
+    assert_true(v);
+    assert_int_equal(id3v1ReadGenre(metadata->id3v1), ROCK_GENRE);
+
     id3Destroy(&metadata);
 }
 
@@ -1215,6 +1385,251 @@ static void id3WriteToFile_v1v2NoTags(void **state) {
     id3Destroy(&metadata2);
 }
 
+static void id3WriteToFile_v1v2AroundAudio(void **state) {
+    (void) state;
+
+    char str[6] = "music";
+    uint8_t tail[ID3V1_TAG_ID_SIZE] = {0};
+    FILE *fp = fopen("assets/tmp", "wb");
+    ID3 *metadata = NULL;
+    ID3 *metadata2 = NULL;
+    long sz = 0;
+    long sz2 = 0;
+    bool v = false;
+
+    assert_non_null(fp);
+    (void) fwrite(str, sizeof(char), strlen(str), fp);
+    (void) fclose(fp);
+
+    metadata = id3FromFile("assets/Beetlebum.mp3");
+    id3ConvertId3v1ToId3v2(metadata);
+    assert_true(id3WriteToFile("assets/tmp", metadata));
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0, SEEK_END);
+    sz = ftell(fp);
+    (void) fclose(fp);
+
+    // the v2 tag grows so the audio is moved, the v1 tag is replaced
+    id3WriteTitle("a much longer title than the one before", metadata);
+    assert_true(id3WriteToFile("assets/tmp", metadata));
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0, SEEK_END);
+    sz2 = ftell(fp);
+    (void) fseek(fp, -(ID3V1_MAX_SIZE + 5), SEEK_END);
+    (void) fread(str, sizeof(char), 5, fp);
+    (void) fread(tail, sizeof(uint8_t), ID3V1_TAG_ID_SIZE, fp);
+    (void) fclose(fp);
+
+    assert_true(sz2 > sz);
+    assert_memory_equal(str, "music", 5);
+    assert_memory_equal(tail, "TAG", ID3V1_TAG_ID_SIZE);
+
+    metadata2 = id3FromFile("assets/tmp");
+    (void) remove("assets/tmp");
+
+    v = id3Compare(metadata, metadata2);
+
+    id3Destroy(&metadata);
+    id3Destroy(&metadata2);
+
+    assert_true(v);
+}
+
+static void id3WriteToFile_v1v2InPlace(void **state) {
+    (void) state;
+
+    ID3 *metadata = NULL;
+    ID3 *metadata2 = NULL;
+    FILE *fp = NULL;
+    long sz = 0;
+    long sz2 = 0;
+    bool v = false;
+
+    metadata = id3FromFile("assets/sorry4dying.mp3");
+    assert_true(id3WriteToFile("assets/tmp", metadata));
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0, SEEK_END);
+    sz = ftell(fp);
+    (void) fclose(fp);
+
+    // only the v1 tag changes so nothing moves
+    assert_true(id3v1WriteTitle("in place", metadata->id3v1));
+    assert_true(id3WriteToFile("assets/tmp", metadata));
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0, SEEK_END);
+    sz2 = ftell(fp);
+    (void) fclose(fp);
+
+    assert_int_equal(sz, sz2);
+
+    metadata2 = id3FromFile("assets/tmp");
+    (void) remove("assets/tmp");
+
+    v = id3Compare(metadata, metadata2);
+
+    id3Destroy(&metadata);
+    id3Destroy(&metadata2);
+
+    assert_true(v);
+}
+
+static void id3FromJSON_roundTrip(void **state) {
+    (void) state;
+    ID3 *metadata = id3FromFile("assets/sorry4dying.mp3");
+    ID3 *imported = NULL;
+    char *json = NULL;
+    char *out = NULL;
+
+    assert_non_null(metadata);
+    assert_true(id3WriteTitle("round trip", metadata));
+
+    json = id3ToJSON(metadata);
+    imported = id3FromJSON(json);
+    assert_non_null(imported);
+    assert_non_null(imported->id3v2);
+
+    out = id3ToJSON(imported);
+    assert_string_equal(out, json);
+
+    free(out);
+    free(json);
+    id3Destroy(&imported);
+    id3Destroy(&metadata);
+}
+
+static void id3FromJSON_v1Only(void **state) {
+    (void) state;
+    ID3 *metadata = id3FromJSON(
+        "{\"ID3v1\":{\"title\":\"title\",\"artist\":\"artist\",\"album\":\"album\",\"year\":2000,\"track\":2,\"comment\":\"\",\"genreNumber\":0,\"genre\":\"Blues\"},\"ID3v2\":{}}");
+    char *title = NULL;
+
+    assert_non_null(metadata);
+    assert_non_null(metadata->id3v1);
+    assert_null(metadata->id3v2);
+
+    title = id3v1ReadTitle(metadata->id3v1);
+    assert_string_equal(title, "title");
+
+    free(title);
+    id3Destroy(&metadata);
+}
+
+static void id3FromJSON_invalid(void **state) {
+    (void) state;
+
+    assert_null(id3FromJSON(NULL));
+    assert_null(id3FromJSON("{}"));
+    assert_null(id3FromJSON("{\"ID3v1\":{\"title\":1},\"ID3v2\":{}}"));
+    assert_null(id3FromJSON("{\"ID3v1\":{},\"ID3v2\":{}} trailing"));
+}
+
+static void id3ToCBOR_roundTrip(void **state) {
+    (void) state;
+    ID3 *metadata = id3FromFile("assets/sorry4dying.mp3");
+    ID3 *imported = NULL;
+    uint8_t *cbor = NULL;
+    size_t cborl = 0;
+    char *json = NULL;
+    char *importedJson = NULL;
+
+    assert_non_null(metadata);
+
+    cbor = id3ToCBOR(metadata, &cborl);
+    assert_non_null(cbor);
+
+    imported = id3FromCBOR(cbor, cborl);
+    assert_non_null(imported);
+
+    json = id3ToJSON(metadata);
+    importedJson = id3ToJSON(imported);
+    assert_string_equal(importedJson, json);
+
+    free(importedJson);
+    free(json);
+    free(cbor);
+    id3Destroy(&imported);
+    id3Destroy(&metadata);
+}
+
+static void id3CreateOptions_valid(void **state) {
+    (void) state;
+
+    Id3v2WriteOptions *write = id3v2CreateWriteOptions(fixed_padding, 128);
+    Id3Options *options = id3CreateOptions(ID3V2_TAG_VERSION_4, NULL, write);
+
+    assert_non_null(options);
+    assert_int_equal(options->preferredStandard, ID3V2_TAG_VERSION_4);
+    assert_null(options->userPairs);
+    assert_non_null(options->writeOptions);
+    assert_true(options->writeOptions != write);
+    assert_int_equal(options->writeOptions->paddingAmount, 128);
+
+    id3v2DestroyWriteOptions(&write);
+    id3DestroyOptions(&options);
+    assert_null(options);
+}
+
+static void id3CreateOptions_invalidStandard(void **state) {
+    (void) state;
+
+    assert_null(id3CreateOptions(5, NULL, NULL));
+    assert_null(id3CreateOptions(0, NULL, NULL));
+}
+
+static void id3FromFileWithOptions_ownPreference(void **state) {
+    (void) state;
+
+    Id3Options *options = id3CreateOptions(ID3V1_TAG_VERSION, NULL, NULL);
+    ID3 *metadata = id3FromFileWithOptions("assets/sorry4dying.mp3", options);
+    ID3 *copy = NULL;
+
+    assert_non_null(metadata);
+    assert_non_null(metadata->id3v2);
+    assert_non_null(metadata->id3v1);
+    assert_true(metadata->options == options);
+
+    // the library wide preference is ignored
+    id3SetPreferredStandard(ID3V2_TAG_VERSION_3);
+    assert_int_equal(id3GetPreferredStandard(), ID3V2_TAG_VERSION_3);
+    assert_int_equal(options->preferredStandard, ID3V1_TAG_VERSION);
+
+    copy = id3Copy(metadata);
+    assert_true(copy->options == options);
+
+    assert_true(id3SetOptions(metadata, NULL));
+    assert_null(metadata->options);
+    assert_false(id3SetOptions(NULL, options));
+
+    id3Destroy(&copy);
+    id3Destroy(&metadata);
+    id3DestroyOptions(&options);
+}
+
+static void id3ConvertId3v1ToId3v2_options(void **state) {
+    (void) state;
+
+    Id3Options *options = id3CreateOptions(ID3V2_TAG_VERSION_4, NULL, NULL);
+    ID3 *metadata = id3FromFileWithOptions("assets/Beetlebum.mp3", options);
+
+    id3SetPreferredStandard(ID3V2_TAG_VERSION_2);
+
+    assert_true(id3ConvertId3v1ToId3v2(metadata));
+    assert_non_null(metadata->id3v2);
+    assert_int_equal(metadata->id3v2->header->majorVersion, ID3V2_TAG_VERSION_4);
+
+    id3SetPreferredStandard(ID3V2_TAG_VERSION_3);
+    id3Destroy(&metadata);
+    id3DestroyOptions(&options);
+}
+
 int main() {
     FILE *fp = NULL;
 
@@ -1238,6 +1653,15 @@ int main() {
         // id3TagFromFile
         cmocka_unit_test(id3FromFile_badPath),
         cmocka_unit_test(id3FromFile_noV2),
+        cmocka_unit_test(id3FromFile_appendedV24),
+
+        // id3AudioRange
+        cmocka_unit_test(id3AudioRange_assets),
+        cmocka_unit_test(id3AudioRangeFromBuffer_tags),
+
+        // id3AudioHash
+        cmocka_unit_test(id3AudioHash_ignoresTags),
+        cmocka_unit_test(id3AudioHash_assets),
 
         // id3Copy
         cmocka_unit_test(id3Copy_fullTags),
@@ -1302,6 +1726,22 @@ int main() {
         cmocka_unit_test(id3WriteToFile_v2UpdateExisting),
         cmocka_unit_test(id3WriteToFile_v2PrependTag),
         cmocka_unit_test(id3WriteToFile_v1v2NoTags),
+        cmocka_unit_test(id3WriteToFile_v1v2AroundAudio),
+        cmocka_unit_test(id3WriteToFile_v1v2InPlace),
+
+        // id3FromJSON
+        cmocka_unit_test(id3FromJSON_roundTrip),
+        cmocka_unit_test(id3FromJSON_v1Only),
+        cmocka_unit_test(id3FromJSON_invalid),
+
+        // id3ToCBOR
+        cmocka_unit_test(id3ToCBOR_roundTrip),
+
+        // id3Options
+        cmocka_unit_test(id3CreateOptions_valid),
+        cmocka_unit_test(id3CreateOptions_invalidStandard),
+        cmocka_unit_test(id3FromFileWithOptions_ownPreference),
+        cmocka_unit_test(id3ConvertId3v1ToId3v2_options),
 
     };
 
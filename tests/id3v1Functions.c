@@ -846,6 +846,51 @@ static void id3v1GenreFromTable_checkForHipHopGenre(void **state) {
     assert_string_equal(id3v1GenreFromTable(HIP_HOP_GENRE), "Hip-Hop");
 }
 
+static void id3v1GenreName_table(void **state) {
+    (void) state; /* unused */
+
+    assert_string_equal(id3v1GenreName(BLUES_GENRE), "Blues");
+    assert_string_equal(id3v1GenreName(CHRISTMAS_GENRE), "Christmas");
+    assert_string_equal(id3v1GenreName(PSYBIENT_GENRE), "Psybient");
+
+    // outside the table
+    assert_string_equal(id3v1GenreName(GENRE_UNKNOWN), "Other");
+    assert_string_equal(id3v1GenreName(200), "Other");
+
+    // borrowed, the same string every time
+    assert_true(id3v1GenreName(ROCK_GENRE) == id3v1GenreName(ROCK_GENRE));
+}
+
+static void id3v1GenreFromString_names(void **state) {
+    (void) state; /* unused */
+
+    for (int i = BLUES_GENRE; i <= PSYBIENT_GENRE; i++) {
+        assert_int_equal(id3v1GenreFromString(id3v1GenreName(i)), i);
+    }
+
+    assert_int_equal(id3v1GenreFromString("rock"), ROCK_GENRE);
+    assert_int_equal(id3v1GenreFromString("HIP-HOP"), HIP_HOP_GENRE);
+    assert_int_equal(id3v1GenreFromString("Roc"), GENRE_UNKNOWN);
+    assert_int_equal(id3v1GenreFromString("Rocks"), GENRE_UNKNOWN);
+    assert_int_equal(id3v1GenreFromString(""), GENRE_UNKNOWN);
+    assert_int_equal(id3v1GenreFromString(NULL), GENRE_UNKNOWN);
+}
+
+static void id3v1GenreFromString_references(void **state) {
+    (void) state; /* unused */
+
+    assert_int_equal(id3v1GenreFromString("(17)"), ROCK_GENRE);
+    assert_int_equal(id3v1GenreFromString("(17)Rock"), ROCK_GENRE);
+    assert_int_equal(id3v1GenreFromString("17"), ROCK_GENRE);
+    assert_int_equal(id3v1GenreFromString("(0)"), BLUES_GENRE);
+    assert_int_equal(id3v1GenreFromString("192"), PSYBIENT_GENRE);
+
+    assert_int_equal(id3v1GenreFromString("193"), GENRE_UNKNOWN);
+    assert_int_equal(id3v1GenreFromString("(RX)"), GENRE_UNKNOWN);
+    assert_int_equal(id3v1GenreFromString("(17"), GENRE_UNKNOWN);
+    assert_int_equal(id3v1GenreFromString("17)"), GENRE_UNKNOWN);
+}
+
 static void id3v1ToJSON_fullTag(void **state) {
     (void) state; /* unused */
 
@@ -1104,6 +1149,76 @@ static void id3v1WriteTagToFile_appendFileBig(void **state) {
     (void) remove("test.mp3");
 }
 
+static void id3v1TagFromJSON_roundTrip(void **state) {
+    (void) state;
+    Id3v1Tag *tag = id3v1CreateTag((uint8_t *) "Beetlebum", (uint8_t *) "Blur", (uint8_t *) "Blur", 1997, 1,
+                                   (uint8_t *) "a comment", ALTERNATIVE_ROCK_GENRE);
+    Id3v1Tag *imported = NULL;
+    char *json = id3v1ToJSON(tag);
+    char *out = NULL;
+
+    imported = id3v1TagFromJSON(json);
+    assert_non_null(imported);
+    assert_true(id3v1CompareTag(tag, imported));
+
+    out = id3v1ToJSON(imported);
+    assert_string_equal(out, json);
+
+    free(out);
+    free(json);
+    id3v1DestroyTag(&imported);
+    id3v1DestroyTag(&tag);
+}
+
+static void id3v1TagFromJSON_longField(void **state) {
+    (void) state;
+    Id3v1Tag *tag = id3v1TagFromJSON(
+        "{\"title\":\"a title that is far longer than thirty bytes\",\"year\":2001,\"genreNumber\":17,\"genre\":\"ignored\",\"extra\":[1,2]}");
+
+    assert_non_null(tag);
+    assert_memory_equal(tag->title, "a title that is far longer tha", ID3V1_FIELD_SIZE);
+    assert_int_equal(tag->year, 2001);
+    assert_int_equal(tag->track, 0);
+    assert_int_equal(tag->genre, 17);
+
+    id3v1DestroyTag(&tag);
+}
+
+static void id3v1TagFromJSON_invalid(void **state) {
+    (void) state;
+
+    assert_null(id3v1TagFromJSON(NULL));
+    assert_null(id3v1TagFromJSON("{}"));
+    assert_null(id3v1TagFromJSON("{\"title\":1}"));
+    assert_null(id3v1TagFromJSON("{\"genreNumber\":300}"));
+    assert_null(id3v1TagFromJSON("{\"title\":\"a\"}{}"));
+}
+
+static void id3v1ToCBOR_roundTrip(void **state) {
+    (void) state;
+    Id3v1Tag *tag = id3v1CreateTag((uint8_t *) "a title that fills all thirty", (uint8_t *) "Blur",
+                                   (uint8_t *) "Blur", 1997, 1, (uint8_t *) "a \"quoted\" comment",
+                                   ALTERNATIVE_ROCK_GENRE);
+    Id3v1Tag *imported = NULL;
+    size_t cborl = 0;
+    uint8_t *cbor = id3v1ToCBOR(tag, &cborl);
+
+    assert_non_null(cbor);
+
+    imported = id3v1TagFromCBOR(cbor, cborl);
+    assert_non_null(imported);
+    assert_true(id3v1CompareTag(tag, imported));
+
+    free(cbor);
+    id3v1DestroyTag(&imported);
+    id3v1DestroyTag(&tag);
+
+    cbor = id3v1ToCBOR(NULL, &cborl);
+    assert_int_equal(cborl, 1);
+    assert_null(id3v1TagFromCBOR(cbor, cborl));
+    free(cbor);
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
         //id3v1HasTag tests
@@ -1170,6 +1285,13 @@ int main() {
         cmocka_unit_test(id3v1GenreFromTable_checkNoNull),
         cmocka_unit_test(id3v1GenreFromTable_checkForHipHopGenre),
 
+        //id3v1GenreName tests
+        cmocka_unit_test(id3v1GenreName_table),
+
+        //id3v1GenreFromString tests
+        cmocka_unit_test(id3v1GenreFromString_names),
+        cmocka_unit_test(id3v1GenreFromString_references),
+
         //id3v1ToJSON
         cmocka_unit_test(id3v1ToJSON_fullTag),
         cmocka_unit_test(id3v1ToJSON_noGenre),
@@ -1183,6 +1305,14 @@ int main() {
         cmocka_unit_test(id3v1WriteTagToFile_appendFile),
         cmocka_unit_test(id3v1WriteTagToFile_appendFileBig),
 
+        //id3v1TagFromJSON
+        cmocka_unit_test(id3v1TagFromJSON_roundTrip),
+        cmocka_unit_test(id3v1TagFromJSON_longField),
+        cmocka_unit_test(id3v1TagFromJSON_invalid),
+
+        //id3v1ToCBOR
+        cmocka_unit_test(id3v1ToCBOR_roundTrip),
+
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -748,6 +748,9 @@ static void id3v2FrameSerialize_v2EQU(void **state) {
 
     assert_non_null(f);
 
+    // encode from the parsed entries rather than the bytes read
+    id3v2MarkFrameDirty(f);
+
     size_t outl = 0;
     uint8_t *out = id3v2FrameSerialize(f, ID3V2_TAG_VERSION_2, &outl);
     rep = byteStreamCreate(out, outl);
@@ -990,6 +993,289 @@ static void id3v2CompareFrameId_EQU(void **state) {
     id3v2DestroyFrame(&f);
 }
 
+static void id3v2FrameSerialize_v2EQUUnchanged(void **state) {
+    (void) state;
+    uint8_t equ[15] = {
+        'E', 'Q', 'U', 0x00, 0x00, 0x09,
+        2U,
+        0x03, 0xe9,
+        0x40, 0x00,
+        0x00, 0x28,
+        0xfc, 0x00
+    };
+
+    Id3v2Frame *f = NULL;
+    List *context = id3v2CreateEqualizationFrameContext(ID3V2_TAG_VERSION_2);
+    size_t outl = 0;
+    uint8_t *out = NULL;
+
+    id3v2ParseFrame(equ, 15, context, ID3V2_TAG_VERSION_2, &f);
+    assert_non_null(f);
+
+    assert_false(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_2));
+    assert_true(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_3));
+
+    out = id3v2FrameSerialize(f, ID3V2_TAG_VERSION_2, &outl);
+    assert_int_equal(outl, 15);
+    assert_memory_equal(out, equ, 15);
+
+    free(out);
+    listFree(context);
+    id3v2DestroyFrame(&f);
+}
+
+static void id3v2WriteFrameEntry_marksDirty(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/OnGP.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    Id3v2Frame *f = (Id3v2Frame *) tag->frames->head->data;
+    Id3v2Frame *g = (Id3v2Frame *) tag->frames->head->next->data;
+    ListIter entries = id3v2CreateFrameEntryTraverser(f);
+    size_t outl = 0;
+    uint8_t *out = NULL;
+
+    assert_false(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_4));
+    assert_false(id3v2FrameIsDirty(g, ID3V2_TAG_VERSION_4));
+
+    // skip the encoding
+    id3v2ReadFrameEntry(&entries, &outl);
+    assert_true(id3v2WriteFrameEntry(f, &entries, 6, "album"));
+
+    assert_true(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_4));
+    assert_false(id3v2FrameIsDirty(g, ID3V2_TAG_VERSION_4));
+
+    // serializing caches the new bytes
+    out = id3v2FrameSerialize(f, ID3V2_TAG_VERSION_4, &outl);
+    assert_non_null(out);
+    assert_false(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_4));
+    assert_memory_equal(out + 11, "album", 5);
+    free(out);
+
+    // header changes are noticed
+    g->header->readOnly = !g->header->readOnly;
+    assert_true(id3v2FrameIsDirty(g, ID3V2_TAG_VERSION_4));
+
+    byteStreamDestroy(stream);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2CopyFrame_keepsCache(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    Id3v2Frame *f = (Id3v2Frame *) tag->frames->head->data;
+    Id3v2Frame *copy = id3v2CopyFrame(f);
+
+    assert_false(id3v2FrameIsDirty(copy, ID3V2_TAG_VERSION_3));
+    assert_int_equal(copy->rawSize, f->rawSize);
+    assert_memory_equal(copy->raw, f->raw, f->rawSize);
+    assert_true(copy->raw != f->raw);
+
+    id3v2MarkFrameDirty(copy);
+    assert_null(copy->raw);
+    assert_true(id3v2FrameIsDirty(copy, ID3V2_TAG_VERSION_3));
+    assert_false(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_3));
+
+    id3v2DestroyFrame(&copy);
+    byteStreamDestroy(stream);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2CacheFrameBytes_sharesPicture(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/OnGP.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    ListIter frames = listCreateIterator(tag->frames);
+    Id3v2Frame *f = NULL;
+    Id3v2Frame *copy = NULL;
+    ListIter entries;
+    Id3v2ContentEntry *entry = NULL;
+    Id3v2ContentEntry *last = NULL;
+    size_t outl = 0;
+    uint8_t *out = NULL;
+
+    while ((f = listIteratorNext(&frames)) != NULL) {
+        if (memcmp(f->header->id, "APIC", ID3V2_FRAME_ID_MAX_SIZE) == 0) {
+            break;
+        }
+    }
+
+    assert_non_null(f);
+    entries = listCreateIterator(f->entries);
+
+    while ((entry = listIteratorNext(&entries)) != NULL) {
+        last = entry;
+    }
+
+    // the picture is held by its entry only
+    assert_true(f->rawShared == last->size);
+    assert_true(f->rawSize < ID3V2_FRAME_CACHE_SHARE_SIZE);
+    assert_false(id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_4));
+
+    out = id3v2FrameSerialize(f, ID3V2_TAG_VERSION_4, &outl);
+    assert_true(outl == f->rawSize + f->rawShared);
+    assert_memory_equal(out, stream->buffer + f->rawOffset, outl);
+    free(out);
+
+    copy = id3v2CopyFrame(f);
+    assert_true(copy->rawShared == f->rawShared);
+    out = id3v2FrameSerialize(copy, ID3V2_TAG_VERSION_4, &outl);
+    assert_memory_equal(out, stream->buffer + f->rawOffset, outl);
+    free(out);
+
+    id3v2DestroyFrame(&copy);
+    byteStreamDestroy(stream);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2FrameToJSON_v2EQU(void **state) {
+    (void) state;
+    uint8_t equ[15] = {
+        'E', 'Q', 'U', 0x00, 0x00, 0x09,
+        2U,
+        0x03, 0xe9,
+        0x40, 0x00,
+        0x00, 0x28,
+        0xfc, 0x00
+    };
+
+    Id3v2Frame *f = NULL;
+    List *context = id3v2CreateEqualizationFrameContext(ID3V2_TAG_VERSION_2);
+    Id3Sink *sink = id3SinkCreateBuffer(0);
+    const char *entry = NULL;
+    char *json = NULL;
+
+    id3v2ParseFrame(equ, 15, context, ID3V2_TAG_VERSION_2, &f);
+    assert_non_null(f);
+
+    json = id3v2FrameToJSON(f, ID3V2_TAG_VERSION_2);
+    assert_non_null(json);
+    assert_true(strncmp(json, "{\"header\":{\"id\":\"EQU\"},\"content\":[{\"value\":", 44) == 0);
+    assert_string_equal(json + strlen(json) - 3, "}]}");
+
+    // every entry including the volume adjustments is closed
+    entry = json;
+    while ((entry = strstr(entry + 1, ",{\"value\"")) != NULL) {
+        assert_int_equal(entry[-1], '}');
+    }
+
+    assert_true(id3v2FrameToJSONSink(f, ID3V2_TAG_VERSION_2, sink));
+    assert_string_equal((const char *) id3SinkBuffer(sink, NULL), json);
+
+    free(json);
+    id3SinkDestroy(&sink);
+    listFree(context);
+    id3v2DestroyFrame(&f);
+}
+
+static void id3v2FrameFromJSON_v3TXXX(void **state) {
+    (void) state;
+    const char *json =
+        "{\"header\":{\"id\":\"TXXX\",\"tagAlterPreservation\":false,\"fileAlterPreservation\":false,\"readOnly\":false,\"decompressionSize\":0,\"encryptionSymbol\":0,\"groupSymbol\":0},\"content\":[{\"value\":\"1\",\"size\":1},{\"value\":\"PERFORMER\",\"size\":9},{\"value\":\"Quadeca\",\"size\":7}]}";
+    Id3v2Frame *f = id3v2FrameFromJSON(json, ID3V2_TAG_VERSION_3);
+    char *out = NULL;
+
+    assert_non_null(f);
+    assert_memory_equal(f->header->id, "TXXX", ID3V2_FRAME_ID_MAX_SIZE);
+    assert_int_equal(f->entries->length, 3);
+
+    out = id3v2FrameToJSON(f, ID3V2_TAG_VERSION_3);
+    assert_string_equal(out, json);
+
+    free(out);
+    id3v2DestroyFrame(&f);
+}
+
+static void id3v2FrameFromJSON_v3APIC(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    ListIter iter = id3v2CreateFrameTraverser(tag);
+    Id3v2Frame *f = NULL;
+    Id3v2Frame *imported = NULL;
+    char *json = NULL;
+    char *out = NULL;
+
+    while ((f = id3v2FrameTraverse(&iter)) != NULL) {
+        if (memcmp(f->header->id, "APIC", ID3V2_FRAME_ID_MAX_SIZE) == 0) {
+            json = id3v2FrameToJSON(f, ID3V2_TAG_VERSION_3);
+            break;
+        }
+    }
+
+    assert_non_null(json);
+
+    // the base64 picture is decoded back into the same bytes
+    imported = id3v2FrameFromJSON(json, ID3V2_TAG_VERSION_3);
+    assert_non_null(imported);
+    assert_int_equal(imported->entries->length, f->entries->length);
+
+    out = id3v2FrameToJSON(imported, ID3V2_TAG_VERSION_3);
+    assert_string_equal(out, json);
+
+    free(out);
+    free(json);
+    id3v2DestroyFrame(&imported);
+    id3v2DestroyTag(&tag);
+    byteStreamDestroy(stream);
+}
+
+static void id3v2FrameFromJSON_invalid(void **state) {
+    (void) state;
+
+    assert_null(id3v2FrameFromJSON(NULL, ID3V2_TAG_VERSION_3));
+    assert_null(id3v2FrameFromJSON("{}", ID3V2_TAG_VERSION_3));
+    assert_null(id3v2FrameFromJSON("{\"content\":[],\"header\":{\"id\":\"TIT2\"}}", ID3V2_TAG_VERSION_3));
+    assert_null(id3v2FrameFromJSON("{\"header\":{\"id\":\"TIT2\"},\"content\":[{\"value\":\"1\",\"size\":1}]} x",
+                                   ID3V2_TAG_VERSION_3));
+    assert_null(id3v2FrameFromJSON("{\"header\":{\"id\":\"TIT2\"},\"content\":[]}", ID3V2_TAG_VERSION_2));
+    assert_null(id3v2FrameFromJSON("{\"header\":{\"id\":\"TIT2\"},\"content\":[{\"value\":\"1\",\"size\":1},",
+                                   ID3V2_TAG_VERSION_3));
+}
+
+static void id3v2FrameToCBOR_v3APIC(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    ListIter iter = id3v2CreateFrameTraverser(tag);
+    Id3v2Frame *f = NULL;
+    Id3v2Frame *imported = NULL;
+    uint8_t *cbor = NULL;
+    size_t cborl = 0;
+    char *json = NULL;
+    char *importedJson = NULL;
+
+    while ((f = id3v2FrameTraverse(&iter)) != NULL) {
+        if (memcmp(f->header->id, "APIC", ID3V2_FRAME_ID_MAX_SIZE) == 0) {
+            break;
+        }
+    }
+
+    assert_non_null(f);
+
+    cbor = id3v2FrameToCBOR(f, ID3V2_TAG_VERSION_3, &cborl);
+    json = id3v2FrameToJSON(f, ID3V2_TAG_VERSION_3);
+    assert_non_null(cbor);
+
+    // the picture is carried as raw bytes instead of base64
+    assert_true(cborl < strlen(json));
+
+    imported = id3v2FrameFromCBOR(cbor, cborl, ID3V2_TAG_VERSION_3);
+    assert_non_null(imported);
+
+    importedJson = id3v2FrameToJSON(imported, ID3V2_TAG_VERSION_3);
+    assert_string_equal(importedJson, json);
+
+    assert_null(id3v2FrameFromCBOR(cbor, cborl - 1, ID3V2_TAG_VERSION_3));
+
+    free(importedJson);
+    free(json);
+    free(cbor);
+    id3v2DestroyFrame(&imported);
+    id3v2DestroyTag(&tag);
+    byteStreamDestroy(stream);
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(id3v2CreateAndDestroyFrameHeader_allInOne),
@@ -1035,6 +1321,7 @@ int main() {
         cmocka_unit_test(id3v2FrameToJSON_v3TXXX),
         cmocka_unit_test(id3v2FrameToJSON_v3APIC),
         cmocka_unit_test(id3v2FrameToJSON_v4ETCO),
+        cmocka_unit_test(id3v2FrameToJSON_v2EQU),
 
         // id3v2CreateEmptyFrame
         cmocka_unit_test(id3v2CreateEmptyFrame_noID),
@@ -1042,7 +1329,21 @@ int main() {
 
         // id3v2CompareFrameId
         cmocka_unit_test(id3v2CompareFrameId_badArgs),
-        cmocka_unit_test(id3v2CompareFrameId_EQU)
+        cmocka_unit_test(id3v2CompareFrameId_EQU),
+
+        // frame cache
+        cmocka_unit_test(id3v2FrameSerialize_v2EQUUnchanged),
+        cmocka_unit_test(id3v2WriteFrameEntry_marksDirty),
+        cmocka_unit_test(id3v2CopyFrame_keepsCache),
+        cmocka_unit_test(id3v2CacheFrameBytes_sharesPicture),
+
+        // id3v2FrameFromJSON
+        cmocka_unit_test(id3v2FrameFromJSON_v3TXXX),
+        cmocka_unit_test(id3v2FrameFromJSON_v3APIC),
+        cmocka_unit_test(id3v2FrameFromJSON_invalid),
+
+        // id3v2FrameToCBOR
+        cmocka_unit_test(id3v2FrameToCBOR_v3APIC)
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -13,10 +13,13 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdlib.h>
+#include <string.h>
 #include "id3v2/id3v2.h"
 #include "id3v2/id3v2Frame.h"
 #include "byteStream.h"
 #include "id3v2/id3v2Parser.h"
+#include "id3v2/id3v2Unsynchronisation.h"
+#include "id3Sha1.h"
 
 static void id3v2TagFromFile_v3(void **state) {
     (void) state;
@@ -635,6 +638,504 @@ static void id3v2ReadPicture_APIC(void **state) {
     id3v2DestroyTag(&tag);
 }
 
+static void id3v2ReadPictureView_APIC(void **state) {
+    (void) state;
+    Id3FileMapping mapping = {0};
+
+    assert_true(id3FileMap("assets/OnGP.mp3", &mapping));
+
+    Id3v2Tag *tag = id3v2TagFromMapping(&mapping);
+    size_t copySize = 0;
+    size_t viewSize = 0;
+    uint8_t *copy = id3v2ReadPicture(0, tag, &copySize);
+    const uint8_t *view = id3v2ReadPictureView(0, tag, &mapping, &viewSize);
+
+    assert_non_null(copy);
+    assert_non_null(view);
+    assert_int_equal(viewSize, copySize);
+    assert_memory_equal(view, copy, copySize);
+    assert_true(view >= mapping.data && view + viewSize <= mapping.data + mapping.length);
+    free(copy);
+
+    // no picture of this type
+    assert_null(id3v2ReadPictureView(0x14, tag, &mapping, &viewSize));
+    assert_int_equal(viewSize, 0);
+
+    id3v2DestroyTag(&tag);
+    id3FileUnmap(&mapping);
+}
+
+static void id3v2ReadPictureView_PIC(void **state) {
+    (void) state;
+    Id3FileMapping mapping = {0};
+
+    assert_true(id3FileMap("assets/danybrown2.mp3", &mapping));
+
+    Id3v2Tag *tag = id3v2TagFromMapping(&mapping);
+    size_t dataSize = 0;
+    const uint8_t *view = id3v2ReadPictureView(0, tag, &mapping, &dataSize);
+
+    assert_non_null(view);
+    assert_int_equal(dataSize, 107904);
+
+    id3v2DestroyTag(&tag);
+    id3FileUnmap(&mapping);
+}
+
+static void id3v2ReadPictureView_changed(void **state) {
+    (void) state;
+    Id3FileMapping mapping = {0};
+
+    assert_true(id3FileMap("assets/OnGP.mp3", &mapping));
+
+    Id3v2Tag *tag = id3v2TagFromMapping(&mapping);
+    size_t dataSize = 0;
+    Id3v2Frame *f = NULL;
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        if (memcmp(f->header->id, "APIC", ID3V2_FRAME_ID_MAX_SIZE) == 0) {
+            id3v2MarkFrameDirty(f);
+        }
+    }
+
+    // the held picture may differ from the file
+    assert_null(id3v2ReadPictureView(0, tag, &mapping, &dataSize));
+
+    id3v2DestroyTag(&tag);
+    id3FileUnmap(&mapping);
+}
+
+static void id3v2ExtractPictureToFd_APIC(void **state) {
+    (void) state;
+
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    size_t dataSize = 0;
+    uint64_t size = 0;
+    uint8_t *data = id3v2ReadPicture(0, tag, &dataSize);
+    uint8_t *copied = NULL;
+    FILE *fp = fopen("assets/tmp", "wb");
+    int fd = -1;
+
+    assert_non_null(fp);
+    (void) fclose(fp);
+    fd = id3FileOpen("assets/tmp", true);
+    assert_true(fd >= 0);
+
+    assert_true(id3v2ExtractPictureToFd("assets/OnGP.mp3", 0, fd));
+    assert_true(id3FileSize(fd, &size));
+    assert_true(size == dataSize);
+
+    copied = malloc(dataSize);
+    assert_true(id3FileReadAt(fd, copied, dataSize, 0));
+    assert_memory_equal(copied, data, dataSize);
+
+    id3FileClose(fd);
+    (void) remove("assets/tmp");
+    free(copied);
+    free(data);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2ExtractPictureToFd_missing(void **state) {
+    (void) state;
+
+    FILE *fp = fopen("assets/tmp", "wb");
+    uint64_t size = 0;
+    int fd = -1;
+
+    assert_non_null(fp);
+    (void) fclose(fp);
+    fd = id3FileOpen("assets/tmp", true);
+    assert_true(fd >= 0);
+
+    // no picture of this type, no picture, no tag, nothing to read or write
+    assert_false(id3v2ExtractPictureToFd("assets/OnGP.mp3", 0x14, fd));
+    assert_false(id3v2ExtractPictureToFd("assets/sorry4dying.mp3", 0x14, fd));
+    assert_false(id3v2ExtractPictureToFd("assets/null.mp3", 0, fd));
+    assert_false(id3v2ExtractPictureToFd(NULL, 0, fd));
+    assert_false(id3v2ExtractPictureToFd("assets/OnGP.mp3", 0, -1));
+
+    assert_true(id3FileSize(fd, &size));
+    assert_true(size == 0);
+
+    id3FileClose(fd);
+    (void) remove("assets/tmp");
+}
+
+static void id3v2WriteAudioHash_versions(void **state) {
+    (void) state;
+    const char *files[] = {"assets/boniver.mp3", "assets/sorry4dying.mp3", "assets/OnGP.mp3"};
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        Id3v2Tag *tag = id3v2TagFromFile(files[i]);
+        Id3v2Tag *parsed = NULL;
+        uint8_t *out = NULL;
+        size_t outl = 0;
+        uint64_t hash = 0;
+
+        assert_non_null(tag);
+        assert_false(id3v2ReadAudioHash(tag, &hash));
+
+        assert_true(id3v2WriteAudioHash(0x0123456789ABCDEFULL, tag));
+        assert_true(id3v2ReadAudioHash(tag, &hash));
+        assert_true(hash == 0x0123456789ABCDEFULL);
+
+        // replaced rather than added
+        size_t frames = tag->frames->length;
+        assert_true(id3v2WriteAudioHash(42, tag));
+        assert_int_equal(tag->frames->length, frames);
+
+        // survives serialization
+        out = id3v2TagSerialize(tag, &outl);
+        assert_non_null(out);
+        parsed = id3v2ParseTagFromBuffer(out, outl, NULL);
+        assert_non_null(parsed);
+        assert_true(id3v2ReadAudioHash(parsed, &hash));
+        assert_true(hash == 42);
+
+        free(out);
+        id3v2DestroyTag(&parsed);
+        id3v2DestroyTag(&tag);
+    }
+
+    assert_false(id3v2WriteAudioHash(0, NULL));
+    assert_false(id3v2ReadAudioHash(NULL, NULL));
+}
+
+static void id3v2ReadAudioHash_otherOwner(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3v2Frame *f = id3v2CreateEmptyFrame("UFID", ID3V2_TAG_VERSION_4, NULL);
+    ListIter entries = id3v2CreateFrameEntryTraverser(f);
+    uint8_t id[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint64_t hash = 0;
+
+    // a UFID from another owner is not a hash
+    assert_true(id3v2WriteFrameEntry(f, &entries, strlen("http://musicbrainz.org"), "http://musicbrainz.org"));
+    id3v2ReadFrameEntryAsU8(&entries);
+    assert_true(id3v2WriteFrameEntry(f, &entries, sizeof(id), id));
+    assert_true(id3v2AttachFrameToTag(tag, f));
+
+    assert_false(id3v2ReadAudioHash(tag, &hash));
+
+    assert_true(id3v2WriteAudioHash(7, tag));
+    assert_true(id3v2ReadAudioHash(tag, &hash));
+    assert_true(hash == 7);
+
+    id3v2DestroyTag(&tag);
+}
+
+// 200 frames of 417 bytes at 128kbps with a seek point every 38 frames, after a 100 byte tag
+static void seekIndexCBR(Id3MpegIndex *index, uint64_t offsets[6]) {
+    for (int i = 0; i < 6; i++) {
+        offsets[i] = (uint64_t) i * 38 * 417;
+    }
+
+    memset(index, 0, sizeof(Id3MpegIndex));
+    index->start = 100;
+    index->length = 417 * 200;
+    index->frames = 200;
+    index->samplesPerFrame = 1152;
+    index->sampleRate = 44100;
+    index->stride = 38;
+    index->count = 6;
+    index->offsets = offsets;
+}
+
+static void seekFrameEquals(Id3v2Tag *tag, const char *id, const uint8_t *expected, size_t expectedSize) {
+    Id3v2Frame *f = id3v2ReadFrameByID(id, tag);
+    ListIter entries = {0};
+    uint8_t *data = NULL;
+    size_t dataSize = 0;
+
+    assert_non_null(f);
+    entries = id3v2CreateFrameEntryTraverser(f);
+    data = id3v2ReadFrameEntry(&entries, &dataSize);
+
+    assert_int_equal(dataSize, expectedSize);
+    assert_memory_equal(data, expected, expectedSize);
+
+    free(data);
+    id3v2DestroyFrame(&f);
+}
+
+static void id3v2WriteSeekIndex_ASPI(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3MpegIndex index;
+    uint64_t offsets[6];
+    size_t frames = 0;
+
+    // start, length, 6 points of 16 bits at frames 0, 33, 66, 100, 133 and 166
+    const uint8_t aspi[] = {0x00, 0x00, 0x00, 0x64, 0x00, 0x01, 0x45, 0xC8, 0x00, 0x06, 0x10,
+                            0x00, 0x00, 0x2A, 0x3D, 0x54, 0x7A, 0x80, 0x00, 0xAA, 0x3D, 0xD4, 0x7A};
+
+    seekIndexCBR(&index, offsets);
+    frames = tag->frames->length;
+
+    assert_true(id3v2WriteSeekIndex(&index, tag));
+    assert_int_equal(tag->frames->length, frames + 1);
+    seekFrameEquals(tag, "ASPI", aspi, sizeof(aspi));
+
+    // replaced rather than added
+    assert_true(id3v2WriteSeekIndex(&index, tag));
+    assert_int_equal(tag->frames->length, frames + 1);
+
+    assert_false(id3v2WriteSeekIndex(NULL, tag));
+    assert_false(id3v2WriteSeekIndex(&index, NULL));
+
+    // nothing to index
+    index.count = 0;
+    assert_false(id3v2WriteSeekIndex(&index, tag));
+
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2WriteSeekIndex_MLLT(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *v22 = id3v2TagFromFile("assets/boniver.mp3");
+    Id3MpegIndex index;
+    uint64_t offsets[6];
+
+    // 38 frames, 15846 bytes and 992ms between references, 0 bits of byte and 4 bits of time deviation
+    const uint8_t mllt[] = {0x00, 0x26, 0x00, 0x3D, 0xE6, 0x00, 0x03, 0xE0, 0x00, 0x04, 0x01, 0x01, 0x10};
+
+    seekIndexCBR(&index, offsets);
+
+    assert_true(id3v2WriteSeekIndex(&index, tag));
+    seekFrameEquals(tag, "MLLT", mllt, sizeof(mllt));
+
+    assert_true(id3v2WriteSeekIndex(&index, v22));
+    seekFrameEquals(v22, "MLL", mllt, sizeof(mllt));
+
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&v22);
+}
+
+static void id3v2TagFromMapping_matchesFile(void **state) {
+    (void) state;
+    Id3FileMapping mapping = {0};
+
+    assert_true(id3FileMap("assets/sorry4dying.mp3", &mapping));
+
+    Id3v2Tag *mapped = id3v2TagFromMapping(&mapping);
+    Id3v2Tag *read = id3v2TagFromFile("assets/sorry4dying.mp3");
+
+    id3FileUnmap(&mapping);
+
+    assert_non_null(mapped);
+    assert_non_null(read);
+    assert_int_equal(mapped->frames->length, read->frames->length);
+
+    assert_null(id3v2TagFromMapping(NULL));
+    assert_null(id3v2TagFromMapping(&mapping));
+
+    id3v2DestroyTag(&mapped);
+    id3v2DestroyTag(&read);
+}
+
+// first frame of the tag with an ID, not a copy
+static Id3v2Frame *lazyFrame(Id3v2Tag *tag, const char *id) {
+    Id3v2Frame *f = NULL;
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        if (memcmp(f->header->id, id, strlen(id)) == 0) {
+            return f;
+        }
+    }
+
+    return NULL;
+}
+
+// last entry of the first frame with an ID
+static Id3v2ContentEntry *lazyLastEntry(Id3v2Tag *tag, const char *id) {
+    Id3v2Frame *f = lazyFrame(tag, id);
+    Id3v2ContentEntry *last = NULL;
+
+    if (f != NULL) {
+        ListIter entries = listCreateIterator(f->entries);
+        Id3v2ContentEntry *e = NULL;
+
+        while ((e = (Id3v2ContentEntry *) listIteratorNext(&entries)) != NULL) {
+            last = e;
+        }
+    }
+
+    return last;
+}
+
+static void id3v2TagFromFileLazy_APIC(void **state) {
+    (void) state;
+
+    Id3v2Tag *lazy = id3v2TagFromFileLazy("assets/OnGP.mp3");
+    Id3v2Tag *read = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3v2ContentEntry *last = lazyLastEntry(lazy, "APIC");
+    size_t lazySize = 0;
+    size_t readSize = 0;
+    size_t lazyl = 0;
+    size_t readl = 0;
+
+    assert_non_null(last);
+    assert_null(last->entry);
+    assert_non_null(last->source);
+    assert_string_equal(last->source->path, "assets/OnGP.mp3");
+
+    // read on demand
+    uint8_t *lazyPicture = id3v2ReadPicture(0, lazy, &lazySize);
+    uint8_t *readPicture = id3v2ReadPicture(0, read, &readSize);
+
+    assert_non_null(lazyPicture);
+    assert_int_equal(lazySize, readSize);
+    assert_memory_equal(lazyPicture, readPicture, readSize);
+    assert_null(last->entry);
+    free(lazyPicture);
+    free(readPicture);
+
+    // encoded from the file like the held picture is encoded from memory
+    id3v2MarkFrameDirty(lazyFrame(read, "APIC"));
+
+    uint8_t *lazyOut = id3v2TagSerialize(lazy, &lazyl);
+    uint8_t *readOut = id3v2TagSerialize(read, &readl);
+
+    assert_non_null(lazyOut);
+    assert_int_equal(lazyl, readl);
+    assert_memory_equal(lazyOut, readOut, readl);
+    assert_null(last->entry);
+    free(lazyOut);
+    free(readOut);
+
+    assert_true(id3v2CompareTag(lazy, read));
+
+    id3v2DestroyTag(&lazy);
+    id3v2DestroyTag(&read);
+}
+
+static void id3v2TagFromFileLazy_PIC(void **state) {
+    (void) state;
+
+    Id3v2Tag *lazy = id3v2TagFromFileLazy("assets/danybrown2.mp3");
+    Id3v2Tag *copy = id3v2CopyTag(lazy);
+    Id3v2ContentEntry *last = lazyLastEntry(copy, "PIC");
+    size_t dataSize = 0;
+
+    // copies refer to the same file
+    assert_non_null(last);
+    assert_non_null(last->source);
+    assert_int_equal(last->source->references, 2);
+
+    uint8_t *data = id3v2ReadPicture(0, copy, &dataSize);
+
+    assert_non_null(data);
+    assert_int_equal(dataSize, 107904);
+    free(data);
+
+    // loaded entries no longer need the file
+    assert_true(id3v2LoadContentEntry(last));
+    assert_null(last->source);
+    assert_non_null(last->entry);
+    assert_int_equal(last->size, 107904);
+    assert_int_equal(lazyLastEntry(lazy, "PIC")->source->references, 1);
+
+    id3v2DestroyTag(&lazy);
+    id3v2DestroyTag(&copy);
+}
+
+static void id3v2TagFromFileLazy_writeBack(void **state) {
+    (void) state;
+
+    Id3v2Tag *read = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3v2Tag *lazy = id3v2TagFromFileLazy("assets/OnGP.mp3");
+    Id3v2Tag *tag = NULL;
+    size_t readSize = 0;
+    size_t dataSize = 0;
+    uint8_t *readPicture = id3v2ReadPicture(0, read, &readSize);
+    uint8_t *data = NULL;
+
+    // copied from the file it was read from into a new one
+    (void) remove("assets/tmp");
+    assert_true(id3v2WriteTagToFile("assets/tmp", lazy));
+    id3v2DestroyTag(&lazy);
+
+    // written back over the file it refers to
+    lazy = id3v2TagFromFileLazy("assets/tmp");
+    assert_non_null(lazyLastEntry(lazy, "APIC")->source);
+    assert_true(id3v2WriteAlbum("SCRAPYARD", lazy));
+    assert_true(id3v2WriteTagToFile("assets/tmp", lazy));
+    assert_null(lazyLastEntry(lazy, "APIC")->source);
+
+    tag = id3v2TagFromFile("assets/tmp");
+    (void) remove("assets/tmp");
+
+    data = id3v2ReadPicture(0, tag, &dataSize);
+    char *str = id3v2ReadAlbum(tag);
+
+    assert_string_equal(str, "SCRAPYARD");
+    assert_int_equal(dataSize, readSize);
+    assert_memory_equal(data, readPicture, readSize);
+
+    free(str);
+    free(data);
+    free(readPicture);
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&lazy);
+    id3v2DestroyTag(&read);
+}
+
+
+static void id3v2TagFromFileLazy_identity(void **state) {
+    (void) state;
+
+    Id3v2Tag *read = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3v2Tag *lazy = NULL;
+    Id3v2Tag *stale = NULL;
+    size_t readSize = 0;
+    size_t dataSize = 0;
+    uint8_t *readPicture = id3v2ReadPicture(0, read, &readSize);
+    uint8_t *data = NULL;
+    int in = -1;
+
+    (void) remove("assets/tmp");
+    assert_true(id3v2WriteTagToFile("assets/tmp", read));
+
+    // the file is recognised through another spelling of its path
+    lazy = id3v2TagFromFileLazy("assets/tmp");
+    assert_true(id3v2WriteAlbum("SCRAPYARD", lazy));
+    assert_true(id3v2WriteTagToFile("./assets/../assets/tmp", lazy));
+    assert_null(lazyLastEntry(lazy, "APIC")->source);
+
+    data = id3v2ReadPicture(0, lazy, &dataSize);
+    assert_int_equal(dataSize, readSize);
+    assert_memory_equal(data, readPicture, readSize);
+    free(data);
+
+    // a file written since is not read from old offsets
+    stale = id3v2TagFromFileLazy("assets/tmp");
+    assert_non_null(lazyLastEntry(stale, "APIC")->source);
+
+    in = id3v2OpenContentSource(lazyLastEntry(stale, "APIC"));
+    assert_true(in >= 0);
+    id3FileClose(in);
+    assert_true(id3v2WriteAlbum("SCRAPYARD SCRAPYARD SCRAPYARD SCRAPYARD", lazy));
+    assert_true(id3v2WriteTagToFile("assets/tmp", lazy));
+
+    data = id3v2ReadPicture(0, stale, &dataSize);
+    assert_null(data);
+    assert_int_equal(id3v2OpenContentSource(lazyLastEntry(stale, "APIC")), -1);
+
+    // nor is the tag written elsewhere without its picture
+    (void) remove("assets/tmp2");
+    assert_false(id3v2WriteTagToFile("assets/tmp2", stale));
+    assert_null(fopen("assets/tmp2", "rb"));
+    (void) remove("assets/tmp");
+
+    free(readPicture);
+    id3v2DestroyTag(&stale);
+    id3v2DestroyTag(&lazy);
+    id3v2DestroyTag(&read);
+}
 
 static void id3v2WriteTextFrameContent_TIT2(void **state) {
     (void) state;
@@ -1477,45 +1978,676 @@ static void id3v2WriteTagToFile_v4OverwriteNoPicturesAsUpdate(void **state) {
     id3v2DestroyTag(&tag);
 }
 
-int main() {
-    const struct CMUnitTest tests[] = {
+static void id3v2TagSerializeWithOptions_fixed(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    Id3v2WriteOptions *options = id3v2CreateWriteOptions(fixed_padding, 1024);
+    size_t outl = 0;
+    size_t paddedl = 0;
+    uint8_t *out = id3v2TagSerialize(tag, &outl);
+    uint8_t *padded = id3v2TagSerializeWithOptions(tag, options, &paddedl);
 
-        // id3v2TagFromFile
-        cmocka_unit_test(id3v2TagFromFile_v3),
-        cmocka_unit_test(id3v2TagFromFile_null),
+    assert_non_null(padded);
+    assert_int_equal(paddedl, outl + 1024);
 
-        // id3v2CopyTag
-        cmocka_unit_test(id3v2CopyTag_v3),
+    for (size_t i = outl; i < paddedl; i++) {
+        assert_int_equal(padded[i], 0);
+    }
 
-        // id3v2CompareTag
-        cmocka_unit_test(id3v2CompareTag_v3v4),
-        cmocka_unit_test(id3v2CompareTag_v3same),
+    Id3v2Tag *tag2 = id3v2ParseTagFromBuffer(padded, paddedl, NULL);
+    bool v = id3v2CompareTag(tag, tag2);
 
-        // id3v2ReadFrameByID
-        cmocka_unit_test(id3v2ReadFrameByID_v3),
-        cmocka_unit_test(id3v2ReadFrameByID_v3MultiTXXX),
-        cmocka_unit_test(id3v2ReadFrameByID_v2Null),
+    free(out);
+    free(padded);
+    id3v2DestroyWriteOptions(&options);
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&tag2);
 
-        // id3v2RemoveFrameByID
-        cmocka_unit_test(id3v2RemoveFrameByID_v3EveryFrame),
-        cmocka_unit_test(id3v2RemoveFrameByID_Null),
+    assert_true(v);
+}
 
-        // id3v2ReadTextFrameContent
-        cmocka_unit_test(id3v2ReadTextFrameContent_TRK),
-        cmocka_unit_test(id3v2ReadTextFrameContent_TXX),
-        cmocka_unit_test(id3v2ReadTextFrameContent_PIC),
+static void id3v2TagSerializeWithOptions_percentage(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/boniver.mp3");
+    Id3v2WriteOptions *options = id3v2CreateWriteOptions(percentage_padding, 10);
+    size_t outl = 0;
+    size_t paddedl = 0;
+    uint8_t *out = id3v2TagSerialize(tag, &outl);
+    uint8_t *padded = id3v2TagSerializeWithOptions(tag, options, &paddedl);
 
-        // id3v2ReadTitle
-        cmocka_unit_test(id3v2ReadTitle_TT2),
-        cmocka_unit_test(id3v2ReadTitle_TIT2),
+    assert_non_null(padded);
+    assert_int_equal(paddedl, outl + (outl * 10) / 100);
 
-        // id3v2ReadArtist
-        cmocka_unit_test(id3v2ReadArtist_TP1),
-        cmocka_unit_test(id3v2ReadArtist_TPE1),
+    free(out);
+    free(padded);
+    id3v2DestroyWriteOptions(&options);
+    id3v2DestroyTag(&tag);
+}
 
-        // id3v2ReadAlbumArtist
-        cmocka_unit_test(id3v2ReadArtist_TP2),
-        cmocka_unit_test(id3v2ReadArtist_TPE2),
+static void id3v2TagSerializeWithOptions_block(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    Id3v2WriteOptions *options = id3v2CreateWriteOptions(block_padding, 0);
+    size_t outl = 0;
+    uint8_t *out = id3v2TagSerializeWithOptions(tag, options, &outl);
+
+    assert_non_null(out);
+    assert_int_equal(outl % ID3V2_PADDING_BLOCK_SIZE, 0);
+    free(out);
+
+    options->paddingAmount = 512;
+    out = id3v2TagSerializeWithOptions(tag, options, &outl);
+
+    assert_non_null(out);
+    assert_int_equal(outl % 512, 0);
+
+    free(out);
+    id3v2DestroyWriteOptions(&options);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagSerializeWithOptions_v4footer(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3v2WriteOptions *options = id3v2CreateWriteOptions(fixed_padding, 1024);
+    size_t outl = 0;
+    size_t paddedl = 0;
+    uint8_t *out = NULL;
+    uint8_t *padded = NULL;
+
+    id3v2WriteFooterIndicator(tag->header, true);
+    out = id3v2TagSerialize(tag, &outl);
+    padded = id3v2TagSerializeWithOptions(tag, options, &paddedl);
+
+    // footers and padding are mutually exclusive
+    assert_int_equal(outl, paddedl);
+
+    free(out);
+    free(padded);
+    id3v2DestroyWriteOptions(&options);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2WriteTagToFileWithOptions_inPlace(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag2 = NULL;
+    Id3v2WriteOptions *options = id3v2CreateWriteOptions(block_padding, 0);
+    FILE *fp = NULL;
+    long sz = 0;
+    long sz2 = 0;
+
+    assert_true(id3v2WriteTagToFileWithOptions("assets/tmp", tag, options));
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0L, SEEK_END);
+    sz = ftell(fp);
+    (void) fclose(fp);
+
+    assert_int_equal(sz % ID3V2_PADDING_BLOCK_SIZE, 0);
+
+    // a small edit must fit in the reserved padding
+    options->paddingPolicy = preserve_padding;
+    assert_true(id3v2WriteTitle("in place", tag));
+    assert_true(id3v2WriteTagToFileWithOptions("assets/tmp", tag, options));
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0L, SEEK_END);
+    sz2 = ftell(fp);
+    (void) fclose(fp);
+
+    assert_int_equal(sz, sz2);
+
+    tag2 = id3v2TagFromFile("assets/tmp");
+    (void) remove("assets/tmp");
+
+    bool v = id3v2CompareTag(tag, tag2);
+
+    id3v2DestroyWriteOptions(&options);
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&tag2);
+
+    assert_true(v);
+}
+
+static void id3v2WriteTagToFile_shrinkKeepsAudio(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag2 = NULL;
+    FILE *fp = NULL;
+    uint8_t *out = NULL;
+    size_t outl = 0;
+    long sz = 0;
+    char str[6] = "music";
+
+    assert_true(id3v2WriteTagToFile("assets/tmp", tag));
+
+    fp = fopen("assets/tmp", "ab");
+    assert_non_null(fp);
+    (void) fwrite(str, 1, 5, fp);
+    (void) fclose(fp);
+
+    // the file is rewritten behind a smaller tag
+    assert_true(id3v2RemoveFrameByID("APIC", tag));
+    assert_true(id3v2WriteTagToFile("assets/tmp", tag));
+    out = id3v2TagSerialize(tag, &outl);
+    free(out);
+
+    fp = fopen("assets/tmp", "rb");
+    assert_non_null(fp);
+    (void) fseek(fp, 0L, SEEK_END);
+    sz = ftell(fp);
+    (void) fseek(fp, -5, SEEK_END);
+    memset(str, 0, sizeof(str));
+    (void) fread(str, 1, 5, fp);
+    (void) fclose(fp);
+
+    assert_int_equal(sz, outl + 5);
+    assert_memory_equal(str, "music", 5);
+
+    tag2 = id3v2TagFromFile("assets/tmp");
+    (void) remove("assets/tmp");
+
+    bool v = id3v2CompareTag(tag, tag2);
+
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&tag2);
+
+    assert_true(v);
+}
+
+static void id3v2TagSerializeToSink_matchesBuffer(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3Sink *sink = id3SinkCreateBuffer(0);
+    size_t outl = 0;
+    size_t sinkl = 0;
+    uint8_t *out = NULL;
+    const uint8_t *sunk = NULL;
+
+    id3v2WriteFooterIndicator(tag->header, true);
+    out = id3v2TagSerialize(tag, &outl);
+
+    assert_true(id3v2TagSerializeToSink(tag, NULL, sink));
+    sunk = id3SinkBuffer(sink, &sinkl);
+
+    assert_int_equal(outl, sinkl);
+    assert_memory_equal(out, sunk, outl);
+
+    free(out);
+    id3SinkDestroy(&sink);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagToJSONSink_matchesString(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/danybrown2.mp3");
+    Id3Sink *sink = id3SinkCreateBuffer(0);
+    char *json = id3v2TagToJSON(tag);
+
+    assert_true(id3v2TagToJSONSink(tag, sink));
+    assert_string_equal((const char *) id3SinkBuffer(sink, NULL), json);
+
+    free(json);
+    id3SinkDestroy(&sink);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagSerialize_v3unsync(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    size_t plainl = 0;
+    size_t outl = 0;
+    uint8_t *plain = id3v2TagSerialize(tag, &plainl);
+
+    id3v2WriteUnsynchronisationIndicator(tag->header, true);
+    uint8_t *out = id3v2TagSerialize(tag, &outl);
+
+    assert_non_null(plain);
+    assert_non_null(out);
+
+    // only false syncs gain a byte
+    assert_int_equal(outl, ID3V2_TAG_HEADER_SIZE + id3v2UnsynchronisedSize(plain + ID3V2_TAG_HEADER_SIZE,
+                                                                            plainl - ID3V2_TAG_HEADER_SIZE, NULL));
+
+    for (size_t i = ID3V2_TAG_HEADER_SIZE; i + 1 < outl; i++) {
+        if (out[i] == 0xFF) {
+            assert_true(out[i + 1] < 0xE0);
+        }
+    }
+
+    Id3v2Tag *tag2 = id3v2ParseTagFromBuffer(out, outl, NULL);
+    bool v = id3v2CompareTag(tag, tag2);
+
+    free(plain);
+    free(out);
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&tag2);
+
+    assert_true(v);
+}
+
+static void id3v2TagSerialize_v4unsync(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    Id3v2Frame *f = NULL;
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+    size_t outl = 0;
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        f->header->unsynchronisation = true;
+    }
+
+    uint8_t *out = id3v2TagSerialize(tag, &outl);
+    assert_non_null(out);
+
+    for (size_t i = ID3V2_TAG_HEADER_SIZE; i + 1 < outl; i++) {
+        if (out[i] == 0xFF) {
+            assert_true(out[i + 1] < 0xE0);
+        }
+    }
+
+    Id3v2Tag *tag2 = id3v2ParseTagFromBuffer(out, outl, NULL);
+    bool v = id3v2CompareTag(tag, tag2);
+
+    free(out);
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&tag2);
+
+    assert_true(v);
+}
+
+static void id3v2TagSerialize_unchangedFramesVerbatim(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    size_t outl = 0;
+    uint8_t *out = NULL;
+
+    // only the title is encoded again
+    assert_true(id3v2WriteTitle("title", tag));
+
+    Id3v2Frame *f = NULL;
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+    size_t dirty = 0;
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        dirty += id3v2FrameIsDirty(f, ID3V2_TAG_VERSION_3) ? 1 : 0;
+    }
+
+    assert_int_equal(dirty, 1);
+
+    id3v2DestroyTag(&tag);
+    tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+
+    // nothing changed so the frames come out exactly as read
+    out = id3v2TagSerialize(tag, &outl);
+    assert_non_null(out);
+    assert_true(outl <= stream->bufferSize);
+    assert_memory_equal(out + ID3V2_TAG_HEADER_SIZE, stream->buffer + ID3V2_TAG_HEADER_SIZE,
+                        outl - ID3V2_TAG_HEADER_SIZE);
+
+    free(out);
+    byteStreamDestroy(stream);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagSerializeWithOptions_compression(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/sorry4dying.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    Id3v2WriteOptions *options = id3v2CreateWriteOptions(fixed_padding, 0);
+    Id3v2Frame *f = NULL;
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+    size_t plainl = 0;
+    size_t outl = 0;
+
+    // unchanged frames are never compressed so encode everything again
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        id3v2MarkFrameDirty(f);
+    }
+
+    uint8_t *plain = id3v2TagSerializeWithOptions(tag, options, &plainl);
+
+    options->compressionThreshold = 64;
+    uint8_t *out = id3v2TagSerializeWithOptions(tag, options, &outl);
+
+    assert_non_null(plain);
+    assert_non_null(out);
+
+    if (id3v2CompressionSupported()) {
+        assert_true(outl < plainl);
+
+        // frames are inflated as they are traversed
+        Id3v2Tag *reparsed = id3v2ParseTagFromBuffer(out, outl, NULL);
+        Id3v2Frame *huge = NULL;
+        assert_non_null(reparsed);
+
+        frames = listCreateIterator(reparsed->frames);
+
+        while ((f = listIteratorNext(&frames)) != NULL && huge == NULL) {
+            if (f->compressed) {
+                assert_non_null(f->compressedContext);
+                huge = id3v2CopyFrame(f);
+            }
+        }
+
+        assert_non_null(huge);
+        assert_true(id3v2CompareTag(tag, reparsed));
+
+        frames = listCreateIterator(reparsed->frames);
+
+        while ((f = listIteratorNext(&frames)) != NULL) {
+            assert_null(f->compressedContext);
+            assert_int_equal(f->header->decompressionSize, 0);
+        }
+
+        // a size no tag can hold is not allocated
+        huge->header->decompressionSize = ID3V2_MAX_TAG_SIZE + 1;
+        assert_false(id3v2DecompressFrame(huge));
+        assert_null(huge->compressedContext);
+        assert_int_equal(huge->entries->length, 1);
+
+        id3v2DestroyFrame(&huge);
+        id3v2DestroyTag(&reparsed);
+    } else {
+        assert_int_equal(outl, plainl);
+        assert_memory_equal(out, plain, outl);
+    }
+
+    free(plain);
+    free(out);
+    id3v2DestroyWriteOptions(&options);
+    byteStreamDestroy(stream);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagSerialize_v3crc(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/sorry4dying.mp3");
+    tag->header->extendedHeader = id3v2CreateExtendedTagHeader(64, 1, 0, 0, 0);
+    id3v2WriteExtendedHeaderIndicator(tag->header, true);
+
+    size_t outl = 0;
+    uint8_t *out = id3v2TagSerialize(tag, &outl);
+
+    assert_non_null(out);
+    assert_int_not_equal(tag->header->extendedHeader->crc, 1);
+    assert_true(id3v2VerifyTagCrc(out, outl));
+
+    // the padding is not covered in v2.3
+    out[outl - 1] = 0xff;
+    assert_true(id3v2VerifyTagCrc(out, outl));
+
+    out[outl - 65] ^= 0x01;
+    assert_false(id3v2VerifyTagCrc(out, outl));
+
+    free(out);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagSerialize_v4crc(void **state) {
+    (void) state;
+    Id3v2Tag *tag = id3v2TagFromFile("assets/OnGP.mp3");
+    tag->header->extendedHeader = id3v2CreateExtendedTagHeader(32, 1, 0, 0, 0);
+    id3v2WriteExtendedHeaderIndicator(tag->header, true);
+
+    size_t outl = 0;
+    uint8_t *out = id3v2TagSerialize(tag, &outl);
+
+    assert_non_null(out);
+    assert_true(id3v2VerifyTagCrc(out, outl));
+
+    Id3v2Tag *tag2 = id3v2ParseTagFromBuffer(out, outl, NULL);
+    assert_non_null(tag2);
+    assert_int_equal(tag2->header->extendedHeader->crc, tag->header->extendedHeader->crc);
+
+    // v2.4 covers the padding too
+    out[outl - 1] = 0xff;
+    assert_false(id3v2VerifyTagCrc(out, outl));
+
+    free(out);
+    id3v2DestroyTag(&tag);
+    id3v2DestroyTag(&tag2);
+}
+
+static void id3v2VerifyTagCrc_noCrc(void **state) {
+    (void) state;
+
+    assert_false(id3v2VerifyTagCrcFromFile("assets/sorry4dying.mp3"));
+    assert_false(id3v2VerifyTagCrcFromFile(NULL));
+    assert_false(id3v2VerifyTagCrc(NULL, 0));
+}
+
+static void id3v2TagToJSONWithOptions_binaryPolicy(void **state) {
+    (void) state;
+    ByteStream *stream = byteStreamFromFile("assets/OnGP.mp3");
+    Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+    Id3v2JSONOptions *options = id3v2CreateJSONOptions(embed_binary, 0);
+    size_t pictureSize = 0;
+    uint8_t *picture = id3v2ReadPicture(0, tag, &pictureSize);
+    uint8_t digest[ID3_SHA1_DIGEST_SIZE];
+    char sha1[ID3_SHA1_DIGEST_SIZE * 2 + 16];
+    bool located = false;
+
+    assert_non_null(picture);
+
+    // embedding matches the plain conversion
+    char *plain = id3v2TagToJSON(tag);
+    char *json = id3v2TagToJSONWithOptions(tag, options);
+    assert_string_equal(json, plain);
+    free(json);
+
+    options->binaryPolicy = truncate_binary;
+    options->binaryLimit = 3;
+    json = id3v2TagToJSONWithOptions(tag, options);
+    assert_non_null(strstr(json, "\"truncated\":true"));
+    assert_true(strlen(json) < strlen(plain));
+    free(json);
+
+    id3Sha1(picture, pictureSize, digest);
+    strcpy(sha1, "\"sha1\":\"");
+
+    for (size_t i = 0; i < ID3_SHA1_DIGEST_SIZE; i++) {
+        sprintf(sha1 + 8 + i * 2, "%02x", digest[i]);
+    }
+
+    options->binaryPolicy = digest_binary;
+    json = id3v2TagToJSONWithOptions(tag, options);
+    assert_non_null(strstr(json, sha1));
+    assert_true(strlen(json) < strlen(plain));
+    free(json);
+
+    // offsets point at the picture inside the file the tag was read from
+    options->binaryPolicy = reference_binary;
+    json = id3v2TagToJSONWithOptions(tag, options);
+
+    for (char *p = strstr(json, "\"offset\":"); p != NULL; p = strstr(p + 1, "\"offset\":")) {
+        size_t offset = 0;
+        size_t size = 0;
+
+        if (sscanf(p, "\"offset\":%zu,\"size\":%zu", &offset, &size) != 2) {
+            continue;
+        }
+
+        assert_true(offset + size <= stream->bufferSize);
+
+        if (size == pictureSize) {
+            assert_memory_equal(stream->buffer + offset, picture, size);
+            located = true;
+        }
+    }
+
+    assert_true(located);
+    free(json);
+
+    // modified frames can no longer be located
+    ListIter frames = id3v2CreateFrameTraverser(tag);
+    Id3v2Frame *f = NULL;
+
+    while ((f = id3v2FrameTraverse(&frames)) != NULL) {
+        id3v2MarkFrameDirty(f);
+    }
+
+    json = id3v2TagToJSONWithOptions(tag, options);
+    assert_non_null(strstr(json, "\"offset\":null"));
+
+    for (char *p = strstr(json, "\"offset\":"); p != NULL; p = strstr(p + 1, "\"offset\":")) {
+        assert_memory_equal(p, "\"offset\":null", 13);
+    }
+
+    free(json);
+
+    free(plain);
+    free(picture);
+    id3v2DestroyJSONOptions(&options);
+    assert_null(options);
+    byteStreamDestroy(stream);
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagFromJSON_roundTrip(void **state) {
+    (void) state;
+    const char *files[] = {"assets/danybrown2.mp3", "assets/sorry4dying.mp3", "assets/OnGP.mp3"};
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        Id3v2Tag *tag = id3v2TagFromFile(files[i]);
+        Id3v2Tag *imported = NULL;
+        char *json = id3v2TagToJSON(tag);
+        char *out = NULL;
+
+        assert_non_null(json);
+
+        imported = id3v2TagFromJSON(json);
+        assert_non_null(imported);
+        assert_int_equal(imported->header->majorVersion, tag->header->majorVersion);
+        assert_int_equal(imported->frames->length, tag->frames->length);
+
+        out = id3v2TagToJSON(imported);
+        assert_string_equal(out, json);
+
+        free(out);
+        free(json);
+        id3v2DestroyTag(&imported);
+        id3v2DestroyTag(&tag);
+    }
+}
+
+static void id3v2TagFromJSON_extendedHeader(void **state) {
+    (void) state;
+    const char *json =
+        "{\"header\":{\"major\":4,\"minor\":0,\"flags\":64,\"extended\":{\"padding\":0,\"crc\":1234,\"update\":true,\"tagRestrictions\":true,\"restrictions\":5}},\"content\":[{}]}";
+    Id3v2Tag *tag = id3v2TagFromJSON(json);
+
+    assert_non_null(tag);
+    assert_int_equal(tag->header->majorVersion, ID3V2_TAG_VERSION_4);
+    assert_int_equal(tag->frames->length, 0);
+    assert_non_null(tag->header->extendedHeader);
+    assert_int_equal(tag->header->extendedHeader->crc, 1234);
+    assert_true(tag->header->extendedHeader->update);
+    assert_true(tag->header->extendedHeader->tagRestrictions);
+    assert_int_equal(tag->header->extendedHeader->restrictions, 5);
+
+    id3v2DestroyTag(&tag);
+}
+
+static void id3v2TagFromJSON_invalid(void **state) {
+    (void) state;
+
+    assert_null(id3v2TagFromJSON(NULL));
+    assert_null(id3v2TagFromJSON("{}"));
+    assert_null(id3v2TagFromJSON("{\"content\":[],\"header\":{\"major\":3,\"minor\":0,\"flags\":0}}"));
+    assert_null(id3v2TagFromJSON("{\"header\":{\"major\":9,\"minor\":0,\"flags\":0},\"content\":[]}"));
+    assert_null(id3v2TagFromJSON("{\"header\":{\"major\":3,\"minor\":0,\"flags\":0},\"content\":[]"));
+    assert_null(id3v2TagFromJSON("{\"header\":{\"major\":3,\"minor\":0,\"flags\":0},\"content\":[{\"header\":1}]}"));
+}
+
+static void id3v2TagToCBOR_roundTrip(void **state) {
+    (void) state;
+    const char *files[] = {"assets/danybrown2.mp3", "assets/sorry4dying.mp3", "assets/OnGP.mp3"};
+
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        Id3v2Tag *tag = id3v2TagFromFile(files[i]);
+        Id3v2Tag *imported = NULL;
+        size_t cborl = 0;
+        uint8_t *cbor = id3v2TagToCBOR(tag, &cborl);
+        char *json = id3v2TagToJSON(tag);
+        char *importedJson = NULL;
+
+        assert_non_null(cbor);
+        assert_true(cborl < strlen(json));
+
+        imported = id3v2TagFromCBOR(cbor, cborl);
+        assert_non_null(imported);
+        assert_int_equal(imported->frames->length, tag->frames->length);
+
+        importedJson = id3v2TagToJSON(imported);
+        assert_string_equal(importedJson, json);
+
+        free(importedJson);
+        free(json);
+        free(cbor);
+        id3v2DestroyTag(&imported);
+        id3v2DestroyTag(&tag);
+    }
+}
+
+static void id3v2TagToCBOR_invalid(void **state) {
+    (void) state;
+    size_t cborl = 0;
+    uint8_t *cbor = id3v2TagToCBOR(NULL, &cborl);
+
+    assert_non_null(cbor);
+    assert_int_equal(cborl, 1);
+    assert_int_equal(cbor[0], 0xa0);
+
+    assert_null(id3v2TagFromCBOR(cbor, cborl));
+    assert_null(id3v2TagFromCBOR(NULL, 0));
+
+    free(cbor);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+
+        // id3v2TagFromFile
+        cmocka_unit_test(id3v2TagFromFile_v3),
+        cmocka_unit_test(id3v2TagFromFile_null),
+
+        // id3v2CopyTag
+        cmocka_unit_test(id3v2CopyTag_v3),
+
+        // id3v2CompareTag
+        cmocka_unit_test(id3v2CompareTag_v3v4),
+        cmocka_unit_test(id3v2CompareTag_v3same),
+
+        // id3v2ReadFrameByID
+        cmocka_unit_test(id3v2ReadFrameByID_v3),
+        cmocka_unit_test(id3v2ReadFrameByID_v3MultiTXXX),
+        cmocka_unit_test(id3v2ReadFrameByID_v2Null),
+
+        // id3v2RemoveFrameByID
+        cmocka_unit_test(id3v2RemoveFrameByID_v3EveryFrame),
+        cmocka_unit_test(id3v2RemoveFrameByID_Null),
+
+        // id3v2ReadTextFrameContent
+        cmocka_unit_test(id3v2ReadTextFrameContent_TRK),
+        cmocka_unit_test(id3v2ReadTextFrameContent_TXX),
+        cmocka_unit_test(id3v2ReadTextFrameContent_PIC),
+
+        // id3v2ReadTitle
+        cmocka_unit_test(id3v2ReadTitle_TT2),
+        cmocka_unit_test(id3v2ReadTitle_TIT2),
+
+        // id3v2ReadArtist
+        cmocka_unit_test(id3v2ReadArtist_TP1),
+        cmocka_unit_test(id3v2ReadArtist_TPE1),
+
+        // id3v2ReadAlbumArtist
+        cmocka_unit_test(id3v2ReadArtist_TP2),
+        cmocka_unit_test(id3v2ReadArtist_TPE2),
 
         // id3v2ReadAlbum
         cmocka_unit_test(id3v2ReadArtist_TAL),
@@ -1553,6 +2685,24 @@ int main() {
         cmocka_unit_test(id3v2ReadPicture_PIC),
         cmocka_unit_test(id3v2ReadPicture_APIC),
 
+        // id3v2ReadPictureView
+        cmocka_unit_test(id3v2ReadPictureView_APIC),
+        cmocka_unit_test(id3v2ReadPictureView_PIC),
+        cmocka_unit_test(id3v2ReadPictureView_changed),
+
+        // id3v2ExtractPictureToFd
+        cmocka_unit_test(id3v2ExtractPictureToFd_APIC),
+        cmocka_unit_test(id3v2ExtractPictureToFd_missing),
+
+        // id3v2TagFromMapping
+        cmocka_unit_test(id3v2TagFromMapping_matchesFile),
+
+        // id3v2TagFromFileLazy
+        cmocka_unit_test(id3v2TagFromFileLazy_APIC),
+        cmocka_unit_test(id3v2TagFromFileLazy_PIC),
+        cmocka_unit_test(id3v2TagFromFileLazy_writeBack),
+        cmocka_unit_test(id3v2TagFromFileLazy_identity),
+
         // id3v2WriteTextFrameContent
         cmocka_unit_test(id3v2WriteTextFrameContent_TIT2),
         cmocka_unit_test(id3v2WriteTextFrameContent_TCOM),
@@ -1607,6 +2757,14 @@ int main() {
         // id3v2WritePictureFromFile
         cmocka_unit_test(id3v2WritePictureFromFile_PIC),
 
+        // id3v2WriteAudioHash
+        cmocka_unit_test(id3v2WriteAudioHash_versions),
+        cmocka_unit_test(id3v2ReadAudioHash_otherOwner),
+
+        // id3v2WriteSeekIndex
+        cmocka_unit_test(id3v2WriteSeekIndex_ASPI),
+        cmocka_unit_test(id3v2WriteSeekIndex_MLLT),
+
         // id3v2InsertTextFrame
         cmocka_unit_test(id3v2InsertTextFrame_TSOA),
         cmocka_unit_test(id3v2InsertTextFrame_TSOAnoString),
@@ -1631,7 +2789,50 @@ int main() {
         cmocka_unit_test(id3v2WriteTagToFile_v2NoFile),
         cmocka_unit_test(id3v2WriteTagToFile_v3Overwrite),
         cmocka_unit_test(id3v2WriteTagToFile_v4OverwriteNoPictures),
-        cmocka_unit_test(id3v2WriteTagToFile_v4OverwriteNoPicturesAsUpdate)
+        cmocka_unit_test(id3v2WriteTagToFile_v4OverwriteNoPicturesAsUpdate),
+        cmocka_unit_test(id3v2WriteTagToFile_shrinkKeepsAudio),
+
+        // id3v2TagSerializeWithOptions
+        cmocka_unit_test(id3v2TagSerializeWithOptions_fixed),
+        cmocka_unit_test(id3v2TagSerializeWithOptions_percentage),
+        cmocka_unit_test(id3v2TagSerializeWithOptions_block),
+        cmocka_unit_test(id3v2TagSerializeWithOptions_v4footer),
+
+        // id3v2WriteTagToFileWithOptions
+        cmocka_unit_test(id3v2WriteTagToFileWithOptions_inPlace),
+
+        // id3v2TagSerializeToSink
+        cmocka_unit_test(id3v2TagSerializeToSink_matchesBuffer),
+
+        // id3v2TagToJSONSink
+        cmocka_unit_test(id3v2TagToJSONSink_matchesString),
+
+        // unsynchronisation
+        cmocka_unit_test(id3v2TagSerialize_v3unsync),
+        cmocka_unit_test(id3v2TagSerialize_v4unsync),
+
+        // frame cache
+        cmocka_unit_test(id3v2TagSerialize_unchangedFramesVerbatim),
+
+        // compression
+        cmocka_unit_test(id3v2TagSerializeWithOptions_compression),
+
+        // extended header crc
+        cmocka_unit_test(id3v2TagSerialize_v3crc),
+        cmocka_unit_test(id3v2TagSerialize_v4crc),
+        cmocka_unit_test(id3v2VerifyTagCrc_noCrc),
+
+        // json options
+        cmocka_unit_test(id3v2TagToJSONWithOptions_binaryPolicy),
+
+        // id3v2TagFromJSON
+        cmocka_unit_test(id3v2TagFromJSON_roundTrip),
+        cmocka_unit_test(id3v2TagFromJSON_extendedHeader),
+        cmocka_unit_test(id3v2TagFromJSON_invalid),
+
+        // id3v2TagToCBOR
+        cmocka_unit_test(id3v2TagToCBOR_roundTrip),
+        cmocka_unit_test(id3v2TagToCBOR_invalid)
 
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -1790,14 +1790,17 @@ static void id3v2ParseTagFromStream_v4(void **state) {
 
 static void id3v2ParseTagFromStream_v2unsync(void **state) {
     (void) state;
-    uint8_t data[43] = {
-        'I', 'D', '3', 0x02, 0x01, 0x80, 0x00, 0x00, 0x00, 0x21,
-        'T', 0x00, 'A', 0x00, 'L', 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b, 0x00,
-        0x00, 0x00,
-        'F', 0x00, 'a', 0x00, 'm', 0x00, 'i', 0x00, 'l', 0x00, 'y', 0x00, ' ', 0x00, 'G', 0x00, 'u', 0x00, 'y'
+    uint8_t data[38] = {
+        'I', 'D', '3', 0x02, 0x01, 0x80, 0x00, 0x00, 0x00, 0x1c,
+        'T', 'A', 'L', 0x00, 0x00, 0x0b,
+        0x00,
+        'F', 'a', 'm', 'i', 'l', 'y', ' ', 'G', 'u', 'y',
+        'C', 'N', 'T', 0x00, 0x00, 0x04,
+        0xff, 0x00, 0xe0, 0xff, 0x01 // $FF $E0 is a false sync, $FF $01 is not
     };
+    const uint8_t counter[4] = {0xff, 0xe0, 0xff, 0x01};
 
-    ByteStream *stream = byteStreamCreate(data, 43);
+    ByteStream *stream = byteStreamCreate(data, 38);
     Id3v2Tag *tag = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
     uint8_t encoding = 0;
 
@@ -1817,10 +1820,39 @@ static void id3v2ParseTagFromStream_v2unsync(void **state) {
     ce = (Id3v2ContentEntry *) f->entries->head->next->data;
     testEntry(ce, 11, (uint8_t *) "Family Guy");
 
+    f = (Id3v2Frame *) tag->frames->head->next->data;
+    ce = (Id3v2ContentEntry *) f->entries->head->data;
+
+    testFrameHeader(f, "CNT\0", 0, 0, 0, 0, 0, 0, 0);
+    testEntry(ce, 4, counter);
+
     id3v2DestroyTag(&tag);
     byteStreamDestroy(stream);
 }
 
+static void id3v2ParseFrame_v4unsync(void **state) {
+    (void) state;
+    uint8_t data[17] = {
+        'P', 'C', 'N', 'T', 0x00, 0x00, 0x00, 0x07, 0x00, 0x02,
+        0xff, 0x00, 0xff, 0x00, 0x00, 0xff, 0x00
+    };
+    const uint8_t counter[4] = {0xff, 0xff, 0x00, 0xff};
+    List *context = id3v2CreatePlayCounterFrameContext();
+    Id3v2Frame *f = NULL;
+    Id3v2ContentEntry *ce = NULL;
+
+    uint32_t v = id3v2ParseFrame(data, 17, context, ID3V2_TAG_VERSION_4, &f);
+
+    assert_int_equal(v, 17);
+    testFrameHeader(f, "PCNT", 1, 0, 0, 0, 0, 0, 0);
+
+    ce = (Id3v2ContentEntry *) f->entries->head->data;
+    testEntry(ce, 4, counter);
+
+    id3v2DestroyFrame(&f);
+    listFree(context);
+}
+
 static void id3v2ParseTagFromStream_v3ext(void **state) {
     (void) state;
     uint8_t data[45] = {
@@ -1896,6 +1928,136 @@ static void id3v2ParseTagFromStream_v2ULTWithMissingDesc(void **state) {
     byteStreamDestroy(stream);
 }
 
+static void id3v2ParserParse_matchesParseTagFromBuffer(void **state) {
+    (void) state;
+    const char *files[3] = {"assets/OnGP.mp3", "assets/sorry4dying.mp3", "assets/danybrown2.mp3"};
+    Id3v2Parser *parser = id3v2CreateParser(NULL);
+
+    assert_non_null(parser);
+
+    // twice over every version so the second pass reuses the kept pairings
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < 3; i++) {
+            ByteStream *stream = byteStreamFromFile(files[i]);
+            Id3v2Tag *expected = id3v2ParseTagFromBuffer(stream->buffer, stream->bufferSize, NULL);
+            Id3v2Tag *tag = id3v2ParserParse(parser, stream->buffer, stream->bufferSize);
+
+            assert_non_null(tag);
+            assert_non_null(tag->header);
+            assert_int_equal(tag->header->majorVersion, expected->header->majorVersion);
+            assert_int_equal(tag->frames->length, expected->frames->length);
+            assert_non_null(parser->pairs[tag->header->majorVersion - ID3V2_TAG_VERSION_2]);
+
+            id3v2DestroyTag(&expected);
+            id3v2DestroyTag(&tag);
+            byteStreamDestroy(stream);
+        }
+    }
+
+    id3v2DestroyParser(&parser);
+    assert_null(parser);
+}
+
+static void id3v2ParserParse_unsyncReusesScratch(void **state) {
+    (void) state;
+    uint8_t data[38] = {
+        'I', 'D', '3', 0x02, 0x01, 0x80, 0x00, 0x00, 0x00, 0x1c,
+        'T', 'A', 'L', 0x00, 0x00, 0x0b,
+        0x00,
+        'F', 'a', 'm', 'i', 'l', 'y', ' ', 'G', 'u', 'y',
+        'C', 'N', 'T', 0x00, 0x00, 0x04,
+        0xff, 0x00, 0xe0, 0xff, 0x01
+    };
+    uint8_t copy[38];
+    const uint8_t counter[4] = {0xff, 0xe0, 0xff, 0x01};
+    Id3v2Parser *parser = id3v2CreateParser(NULL);
+    uint8_t *scratch = NULL;
+
+    memcpy(copy, data, sizeof(data));
+
+    for (int i = 0; i < 2; i++) {
+        Id3v2Tag *tag = id3v2ParserParse(parser, data, sizeof(data));
+        Id3v2Frame *f = NULL;
+        Id3v2ContentEntry *ce = NULL;
+
+        assert_non_null(tag);
+        assert_int_equal(tag->frames->length, 2);
+
+        f = (Id3v2Frame *) tag->frames->head->next->data;
+        ce = (Id3v2ContentEntry *) f->entries->head->data;
+        testFrameHeader(f, "CNT\0", 0, 0, 0, 0, 0, 0, 0);
+        testEntry(ce, 4, counter);
+
+        // the input is resynchronised in the parser's buffer, not in place
+        assert_memory_equal(data, copy, sizeof(data));
+
+        if (i == 0) {
+            scratch = parser->scratch;
+            assert_non_null(scratch);
+        } else {
+            assert_true(parser->scratch == scratch);
+        }
+
+        id3v2DestroyTag(&tag);
+    }
+
+    id3v2DestroyParser(&parser);
+}
+
+static void id3v2ParserParse_frameUnsyncReusesScratch(void **state) {
+    (void) state;
+    uint8_t data[25] = {
+        'I', 'D', '3', 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f,
+        'P', 'C', 'N', 'T', 0x00, 0x00, 0x00, 0x05, 0x00, 0x02,
+        0xff, 0x00, 0xe0, 0xff, 0x01
+    };
+    uint8_t copy[25];
+    const uint8_t counter[4] = {0xff, 0xe0, 0xff, 0x01};
+    Id3v2Parser *parser = id3v2CreateParser(NULL);
+    uint8_t *scratch = NULL;
+
+    memcpy(copy, data, sizeof(data));
+
+    for (int i = 0; i < 2; i++) {
+        Id3v2Tag *tag = id3v2ParserParse(parser, data, sizeof(data));
+        Id3v2Frame *f = NULL;
+
+        assert_non_null(tag);
+        assert_int_equal(tag->frames->length, 1);
+
+        f = (Id3v2Frame *) tag->frames->head->data;
+        testFrameHeader(f, "PCNT", 1, 0, 0, 0, 0, 0, 0);
+        testEntry((Id3v2ContentEntry *) f->entries->head->data, 4, counter);
+
+        // a v2.4 frame is resynchronised in the parser's buffer too, leaving the input as read
+        assert_memory_equal(data, copy, sizeof(data));
+
+        if (i == 0) {
+            scratch = parser->scratch;
+            assert_non_null(scratch);
+        } else {
+            assert_true(parser->scratch == scratch);
+        }
+
+        id3v2DestroyTag(&tag);
+    }
+
+    id3v2DestroyParser(&parser);
+}
+
+static void id3v2ParserParse_null(void **state) {
+    (void) state;
+    uint8_t data[3] = {'I', 'D', '3'};
+    Id3v2Parser *parser = id3v2CreateParser(NULL);
+
+    assert_null(id3v2ParserParse(NULL, data, sizeof(data)));
+    assert_null(id3v2ParserParse(parser, NULL, 0));
+
+    id3v2DestroyParser(&parser);
+    id3v2DestroyParser(&parser);
+    id3v2DestroyParser(NULL);
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
 
@@ -1953,8 +2115,15 @@ int main() {
         cmocka_unit_test(id3v2ParseTagFromStream_v3),
         cmocka_unit_test(id3v2ParseTagFromStream_v4),
         cmocka_unit_test(id3v2ParseTagFromStream_v2unsync),
+        cmocka_unit_test(id3v2ParseFrame_v4unsync),
         cmocka_unit_test(id3v2ParseTagFromStream_v3ext),
-        cmocka_unit_test(id3v2ParseTagFromStream_v2ULTWithMissingDesc)
+        cmocka_unit_test(id3v2ParseTagFromStream_v2ULTWithMissingDesc),
+
+        // id3v2ParserParse
+        cmocka_unit_test(id3v2ParserParse_matchesParseTagFromBuffer),
+        cmocka_unit_test(id3v2ParserParse_unsyncReusesScratch),
+        cmocka_unit_test(id3v2ParserParse_frameUnsyncReusesScratch),
+        cmocka_unit_test(id3v2ParserParse_null)
 
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
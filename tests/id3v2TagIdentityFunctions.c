@@ -1273,6 +1273,21 @@ static void id3v2TagHeaderToJSON_v4ext(void **state) {
  * Its done this way as pretty much all structs are unaware of the unsync flag
  */
 
+static void id3v2ExtendedTagHeaderSerialize_v4fullCrc(void **state) {
+    (void) state;
+    Id3v2ExtendedTagHeader *ext = id3v2CreateExtendedTagHeader(0, 0xFFFFFFFF, 0, 0, 0);
+    size_t outl = 0;
+    uint8_t *out = id3v2ExtendedTagHeaderSerialize(ext, ID3V2_TAG_VERSION_4, &outl);
+    const uint8_t crc[5] = {0x0F, 0x7F, 0x7F, 0x7F, 0x7F};
+
+    // all 32 bits need 35 syncsafe bits
+    assert_int_equal(outl, 11);
+    assert_memory_equal(out + 6, crc, 5);
+
+    free(out);
+    id3v2DestroyExtendedTagHeader(&ext);
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
 
@@ -1404,6 +1419,7 @@ int main() {
         cmocka_unit_test(id3v2ExtendedTagHeaderSerialize_v4WithEverything),
         cmocka_unit_test(id3v2ExtendedTagHeaderSerialize_v4),
         cmocka_unit_test(id3v2ExtendedTagHeaderSerialize_v4crc),
+        cmocka_unit_test(id3v2ExtendedTagHeaderSerialize_v4fullCrc),
         cmocka_unit_test(id3v2ExtendedTagHeaderSerialize_v4restrictions),
 
         // id3v2ExtendedTagHeaderToJSON
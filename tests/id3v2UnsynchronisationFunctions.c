@@ -0,0 +1,140 @@
+/**
+ * @file id3v2UnsynchronisationFunctions.c
+ * @author Ewan Jones
+ * @brief unit tests for id3v2Unsynchronisation.c
+ * @version 26.01
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include "id3v2/id3v2Unsynchronisation.h"
+
+static void id3v2Unsynchronise_onlyFalseSyncs(void **state) {
+    (void) state;
+
+    const uint8_t in[] = {0x01, 0xFF, 0xE0, 0xFF, 0x00, 0xFF, 0x7F, 0xFF, 0xDF, 0x02};
+    const uint8_t expected[] = {0x01, 0xFF, 0x00, 0xE0, 0xFF, 0x00, 0x00, 0xFF, 0x7F, 0xFF, 0xDF, 0x02};
+    size_t outl = 0;
+    uint8_t *out = id3v2Unsynchronise(in, sizeof(in), NULL, &outl);
+
+    assert_non_null(out);
+    assert_int_equal(outl, sizeof(expected));
+    assert_int_equal(id3v2UnsynchronisedSize(in, sizeof(in), NULL), sizeof(expected));
+    assert_memory_equal(out, expected, sizeof(expected));
+
+    free(out);
+}
+
+static void id3v2Unsynchronise_noMarkers(void **state) {
+    (void) state;
+
+    const uint8_t in[] = "TIT2 nothing to stuff here";
+    size_t outl = 0;
+    uint8_t *out = id3v2Unsynchronise(in, sizeof(in) - 1, NULL, &outl);
+
+    assert_non_null(out);
+    assert_int_equal(outl, sizeof(in) - 1);
+    assert_memory_equal(out, in, outl);
+
+    free(out);
+}
+
+static void id3v2Unsynchronise_trailingMarker(void **state) {
+    (void) state;
+
+    const uint8_t in[] = {0x41, 0xFF};
+    const uint8_t frameId = 'T';
+    const uint8_t sync = 0xFB;
+    size_t outl = 0;
+    uint8_t *out = NULL;
+
+    // end of the tag or padding
+    out = id3v2Unsynchronise(in, sizeof(in), NULL, &outl);
+    assert_int_equal(outl, 3);
+    assert_int_equal(out[2], 0x00);
+    free(out);
+
+    // another frame follows
+    out = id3v2Unsynchronise(in, sizeof(in), &frameId, &outl);
+    assert_int_equal(outl, 2);
+    assert_memory_equal(out, in, 2);
+    free(out);
+
+    // a false sync across the boundary
+    assert_int_equal(id3v2UnsynchronisedSize(in, sizeof(in), &sync), 3);
+}
+
+static void id3v2Unsynchronise_empty(void **state) {
+    (void) state;
+
+    size_t outl = 1;
+
+    assert_null(id3v2Unsynchronise(NULL, 10, NULL, &outl));
+    assert_int_equal(outl, 0);
+    assert_int_equal(id3v2UnsynchronisedSize(NULL, 0, NULL), 0);
+    assert_int_equal(id3v2Resynchronise(NULL, 0), 0);
+}
+
+static void id3v2Resynchronise_roundTrip(void **state) {
+    (void) state;
+
+    uint8_t in[4096];
+    size_t outl = 0;
+    uint8_t *out = NULL;
+    size_t length = 0;
+
+    srand(26);
+    for (size_t i = 0; i < sizeof(in); i++) {
+        in[i] = (rand() % 4 == 0) ? 0xFF : (uint8_t) rand();
+    }
+
+    out = id3v2Unsynchronise(in, sizeof(in), NULL, &outl);
+    assert_non_null(out);
+    assert_true(outl > sizeof(in));
+
+    // no false syncs remain
+    for (size_t i = 0; i + 1 < outl; i++) {
+        if (out[i] == 0xFF) {
+            assert_true(out[i + 1] < 0xE0);
+        }
+    }
+
+    length = id3v2Resynchronise(out, outl);
+    assert_int_equal(length, sizeof(in));
+    assert_memory_equal(out, in, sizeof(in));
+
+    free(out);
+}
+
+static void id3v2Resynchronise_keepsLoneMarkers(void **state) {
+    (void) state;
+
+    uint8_t in[] = {0xFF, 0x00, 0xE0, 0xFF, 0x41, 0xFF, 0x00, 0x00, 0xFF};
+    const uint8_t expected[] = {0xFF, 0xE0, 0xFF, 0x41, 0xFF, 0x00, 0xFF};
+
+    assert_int_equal(id3v2Resynchronise(in, sizeof(in)), sizeof(expected));
+    assert_memory_equal(in, expected, sizeof(expected));
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        // id3v2Unsynchronise
+        cmocka_unit_test(id3v2Unsynchronise_onlyFalseSyncs),
+        cmocka_unit_test(id3v2Unsynchronise_noMarkers),
+        cmocka_unit_test(id3v2Unsynchronise_trailingMarker),
+        cmocka_unit_test(id3v2Unsynchronise_empty),
+
+        // id3v2Resynchronise
+        cmocka_unit_test(id3v2Resynchronise_roundTrip),
+        cmocka_unit_test(id3v2Resynchronise_keepsLoneMarkers),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}